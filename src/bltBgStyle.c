@@ -3030,6 +3030,25 @@ Blt_BackgroundBorder(Background *bgPtr)
     return bgPtr->corePtr->border;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_BackgroundIsSolid
+ *
+ *	Indicates if the background pattern referenced by the token is a
+ *	solid color.
+ *
+ * Results:
+ *	Returns 1 if the pattern is a solid color, 0 otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_BackgroundIsSolid(Background *bgPtr)
+{
+    return (bgPtr->corePtr->classPtr->type == PATTERN_SOLID);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -41,6 +41,8 @@ BLT_EXTERN XColor *Blt_BackgroundBorderColor(Blt_Background bg);
 
 BLT_EXTERN Tk_3DBorder Blt_BackgroundBorder(Blt_Background bg);
 
+BLT_EXTERN int Blt_BackgroundIsSolid(Blt_Background bg);
+
 BLT_EXTERN const char *Blt_NameOfBackground(Blt_Background bg);
 
 BLT_EXTERN void Blt_FreeBackground(Blt_Background bg);
@@ -45,6 +45,8 @@
 #define NUMDIGITS		15	/* Specifies the number of digits of
 					 * accuracy used when outputting axis
 					 * tick labels. */
+#define LABEL_CACHE_SIZE	500	/* # of tick labels cached by an axis,
+					 * besides the ones displayed. */
 enum TickRange {
     AXIS_TIGHT, AXIS_LOOSE, AXIS_ALWAYS_LOOSE
 };
@@ -63,9 +65,29 @@ enum TickRange {
 #define AXIS_SHOWTICKS		(1<<21)	/* Display axis ticks. */
 #define AXIS_EXTERIOR		(1<<22)	/* Axis is exterior to the plot. */
 #define AXIS_CHECK_LIMITS	(1<<23)	/* Validate user-defined axis limits. */
+#define AXIS_FLUSH_LABELS	(1<<26)	/* Flush the cached tick labels before
+					 * they are next used. */
 
 #define HORIZMARGIN(m)	(!((m)->site & 0x1)) /* Even sites are horizontal */
 
+/* Log scale overrides time scale. */
+#define IsTimeAxis(a)	(((a)->timeScale) && (!(a)->logScale))
+
+/* Format of time labels when the tick step is unknown. */
+#define DEF_TIME_FORMAT		"%Y-%m-%d %H:%M:%S"
+
+/* Shared axes are kept by name in a table of the interpreter. */
+#define SHARED_AXIS_THREAD_KEY	"BLT Graph Shared Axis Data"
+
+/* Options copied between the axes of a shared axis. */
+#define SHARED_OPTIONS	"-autorange", "-descending", "-epoch", "-logscale", \
+	"-loose", "-max", "-min", "-scrollmax", "-scrollmin", "-shiftby", \
+	"-stepsize", "-subdivisions", "-tickdefault", "-timescale", "-timeunits"
+
+/* Options that change how tick labels are formatted or measured. */
+#define LABEL_OPTIONS	"-command", "-epoch", "-logscale", "-rotate", \
+	"-tickfont", "-timescale", "-timeunits"
+
 typedef struct {
     int axis;				/* Length of the axis.  */
     int t1;			        /* Length of a major tick (in
@@ -125,6 +147,11 @@ static Blt_OptionPrintProc LooseToObjProc;
 static Blt_CustomOption looseOption = {
     ObjToLooseProc, LooseToObjProc, NULL, (ClientData)0,
 };
+static Blt_OptionParseProc ObjToTimeUnitsProc;
+static Blt_OptionPrintProc TimeUnitsToObjProc;
+static Blt_CustomOption timeUnitsOption = {
+    ObjToTimeUnitsProc, TimeUnitsToObjProc, NULL, (ClientData)0,
+};
 
 static Blt_OptionParseProc ObjToUseProc;
 static Blt_OptionPrintProc UseToObjProc;
@@ -132,6 +159,13 @@ static Blt_CustomOption useOption = {
     ObjToUseProc, UseToObjProc, NULL, (ClientData)0
 };
 
+static Blt_OptionFreeProc  FreeSharedProc;
+static Blt_OptionParseProc ObjToSharedProc;
+static Blt_OptionPrintProc SharedToObjProc;
+static Blt_CustomOption sharedOption = {
+    ObjToSharedProc, SharedToObjProc, FreeSharedProc, (ClientData)0
+};
+
 #define DEF_AXIS_ACTIVEBACKGROUND	STD_ACTIVE_BACKGROUND
 #define DEF_AXIS_ACTIVEFOREGROUND	STD_ACTIVE_FOREGROUND
 #define DEF_AXIS_ACTIVERELIEF		"flat"
@@ -141,6 +175,7 @@ static Blt_CustomOption useOption = {
 #define DEF_AXIS_CHECKLIMITS		"0"
 #define DEF_AXIS_COMMAND		(char *)NULL
 #define DEF_AXIS_DESCENDING		"0"
+#define DEF_AXIS_EPOCH			"0"
 #define DEF_AXIS_FOREGROUND		RGB_BLACK
 #define DEF_AXIS_GRID_BARCHART		"1"
 #define DEF_AXIS_GRIDCOLOR		RGB_GREY64
@@ -158,6 +193,7 @@ static Blt_CustomOption useOption = {
 #define DEF_AXIS_RANGE			"0.0"
 #define DEF_AXIS_RELIEF			"flat"
 #define DEF_AXIS_SCROLL_INCREMENT 	"10"
+#define DEF_AXIS_SHARED			(char *)NULL
 #define DEF_AXIS_SHIFTBY		"0.0"
 #define DEF_AXIS_SHOWTICKS		"1"
 #define DEF_AXIS_STEP			"0.0"
@@ -171,6 +207,9 @@ static Blt_CustomOption useOption = {
 #define DEF_AXIS_TICKFONT_BARCHART	STD_FONT_SMALL
 #define DEF_AXIS_TICKLENGTH		"4"
 #define DEF_AXIS_DIVISIONS		"10"
+#define DEF_AXIS_TIMEFORMAT		(char *)NULL
+#define DEF_AXIS_TIMESCALE		"0"
+#define DEF_AXIS_TIMEUNITS		"seconds"
 #define DEF_AXIS_TITLE_ALTERNATE	"0"
 #define DEF_AXIS_TITLE_FG		RGB_BLACK
 #define DEF_AXIS_TITLE_FONT		"{Sans Serif} 10"
@@ -214,6 +253,8 @@ static Blt_ConfigSpec configSpecs[] =
     {BLT_CONFIG_BOOLEAN, "-descending", "descending", "Descending",
 	DEF_AXIS_DESCENDING, Blt_Offset(Axis, descending),
 	ALL_GRAPHS | BLT_CONFIG_DONT_SET_DEFAULT},
+    {BLT_CONFIG_LONG, "-epoch", "epoch", "Epoch", DEF_AXIS_EPOCH, 
+	Blt_Offset(Axis, epoch), ALL_GRAPHS | BLT_CONFIG_DONT_SET_DEFAULT},
     {BLT_CONFIG_BITMASK, "-exterior", "exterior", "exterior", DEF_AXIS_EXTERIOR,
 	Blt_Offset(Axis, flags), ALL_GRAPHS | BLT_CONFIG_DONT_SET_DEFAULT, 
  	(Blt_CustomOption *)AXIS_EXTERIOR},
@@ -297,6 +338,9 @@ static Blt_ConfigSpec configSpecs[] =
 	Blt_Offset(Axis, reqScrollMax),  ALL_GRAPHS, &limitOption},
     {BLT_CONFIG_CUSTOM, "-scrollmin", "scrollMin", "ScrollMin", (char *)NULL, 
 	Blt_Offset(Axis, reqScrollMin), ALL_GRAPHS, &limitOption},
+    {BLT_CONFIG_CUSTOM, "-shared", "shared", "Shared", DEF_AXIS_SHARED, 
+	Blt_Offset(Axis, sharedPtr), ALL_GRAPHS | BLT_CONFIG_NULL_OK, 
+	&sharedOption},
     {BLT_CONFIG_DOUBLE, "-shiftby", "shiftBy", "ShiftBy",
 	DEF_AXIS_SHIFTBY, Blt_Offset(Axis, shiftBy),
 	ALL_GRAPHS | BLT_CONFIG_DONT_SET_DEFAULT},
@@ -322,6 +366,15 @@ static Blt_ConfigSpec configSpecs[] =
     {BLT_CONFIG_INT, "-tickdefault", "tickDefault", "TickDefault",
 	DEF_AXIS_DIVISIONS, Blt_Offset(Axis, reqNumMajorTicks),
 	ALL_GRAPHS | BLT_CONFIG_DONT_SET_DEFAULT},
+    {BLT_CONFIG_STRING, "-timeformat", "timeFormat", "TimeFormat",
+	DEF_AXIS_TIMEFORMAT, Blt_Offset(Axis, timeFormat),
+	BLT_CONFIG_NULL_OK | ALL_GRAPHS},
+    {BLT_CONFIG_BOOLEAN, "-timescale", "timeScale", "TimeScale",
+	DEF_AXIS_TIMESCALE, Blt_Offset(Axis, timeScale),
+	ALL_GRAPHS | BLT_CONFIG_DONT_SET_DEFAULT},
+    {BLT_CONFIG_CUSTOM, "-timeunits", "timeUnits", "TimeUnits", 
+	DEF_AXIS_TIMEUNITS, Blt_Offset(Axis, timeUnits), 
+	ALL_GRAPHS | BLT_CONFIG_DONT_SET_DEFAULT, &timeUnitsOption},
     {BLT_CONFIG_STRING, "-title", "title", "Title",
 	(char *)NULL, Blt_Offset(Axis, title),
 	BLT_CONFIG_DONT_SET_DEFAULT | BLT_CONFIG_NULL_OK | ALL_GRAPHS},
@@ -344,6 +397,15 @@ static Tcl_FreeProc FreeAxis;
 static int GetAxisByClass(Tcl_Interp *interp, Graph *graphPtr, Tcl_Obj *objPtr,
 	ClassId classId, Axis **axisPtrPtr);
 static void TimeScaleAxis(Axis *axisPtr, double min, double max);
+static Ticks *GenerateTimeTicks(Axis *axisPtr);
+static int ValueToTime(Axis *axisPtr, double value, Tcl_WideInt *timePtr);
+static Tcl_WideInt RoundTickTime(Axis *axisPtr, Tcl_WideInt t);
+static void FormatTime(const char *fmt, Tcl_WideInt t, char *buffer, 
+	size_t size);
+static void FormatTimeValue(Axis *axisPtr, Tcl_WideInt t, char *buffer, 
+	size_t size);
+static const char *TimeTickFormat(Axis *axisPtr);
+static Tcl_IdleProc DisplaySharedAxis;
 
 static int lastMargin;
 typedef int (GraphAxisProc)(Tcl_Interp *interp, Axis *axisPtr, int objc, 
@@ -818,6 +880,366 @@ UseToObjProc(
     return Tcl_NewStringObj(axisNames[axisPtr->margin].name, -1);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SharedAxisInterpDeleteProc --
+ *
+ *	Frees the shared axes of the interpreter when it's deleted.  Axes
+ *	still attached to them are detached.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static void
+SharedAxisInterpDeleteProc(ClientData clientData, Tcl_Interp *interp)
+{
+    Blt_HashTable *tablePtr = clientData;
+    Blt_HashEntry *hPtr;
+    Blt_HashSearch iter;
+
+    for (hPtr = Blt_FirstHashEntry(tablePtr, &iter); hPtr != NULL;
+	 hPtr = Blt_NextHashEntry(&iter)) {
+	SharedAxis *sharedPtr;
+	Blt_ChainLink link;
+
+	sharedPtr = Blt_GetHashValue(hPtr);
+	for (link = Blt_Chain_FirstLink(sharedPtr->axes); link != NULL;
+	     link = Blt_Chain_NextLink(link)) {
+	    Axis *axisPtr;
+
+	    axisPtr = Blt_Chain_GetValue(link);
+	    axisPtr->sharedPtr = NULL;
+	    axisPtr->sharedLink = NULL;
+	}
+	if (sharedPtr->flags & SHARED_REDRAW_PENDING) {
+	    Tcl_CancelIdleCall(DisplaySharedAxis, sharedPtr);
+	}
+	Blt_Chain_Destroy(sharedPtr->axes);
+	Blt_Free(sharedPtr);
+    }
+    Blt_DeleteHashTable(tablePtr);
+    Tcl_DeleteAssocData(interp, SHARED_AXIS_THREAD_KEY);
+    Blt_Free(tablePtr);
+}
+
+static Blt_HashTable *
+GetSharedAxisTable(Tcl_Interp *interp)
+{
+    Blt_HashTable *tablePtr;
+    Tcl_InterpDeleteProc *proc;
+
+    tablePtr = Tcl_GetAssocData(interp, SHARED_AXIS_THREAD_KEY, &proc);
+    if (tablePtr == NULL) {
+	tablePtr = Blt_AssertMalloc(sizeof(Blt_HashTable));
+	Blt_InitHashTable(tablePtr, BLT_STRING_KEYS);
+	Tcl_SetAssocData(interp, SHARED_AXIS_THREAD_KEY, 
+		SharedAxisInterpDeleteProc, tablePtr);
+    }
+    return tablePtr;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DisplaySharedAxis --
+ *
+ *	Redraws, one after another, the graphs of the shared axis that are
+ *	waiting to be redrawn.  The limits of the shared axis are computed by
+ *	the first graph and reused by the others.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The graphs are redisplayed.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+DisplaySharedAxis(ClientData clientData)
+{
+    SharedAxis *sharedPtr = clientData;
+    Blt_ChainLink link;
+    Graph **graphs;
+    int i, n;
+
+    sharedPtr->flags &= ~SHARED_REDRAW_PENDING;
+    graphs = Blt_AssertMalloc(Blt_Chain_GetLength(sharedPtr->axes) * 
+			      sizeof(Graph *));
+    n = 0;
+    for (link = Blt_Chain_FirstLink(sharedPtr->axes); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	Axis *axisPtr;
+
+	axisPtr = Blt_Chain_GetValue(link);
+	if (axisPtr->obj.graphPtr->flags & REDRAW_PENDING) {
+	    graphs[n] = axisPtr->obj.graphPtr;
+	    Tcl_Preserve(graphs[n]);
+	    n++;
+	}
+    }
+    /* Redrawing a graph may destroy the shared axis or other graphs. */
+    for (i = 0; i < n; i++) {
+	Blt_RedrawGraphNow(graphs[i]);
+	Tcl_Release(graphs[i]);
+    }
+    Blt_Free(graphs);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EventuallyRedrawSharedAxis --
+ *
+ *	Sets the given flags in the graphs of the shared axis and schedules
+ *	a single idle handler to redraw all of them.  The graph designated
+ *	by skipPtr, if any, is left alone.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+EventuallyRedrawSharedAxis(SharedAxis *sharedPtr, unsigned int flags, 
+			   Graph *skipPtr)
+{
+    Blt_ChainLink link;
+
+    for (link = Blt_Chain_FirstLink(sharedPtr->axes); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	Axis *axisPtr;
+	Graph *graphPtr;
+
+	axisPtr = Blt_Chain_GetValue(link);
+	graphPtr = axisPtr->obj.graphPtr;
+	if (graphPtr == skipPtr) {
+	    continue;
+	}
+	graphPtr->flags |= flags;
+	if (graphPtr->tkwin != NULL) {
+	    /* Don't let the graph schedule its own redraw. */
+	    graphPtr->flags |= REDRAW_PENDING;
+	}
+    }
+    if ((sharedPtr->flags & SHARED_REDRAW_PENDING) == 0) {
+	Tcl_DoWhenIdle(DisplaySharedAxis, sharedPtr);
+	sharedPtr->flags |= SHARED_REDRAW_PENDING;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * CopySharedOptions --
+ *
+ *	Copies the options that determine the limits and ticks of a shared
+ *	axis from one of its axes to another.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+CopySharedOptions(Axis *destPtr, Axis *srcPtr)
+{
+    destPtr->reqMin = srcPtr->reqMin;
+    destPtr->reqMax = srcPtr->reqMax;
+    destPtr->reqScrollMin = srcPtr->reqScrollMin;
+    destPtr->reqScrollMax = srcPtr->reqScrollMax;
+    destPtr->scrollMin = srcPtr->scrollMin;
+    destPtr->scrollMax = srcPtr->scrollMax;
+    destPtr->windowSize = srcPtr->windowSize;
+    destPtr->shiftBy = srcPtr->shiftBy;
+    destPtr->reqStep = srcPtr->reqStep;
+    destPtr->reqNumMajorTicks = srcPtr->reqNumMajorTicks;
+    destPtr->reqNumMinorTicks = srcPtr->reqNumMinorTicks;
+    destPtr->looseMin = srcPtr->looseMin;
+    destPtr->looseMax = srcPtr->looseMax;
+    destPtr->descending = srcPtr->descending;
+    destPtr->logScale = srcPtr->logScale;
+    destPtr->timeScale = srcPtr->timeScale;
+    destPtr->timeUnits = srcPtr->timeUnits;
+    destPtr->epoch = srcPtr->epoch;
+    destPtr->flags |= AXIS_FLUSH_LABELS;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * AttachSharedAxis --
+ *
+ *	Adds the axis to the named shared axis, creating the shared axis if
+ *	it doesn't already exist.  The axis takes the limits of the axes
+ *	already sharing them.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+AttachSharedAxis(Tcl_Interp *interp, Axis *axisPtr, const char *name)
+{
+    Blt_HashTable *tablePtr;
+    Blt_HashEntry *hPtr;
+    SharedAxis *sharedPtr;
+    int isNew;
+
+    tablePtr = GetSharedAxisTable(interp);
+    hPtr = Blt_CreateHashEntry(tablePtr, name, &isNew);
+    if (isNew) {
+	sharedPtr = Blt_AssertCalloc(1, sizeof(SharedAxis));
+	sharedPtr->name = Blt_GetHashKey(tablePtr, hPtr);
+	sharedPtr->hashPtr = hPtr;
+	sharedPtr->tablePtr = tablePtr;
+	sharedPtr->axes = Blt_Chain_Create();
+	Blt_SetHashValue(hPtr, sharedPtr);
+    } else {
+	Blt_ChainLink link;
+
+	sharedPtr = Blt_GetHashValue(hPtr);
+	link = Blt_Chain_FirstLink(sharedPtr->axes);
+	if (link != NULL) {
+	    CopySharedOptions(axisPtr, Blt_Chain_GetValue(link));
+	}
+    }
+    axisPtr->sharedPtr = sharedPtr;
+    axisPtr->sharedLink = Blt_Chain_Append(sharedPtr->axes, axisPtr);
+    axisPtr->sharedMin = DBL_MAX;
+    axisPtr->sharedMax = -DBL_MAX;
+    sharedPtr->flags |= SHARED_RESET;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DetachSharedAxis --
+ *
+ *	Removes the axis from its shared axis.  The shared axis is freed
+ *	when its last axis is removed.  Otherwise the limits of the
+ *	remaining axes are recomputed, since the data of this graph no
+ *	longer counts.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+DetachSharedAxis(Axis *axisPtr)
+{
+    SharedAxis *sharedPtr = axisPtr->sharedPtr;
+    Graph *graphPtr = axisPtr->obj.graphPtr;
+    int pending;
+
+    if (sharedPtr == NULL) {
+	return;
+    }
+    Blt_Chain_DeleteLink(sharedPtr->axes, axisPtr->sharedLink);
+    axisPtr->sharedPtr = NULL;
+    axisPtr->sharedLink = NULL;
+    pending = (sharedPtr->flags & SHARED_REDRAW_PENDING);
+    if (Blt_Chain_GetLength(sharedPtr->axes) == 0) {
+	if (pending) {
+	    Tcl_CancelIdleCall(DisplaySharedAxis, sharedPtr);
+	}
+	Blt_Chain_Destroy(sharedPtr->axes);
+	Blt_DeleteHashEntry(sharedPtr->tablePtr, sharedPtr->hashPtr);
+	Blt_Free(sharedPtr);
+    } else {
+	sharedPtr->flags |= SHARED_RESET;
+	EventuallyRedrawSharedAxis(sharedPtr, RESET_AXES, NULL);
+    }
+    if ((pending) && (graphPtr->flags & REDRAW_PENDING)) {
+	/* The graph may have been waiting on the shared axis to be
+	 * redrawn.  Schedule its own redraw instead. */
+	graphPtr->flags &= ~REDRAW_PENDING;
+	Blt_EventuallyRedrawGraph(graphPtr);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ObjToSharedProc --
+ *
+ *	Attaches the axis to the shared axis by the given name.  If the name
+ *	is "", the axis is detached from its shared axis.
+ *
+ * Results:
+ *	The return value is a standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ObjToSharedProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,		        /* Interpreter of the shared axes. */
+    Tk_Window tkwin,			/* Not used. */
+    Tcl_Obj *objPtr,			/* String representing new value. */
+    char *widgRec,			/* Pointer to structure record. */
+    int offset,				/* Not used. */
+    int flags)				/* Not used. */
+{
+    Axis *axisPtr = (Axis *)(widgRec);
+    const char *string;
+
+    DetachSharedAxis(axisPtr);
+    string = Tcl_GetString(objPtr);
+    if (string[0] != '\0') {
+	AttachSharedAxis(interp, axisPtr, string);
+    }
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SharedToObjProc --
+ *
+ *	Returns the name of the shared axis of the axis.
+ *
+ * Results:
+ *	The name of the shared axis or "" if the axis isn't shared.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static Tcl_Obj *
+SharedToObjProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Not used. */
+    Tk_Window tkwin,			/* Not used. */
+    char *widgRec,			/* Pointer to structure record. */
+    int offset,				/* Not used. */
+    int flags)				/* Not used. */
+{
+    Axis *axisPtr = (Axis *)(widgRec);
+    
+    if (axisPtr->sharedPtr == NULL) {
+	return Tcl_NewStringObj("", -1);
+    }
+    return Tcl_NewStringObj(axisPtr->sharedPtr->name, -1);
+}
+
+/*ARGSUSED*/
+static void
+FreeSharedProc(
+    ClientData clientData,		/* Not used. */
+    Display *display,			/* Not used. */
+    char *widgRec,
+    int offset)
+{
+    DetachSharedAxis((Axis *)widgRec);
+}
+
 /*ARGSUSED*/
 static void
 FreeTicksProc(
@@ -1047,44 +1469,236 @@ LooseToObjProc(
     return listObjPtr;
 }
 
-static void
-FreeTickLabels(Blt_Chain chain)
-{
-    Blt_ChainLink link;
+static const char *timeUnitNames[] = {
+    "seconds", "milliseconds", "microseconds", "nanoseconds"
+};
 
-    for (link = Blt_Chain_FirstLink(chain); link != NULL; 
-	 link = Blt_Chain_NextLink(link)) {
-	TickLabel *labelPtr;
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ObjToTimeUnitsProc --
+ *
+ *	Converts the name of the units of a time scale axis: "seconds",
+ *	"milliseconds", "microseconds", or "nanoseconds".
+ *
+ * Results:
+ *	If the string is successfully converted, TCL_OK is returned.
+ *	Otherwise, TCL_ERROR is returned and an error message is left in
+ *	interpreter's result field.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ObjToTimeUnitsProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,		        /* Interpreter to send results. */
+    Tk_Window tkwin,			/* Not used. */
+    Tcl_Obj *objPtr,			/* String representing new value. */
+    char *widgRec,			/* Pointer to structure record. */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    int *unitsPtr = (int *)(widgRec + offset);
+    const char *string;
+    int i;
 
-	labelPtr = Blt_Chain_GetValue(link);
-	Blt_Free(labelPtr);
+    string = Tcl_GetString(objPtr);
+    for (i = TIME_UNITS_SECONDS; i <= TIME_UNITS_NANOSECONDS; i++) {
+	if (strcmp(string, timeUnitNames[i]) == 0) {
+	    *unitsPtr = i;
+	    return TCL_OK;
+	}
     }
-    Blt_Chain_Reset(chain);
+    Tcl_AppendResult(interp, "unknown time units \"", string, 
+	"\": should be seconds, milliseconds, microseconds, or nanoseconds",
+	(char *)NULL);
+    return TCL_ERROR;
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * MakeLabel --
- *
- *	Converts a floating point tick value to a string to be used as its
- *	label.
+ * TimeUnitsToObjProc --
  *
  * Results:
- *	None.
- *
- * Side Effects:
- *	Returns a new label in the string character buffer.  The formatted
- *	tick label will be displayed on the graph.
+ *	The name of the time units is returned.
  *
- * -------------------------------------------------------------------------- 
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static Tcl_Obj *
+TimeUnitsToObjProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,
+    Tk_Window tkwin,			/* Not used. */
+    char *widgRec,			/* Widget record */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    int units = *(int *)(widgRec + offset);
+
+    return Tcl_NewStringObj(timeUnitNames[units], -1);
+}
+
+static void
+FreeTickLabel(TickLabel *labelPtr)
+{
+    if (labelPtr->layoutPtr != NULL) {
+	Blt_Free(labelPtr->layoutPtr);
+    }
+    Blt_Free(labelPtr);
+}
+
+static void
+InitLabelCache(TickLabelCache *cachePtr)
+{
+    Blt_InitHashTable(&cachePtr->table, sizeof(double) / sizeof(int));
+    cachePtr->lru = Blt_Chain_Create();
+    cachePtr->timeFormat = NULL;
+}
+
+static int
+SameString(const char *s1, const char *s2)
+{
+    if ((s1 == NULL) || (s2 == NULL)) {
+	return (s1 == s2);
+    }
+    return (strcmp(s1, s2) == 0);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FlushLabelCache --
+ *
+ *	Frees all the tick labels of the axis, both the ones displayed and
+ *	the ones cached.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+FlushLabelCache(Axis *axisPtr)
+{
+    TickLabelCache *cachePtr = &axisPtr->labelCache;
+    Blt_ChainLink link;
+
+    Blt_Chain_Reset(axisPtr->tickLabels);
+    for (link = Blt_Chain_FirstLink(cachePtr->lru); link != NULL; 
+	 link = Blt_Chain_NextLink(link)) {
+	FreeTickLabel(Blt_Chain_GetValue(link));
+    }
+    Blt_Chain_Reset(cachePtr->lru);
+    Blt_DeleteHashTable(&cachePtr->table);
+    Blt_InitHashTable(&cachePtr->table, sizeof(double) / sizeof(int));
+    if (cachePtr->timeFormat != NULL) {
+	Blt_Free(cachePtr->timeFormat);
+	cachePtr->timeFormat = NULL;
+    }
+}
+
+static void
+DestroyLabelCache(Axis *axisPtr)
+{
+    FlushLabelCache(axisPtr);
+    Blt_DeleteHashTable(&axisPtr->labelCache.table);
+    Blt_Chain_Destroy(axisPtr->labelCache.lru);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * CheckLabelCache --
+ *
+ *	Flushes the tick labels cached by the axis if an option used to
+ *	format or measure them was changed (see AXIS_FLUSH_LABELS).  Time
+ *	labels also depend upon the time format, which is chosen from the
+ *	tick step.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+CheckLabelCache(Axis *axisPtr)
+{
+    TickLabelCache *cachePtr = &axisPtr->labelCache;
+    const char *timeFormat;
+
+    timeFormat = (IsTimeAxis(axisPtr)) ? axisPtr->tickTimeFormat : NULL;
+    if (((axisPtr->flags & AXIS_FLUSH_LABELS) == 0) && 
+	(SameString(cachePtr->timeFormat, timeFormat))) {
+	return;
+    }
+    FlushLabelCache(axisPtr);
+    axisPtr->flags &= ~AXIS_FLUSH_LABELS;
+    if (timeFormat != NULL) {
+	cachePtr->timeFormat = Blt_AssertStrdup(timeFormat);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * TrimLabelCache --
+ *
+ *	Frees the least recently used tick labels, keeping at most
+ *	LABEL_CACHE_SIZE labels besides the ones currently displayed.  The
+ *	displayed labels are always the most recently used.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+TrimLabelCache(Axis *axisPtr)
+{
+    TickLabelCache *cachePtr = &axisPtr->labelCache;
+    long maxSize;
+
+    maxSize = Blt_Chain_GetLength(axisPtr->tickLabels) + LABEL_CACHE_SIZE;
+    while (Blt_Chain_GetLength(cachePtr->lru) > maxSize) {
+	Blt_ChainLink link;
+	TickLabel *labelPtr;
+
+	link = Blt_Chain_LastLink(cachePtr->lru);
+	labelPtr = Blt_Chain_GetValue(link);
+	Blt_DeleteHashEntry(&cachePtr->table, labelPtr->hashPtr);
+	Blt_Chain_DeleteLink(cachePtr->lru, link);
+	FreeTickLabel(labelPtr);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MakeLabel --
+ *
+ *	Converts a floating point tick value to a string to be used as its
+ *	label.  The ticks of time scale axes are formatted as times.
+ *
+ * Results:
+ *	None.
+ *
+ * Side Effects:
+ *	Returns a new label in the string character buffer.  The formatted
+ *	tick label will be displayed on the graph.
+ *
+ * -------------------------------------------------------------------------- 
  */
 static TickLabel *
 MakeLabel(Axis *axisPtr, double value)
 {
 #define TICK_LABEL_SIZE		200
     char string[TICK_LABEL_SIZE + 1];
+    char arg[TICK_LABEL_SIZE + 1];
     TickLabel *labelPtr;
+    Tcl_WideInt t;
 
     /* Generate a default tick label based upon the tick value.  */
     if (axisPtr->logScale) {
@@ -1092,6 +1706,16 @@ MakeLabel(Axis *axisPtr, double value)
     } else {
 	sprintf_s(string, TICK_LABEL_SIZE, "%.*G", NUMDIGITS, value);
     }
+    strcpy(arg, string);
+    if ((IsTimeAxis(axisPtr)) && (ValueToTime(axisPtr, value, &t))) {
+	t = RoundTickTime(axisPtr, t);
+	FormatTime((axisPtr->tickTimeFormat != NULL) ? 
+		   axisPtr->tickTimeFormat : DEF_TIME_FORMAT, t, 
+		   string, TICK_LABEL_SIZE + 1);
+	/* The format command is passed the time since 1970, in the units of
+	 * the axis, rather than the time label. */
+	FormatTimeValue(axisPtr, t, arg, TICK_LABEL_SIZE);
+    }
 
     if (axisPtr->formatCmd != NULL) {
 	Graph *graphPtr;
@@ -1108,7 +1732,7 @@ MakeLabel(Axis *axisPtr, double value)
 	 */
 	Tcl_ResetResult(interp);
 	if (Tcl_VarEval(interp, axisPtr->formatCmd, " ", Tk_PathName(tkwin),
-		" ", string, (char *)NULL) != TCL_OK) {
+		" ", arg, (char *)NULL) != TCL_OK) {
 	    Tcl_BackgroundError(interp);
 	} else {
 	    /* 
@@ -1121,9 +1745,65 @@ MakeLabel(Axis *axisPtr, double value)
 	    Tcl_ResetResult(interp); /* Clear the interpreter's result. */
 	}
     }
-    labelPtr = Blt_AssertMalloc(sizeof(TickLabel) + strlen(string));
+    labelPtr = Blt_AssertCalloc(1, sizeof(TickLabel) + strlen(string));
     strcpy(labelPtr->string, string);
     labelPtr->anchorPos.x = labelPtr->anchorPos.y = DBL_MAX;
+    labelPtr->value = value;
+    return labelPtr;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetTickLabel --
+ *
+ *	Returns the label of the given tick value, either from the axis'
+ *	label cache or newly formatted and measured.  The label becomes the
+ *	most recently used one of the cache.
+ *
+ * Results:
+ *	Returns the tick label.
+ *
+ *---------------------------------------------------------------------------
+ */
+static TickLabel *
+GetTickLabel(Axis *axisPtr, double value)
+{
+    TickLabelCache *cachePtr = &axisPtr->labelCache;
+    Blt_HashEntry *hPtr;
+    TickLabel *labelPtr;
+    int isNew;
+    unsigned int lw, lh;		/* Label width and height. */
+
+    if (value == 0.0) {
+	value = 0.0;			/* Don't distinguish -0.0 from 0.0 */
+    }
+    hPtr = Blt_CreateHashEntry(&cachePtr->table, (char *)&value, &isNew);
+    if (!isNew) {
+	labelPtr = Blt_GetHashValue(hPtr);
+	Blt_Chain_UnlinkLink(cachePtr->lru, labelPtr->link);
+	Blt_Chain_PrependLink(cachePtr->lru, labelPtr->link);
+	return labelPtr;
+    }
+    labelPtr = MakeLabel(axisPtr, value);
+    labelPtr->hashPtr = hPtr;
+    Blt_SetHashValue(hPtr, labelPtr);
+    labelPtr->link = Blt_Chain_Prepend(cachePtr->lru, labelPtr);
+    /* 
+     * Get the dimensions of each tick label.  Remember tick labels can be
+     * multi-lined and/or rotated.
+     */
+    Blt_GetTextExtents(axisPtr->tickFont, 0, labelPtr->string, -1, &lw, &lh);
+    labelPtr->width  = lw;
+    labelPtr->height = lh;
+    if (axisPtr->tickAngle != 0.0f) {
+	double rlw, rlh;		/* Rotated label width and height. */
+
+	Blt_GetBoundingBox(lw, lh, axisPtr->tickAngle, &rlw, &rlh, NULL);
+	lw = ROUND(rlw), lh = ROUND(rlh);
+    }
+    labelPtr->rotWidth = lw;
+    labelPtr->rotHeight = lh;
     return labelPtr;
 }
 
@@ -1243,6 +1923,150 @@ Blt_VMap(Axis *axisPtr, double y)
     return ((1.0 - y) * axisPtr->screenRange + axisPtr->screenMin);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_GetAxisTransform --
+ *
+ *	Computes the origin, scale and offset that map values to window
+ *	positions on the axis, so that position = (value - origin) * scale +
+ *	offset.  This is the same mapping as Blt_HMap (or Blt_VMap if
+ *	vertical is non-zero), except that log scale axes expect values
+ *	already in log10 space.  Many points can be mapped by the same
+ *	subtract and multiply-add.
+ *
+ *	The origin is the minimum of the axis.  Folding it into the offset
+ *	would lose the low order digits of values that are large compared
+ *	to the range of the axis, such as times zoomed to microseconds.
+ *
+ * Results:
+ *	The origin, scale and offset are returned via originPtr, scalePtr
+ *	and offsetPtr.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_GetAxisTransform(Axis *axisPtr, int vertical, double *originPtr,
+		     double *scalePtr, double *offsetPtr)
+{
+    double scale, offset;
+
+    /* Normalized coordinate [0..1] = (value - min) * axisRange.scale */
+    scale = axisPtr->axisRange.scale * axisPtr->screenRange;
+    offset = axisPtr->screenMin;
+    if ((vertical) ^ (axisPtr->descending)) {
+	/* Position runs from screenMin + screenRange down to screenMin. */
+	offset = axisPtr->screenMin + axisPtr->screenRange;
+	scale = -scale;
+    }
+    *originPtr = axisPtr->axisRange.min;
+    *scalePtr = scale;
+    *offsetPtr = offset;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_SaveAxisTransforms --
+ *
+ *	Saves the current transform of each axis, so that it can later be
+ *	compared with the new transform by Blt_GetAxisScroll.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_SaveAxisTransforms(Graph *graphPtr)
+{
+    Blt_HashEntry *hPtr;
+    Blt_HashSearch cursor;
+
+    for (hPtr = Blt_FirstHashEntry(&graphPtr->axes.table, &cursor);
+	 hPtr != NULL; hPtr = Blt_NextHashEntry(&cursor)) {
+	Axis *axisPtr;
+
+	axisPtr = Blt_GetHashValue(hPtr);
+	Blt_GetAxisTransform(axisPtr, !AxisIsHorizontal(axisPtr), 
+		&axisPtr->lastOrigin, &axisPtr->lastScale, 
+		&axisPtr->lastOffset);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_GetAxisScroll --
+ *
+ *	Determines if the axes have only slid horizontally since their
+ *	transforms were saved, so that the plot can be scrolled rather than
+ *	redrawn.  The vertical axes must be unchanged and every horizontal
+ *	axis must have moved left by the same whole number of pixels (or
+ *	not at all).  The plot can't be scrolled if the axis limits are
+ *	displayed or the grid lines across it are dashed.
+ *
+ * Results:
+ *	Returns 1 if the plot can be scrolled, 0 otherwise.  The number of
+ *	pixels (zero or negative) to scroll is returned via dxPtr.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_GetAxisScroll(Graph *graphPtr, int *dxPtr)
+{
+    Blt_HashEntry *hPtr;
+    Blt_HashSearch cursor;
+    int dx, haveDx;
+
+    dx = 0;
+    haveDx = FALSE;
+    for (hPtr = Blt_FirstHashEntry(&graphPtr->axes.table, &cursor);
+	 hPtr != NULL; hPtr = Blt_NextHashEntry(&cursor)) {
+	Axis *axisPtr;
+	double origin, scale, offset, shift;
+	int horizontal, d;
+
+	axisPtr = Blt_GetHashValue(hPtr);
+	if ((axisPtr->flags & (AXIS_USE|DELETE_PENDING)) != AXIS_USE) {
+	    continue;
+	}
+	if (axisPtr->nFormats > 0) {
+	    return FALSE;		/* Limits are drawn in the plot. */
+	}
+	horizontal = AxisIsHorizontal(axisPtr);
+	Blt_GetAxisTransform(axisPtr, !horizontal, &origin, &scale, &offset);
+	if (!horizontal) {
+	    if ((origin != axisPtr->lastOrigin) ||
+		(scale != axisPtr->lastScale) || 
+		(offset != axisPtr->lastOffset)) {
+		return FALSE;
+	    }
+	    if ((axisPtr->flags & AXIS_GRID) && 
+		((LineIsDashed(axisPtr->major.dashes)) ||
+		 ((axisPtr->flags & AXIS_GRIDMINOR) && 
+		  (LineIsDashed(axisPtr->minor.dashes))))) {
+		return FALSE;		/* Dashes wouldn't line up. */
+	    }
+	    continue;
+	}
+	if (FABS(scale - axisPtr->lastScale) > (FABS(scale) * 1e-9)) {
+	    return FALSE;		/* Axis was rescaled. */
+	}
+	shift = (offset - axisPtr->lastOffset) - 
+	    (origin - axisPtr->lastOrigin) * scale;
+	d = ROUND(shift);
+	if ((FABS(shift - d) > 1e-4) || (d > 0) || 
+	    (-d >= graphPtr->hRange) || ((haveDx) && (d != dx))) {
+	    return FALSE;
+	}
+	dx = d;
+	haveDx = TRUE;
+    }
+    *dxPtr = dx;
+    return TRUE;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1514,6 +2338,28 @@ GenerateTicks(TickSweep *sweepPtr)
     return ticksPtr;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GenerateMajorTicks --
+ *
+ *	Generates the major ticks of the axis, either from its major sweep
+ *	or, for time scale axes, from its time sweep.
+ *
+ * Results:
+ *	Returns the array of tick values.
+ *
+ *---------------------------------------------------------------------------
+ */
+static Ticks *
+GenerateMajorTicks(Axis *axisPtr)
+{
+    if ((IsTimeAxis(axisPtr)) && (axisPtr->timeSweep.step > 0)) {
+	return GenerateTimeTicks(axisPtr);
+    }
+    return GenerateTicks(&axisPtr->majorSweep);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1800,7 +2646,7 @@ SweepTicks(Axis *axisPtr)
 	if (axisPtr->t1Ptr != NULL) {
 	    Blt_Free(axisPtr->t1Ptr);
 	}
-	axisPtr->t1Ptr = GenerateTicks(&axisPtr->majorSweep);
+	axisPtr->t1Ptr = GenerateMajorTicks(axisPtr);
     }
     if (axisPtr->flags & AXIS_AUTO_MINOR) {
 	if (axisPtr->t2Ptr != NULL) {
@@ -1813,45 +2659,225 @@ SweepTicks(Axis *axisPtr)
 /*
  *---------------------------------------------------------------------------
  *
- * Blt_ResetAxes --
+ * ScaleAxis --
+ *
+ *	Sets the limits of the axis from its range of data values and
+ *	computes the sweeps to generate its ticks.
  *
  * Results:
  *	None.
  *
  *---------------------------------------------------------------------------
  */
-void
-Blt_ResetAxes(Graph *graphPtr)
+static void
+ScaleAxis(Axis *axisPtr)
 {
-    Blt_ChainLink link;
-    Blt_HashEntry *hPtr;
-    Blt_HashSearch cursor;
+    double min, max;
 
-    /* FIXME: This should be called whenever the display list of
-     *	      elements change. Maybe yet another flag INIT_STACKS to
-     *	      indicate that the element display list has changed.
-     *	      Needs to be done before the axis limits are set.
-     */
-    Blt_InitBarSetTable(graphPtr);
-    if ((graphPtr->mode == BARS_STACKED) && (graphPtr->nBarGroups > 0)) {
-	Blt_ComputeBarStacks(graphPtr);
+    FixAxisRange(axisPtr);
+
+    /* Calculate min/max tick (major/minor) layouts */
+    min = axisPtr->min;
+    max = axisPtr->max;
+    if ((DEFINED(axisPtr->scrollMin)) && (min < axisPtr->scrollMin)) {
+	min = axisPtr->scrollMin;
     }
-    /*
-     * Step 1:  Reset all axes. Initialize the data limits of the axis to
-     *		impossible values.
-     */
-    for (hPtr = Blt_FirstHashEntry(&graphPtr->axes.table, &cursor);
-	hPtr != NULL; hPtr = Blt_NextHashEntry(&cursor)) {
-	Axis *axisPtr;
+    if ((DEFINED(axisPtr->scrollMax)) && (max > axisPtr->scrollMax)) {
+	max = axisPtr->scrollMax;
+    }
+    if (axisPtr->logScale) {
+	LogScaleAxis(axisPtr, min, max);
+    } else if (axisPtr->timeScale) {
+	TimeScaleAxis(axisPtr, min, max);
+    } else {
+	LinearScaleAxis(axisPtr, min, max);
+    }
+}
 
-	axisPtr = Blt_GetHashValue(hPtr);
-	axisPtr->min = axisPtr->valueRange.min = DBL_MAX;
-	axisPtr->max = axisPtr->valueRange.max = -DBL_MAX;
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ResetSharedAxis --
+ *
+ *	Sets the limits and tick sweeps of an axis of a shared axis.  The
+ *	limits are only computed again if the data range of this graph or
+ *	the options of the shared axis have changed.  Otherwise the limits
+ *	last computed, possibly by another graph, are copied.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	If the shared limits change, the other graphs of the shared axis are
+ *	scheduled to be redrawn.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ResetSharedAxis(Axis *axisPtr)
+{
+    SharedAxis *sharedPtr = axisPtr->sharedPtr;
+
+    if ((axisPtr->valueRange.min != axisPtr->sharedMin) ||
+	(axisPtr->valueRange.max != axisPtr->sharedMax)) {
+	axisPtr->sharedMin = axisPtr->valueRange.min;
+	axisPtr->sharedMax = axisPtr->valueRange.max;
+	sharedPtr->flags |= SHARED_RESET;
     }
+    if (sharedPtr->flags & SHARED_RESET) {
+	Blt_ChainLink link;
+	double min, max;
+	int changed;
 
-    /*
-     * Step 2:  For each element that's to be displayed, get the smallest
-     *		and largest data values mapped to each X and Y-axis.  This
+	/* Auto-scale from the data of all the graphs. */
+	min = DBL_MAX, max = -DBL_MAX;
+	for (link = Blt_Chain_FirstLink(sharedPtr->axes); link != NULL;
+	     link = Blt_Chain_NextLink(link)) {
+	    Axis *p;
+
+	    p = Blt_Chain_GetValue(link);
+	    if (p->sharedMin < min) {
+		min = p->sharedMin;
+	    }
+	    if (p->sharedMax > max) {
+		max = p->sharedMax;
+	    }
+	}
+	axisPtr->valueRange.min = min;
+	axisPtr->valueRange.max = max;
+	ScaleAxis(axisPtr);
+
+	changed = ((sharedPtr->min != axisPtr->min) || 
+		   (sharedPtr->max != axisPtr->max) ||
+		   (sharedPtr->valueRange.min != axisPtr->valueRange.min) ||
+		   (sharedPtr->valueRange.max != axisPtr->valueRange.max));
+	sharedPtr->min = axisPtr->min;
+	sharedPtr->max = axisPtr->max;
+	sharedPtr->valueRange = axisPtr->valueRange;
+	sharedPtr->axisRange = axisPtr->axisRange;
+	sharedPtr->majorSweep = axisPtr->majorSweep;
+	sharedPtr->minorSweep = axisPtr->minorSweep;
+	sharedPtr->timeSweep = axisPtr->timeSweep;
+	sharedPtr->flags &= ~SHARED_RESET;
+	if (changed) {
+	    EventuallyRedrawSharedAxis(sharedPtr, RESET_AXES, 
+		axisPtr->obj.graphPtr);
+	}
+	return;
+    }
+    axisPtr->min = sharedPtr->min;
+    axisPtr->max = sharedPtr->max;
+    axisPtr->valueRange = sharedPtr->valueRange;
+    axisPtr->axisRange = sharedPtr->axisRange;
+    axisPtr->majorSweep = sharedPtr->majorSweep;
+    axisPtr->minorSweep = sharedPtr->minorSweep;
+    axisPtr->timeSweep = sharedPtr->timeSweep;
+    axisPtr->tickTimeFormat = TimeTickFormat(axisPtr);
+    if ((axisPtr->max != axisPtr->prevMax) || 
+	(axisPtr->min != axisPtr->prevMin)) {
+	axisPtr->flags |= DIRTY;
+	axisPtr->prevMin = axisPtr->min;
+	axisPtr->prevMax = axisPtr->max;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SyncSharedAxis --
+ *
+ *	Copies the limit options of the axis to the other axes of its shared
+ *	axis, after they were configured or scrolled.  All the graphs are
+ *	redrawn from a single idle handler.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+SyncSharedAxis(Axis *axisPtr, unsigned int flags)
+{
+    SharedAxis *sharedPtr = axisPtr->sharedPtr;
+    Blt_ChainLink link;
+
+    for (link = Blt_Chain_FirstLink(sharedPtr->axes); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	Axis *p;
+
+	p = Blt_Chain_GetValue(link);
+	if (p != axisPtr) {
+	    CopySharedOptions(p, axisPtr);
+	    p->flags |= DIRTY;
+	}
+    }
+    sharedPtr->flags |= SHARED_RESET;
+    EventuallyRedrawSharedAxis(sharedPtr, flags, NULL);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_ResetAxes --
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_ResetAxes(Graph *graphPtr)
+{
+    Blt_ChainLink link;
+    Blt_HashEntry *hPtr;
+    Blt_HashSearch cursor;
+    int changed;
+
+    /* Integer times from datatables are relative to the epoch of their
+     * axis. */
+    for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList);
+	 link != NULL; link = Blt_Chain_NextLink(link)) {
+	Blt_UpdateElementEpochs(Blt_Chain_GetValue(link));
+    }
+    /* 
+     * Rebuild the bar sets only if the element display list or the data of
+     * a bar element has changed.  Needs to be done before the axis limits
+     * are set.
+     */
+    if (graphPtr->flags & RESET_BAR_SETS) {
+	Blt_InitBarSetTable(graphPtr);
+	if ((graphPtr->mode == BARS_STACKED) && (graphPtr->nBarGroups > 0)) {
+	    Blt_ComputeBarStacks(graphPtr);
+	}
+	/* The extents of bar elements depend upon the stacks and the
+	 * baseline. */
+	for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList);
+	     link != NULL; link = Blt_Chain_NextLink(link)) {
+	    Element *elemPtr;
+
+	    elemPtr = Blt_Chain_GetValue(link);
+	    if (elemPtr->obj.classId == CID_ELEM_BAR) {
+		elemPtr->flags &= ~EXTENTS_CACHED;
+	    }
+	}
+	graphPtr->flags &= ~RESET_BAR_SETS;
+    }
+    /*
+     * Step 1:  Reset all axes. Initialize the data limits of the axis to
+     *		impossible values.
+     */
+    for (hPtr = Blt_FirstHashEntry(&graphPtr->axes.table, &cursor);
+	hPtr != NULL; hPtr = Blt_NextHashEntry(&cursor)) {
+	Axis *axisPtr;
+
+	axisPtr = Blt_GetHashValue(hPtr);
+	axisPtr->min = axisPtr->valueRange.min = DBL_MAX;
+	axisPtr->max = axisPtr->valueRange.max = -DBL_MAX;
+    }
+
+    /*
+     * Step 2:  For each element that's to be displayed, get the smallest
+     *		and largest data values mapped to each X and Y-axis.  This
      *		will be the axis limits if the user doesn't override them 
      *		with -min and -max options.
      */
@@ -1864,7 +2890,7 @@ Blt_ResetAxes(Graph *graphPtr)
 	if ((graphPtr->flags & UNMAP_HIDDEN) && (elemPtr->flags & HIDE)) {
 	    continue;
 	}
-	(*elemPtr->procsPtr->extentsProc) (elemPtr, &exts);
+	Blt_GetElementExtents(elemPtr, &exts);
 	GetDataLimits(elemPtr->axes.x, exts.left, exts.right);
 	GetDataLimits(elemPtr->axes.y, exts.top, exts.bottom);
     }
@@ -1872,43 +2898,34 @@ Blt_ResetAxes(Graph *graphPtr)
      * Step 3:  Now that we know the range of data values for each axis,
      *		set axis limits and compute a sweep to generate tick values.
      */
+    changed = FALSE;
     for (hPtr = Blt_FirstHashEntry(&graphPtr->axes.table, &cursor);
 	 hPtr != NULL; hPtr = Blt_NextHashEntry(&cursor)) {
 	Axis *axisPtr;
-	double min, max;
 
 	axisPtr = Blt_GetHashValue(hPtr);
-	FixAxisRange(axisPtr);
-
-	/* Calculate min/max tick (major/minor) layouts */
-	min = axisPtr->min;
-	max = axisPtr->max;
-	if ((DEFINED(axisPtr->scrollMin)) && (min < axisPtr->scrollMin)) {
-	    min = axisPtr->scrollMin;
-	}
-	if ((DEFINED(axisPtr->scrollMax)) && (max > axisPtr->scrollMax)) {
-	    max = axisPtr->scrollMax;
-	}
-	if (axisPtr->logScale) {
-	    LogScaleAxis(axisPtr, min, max);
-	} else if (axisPtr->timeScale) {
-	    TimeScaleAxis(axisPtr, min, max);
+	if (axisPtr->sharedPtr != NULL) {
+	    ResetSharedAxis(axisPtr);
 	} else {
-	    LinearScaleAxis(axisPtr, min, max);
+	    ScaleAxis(axisPtr);
 	}
-
 	if ((axisPtr->flags & (DIRTY|AXIS_USE)) == (DIRTY|AXIS_USE)) {
 	    graphPtr->flags |= CACHE_DIRTY;
+	    changed = TRUE;
 	}
+	axisPtr->flags &= ~DIRTY;
     }
 
     graphPtr->flags &= ~RESET_AXES;
 
     /*
      * When any axis changes, we need to layout the entire graph.
+     * Otherwise only the elements whose data changed are remapped.
      */
-    graphPtr->flags |= (GET_AXIS_GEOMETRY | LAYOUT_NEEDED | MAP_ALL | 
-			REDRAW_WORLD);
+    if (changed) {
+	graphPtr->flags |= (GET_AXIS_GEOMETRY | LAYOUT_NEEDED | MAP_ALL | 
+			    REDRAW_WORLD);
+    }
 }
 
 /*
@@ -2041,7 +3058,7 @@ DestroyAxis(Axis *axisPtr)
     if (axisPtr->minor.gc != NULL) {
 	Blt_FreePrivateGC(graphPtr->display, axisPtr->minor.gc);
     }
-    FreeTickLabels(axisPtr->tickLabels);
+    DestroyLabelCache(axisPtr);
     Blt_Chain_Destroy(axisPtr->tickLabels);
     if (axisPtr->segments != NULL) {
 	Blt_Free(axisPtr->segments);
@@ -2861,9 +3878,16 @@ DrawAxis(Axis *axisPtr, Drawable drawable)
 	    TickLabel *labelPtr;
 
 	    labelPtr = Blt_Chain_GetValue(link);
+	    if (labelPtr->string[0] == '\0') {
+		continue;
+	    }
 	    /* Draw major tick labels */
-	    Blt_DrawText(graphPtr->tkwin, drawable, labelPtr->string, &ts, 
-		(int)labelPtr->anchorPos.x, (int)labelPtr->anchorPos.y);
+	    if (labelPtr->layoutPtr == NULL) {
+		labelPtr->layoutPtr = Blt_Ts_CreateLayout(labelPtr->string, -1,
+			&ts);
+	    }
+	    Blt_Ts_DrawLayout(graphPtr->tkwin, drawable, labelPtr->layoutPtr,
+		&ts, (int)labelPtr->anchorPos.x, (int)labelPtr->anchorPos.y);
 	}
     }
     if ((axisPtr->nSegments > 0) && (axisPtr->lineWidth > 0)) {	
@@ -2999,7 +4023,7 @@ MapGridlines(Axis *axisPtr)
     }
     t1Ptr = axisPtr->t1Ptr;
     if (t1Ptr == NULL) {
-	t1Ptr = GenerateTicks(&axisPtr->majorSweep);
+	t1Ptr = GenerateMajorTicks(axisPtr);
     }
     t2Ptr = axisPtr->t2Ptr;
     if (t2Ptr == NULL) {
@@ -3095,7 +4119,8 @@ GetAxisGeometry(Graph *graphPtr, Axis *axisPtr)
 {
     unsigned int y;
 
-    FreeTickLabels(axisPtr->tickLabels);
+    Blt_Chain_Reset(axisPtr->tickLabels);
+    CheckLabelCache(axisPtr);
     y = 0;
 
     if ((axisPtr->flags & AXIS_EXTERIOR) && 
@@ -3130,23 +4155,10 @@ GetAxisGeometry(Graph *graphPtr, Axis *axisPtr)
 	    if (!InRange(x2, &axisPtr->axisRange)) {
 		continue;
 	    }
-	    labelPtr = MakeLabel(axisPtr, x);
+	    labelPtr = GetTickLabel(axisPtr, x);
 	    Blt_Chain_Append(axisPtr->tickLabels, labelPtr);
 	    nLabels++;
-	    /* 
-	     * Get the dimensions of each tick label.  Remember tick labels
-	     * can be multi-lined and/or rotated.
-	     */
-	    Blt_GetTextExtents(axisPtr->tickFont, 0, labelPtr->string, -1, 
-		&lw, &lh);
-	    labelPtr->width  = lw;
-	    labelPtr->height = lh;
-
-	    if (axisPtr->tickAngle != 0.0f) {
-		double rlw, rlh;	/* Rotated label width and height. */
-		Blt_GetBoundingBox(lw, lh, axisPtr->tickAngle, &rlw, &rlh,NULL);
-		lw = ROUND(rlw), lh = ROUND(rlh);
-	    }
+	    lw = labelPtr->rotWidth, lh = labelPtr->rotHeight;
 	    if (axisPtr->maxTickWidth < lw) {
 		axisPtr->maxTickWidth = lw;
 	    }
@@ -3155,6 +4167,7 @@ GetAxisGeometry(Graph *graphPtr, Axis *axisPtr)
 	    }
 	}
 	assert(nLabels <= nTicks);
+	TrimLabelCache(axisPtr);
 	
 	pad = 0;
 	if (axisPtr->flags & AXIS_EXTERIOR) {
@@ -3742,6 +4755,9 @@ ConfigureAxis(Axis *axisPtr)
 		graphPtr);
     }
     axisPtr->tickAngle = angle;
+    /* The -timeformat string may have been freed.  It's picked up again
+     * when the ticks are recomputed. */
+    axisPtr->tickTimeFormat = NULL;
     ResetTextStyles(axisPtr);
 
     axisPtr->titleWidth = axisPtr->titleHeight = 0;
@@ -3838,6 +4854,7 @@ NewAxis(Graph *graphPtr, const char *name, int margin)
 	}
 	Blt_Ts_InitStyle(axisPtr->limitsTextStyle);
 	axisPtr->tickLabels = Blt_Chain_Create();
+	InitLabelCache(&axisPtr->labelCache);
 	axisPtr->lineWidth = 1;
 	Blt_SetHashValue(hPtr, axisPtr);
     }
@@ -3938,6 +4955,7 @@ Blt_ConfigureAxes(Graph *graphPtr)
 	
 	axisPtr = Blt_GetHashValue(hPtr);
 	ConfigureAxis(axisPtr);
+	axisPtr->flags |= AXIS_FLUSH_LABELS;
     }
 }
 
@@ -4097,6 +5115,15 @@ ConfigureOp(Tcl_Interp *interp, Axis *axisPtr, int objc, Tcl_Obj *const *objv)
     if (ConfigureAxis(axisPtr) != TCL_OK) {
 	return TCL_ERROR;
     }
+    if (Blt_ConfigModified(configSpecs, LABEL_OPTIONS, (char *)NULL)) {
+	/* Setting -command again flushes the labels even if it's the same
+	 * command, since it may now format them differently. */
+	axisPtr->flags |= AXIS_FLUSH_LABELS;
+    }
+    if ((axisPtr->sharedPtr != NULL) && 
+	(Blt_ConfigModified(configSpecs, SHARED_OPTIONS, (char *)NULL))) {
+	SyncSharedAxis(axisPtr, MAP_WORLD | REDRAW_WORLD | CACHE_DIRTY);
+    }
     if (axisPtr->flags & AXIS_USE) {
 	if (!Blt_ConfigModified(configSpecs, "-*color", "-background", "-bg",
 				(char *)NULL)) {
@@ -4464,7 +5491,12 @@ ViewOp(Tcl_Interp *interp, Axis *axisPtr, int objc, Tcl_Obj *const *objv)
 	axisPtr->reqMax = EXP10(axisPtr->reqMax);
     }
     graphPtr->flags |= (GET_AXIS_GEOMETRY | LAYOUT_NEEDED | RESET_AXES);
-    Blt_EventuallyRedrawGraph(graphPtr);
+    if (axisPtr->sharedPtr != NULL) {
+	/* Scroll all the graphs of the shared axis together. */
+	SyncSharedAxis(axisPtr, GET_AXIS_GEOMETRY | LAYOUT_NEEDED | RESET_AXES);
+    } else {
+	Blt_EventuallyRedrawGraph(graphPtr);
+    }
     return TCL_OK;
 }
 
@@ -4500,6 +5532,10 @@ AxisCreateOp(Tcl_Interp *interp, Graph *graphPtr, int objc,
 	DestroyAxis(axisPtr);
 	return TCL_ERROR;
     }
+    if ((axisPtr->sharedPtr != NULL) && 
+	(Blt_ConfigModified(configSpecs, SHARED_OPTIONS, (char *)NULL))) {
+	SyncSharedAxis(axisPtr, MAP_WORLD | REDRAW_WORLD | CACHE_DIRTY);
+    }
     Tcl_SetStringObj(Tcl_GetObjResult(interp), axisPtr->obj.name, -1);
     return TCL_OK;
 }
@@ -5119,6 +6155,51 @@ Blt_DrawAxes(Graph *graphPtr, Drawable drawable)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_AxesAreHidden --
+ *
+ *	Indicates if no axis, grid, or axis limit is drawn in the graph.
+ *
+ * Results:
+ *	Returns 1 if nothing is drawn for the axes, 0 otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_AxesAreHidden(Graph *graphPtr)
+{
+    Blt_HashEntry *hPtr;
+    Blt_HashSearch cursor;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+	Blt_ChainLink link;
+
+	for (link = Blt_Chain_FirstLink(graphPtr->margins[i].axes); 
+	     link != NULL; link = Blt_Chain_NextLink(link)) {
+	    Axis *axisPtr;
+
+	    axisPtr = Blt_Chain_GetValue(link);
+	    if ((axisPtr->flags & (DELETE_PENDING|HIDE|AXIS_USE)) == AXIS_USE) {
+		return FALSE;
+	    }
+	}
+    }
+    for (hPtr = Blt_FirstHashEntry(&graphPtr->axes.table, &cursor);
+	hPtr != NULL; hPtr = Blt_NextHashEntry(&cursor)) {
+	Axis *axisPtr;
+
+	axisPtr = Blt_GetHashValue(hPtr);
+	if (((axisPtr->flags & DELETE_PENDING) == 0) && 
+	    (axisPtr->nFormats > 0)) {
+	    return FALSE;
+	}
+    }
+    return TRUE;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -5161,6 +6242,53 @@ Blt_DrawGrids(Graph *graphPtr, Drawable drawable)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_DrawGridRegion --
+ *
+ *	Draws the grid lines, clipped to the given region.  This is used to
+ *	draw the grid into the strip exposed when the plot is scrolled.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_DrawGridRegion(Graph *graphPtr, Drawable drawable, TkRegion rgn) 
+{
+    Blt_HashEntry *hPtr;
+    Blt_HashSearch cursor;
+
+    /* The grid GCs are private, so they can be clipped. */
+    for (hPtr = Blt_FirstHashEntry(&graphPtr->axes.table, &cursor);
+	 hPtr != NULL; hPtr = Blt_NextHashEntry(&cursor)) {
+	Axis *axisPtr;
+
+	axisPtr = Blt_GetHashValue(hPtr);
+	if (axisPtr->major.gc != NULL) {
+	    TkSetRegion(graphPtr->display, axisPtr->major.gc, rgn);
+	}
+	if (axisPtr->minor.gc != NULL) {
+	    TkSetRegion(graphPtr->display, axisPtr->minor.gc, rgn);
+	}
+    }
+    Blt_DrawGrids(graphPtr, drawable);
+    for (hPtr = Blt_FirstHashEntry(&graphPtr->axes.table, &cursor);
+	 hPtr != NULL; hPtr = Blt_NextHashEntry(&cursor)) {
+	Axis *axisPtr;
+
+	axisPtr = Blt_GetHashValue(hPtr);
+	if (axisPtr->major.gc != NULL) {
+	    XSetClipMask(graphPtr->display, axisPtr->major.gc, None);
+	}
+	if (axisPtr->minor.gc != NULL) {
+	    XSetClipMask(graphPtr->display, axisPtr->minor.gc, None);
+	}
+    }
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -5492,59 +6620,499 @@ Blt_MakeAxisTag(Graph *graphPtr, const char *tagName)
     return Blt_GetHashKey(&graphPtr->axes.tagTable, hPtr);
 }
 
+/*
+ * Time scale axes.
+ *
+ *	The values of a time scale axis are times, in seconds, milliseconds,
+ *	microseconds or nanoseconds, relative to the axis' epoch.  The ticks
+ *	are computed with 64-bit integers in nanoseconds since 1970-01-01
+ *	UTC, so that they fall exactly on calendar boundaries, and converted
+ *	back to axis values only when they are generated.
+ */
+#define NS_PER_USEC	((Tcl_WideInt)1000)
+#define NS_PER_MSEC	(NS_PER_USEC * 1000)
+#define NS_PER_SEC	(NS_PER_MSEC * 1000)
+#define NS_PER_MIN	(NS_PER_SEC * 60)
+#define NS_PER_HOUR	(NS_PER_MIN * 60)
+#define NS_PER_DAY	(NS_PER_HOUR * 24)
+#define NS_PER_WEEK	(NS_PER_DAY * 7)
+#define NS_PER_MONTH	(NS_PER_SEC * 2629746) /* Average Gregorian month. */
+
+/* Largest time in nanoseconds (about 146 years from 1970) handled by time
+ * scale axes.  Leaves room for the ticks outside of the data range. */
+#define MAX_TIME_NS	4.6e18
+
+/* Calendar units of time steps. */
+#define TIME_STEP_NSEC	0
+#define TIME_STEP_USEC	1
+#define TIME_STEP_MSEC	2
+#define TIME_STEP_SEC	3
+#define TIME_STEP_MIN	4
+#define TIME_STEP_HOUR	5
+#define TIME_STEP_DAY	6
+#define TIME_STEP_WEEK	7
+#define TIME_STEP_MONTH	8		/* Steps of months and years are */
+#define TIME_STEP_YEAR	9		/* counted in months. */
+
+typedef struct {
+    int unit;				/* Calendar unit of the step. */
+    Tcl_WideInt size;			/* Size of the step, in nanoseconds
+					 * or months. */
+} TimeStep;
+
+/* Steps of a second or longer.  Shorter steps are 1, 2, or 5 times a
+ * power of ten nanoseconds. */
+static TimeStep timeSteps[] = {
+    { TIME_STEP_SEC,   NS_PER_SEC      },
+    { TIME_STEP_SEC,   NS_PER_SEC * 2  },
+    { TIME_STEP_SEC,   NS_PER_SEC * 5  },
+    { TIME_STEP_SEC,   NS_PER_SEC * 10 },
+    { TIME_STEP_SEC,   NS_PER_SEC * 15 },
+    { TIME_STEP_SEC,   NS_PER_SEC * 30 },
+    { TIME_STEP_MIN,   NS_PER_MIN      },
+    { TIME_STEP_MIN,   NS_PER_MIN * 2  },
+    { TIME_STEP_MIN,   NS_PER_MIN * 5  },
+    { TIME_STEP_MIN,   NS_PER_MIN * 10 },
+    { TIME_STEP_MIN,   NS_PER_MIN * 15 },
+    { TIME_STEP_MIN,   NS_PER_MIN * 30 },
+    { TIME_STEP_HOUR,  NS_PER_HOUR     },
+    { TIME_STEP_HOUR,  NS_PER_HOUR * 2 },
+    { TIME_STEP_HOUR,  NS_PER_HOUR * 3 },
+    { TIME_STEP_HOUR,  NS_PER_HOUR * 6 },
+    { TIME_STEP_HOUR,  NS_PER_HOUR * 12},
+    { TIME_STEP_DAY,   NS_PER_DAY      },
+    { TIME_STEP_DAY,   NS_PER_DAY * 2  },
+    { TIME_STEP_WEEK,  NS_PER_WEEK     },
+    { TIME_STEP_MONTH, 1    },
+    { TIME_STEP_MONTH, 2    },
+    { TIME_STEP_MONTH, 3    },
+    { TIME_STEP_MONTH, 6    },
+    { TIME_STEP_YEAR,  12   },
+    { TIME_STEP_YEAR,  24   },
+    { TIME_STEP_YEAR,  60   },
+    { TIME_STEP_YEAR,  120  },
+    { TIME_STEP_YEAR,  240  },
+    { TIME_STEP_YEAR,  600  },
+    { TIME_STEP_YEAR,  1200 },
+};
+static int nTimeSteps = sizeof(timeSteps) / sizeof(TimeStep);
+
+/* Tick label formats suited to each unit of step. */
+static const char *timeFormats[] = {
+    "%H:%M:%S.%9N",			/* TIME_STEP_NSEC */
+    "%H:%M:%S.%6N",			/* TIME_STEP_USEC */
+    "%H:%M:%S.%3N",			/* TIME_STEP_MSEC */
+    "%H:%M:%S",				/* TIME_STEP_SEC */
+    "%H:%M",				/* TIME_STEP_MIN */
+    "%b %d %H:%M",			/* TIME_STEP_HOUR */
+    "%Y-%m-%d",				/* TIME_STEP_DAY */
+    "%Y-%m-%d",				/* TIME_STEP_WEEK */
+    "%b %Y",				/* TIME_STEP_MONTH */
+    "%Y",				/* TIME_STEP_YEAR */
+};
 
+static Tcl_WideInt nsPerTimeUnit[] = {
+    NS_PER_SEC, NS_PER_MSEC, NS_PER_USEC, 1
+};
+
+static const char *monthNames[] = {
+    "January", "February", "March", "April", "May", "June", "July",
+    "August", "September", "October", "November", "December"
+};
+
+static const char *dayNames[] = {
+    "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday",
+    "Saturday"
+};
+
+static Tcl_WideInt
+FloorDiv(Tcl_WideInt a, Tcl_WideInt b)
+{
+    Tcl_WideInt q;
+
+    q = a / b;
+    if (((a % b) != 0) && ((a < 0) != (b < 0))) {
+	q--;
+    }
+    return q;
+}
 
 /*
  *---------------------------------------------------------------------------
  *
- * TimeScaleAxis --
+ * DaysFromCivil --
  *
- * 	Determine the units of a linear scaled axis.
+ *	Computes the number of days since 1970-01-01 of the given date of
+ *	the proleptic Gregorian calendar.
  *
- *	The axis limits are either the range of the data values mapped
- *	to the axis (autoscaled), or the values specified by the -min
- *	and -max options (manual).
+ *---------------------------------------------------------------------------
+ */
+static Tcl_WideInt
+DaysFromCivil(int year, int month, int day)
+{
+    Tcl_WideInt y, era, yoe, doy, doe;
+
+    y = (month <= 2) ? year - 1 : year;
+    era = FloorDiv(y, 400);
+    yoe = y - era * 400;		/* [0, 399] */
+    doy = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/*
+ *---------------------------------------------------------------------------
  *
- *	If autoscaled, the smallest and largest major ticks will
- *	encompass the range of data values.  If the -loose option is
- *	selected, the next outer ticks are choosen.  If tight, the
- *	ticks are at or inside of the data limits are used.
+ * CivilFromDays --
  *
- * 	If manually set, the ticks are at or inside the data limits
- * 	are used.  This makes sense for zooming.  You want the
- * 	selected range to represent the next limit, not something a
- * 	bit bigger.
+ *	Computes the date of the proleptic Gregorian calendar of the given
+ *	number of days since 1970-01-01.
  *
- *	Note: I added an "always" value to the -loose option to force
- *	      the manually selected axes to be loose. It's probably
- *	      not a good idea.
+ *---------------------------------------------------------------------------
+ */
+static void
+CivilFromDays(Tcl_WideInt days, int *yearPtr, int *monthPtr, int *dayPtr)
+{
+    Tcl_WideInt era, doe, yoe, doy, mp;
+    int month;
+
+    days += 719468;
+    era = FloorDiv(days, 146097);
+    doe = days - era * 146097;		/* [0, 146096] */
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    month = (int)((mp < 10) ? mp + 3 : mp - 9);
+    *dayPtr = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *monthPtr = month;
+    *yearPtr = (int)(yoe + era * 400 + ((month <= 2) ? 1 : 0));
+}
+
+/* Months since January 1970 of the given time. */
+static Tcl_WideInt
+MonthOfTime(Tcl_WideInt t)
+{
+    int year, month, day;
+
+    CivilFromDays(FloorDiv(t, NS_PER_DAY), &year, &month, &day);
+    return (Tcl_WideInt)(year - 1970) * 12 + (month - 1);
+}
+
+/* Time of the first day of the given month since January 1970. */
+static Tcl_WideInt
+TimeOfMonth(Tcl_WideInt m)
+{
+    Tcl_WideInt year;
+
+    year = FloorDiv(m, 12);
+    return DaysFromCivil((int)(year + 1970), (int)(m - year * 12) + 1, 1) * 
+	NS_PER_DAY;
+}
+
+/*
+ *---------------------------------------------------------------------------
  *
- *          maxY
- *            |    units = magnitude (of least significant digit)
- *            |    high  = largest unit tick < max axis value
- *      high _|    low   = smallest unit tick > min axis value
- *            |
- *            |    range = high - low
- *            |    # ticks = greatest factor of range/units
- *           _|
- *        U   |
- *        n   |
- *        i   |
- *        t  _|
- *            |
- *            |
- *            |
- *       low _|
- *            |
- *            |_minX________________maxX__
- *            |   |       |      |       |
- *     minY  low                        high
- *           minY
+ * ValueToTime --
  *
- * 	numTicks = Number of ticks
- * 	min = Minimum value of axis
- * 	max = Maximum value of axis
- * 	range    = Range of values (max - min)
+ *	Converts a value of a time scale axis into nanoseconds since
+ *	1970-01-01 UTC.
+ *
+ * Results:
+ *	Returns 1 if the time is within the range handled by time scale
+ *	axes, 0 otherwise.  The time is returned via timePtr.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+ValueToTime(Axis *axisPtr, double value, Tcl_WideInt *timePtr)
+{
+    Tcl_WideInt perUnit;
+    double epoch, ns;
+
+    perUnit = nsPerTimeUnit[axisPtr->timeUnits];
+    epoch = (double)axisPtr->epoch * perUnit;
+    ns = value * perUnit;
+    if ((!FINITE(ns)) || (FABS(ns) > MAX_TIME_NS) || 
+	(FABS(epoch) > MAX_TIME_NS) || (FABS(epoch + ns) > MAX_TIME_NS)) {
+	return FALSE;
+    }
+    *timePtr = (Tcl_WideInt)axisPtr->epoch * perUnit + 
+	(Tcl_WideInt)floor(ns + 0.5);
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * TimeToValue --
+ *
+ *	Converts a time in nanoseconds since 1970-01-01 UTC into a value
+ *	of the time scale axis.  The whole units and the fraction are
+ *	converted separately, so that no digits are lost to the division.
+ *
+ *---------------------------------------------------------------------------
+ */
+static double
+TimeToValue(Axis *axisPtr, Tcl_WideInt t)
+{
+    Tcl_WideInt perUnit, rel;
+
+    perUnit = nsPerTimeUnit[axisPtr->timeUnits];
+    rel = t - (Tcl_WideInt)axisPtr->epoch * perUnit;
+    if (perUnit == 1) {
+	return (double)rel;
+    }
+    return (double)(rel / perUnit) + (double)(rel % perUnit) / perUnit;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * RoundTickTime --
+ *
+ *	Rounds the time of a tick to the resolution of the current step:
+ *	whole seconds, milliseconds, microseconds, or nanoseconds.  Tick
+ *	values far from the epoch may be off by a few nanoseconds, once
+ *	converted to doubles.
+ *
+ *---------------------------------------------------------------------------
+ */
+static Tcl_WideInt
+RoundTickTime(Axis *axisPtr, Tcl_WideInt t)
+{
+    Tcl_WideInt resolution;
+
+    if (axisPtr->timeSweep.step == 0) {
+	return t;
+    }
+    switch (axisPtr->timeSweep.unit) {
+    case TIME_STEP_NSEC:
+	return t;
+    case TIME_STEP_USEC:
+	resolution = NS_PER_USEC;		break;
+    case TIME_STEP_MSEC:
+	resolution = NS_PER_MSEC;		break;
+    default:
+	resolution = NS_PER_SEC;		break;
+    }
+    return FloorDiv(t + resolution / 2, resolution) * resolution;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FormatTime --
+ *
+ *	Formats a time, in nanoseconds since 1970-01-01 UTC, using a subset
+ *	of the strftime conversions: %Y %y %m %d %e %j %H %I %p %M %S %b %B
+ *	%a %A and %%.  "%N" is the fraction of the second in nanoseconds;
+ *	"%3N" and "%6N" keep only the leading digits (milliseconds and
+ *	microseconds).  Times are always UTC.  This is much faster than
+ *	calling TCL's "clock format" for each tick.
+ *
+ * Results:
+ *	The formatted string is left in buffer, truncated to its size.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+FormatTime(const char *fmt, Tcl_WideInt t, char *buffer, size_t size)
+{
+    Tcl_WideInt days, ns;
+    int year, month, day, hour, minute, second, wday;
+    char *bp, *bend;
+    const char *p;
+
+    days = FloorDiv(t, NS_PER_DAY);
+    ns = t - days * NS_PER_DAY;		/* Nanoseconds into the day. */
+    CivilFromDays(days, &year, &month, &day);
+    hour = (int)(ns / NS_PER_HOUR);
+    minute = (int)((ns / NS_PER_MIN) % 60);
+    second = (int)((ns / NS_PER_SEC) % 60);
+    ns %= NS_PER_SEC;
+    wday = (int)(days + 4 - FloorDiv(days + 4, 7) * 7); /* 1970-01-01 was a
+							 * Thursday. */
+    bp = buffer, bend = buffer + size - 1;
+    for (p = fmt; (*p != '\0') && (bp < bend); p++) {
+	char field[40];
+	const char *string;
+	int digits;
+
+	if ((*p != '%') || (p[1] == '\0')) {
+	    *bp++ = *p;
+	    continue;
+	}
+	p++;
+	digits = 9;
+	if ((*p >= '1') && (*p <= '9') && (p[1] == 'N')) {
+	    digits = *p - '0';
+	    p++;
+	}
+	string = field;
+	switch (*p) {
+	case 'Y':
+	    sprintf_s(field, sizeof(field), "%d", year);		break;
+	case 'y':
+	    sprintf_s(field, sizeof(field), "%02d", 
+		(int)(year - FloorDiv(year, 100) * 100));		break;
+	case 'm':
+	    sprintf_s(field, sizeof(field), "%02d", month);		break;
+	case 'd':
+	    sprintf_s(field, sizeof(field), "%02d", day);		break;
+	case 'e':
+	    sprintf_s(field, sizeof(field), "%2d", day);		break;
+	case 'j':
+	    sprintf_s(field, sizeof(field), "%03d", 
+		(int)(days - DaysFromCivil(year, 1, 1)) + 1);		break;
+	case 'H':
+	    sprintf_s(field, sizeof(field), "%02d", hour);		break;
+	case 'I':
+	    sprintf_s(field, sizeof(field), "%02d", (hour + 11) % 12 + 1);
+	    break;
+	case 'p':
+	    string = (hour < 12) ? "AM" : "PM";				break;
+	case 'M':
+	    sprintf_s(field, sizeof(field), "%02d", minute);		break;
+	case 'S':
+	    sprintf_s(field, sizeof(field), "%02d", second);		break;
+	case 'N':
+	    sprintf_s(field, sizeof(field), "%09d", (int)ns);
+	    field[digits] = '\0';
+	    break;
+	case 'b':
+	    strncpy(field, monthNames[month - 1], 3);
+	    field[3] = '\0';
+	    break;
+	case 'B':
+	    string = monthNames[month - 1];				break;
+	case 'a':
+	    strncpy(field, dayNames[wday], 3);
+	    field[3] = '\0';
+	    break;
+	case 'A':
+	    string = dayNames[wday];					break;
+	case '%':
+	    string = "%";						break;
+	default:
+	    field[0] = '%', field[1] = *p, field[2] = '\0';		break;
+	}
+	for (/*empty*/; (*string != '\0') && (bp < bend); string++) {
+	    *bp++ = *string;
+	}
+    }
+    *bp = '\0';
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FormatTimeValue --
+ *
+ *	Formats a time, in nanoseconds since 1970-01-01 UTC, as a number in
+ *	the units of the axis.  The number is exact: there are only as many
+ *	decimals as the fraction of the unit needs.
+ *
+ * Results:
+ *	The formatted number is left in buffer.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+FormatTimeValue(Axis *axisPtr, Tcl_WideInt t, char *buffer, size_t size)
+{
+    Tcl_WideInt perUnit, whole, fraction;
+    const char *sign;
+    int digits;
+
+    perUnit = nsPerTimeUnit[axisPtr->timeUnits];
+    sign = (t < 0) ? "-" : "";
+    if (t < 0) {
+	t = -t;
+    }
+    whole = t / perUnit;
+    fraction = t % perUnit;
+    if (fraction == 0) {
+	sprintf_s(buffer, size, "%s%" TCL_LL_MODIFIER "d", sign, whole);
+	return;
+    }
+    for (digits = 0; perUnit > 1; perUnit /= 10) {
+	digits++;
+    }
+    while ((fraction % 10) == 0) {
+	fraction /= 10;
+	digits--;
+    }
+    sprintf_s(buffer, size, "%s%" TCL_LL_MODIFIER "d.%0*" TCL_LL_MODIFIER "d",
+	sign, whole, digits, fraction);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ChooseTimeStep --
+ *
+ *	Picks the smallest calendar step that divides the range of the axis
+ *	into at most the requested number of major ticks.  Steps shorter
+ *	than a second are 1, 2, or 5 times a power of ten nanoseconds.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ChooseTimeStep(Axis *axisPtr, double range, TimeStep *stepPtr)
+{
+    static int mantissas[] = { 1, 2, 5 };
+    double target;
+    int i;
+
+    target = range / MAX(axisPtr->reqNumMajorTicks, 1);
+    if (target < NS_PER_SEC) {
+	Tcl_WideInt base;
+
+	for (base = 1; base < NS_PER_SEC; base *= 10) {
+	    for (i = 0; i < 3; i++) {
+		Tcl_WideInt size;
+
+		size = base * mantissas[i];
+		if (size >= target) {
+		    stepPtr->size = size;
+		    stepPtr->unit = (size < NS_PER_USEC) ? TIME_STEP_NSEC :
+			(size < NS_PER_MSEC) ? TIME_STEP_USEC : TIME_STEP_MSEC;
+		    return;
+		}
+	    }
+	}
+    }
+    for (i = 0; i < nTimeSteps; i++) {
+	double length;
+
+	length = (double)timeSteps[i].size;
+	if (timeSteps[i].unit >= TIME_STEP_MONTH) {
+	    length *= NS_PER_MONTH;
+	}
+	if (length >= target) {
+	    break;
+	}
+    }
+    *stepPtr = timeSteps[MIN(i, nTimeSteps - 1)];
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * TimeScaleAxis --
+ *
+ * 	Determines the major and minor ticks of a time scale axis.  The
+ * 	major ticks fall on calendar boundaries (whole seconds, minutes,
+ * 	hours, days, Mondays, months, or years) and are computed from
+ * 	64-bit integer times, not by repeatedly adding a floating point
+ * 	step.  If -stepsize is set, it's used as a fixed step, in the units
+ * 	of the axis.
+ *
+ *	The axis limits are chosen as for linear axes: either the outer
+ *	ticks ("loose") or the range of the data ("tight").
+ *
+ *	Times that can't be represented in nanoseconds since 1970 are
+ *	handled as a linear axis.
  *
  * Results:
  *	None.
@@ -5558,115 +7126,81 @@ Blt_MakeAxisTag(Graph *graphPtr, const char *tagName)
 static void
 TimeScaleAxis(Axis *axisPtr, double min, double max)
 {
-#ifdef notdef
-    double step;
-    double tickMin, tickMax;
-    double axisMin, axisMax;
+    TimeSweep *sweepPtr = &axisPtr->timeSweep;
+    TimeStep ts;
+    Tcl_WideInt tMin, tMax, tickMin, tickMax, first, last, perUnit;
+    double axisMin, axisMax, step;
     unsigned int nTicks;
 
-    range = max - min;
-
-
-#define SECONDS_MIN	(60)
-#define SECONDS_HOUR	(SECONDS_MIN * 60)
-#define SECONDS_DAY	(SECONDS_HOUR * 24)
-#define SECONDS_MONTH	(SECONDS_DAY * 30)
-#define SECONDS_YEAR	(SECONDS_MONTH * 12)
-    div = nTicks - 1;
-    if (range > (SECONDS_MONTH * 6 * div)) {
-	unit = TICK_YEAR;
-    } else if (range > (SECONDS_MONTH * 3 * div)) {
-	unit = TICKS_6MONTH;
-	first = timefloor(min, unit);
-	last = timeceil(max, unit);
-    } else if (range > (SECONDS_MONTH * 2 * div)) {
-	unit = TICKS_3MONTH;
-	first = timefloor(min, unit);
-	last = timeceil(max, unit);
-    } else if (range > (SECONDS_MONTH * div)) {
-	unit = TICKS_2MONTH;
-	first = timefloor(min, unit);
-	last = timeceil(max, unit);
-    } else if (range > (SECONDS_DAY * 15 * div)) {
-	unit = TICKS_1MONTH;
-    } else if (range > (SECONDS_DAY * 10 * div)) {
-	unit = TICKS_15DAY;
-    } else if (range > (SECONDS_DAY * div)) {
-	unit = TICKS_10DAY;
-    } else if (range > (SECONDS_HOUR * 12 * div)) {
-	unit = TICKS_1DAY;
-    } else if (range > (SECONDS_HOUR * 6 * div)) {
-	unit = TICKS_12HOUR;
-    } else if (range > (SECONDS_HOUR * 3 * div)) {
-	unit = TICKS_6HOUR;
-    } else if (range > (SECONDS_HOUR * div)) {
-	unit = TICKS_3HOUR;
-    } else if (range > (SECONDS_MIN * 30 * div)) {
-	unit = TICKS_HOUR;
-    } else if (range > (SECONDS_MIN * 20 * div)) {
-	unit = TICKS_30MIN;
-    } else if (range > (SECONDS_MIN * 15 * div)) {
-	unit = TICKS_20MIN;
-    } else if (range > (SECONDS_MIN * 10 * div)) {
-	unit = TICKS_15MIN;
-    } else if (range > (SECONDS_MIN * div)) {
-	unit = TICKS_10MIN;
-    } else if (range > (SECONDS_SEC * 30 * div)) {
-	unit = TICKS_1MIN;
-    } else if (range > (SECONDS_SEC * 20 * div)) {
-	unit = TICKS_30SEC;
-    } else if (range > (SECONDS_SEC * 15 * div)) {
-	unit = TICKS_20SEC;
-    } else if (range > (SECONDS_SEC * 10 * div)) {
-	unit = TICKS_15SEC;
-    } else if (range > (SECONDS_SEC * div)) {
-	unit = TICKS_10SEC;
-    } else {
-	unit = TICKS_1SEC;
+    sweepPtr->step = 0;
+    if ((min >= max) || (!ValueToTime(axisPtr, min, &tMin)) ||
+	(!ValueToTime(axisPtr, max, &tMax))) {
+	LinearScaleAxis(axisPtr, min, max);
+	axisPtr->tickTimeFormat = TimeTickFormat(axisPtr);
+	return;
     }
-
+    perUnit = nsPerTimeUnit[axisPtr->timeUnits];
+    if (axisPtr->reqStep > 0.0) {
+	double size;
+
+	/* A fixed step was designated by the user.  Keep halving it until
+	 * it fits comfortably within the current range of the axis. */
+	size = axisPtr->reqStep * perUnit;
+	if (size > MAX_TIME_NS) {
+	    size = MAX_TIME_NS;
+	}
+	ts.size = MAX((Tcl_WideInt)floor(size + 0.5), 1);
+	while ((ts.size > 1) && ((2 * ts.size) >= (tMax - tMin))) {
+	    ts.size /= 2;
+	}
+	ts.unit = (ts.size < NS_PER_USEC) ? TIME_STEP_NSEC :
+	    (ts.size < NS_PER_MSEC) ? TIME_STEP_USEC :
+	    (ts.size < NS_PER_SEC) ? TIME_STEP_MSEC :
+	    (ts.size < NS_PER_MIN) ? TIME_STEP_SEC :
+	    (ts.size < NS_PER_HOUR) ? TIME_STEP_MIN :
+	    (ts.size < NS_PER_DAY) ? TIME_STEP_HOUR : TIME_STEP_DAY;
     } else {
-	unit = TICKS_SECS;
-    }
-    nTicks = 0;
-    step = 1.0;
-    /* Suppress compiler warning. */
-    axisMin = axisMax = tickMin = tickMax = Blt_NaN();
-    if (min < max) {
-	double range;
-
-	range = max - min;
-	/* Calculate the major tick stepping. */
-	if (axisPtr->reqStep > 0.0) {
-	    /* An interval was designated by the user.  Keep scaling it until
-	     * it fits comfortably within the current range of the axis.  */
-	    step = axisPtr->reqStep;
-	    while ((2 * step) >= range) {
-		step *= 0.5;
-	    }
-	} else {
-	    range = NiceNum(range, 0);
-	    step = NiceNum(range / axisPtr->reqNumMajorTicks, 1);
-	}
-	
-	/* Find the outer tick values. Add 0.0 to prevent getting -0.0. */
-	axisMin = tickMin = floor(min / step) * step + 0.0;
-	axisMax = tickMax = ceil(max / step) * step + 0.0;
-	
-	nTicks = Round((tickMax - tickMin) / step) + 1;
-    } 
+	ChooseTimeStep(axisPtr, (double)(tMax - tMin), &ts);
+    }
+    if (ts.unit >= TIME_STEP_MONTH) {
+	Tcl_WideInt mMin, mMax;
+
+	/* Months vary in length, so count the ticks in months. */
+	mMin = MonthOfTime(tMin);
+	mMax = MonthOfTime(tMax);
+	if (TimeOfMonth(mMax) < tMax) {
+	    mMax++;
+	}
+	first = FloorDiv(mMin, ts.size) * ts.size;
+	last = -FloorDiv(-mMax, ts.size) * ts.size;
+	tickMin = TimeOfMonth(first);
+	tickMax = TimeOfMonth(last);
+	step = (double)ts.size * NS_PER_MONTH / perUnit;
+    } else {
+	Tcl_WideInt align;
+
+	/* Weeks start on Mondays. 1970-01-05 was a Monday. */
+	align = (ts.unit == TIME_STEP_WEEK) ? 4 * NS_PER_DAY : 0;
+	first = FloorDiv(tMin - align, ts.size) * ts.size + align;
+	last = -FloorDiv(align - tMax, ts.size) * ts.size + align;
+	tickMin = first, tickMax = last;
+	step = (double)ts.size / perUnit;
+    }
+    nTicks = (unsigned int)((last - first) / ts.size) + 1;
+    sweepPtr->unit = ts.unit;
+    sweepPtr->step = ts.size;
+    sweepPtr->initial = first;
+    sweepPtr->nSteps = nTicks;
+
+    axisMin = TimeToValue(axisPtr, tickMin);
+    axisMax = TimeToValue(axisPtr, tickMax);
     axisPtr->majorSweep.step = step;
-    axisPtr->majorSweep.initial = tickMin;
+    axisPtr->majorSweep.initial = axisMin;
     axisPtr->majorSweep.nSteps = nTicks;
+    axisPtr->tickTimeFormat = TimeTickFormat(axisPtr);
 
-    /*
-     * The limits of the axis are either the range of the data ("tight") or at
-     * the next outer tick interval ("loose").  The looseness or tightness has
-     * to do with how the axis fits the range of data values.  This option is
-     * overridden when the user sets an axis limit (by either -min or -max
-     * option).  The axis limit is always at the selected limit (otherwise we
-     * assume that user would have picked a different number).
-     */
+    /* The axis limits are the outer ticks or the data limits, as for
+     * linear axes. */
     if ((axisPtr->looseMin == AXIS_TIGHT) || 
 	((axisPtr->looseMin == AXIS_LOOSE) &&
 	 (DEFINED(axisPtr->reqMin)))) {
@@ -5679,87 +7213,74 @@ TimeScaleAxis(Axis *axisPtr, double min, double max)
     }
     SetAxisRange(&axisPtr->axisRange, axisMin, axisMax);
 
-    /* Now calculate the minor tick step and number. */
-
-    if ((axisPtr->reqNumMinorTicks > 0) && (axisPtr->flags & AXIS_AUTO_MAJOR)) {
+    /* 
+     * Minor ticks evenly subdivide the major step, so there are none for
+     * steps of months or years.
+     */
+    if ((ts.unit < TIME_STEP_MONTH) && (axisPtr->reqNumMinorTicks > 0) && 
+	(axisPtr->flags & AXIS_AUTO_MAJOR)) {
 	nTicks = axisPtr->reqNumMinorTicks - 1;
 	step = 1.0 / (nTicks + 1);
     } else {
 	nTicks = 0;			/* No minor ticks. */
-	step = 0.5;			/* Don't set the minor tick interval to
-					 * 0.0. It makes the GenerateTicks
-					 * routine * create minor log-scale tick
-					 * marks.  */
+	step = 0.5;
     }
     axisPtr->minorSweep.initial = axisPtr->minorSweep.step = step;
     axisPtr->minorSweep.nSteps = nTicks;
-#endif
 }
 
-#ifdef notdef
+/*
+ *---------------------------------------------------------------------------
+ *
+ * TimeTickFormat --
+ *
+ *	Returns the format of the time tick labels: the -timeformat option
+ *	if set, otherwise the format suited to the current tick step.
+ *
+ *---------------------------------------------------------------------------
+ */
+static const char *
+TimeTickFormat(Axis *axisPtr)
+{
+    if (axisPtr->timeFormat != NULL) {
+	return axisPtr->timeFormat;
+    }
+    if (axisPtr->timeSweep.step > 0) {
+	return timeFormats[axisPtr->timeSweep.unit];
+    }
+    return DEF_TIME_FORMAT;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GenerateTimeTicks --
+ *
+ *	Generates the major ticks of a time scale axis from its time sweep.
+ *
+ * Results:
+ *	Returns the array of tick values.
+ *
+ *---------------------------------------------------------------------------
+ */
 static Ticks *
-TimeGenerateTicks(TickSweep *sweepPtr)
+GenerateTimeTicks(Axis *axisPtr)
 {
+    TimeSweep *sweepPtr = &axisPtr->timeSweep;
     Ticks *ticksPtr;
+    unsigned int i;
 
     ticksPtr = Blt_AssertMalloc(sizeof(Ticks) + 
 	(sweepPtr->nSteps * sizeof(double)));
-    ticksPtr->nTicks = 0;
+    for (i = 0; i < sweepPtr->nSteps; i++) {
+	Tcl_WideInt t;
 
-    if (sweepPtr->step == 0.0) { 
-	/* Hack: A zero step indicates to use log values. */
-	int i;
-	/* Precomputed log10 values [1..10] */
-	static double logTable[] = {
-	    0.0, 
-	    0.301029995663981, 
-	    0.477121254719662, 
-	    0.602059991327962, 
-	    0.698970004336019, 
-	    0.778151250383644, 
-	    0.845098040014257,
-	    0.903089986991944, 
-	    0.954242509439325, 
-	    1.0
-	};
-	for (i = 0; i < sweepPtr->nSteps; i++) {
-	    ticksPtr->values[i] = logTable[i];
-	}
-    } else {
-	double value;
-	int i;
-    
-	value = sweepPtr->initial;	/* Start from smallest axis tick */
-	for (i = 0; i < sweepPtr->nSteps; i++) {
-	    value = UROUND(value, sweepPtr->step);
-	    ticksPtr->values[i] = value;
-	    value += sweepPtr->step;
+	t = sweepPtr->initial + i * sweepPtr->step;
+	if (sweepPtr->unit >= TIME_STEP_MONTH) {
+	    t = TimeOfMonth(t);
 	}
+	ticksPtr->values[i] = TimeToValue(axisPtr, t);
     }
     ticksPtr->nTicks = sweepPtr->nSteps;
     return ticksPtr;
 }
-
-static double
-TimeFloor(double min, int unit)
-{
-    unsigned long ticks;
-
-    ticks = (long)floor(min);
-    localtime_r(&ticks, &tm);
-    switch(unit) {
-	case TICK_6MONTHS:
-	    tm.sec = 0;
-	    tm.min = 0;
-	    tm.day = 0;
-	    tm.
-    }
-}
-static double
-TimeCeil(double max, int unit)
-{
-    
-}
-
-#endif
-
@@ -75,16 +75,46 @@ typedef struct {
  * TickLabel --
  *
  * 	Structure containing the X-Y screen coordinates of the tick
- * 	label (anchored at its center).
+ * 	label (anchored at its center).  Labels are kept in the axis' label
+ * 	cache and reused as long as their tick value stays visible.
  *
  *---------------------------------------------------------------------------
  */
 typedef struct {
     Point2d anchorPos;
-    unsigned int width, height;
+    unsigned int width, height;		/* Dimensions of the label. */
+    unsigned int rotWidth, rotHeight;	/* Dimensions of the label's bounding
+					 * box, once rotated. */
+    double value;			/* Tick value of the label. */
+    TextLayout *layoutPtr;		/* Layout of the label.  Created the
+					 * first time the label is drawn. */
+    Blt_HashEntry *hashPtr;		/* Entry in the label cache. */
+    Blt_ChainLink link;			/* Link in the cache's LRU list. */
     char string[1];
 } TickLabel;
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * TickLabelCache --
+ *
+ * 	Tick labels previously generated for the axis, keyed by their tick
+ * 	value.  When the axis is scrolled or zoomed, only the labels of
+ * 	newly visible ticks need to be formatted and measured.  The cache
+ * 	is flushed when the axis is configured with an option that changes
+ * 	how labels are formatted or measured (-command, -tickfont, -rotate,
+ * 	and the scale and time options), or when the time format changes.
+ *
+ *---------------------------------------------------------------------------
+ */
+typedef struct {
+    Blt_HashTable table;		/* Labels keyed by tick value. */
+    Blt_Chain lru;			/* Labels, most recently used first. */
+    char *timeFormat;			/* Copy of the time format used to
+					 * generate the labels, or NULL if
+					 * they weren't times. */
+} TickLabelCache;
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -116,6 +146,64 @@ typedef struct {
     unsigned int nSteps;	/* Number of intervals. */
 } TickSweep;
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * TimeSweep --
+ *
+ * 	Structure containing information where the major ticks of a time
+ * 	scale axis will be displayed.  Ticks are computed in nanoseconds
+ * 	since 1970-01-01 UTC.  Steps of months or years aren't a fixed
+ * 	length, so their ticks are counted in months.
+ *
+ *---------------------------------------------------------------------------
+ */
+typedef struct {
+    int unit;			/* Calendar unit of the step. */
+    Tcl_WideInt step;		/* Size of interval, in nanoseconds or
+				 * months. If zero, the axis uses the major
+				 * sweep above. */
+    Tcl_WideInt initial;	/* First tick, in nanoseconds or months. */
+    unsigned int nSteps;	/* Number of ticks. */
+} TimeSweep;
+
+/* Units of the values of time scale axes. */
+#define TIME_UNITS_SECONDS	0
+#define TIME_UNITS_MILLISECONDS	1
+#define TIME_UNITS_MICROSECONDS	2
+#define TIME_UNITS_NANOSECONDS	3
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SharedAxis --
+ *
+ *	Limits and ticks shared by axes of different graphs.  Axes join a
+ *	shared axis by its name with their -shared option.  The limits are
+ *	computed once, from the union of the data ranges of the axes, and
+ *	then copied to each axis.
+ *
+ *---------------------------------------------------------------------------
+ */
+typedef struct _SharedAxis {
+    const char *name;			/* Name of the shared axis. */
+    Blt_HashEntry *hashPtr;		/* Entry in the interpreter's table
+					 * of shared axes. */
+    Blt_HashTable *tablePtr;
+    Blt_Chain axes;			/* Axes sharing the limits. */
+    unsigned int flags;			/* SHARED_RESET, SHARED_REDRAW_PENDING */
+
+    /* Limits and sweeps last computed for the axes. */
+    double min, max;
+    AxisRange valueRange, axisRange;
+    TickSweep majorSweep, minorSweep;
+    TimeSweep timeSweep;
+} SharedAxis;
+
+#define SHARED_RESET		(1<<0)	/* Limits must be recomputed. */
+#define SHARED_REDRAW_PENDING	(1<<1)	/* An idle handler to redraw the
+					 * graphs is pending. */
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -144,6 +232,19 @@ typedef struct {
     int timeScale;			/* If non-zero, generate time scale
 					 * ticks for the axis. This option is
 					 * overridden by -logscale. */
+    int timeUnits;			/* Units of the time values: seconds,
+					 * milliseconds, microseconds, or
+					 * nanoseconds. */
+    long epoch;				/* Time, in the above units, of the
+					 * value 0.0.  Time values are
+					 * relative to the epoch, so that
+					 * they can be represented exactly. */
+    const char *timeFormat;		/* If non-NULL, format of the time
+					 * tick labels.  Otherwise a format
+					 * suited to the tick step is used. */
+    const char *tickTimeFormat;		/* Format of the time tick labels
+					 * currently displayed. */
+    TimeSweep timeSweep;
     int descending;			/* If non-zero, display the range of
 					 * values on the axis in descending
 					 * order, from high to low. */
@@ -227,6 +328,13 @@ typedef struct {
 
     double prevMin, prevMax;
 
+    SharedAxis *sharedPtr;		/* If non-NULL, shared axis whose
+					 * limits this axis displays. */
+    Blt_ChainLink sharedLink;		/* Link in the shared axis' list. */
+    double sharedMin, sharedMax;	/* Range of data values of this
+					 * graph last used to compute the
+					 * shared limits. */
+
     double reqStep;		/* If > 0.0, overrides the computed major 
 				 * tick interval.  Otherwise a stepsize 
 				 * is automatically calculated, based 
@@ -268,7 +376,9 @@ typedef struct {
 					 * array. */
     Blt_Chain tickLabels;		/* Contains major tick label strings
 					 * and their offsets along the
-					 * axis. */
+					 * axis. The labels are owned by
+					 * the label cache below. */
+    TickLabelCache labelCache;
     short int left, right, top, bottom;	/* Region occupied by the of axis. */
     short int width, height;		/* Extents of axis */
     short int maxTickWidth, maxTickHeight;
@@ -300,6 +410,12 @@ typedef struct {
     double screenScale;
     int screenMin, screenRange;
 
+    double lastOrigin;
+    double lastScale, lastOffset;	/* Transform of the axis when the
+					 * graph was last mapped.  Used to
+					 * tell if the plot has only
+					 * scrolled. */
+
 } Axis;
 
 /*
@@ -30,9 +30,20 @@
 #include <X11/Xutil.h>
 
 #include "bltGrElem.h"
+#include "bltPainter.h"
 
 #define CLAMP(x,l,h)	((x) = (((x)<(l))? (l) : ((x)>(h)) ? (h) : (x)))
 
+#define BAR_CHUNK	256		/* # of bars mapped at a time. */
+
+/* 
+ * Runs of one pixel wide bars can be drawn as a single rectangle only if
+ * the bars have no outline or 3D border to separate them.
+ */
+#define CAN_MERGE_BARS(p) \
+    (((p)->outlineColor == NULL) && \
+     (((p)->borderWidth == 0) || ((p)->relief == TK_RELIEF_FLAT)))
+
 typedef struct {
     float x1, y1, x2, y2;
 } BarRegion;
@@ -98,6 +109,10 @@ typedef struct {
     XRectangle *bars;			/* Indicates starting location in bar
 					 * array for this pen. */
     int nBars;				/* # of bar segments for this pen. */
+    XRectangle *spans;			/* Runs of one pixel wide bars in the
+					 * same column (or row), merged into
+					 * single rectangles. */
+    int nSpans;				/* # of spans for this pen. */
 
     GraphSegments xeb, yeb;		/* X and Y error bars. */
 
@@ -108,6 +123,28 @@ typedef struct {
 
 } BarStyle;
 
+/*
+ * BarSlot --
+ *
+ *	Place of a bar in the set of bars sharing its abscissa.  The slots
+ *	are computed when the bar sets are rebuilt, so that the bars can be
+ *	mapped without looking up their groups and regardless of the order
+ *	in which the elements are mapped.
+ */
+typedef struct {
+    int group;				/* Index of the bar's group in the
+					 * graph's array of groups, or -1 if
+					 * the bar isn't in a set. */
+    double offset;			/* Offset of the left side of the bar
+					 * from the left side of the abscissa's
+					 * slot, as a fraction of the bar
+					 * width. */
+    double width;			/* Width of the bar, as a fraction of
+					 * the bar width. */
+    double base;			/* Sum of the segments stacked below
+					 * the bar. */
+} BarSlot;
+
 typedef struct {
     GraphObj obj;			/* Must be first field in element. */
     unsigned int flags;		
@@ -148,6 +185,15 @@ typedef struct {
 					 * symbol. */
     int state;
     Blt_ChainLink link;
+    Region2d exts;			/* Cached data extents of the
+					 * element. Valid only if the
+					 * EXTENTS_CACHED flag is set. */
+    int extsLogScale;			/* Log scales of the X (bit 0) and Y
+					 * (bit 1) axes when the extents were
+					 * computed. */
+    PerfCounter mapPerf;		/* Time spent mapping the element. */
+    int nDrawnPoints;			/* # of screen points (or bars)
+					 * generated by the last mapping. */
 
     /* Fields specific to the barchart element */
 
@@ -163,6 +209,10 @@ typedef struct {
     int nBars;				/* # of visible bar segments for
 					 * element */
     int nActive;
+    XRectangle *spans;			/* Merged runs of one pixel wide bars,
+					 * grouped by pen style. */
+    BarSlot *slots;			/* Position of each bar in its set. */
+    int nSlots;				/* # of slots. */
 
     int xPad;				/* Spacing on either side of bar */
 
@@ -563,7 +613,7 @@ ResetStylePalette(Blt_Chain stylePalette)
 
 	stylePtr = Blt_Chain_GetValue(link);
 	stylePtr->xeb.length = stylePtr->yeb.length = 0;
-	stylePtr->nBars = 0;
+	stylePtr->nBars = stylePtr->nSpans = 0;
     }
 }
 
@@ -1202,6 +1252,83 @@ MapActiveBars(BarElement *elemPtr)
     elemPtr->flags &= ~ACTIVE_PENDING;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MergeBarSpans --
+ *
+ *	Merges consecutive bars of each pen style that are one pixel wide,
+ *	in the same column, and touch or overlap vertically into single
+ *	rectangles (likewise one pixel high bars in the same row, if the
+ *	graph is inverted).  When there are many more bars than pixels
+ *	across the plotting area, this greatly reduces the number of
+ *	rectangles drawn.
+ *	The bars themselves are left as is, since they are used to draw the
+ *	values and to search for the closest bar.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The spans of each pen style are set.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+MergeBarSpans(BarElement *elemPtr)
+{
+    Blt_ChainLink link;
+    XRectangle *sp;
+
+    if (elemPtr->nBars == 0) {
+	return;
+    }
+    elemPtr->spans = sp = Blt_AssertMalloc(elemPtr->nBars * sizeof(XRectangle));
+    for (link = Blt_Chain_FirstLink(elemPtr->stylePalette); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	BarStyle *stylePtr;
+	XRectangle *rp, *rend, *lastPtr;
+
+	stylePtr = Blt_Chain_GetValue(link);
+	stylePtr->spans = sp;
+	lastPtr = NULL;
+	for (rp = stylePtr->bars, rend = rp + stylePtr->nBars; rp < rend; 
+	     rp++) {
+	    if (lastPtr != NULL) {
+		if ((rp->width == 1) && (lastPtr->width == 1) && 
+		    (rp->x == lastPtr->x) &&
+		    (rp->y <= (lastPtr->y + lastPtr->height)) && 
+		    ((rp->y + rp->height) >= lastPtr->y)) {
+		    int y1, y2;
+
+		    y1 = MIN(rp->y, lastPtr->y);
+		    y2 = MAX(rp->y + rp->height, lastPtr->y + lastPtr->height);
+		    lastPtr->y = y1;
+		    lastPtr->height = y2 - y1;
+		    continue;
+		}
+		/* Horizontal bars of an inverted graph. */
+		if ((rp->height == 1) && (lastPtr->height == 1) && 
+		    (rp->y == lastPtr->y) &&
+		    (rp->x <= (lastPtr->x + lastPtr->width)) && 
+		    ((rp->x + rp->width) >= lastPtr->x)) {
+		    int x1, x2;
+
+		    x1 = MIN(rp->x, lastPtr->x);
+		    x2 = MAX(rp->x + rp->width, lastPtr->x + lastPtr->width);
+		    lastPtr->x = x1;
+		    lastPtr->width = x2 - x1;
+		    continue;
+		}
+	    }
+	    *sp = *rp;
+	    lastPtr = sp;
+	    sp++;
+	}
+	stylePtr->nSpans = sp - stylePtr->spans;
+    }
+}
+
 static void
 ResetBar(BarElement *elemPtr)
 {
@@ -1231,9 +1358,12 @@ ResetBar(BarElement *elemPtr)
     if (elemPtr->barToData != NULL) {
 	Blt_Free(elemPtr->barToData);
     }
+    if (elemPtr->spans != NULL) {
+	Blt_Free(elemPtr->spans);
+    }
     elemPtr->activeToData = elemPtr->xeb.map = elemPtr->yeb.map = 
 	elemPtr->barToData = NULL;
-    elemPtr->activeRects = elemPtr->bars = NULL;
+    elemPtr->activeRects = elemPtr->bars = elemPtr->spans = NULL;
     elemPtr->xeb.segments = elemPtr->yeb.segments = NULL;
     elemPtr->nActive = elemPtr->xeb.length = elemPtr->yeb.length = 
 	elemPtr->nBars = 0;
@@ -1393,6 +1523,30 @@ MapErrorBars(Graph *graphPtr, BarElement *elemPtr, BarStyle **dataToStyle)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * LogValues --
+ *
+ *	Converts an array of graph coordinates to the log values expected by
+ *	a log scale axis's transform, as Blt_HMap and Blt_VMap do.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+LogValues(double *values, int n)
+{
+    double *vp, *vend;
+
+    for (vp = values, vend = vp + n; vp < vend; vp++) {
+	if (*vp != 0.0) {
+	    *vp = log10(FABS(*vp));
+	}
+    }
+}
 
 /*
  *---------------------------------------------------------------------------
@@ -1408,7 +1562,10 @@ MapErrorBars(Graph *graphPtr, BarElement *elemPtr, BarStyle **dataToStyle)
  * Notes:
  *	A bar can have multiple segments (more than one x,y pairs).  In this
  *	case, the bar can be represented as either a set of non-contiguous
- *	bars or a single multi-segmented (stacked) bar.
+ *	bars or a single multi-segmented (stacked) bar.  The position of
+ *	each segment within its set was determined when the bar sets were
+ *	built (see Blt_InitBarSetTable), so an element can be remapped
+ *	without the others.
  *
  *	The x-axis layout for a barchart may be presented in one of two ways.
  *	If abscissas are used, the bars are placed at those coordinates.
@@ -1420,13 +1577,15 @@ static void
 MapBarProc(Graph *graphPtr, Element *basePtr)
 {
     BarElement *elemPtr = (BarElement *)basePtr;
+    Axis *xAxisPtr, *yAxisPtr;
+    BarSlot *slots;
     BarStyle **dataToStyle;
     double *x, *y;
-    double barWidth, barOffset;
-    double baseline, ybot;
+    double barWidth, barOffset, baseline;
+    double xOrigin, xScale, xOffset, yOrigin, yScale, yOffset;
+    double left, right, top, bottom;	/* Bounds of the bars. */
     int *barToData;			/* Maps bars to data point indices */
-    int invertBar;
-    int nPoints, count;
+    int nPoints, nSlots, count, stacked;
     XRectangle *rp, *bars;
     int i;
     int size;
@@ -1436,185 +1595,195 @@ MapBarProc(Graph *graphPtr, Element *basePtr)
     if (nPoints < 1) {
 	return;				/* No data points */
     }
-    barWidth = graphPtr->barWidth;
     barWidth = (elemPtr->barWidth > 0.0f) 
 	? elemPtr->barWidth : graphPtr->barWidth;
     baseline = (elemPtr->axes.y->logScale) ? 0.0 : graphPtr->baseline;
     barOffset = barWidth * 0.5;
+    xAxisPtr = elemPtr->axes.x, yAxisPtr = elemPtr->axes.y;
+
+    /*
+     * If the mode is "aligned", "overlap", or "stacked", the bars are
+     * positioned within their sets by the slots computed when the sets
+     * were built.
+     */
+    slots = NULL;
+    nSlots = 0;
+    if ((graphPtr->nBarGroups > 0) && (graphPtr->mode != BARS_INFRONT) && 
+	(!graphPtr->stackAxes) && (elemPtr->slots != NULL)) {
+	slots = elemPtr->slots;
+	nSlots = MIN(elemPtr->nSlots, nPoints);
+    }
+    stacked = (graphPtr->mode == BARS_STACKED);
+
+    /* Bound the bars horizontally by the width of the graph window */
+    /* Bound the bars vertically by the position of the axis. */
+    if (graphPtr->stackAxes) {
+	top = yAxisPtr->screenMin;
+	bottom = yAxisPtr->screenMin + yAxisPtr->screenRange;
+	left = graphPtr->left;
+	right = graphPtr->right;
+    } else {
+	left = top = 0;
+	bottom = right = 10000;
+	/* Shouldn't really have a call to Tk_Width or Tk_Height in mapping
+	 * routine.  We only want to clamp the bar segment to the size of the
+	 * window if we're actually mapped onscreen. */
+	if (Tk_Height(graphPtr->tkwin) > 1) {
+	    bottom = Tk_Height(graphPtr->tkwin);
+	}
+	if (Tk_Width(graphPtr->tkwin) > 1) {
+	    right = Tk_Width(graphPtr->tkwin);
+	}
+    }
+    Blt_GetAxisTransform(xAxisPtr, graphPtr->inverted, &xOrigin, &xScale, 
+	&xOffset);
+    Blt_GetAxisTransform(yAxisPtr, !graphPtr->inverted, &yOrigin, &yScale, 
+	&yOffset);
 
     /*
      * Create an array of bars representing the screen coordinates of all the
      * segments in the bar.
      */
-    bars = Blt_AssertCalloc(nPoints, sizeof(XRectangle));
-    barToData = Blt_AssertCalloc(nPoints, sizeof(int));
+    bars = Blt_AssertMalloc(nPoints * sizeof(XRectangle));
+    barToData = Blt_AssertMalloc(nPoints * sizeof(int));
 
     x = elemPtr->x.values, y = elemPtr->y.values;
     count = 0;
-    for (rp = bars, i = 0; i < nPoints; i++) {
-	Point2d c1, c2;			/* Two opposite corners of the rectangle
-					 * in graph coordinates. */
-	double dx, dy;
-	int height;
-	double right, left, top, bottom;
-
-	if (((x[i] - barWidth) > elemPtr->axes.x->axisRange.max) ||
-	    ((x[i] + barWidth) < elemPtr->axes.x->axisRange.min)) {
-	    continue;			/* Abscissa is out of range of the
-					 * x-axis */
-	}
-	c1.x = x[i] - barOffset;
-	c1.y = y[i];
-	c2.x = c1.x + barWidth;
-	c2.y = baseline;
+    rp = bars;
+    for (i = 0; i < nPoints; i += BAR_CHUNK) {
+	double x1[BAR_CHUNK], x2[BAR_CHUNK];
+	double y1[BAR_CHUNK], y2[BAR_CHUNK];
+	unsigned char negative[BAR_CHUNK], onAxis[BAR_CHUNK];
+	int j, n;
 
 	/*
-	 * If the mode is "aligned" or "stacked" we need to adjust the x or y
-	 * coordinates of the two corners.
+	 * The bars are mapped a chunk at a time.  The two opposite corners
+	 * of each bar are first computed in graph coordinates, then
+	 * transformed to screen coordinates.  Both loops are free of
+	 * branches and function calls, so that the compiler can vectorize
+	 * them.
 	 */
-
-	if ((graphPtr->nBarGroups > 0) && (graphPtr->mode != BARS_INFRONT) && 
-	    (!graphPtr->stackAxes)) {
-	    Blt_HashEntry *hPtr;
-	    BarSetKey key;
-
-	    key.value = (float)x[i];
-	    key.axes = elemPtr->axes;
-	    key.axes.y = NULL;
-	    hPtr = Blt_FindHashEntry(&graphPtr->setTable, (char *)&key);
-	    if (hPtr != NULL) {
-		Blt_HashTable *tablePtr;
-		const char *name;
-
-		tablePtr = Blt_GetHashValue(hPtr);
-		name = (elemPtr->groupName != NULL) ? elemPtr->groupName : 
-		    elemPtr->axes.y->obj.name;
- 		hPtr = Blt_FindHashEntry(tablePtr, name);
-		if (hPtr != NULL) {
-		    BarGroup *groupPtr;
-		    double slice, width, offset;
-		    
-		    groupPtr = Blt_GetHashValue(hPtr);
-		    slice = barWidth / (double)graphPtr->maxBarSetSize;
-		    offset = (slice * groupPtr->index);
-		    if (graphPtr->maxBarSetSize > 1) {
-			offset += slice * 0.05;
-			slice *= 0.90;
-		    }
-		    switch (graphPtr->mode) {
-		    case BARS_STACKED:
-			groupPtr->count++;
-			c2.y = groupPtr->lastY;
-			c1.y += c2.y;
-			groupPtr->lastY = c1.y;
-			c1.x += offset;
-			c2.x = c1.x + slice;
-			break;
-			
-		    case BARS_ALIGNED:
-			slice /= groupPtr->nSegments;
-			c1.x += offset + (slice * groupPtr->count);
-			c2.x = c1.x + slice;
-			groupPtr->count++;
-			break;
-			
-		    case BARS_OVERLAP:
-			slice /= (groupPtr->nSegments + 1);
-			width = slice + slice;
-			groupPtr->count++;
-			c1.x += offset + 
-			    (slice * (groupPtr->nSegments - groupPtr->count));
-			c2.x = c1.x + width;
-			break;
-			
-		    case BARS_INFRONT:
-			break;
+	n = MIN(BAR_CHUNK, nPoints - i);
+	for (j = 0; j < n; j++) {
+	    x1[j] = x[i + j] - barOffset;
+	    x2[j] = x1[j] + barWidth;
+	    y1[j] = y[i + j];
+	    y2[j] = baseline;
+	}
+	if (i < nSlots) {
+	    BarSlot *sp;
+	    int m;
+
+	    m = MIN(n, nSlots - i);
+	    sp = slots + i;
+	    for (j = 0; j < m; j++) {
+		x1[j] += sp[j].offset * barWidth;
+		x2[j] = x1[j] + sp[j].width * barWidth;
+	    }
+	    if (stacked) {
+		for (j = 0; j < m; j++) {
+		    if (sp[j].group >= 0) {
+			y1[j] += sp[j].base;
+			y2[j] = sp[j].base;
 		    }
 		}
 	    }
 	}
-	invertBar = FALSE;
-	if (c1.y < c2.y) {
-	    double temp;
+	/* Handle negative bar values by swapping ordinates */
+	for (j = 0; j < n; j++) {
+	    double t;
 
-	    /* Handle negative bar values by swapping ordinates */
-	    temp = c1.y, c1.y = c2.y, c2.y = temp;
-	    invertBar = TRUE;
+	    negative[j] = (y1[j] < y2[j]);
+	    t = MAX(y1[j], y2[j]);
+	    y2[j] = MIN(y1[j], y2[j]);
+	    y1[j] = t;
+	    onAxis[j] = (y2[j] == 0.0);
 	}
-	/*
-	 * Get the two corners of the bar segment and compute the rectangle
-	 */
-	ybot = c2.y;
-	c1 = Blt_Map2D(graphPtr, c1.x, c1.y, &elemPtr->axes);
-	c2 = Blt_Map2D(graphPtr, c2.x, c2.y, &elemPtr->axes);
-	if ((ybot == 0.0) && (elemPtr->axes.y->logScale)) {
-	    c2.y = graphPtr->bottom;
+	if (xAxisPtr->logScale) {
+	    LogValues(x1, n);
+	    LogValues(x2, n);
 	}
-	    
-	if (c2.y < c1.y) {
-	    double t;
-	    t = c1.y, c1.y = c2.y, c2.y = t;
+	if (yAxisPtr->logScale) {
+	    LogValues(y1, n);
+	    LogValues(y2, n);
 	}
-	if (c2.x < c1.x) {
-	    double t;
-	    t = c1.x, c1.x = c2.x, c2.x = t;
-	}
-	if ((c1.x > graphPtr->right) || (c2.x < graphPtr->left) || 
-	    (c1.y > graphPtr->bottom) || (c2.y < graphPtr->top)) {
-	    continue;
+	for (j = 0; j < n; j++) {
+	    x1[j] = (x1[j] - xOrigin) * xScale + xOffset;
+	    x2[j] = (x2[j] - xOrigin) * xScale + xOffset;
+	    y1[j] = (y1[j] - yOrigin) * yScale + yOffset;
+	    y2[j] = (y2[j] - yOrigin) * yScale + yOffset;
 	}
-	/* Bound the bars horizontally by the width of the graph window */
-	/* Bound the bars vertically by the position of the axis. */
-	if (graphPtr->stackAxes) {
-	    top = elemPtr->axes.y->screenMin;
-	    bottom = elemPtr->axes.y->screenMin + elemPtr->axes.y->screenRange;
-	    left = graphPtr->left;
-	    right = graphPtr->right;
-	} else {
-	    left = top = 0;
-	    bottom = right = 10000;
-	    /* Shouldn't really have a call to Tk_Width or Tk_Height in
-	     * mapping routine.  We only want to clamp the bar segment to the
-	     * size of the window if we're actually mapped onscreen. */
-	    if (Tk_Height(graphPtr->tkwin) > 1) {
-		bottom = Tk_Height(graphPtr->tkwin);
+
+	for (j = 0; j < n; j++) {
+	    Point2d c1, c2;		/* Two opposite corners of the
+					 * rectangle in screen coordinates. */
+	    double dx, dy;
+	    int height, k;
+
+	    k = i + j;
+	    if (((x[k] - barWidth) > xAxisPtr->axisRange.max) ||
+		((x[k] + barWidth) < xAxisPtr->axisRange.min)) {
+		continue;		/* Abscissa is out of range of the
+					 * x-axis */
 	    }
-	    if (Tk_Width(graphPtr->tkwin) > 1) {
-		right = Tk_Width(graphPtr->tkwin);
+	    if (graphPtr->inverted) {
+		c1.x = y1[j], c1.y = x1[j];
+		c2.x = y2[j], c2.y = x2[j];
+	    } else {
+		c1.x = x1[j], c1.y = y1[j];
+		c2.x = x2[j], c2.y = y2[j];
 	    }
-	}
-	CLAMP(c1.y, top, bottom);
-	CLAMP(c2.y, top, bottom);
-	CLAMP(c1.x, left, right);
-	CLAMP(c2.x, left, right);
-	dx = FABS(c1.x - c2.x);
-	dy = FABS(c1.y - c2.y);
-	if ((dx == 0) || (dy == 0)) {
-	    continue;
-	}
-	height = (int)dy;
-	if (invertBar) {
-	    rp->y = (short int)MIN(c1.y, c2.y);
-	} else {
-	    rp->y = (short int)(MAX(c1.y, c2.y)) - height;
-	}
-	rp->x = (short int)MIN(c1.x, c2.x);
-	rp->width = (short int)dx + 1;
-	rp->width |= 0x1;
-	if (rp->width < 1) {
-	    rp->width = 1;
-	}
-	rp->height = height + 1;
-	if (rp->height < 1) {
-	    rp->height = 1;
-	}
-	barToData[count] = i;		/* Save the data index corresponding to
+	    if ((onAxis[j]) && (yAxisPtr->logScale)) {
+		c2.y = graphPtr->bottom;
+	    }
+	    if (c2.y < c1.y) {
+		double t;
+
+		t = c1.y, c1.y = c2.y, c2.y = t;
+	    }
+	    if (c2.x < c1.x) {
+		double t;
+
+		t = c1.x, c1.x = c2.x, c2.x = t;
+	    }
+	    if ((c1.x > graphPtr->right) || (c2.x < graphPtr->left) || 
+		(c1.y > graphPtr->bottom) || (c2.y < graphPtr->top)) {
+		continue;
+	    }
+	    CLAMP(c1.y, top, bottom);
+	    CLAMP(c2.y, top, bottom);
+	    CLAMP(c1.x, left, right);
+	    CLAMP(c2.x, left, right);
+	    dx = FABS(c1.x - c2.x);
+	    dy = FABS(c1.y - c2.y);
+	    if ((dx == 0) || (dy == 0)) {
+		continue;
+	    }
+	    height = (int)dy;
+	    if (negative[j]) {
+		rp->y = (short int)MIN(c1.y, c2.y);
+	    } else {
+		rp->y = (short int)(MAX(c1.y, c2.y)) - height;
+	    }
+	    rp->x = (short int)MIN(c1.x, c2.x);
+	    rp->width = (short int)dx + 1;
+	    rp->width |= 0x1;
+	    if (rp->width < 1) {
+		rp->width = 1;
+	    }
+	    rp->height = height + 1;
+	    if (rp->height < 1) {
+		rp->height = 1;
+	    }
+	    barToData[count] = k;	/* Save the data index corresponding to
 					 * the rectangle */
-	count++;
-	rp++;
+	    count++;
+	    rp++;
+	}
     }
     elemPtr->nBars = count;
     elemPtr->bars = bars;
+    elemPtr->nDrawnPoints = count;
     elemPtr->barToData = barToData;
     if (elemPtr->nActiveIndices > 0) {
 	MapActiveBars(elemPtr);
@@ -1647,6 +1816,7 @@ MapBarProc(Graph *graphPtr, Element *basePtr)
 	MapErrorBars(graphPtr, elemPtr, dataToStyle);
     }
     MergePens(elemPtr, dataToStyle);
+    MergeBarSpans(elemPtr);
     Blt_Free(dataToStyle);
 }
 
@@ -1871,7 +2041,10 @@ DrawNormalBarProc(Graph *graphPtr, Drawable drawable, Element *basePtr)
 
 	stylePtr = Blt_Chain_GetValue(link);
 	penPtr = stylePtr->penPtr;
-	if (stylePtr->nBars > 0) {
+	if ((stylePtr->nSpans > 0) && (CAN_MERGE_BARS(penPtr))) {
+	    DrawBarSegments(graphPtr, drawable, penPtr, stylePtr->spans,
+		stylePtr->nSpans);
+	} else if (stylePtr->nBars > 0) {
 	    DrawBarSegments(graphPtr, drawable, penPtr, stylePtr->bars,
 		stylePtr->nBars);
 	}
@@ -2166,7 +2339,10 @@ NormalBarToPostScriptProc(Graph *graphPtr, Blt_Ps ps, Element *basePtr)
 
 	stylePtr = Blt_Chain_GetValue(link);
 	penPtr = stylePtr->penPtr;
-	if (stylePtr->nBars > 0) {
+	if ((stylePtr->nSpans > 0) && (CAN_MERGE_BARS(penPtr))) {
+	    SegmentsToPostScript(graphPtr, ps, penPtr, stylePtr->spans, 
+		stylePtr->nSpans);
+	} else if (stylePtr->nBars > 0) {
 	    SegmentsToPostScript(graphPtr, ps, penPtr, stylePtr->bars, 
 		stylePtr->nBars);
 	}
@@ -2227,6 +2403,121 @@ DestroyBarProc(Graph *graphPtr, Element *basePtr)
     if (elemPtr->activeIndices != NULL) {
 	Blt_Free(elemPtr->activeIndices);
     }
+    if (elemPtr->slots != NULL) {
+	Blt_Free(elemPtr->slots);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * BarsToPicture --
+ *
+ *	Paints the bars, clipped to the plotting area, into the picture.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+BarsToPicture(Graph *graphPtr, Blt_Picture picture, BarPen *penPtr, 
+	      XRectangle *bars, int nBars)
+{
+    Blt_Pixel fill, outline;
+    XRectangle *rp, *rend;
+    int hasOutline;
+
+    /* As with X, filled bars are outlined only if they're flat. */
+    hasOutline = ((penPtr->outlineColor != NULL) && 
+		  ((penPtr->fill == NULL) || 
+		   (penPtr->relief == TK_RELIEF_FLAT) ||
+		   (penPtr->relief == TK_RELIEF_SOLID)));
+    if (penPtr->fill != NULL) {
+	fill = Blt_XColorToPixel(Blt_BackgroundBorderColor(penPtr->fill));
+    }
+    if (hasOutline) {
+	outline = Blt_XColorToPixel(penPtr->outlineColor);
+    }
+    for (rp = bars, rend = rp + nBars; rp < rend; rp++) {
+	int x1, y1, x2, y2;
+
+	x1 = MAX(rp->x, graphPtr->left);
+	y1 = MAX(rp->y, graphPtr->top);
+	x2 = MIN(rp->x + rp->width, graphPtr->right + 1);
+	y2 = MIN(rp->y + rp->height, graphPtr->bottom + 1);
+	if ((x1 >= x2) || (y1 >= y2)) {
+	    continue;
+	}
+	if (penPtr->fill != NULL) {
+	    Blt_PaintRectangle(picture, x1, y1, x2 - x1, y2 - y1, 0, 0, &fill);
+	}
+	if (hasOutline) {
+	    Blt_PaintRectangle(picture, x1, y1, x2 - x1 + 1, y2 - y1 + 1, 0, 1,
+		&outline);
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * BarToPictureProc --
+ *
+ *	Paints the bars of the element into the picture, without drawing
+ *	through X.  Only bars filled with a solid color and without a 3D
+ *	border can be painted.
+ *
+ * Results:
+ *	Returns 1 if the element was painted.  Returns 0, before anything is
+ *	painted, if the element has stippled or patterned bars, 3D borders,
+ *	error bars, or values, which can only be drawn through X.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+BarToPictureProc(Graph *graphPtr, Blt_Picture picture, Element *basePtr)
+{
+    BarElement *elemPtr = (BarElement *)basePtr;
+    Blt_ChainLink link;
+
+    for (link = Blt_Chain_FirstLink(elemPtr->stylePalette); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	BarStyle *stylePtr;
+	BarPen *penPtr;
+
+	stylePtr = Blt_Chain_GetValue(link);
+	penPtr = stylePtr->penPtr;
+	if (((stylePtr->xeb.length > 0) && (penPtr->errorBarShow & SHOW_X)) ||
+	    ((stylePtr->yeb.length > 0) && (penPtr->errorBarShow & SHOW_Y)) ||
+	    (penPtr->valueShow != SHOW_NONE)) {
+	    return FALSE;
+	}
+	if ((penPtr->fill != NULL) && 
+	    ((penPtr->stipple != None) || 
+	     (!Blt_BackgroundIsSolid(penPtr->fill)) ||
+	     ((penPtr->borderWidth > 0) && 
+	      (penPtr->relief != TK_RELIEF_FLAT) &&
+	      (penPtr->relief != TK_RELIEF_SOLID)))) {
+	    return FALSE;
+	}
+    }
+    for (link = Blt_Chain_FirstLink(elemPtr->stylePalette); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	BarStyle *stylePtr;
+	BarPen *penPtr;
+
+	stylePtr = Blt_Chain_GetValue(link);
+	penPtr = stylePtr->penPtr;
+	if ((stylePtr->nSpans > 0) && (CAN_MERGE_BARS(penPtr))) {
+	    BarsToPicture(graphPtr, picture, penPtr, stylePtr->spans, 
+		stylePtr->nSpans);
+	} else if (stylePtr->nBars > 0) {
+	    BarsToPicture(graphPtr, picture, penPtr, stylePtr->bars, 
+		stylePtr->nBars);
+	}
+    }
+    return TRUE;
 }
 
 /*
@@ -2257,6 +2548,9 @@ static ElementProcs barProcs = {
     NormalBarToPostScriptProc,
     SymbolToPostScriptProc,
     MapBarProc,
+    NULL,				/* Bars can't be scrolled. */
+    NULL,
+    BarToPictureProc,
 };
 
 
@@ -2281,6 +2575,148 @@ Blt_BarElement(Graph *graphPtr, const char *name, ClassId classId)
     return (Element *)elemPtr;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FreeBarSlots --
+ *
+ *	Frees the slots of each bar element.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+FreeBarSlots(Graph *graphPtr)
+{
+    Blt_HashEntry *hPtr;
+    Blt_HashSearch iter;
+
+    for (hPtr = Blt_FirstHashEntry(&graphPtr->elements.table, &iter); 
+	 hPtr != NULL; hPtr = Blt_NextHashEntry(&iter)) {
+	BarElement *elemPtr;
+
+	elemPtr = Blt_GetHashValue(hPtr);
+	if ((elemPtr->obj.classId == CID_ELEM_BAR) && (elemPtr->slots != NULL)) {
+	    Blt_Free(elemPtr->slots);
+	    elemPtr->slots = NULL;
+	    elemPtr->nSlots = 0;
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MakeBarSlots --
+ *
+ *	Computes the slot of each bar in the set of bars sharing its
+ *	abscissa: its group and the offset and width of the bar within the
+ *	abscissa's slot.  The bars of a group are placed in the order of the
+ *	elements in the display list.  This is where the bar sets are
+ *	searched, so that the bars can later be mapped without any table
+ *	lookups.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory is allocated for the slots of each visible bar element.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+MakeBarSlots(Graph *graphPtr)
+{
+    Blt_ChainLink link;
+    double part, slice, pad;
+
+    if (graphPtr->nBarGroups == 0) {
+	return;
+    }
+    {
+	BarGroup *gp, *gend;
+
+	for (gp = graphPtr->barGroups, gend = gp + graphPtr->nBarGroups; 
+	     gp < gend; gp++) {
+	    gp->count = 0;
+	}
+    }
+    /* Each group of a set gets an equal part of the bar width, minus some
+     * padding if there's more than one group. */
+    part = 1.0 / (double)graphPtr->maxBarSetSize;
+    slice = part;
+    pad = 0.0;
+    if (graphPtr->maxBarSetSize > 1) {
+	pad = part * 0.05;
+	slice = part * 0.90;
+    }
+    for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList);
+	link != NULL; link = Blt_Chain_NextLink(link)) {
+	BarElement *elemPtr;
+	BarSlot *sp;
+	const char *name;
+	int i, nPoints;
+
+	elemPtr = Blt_Chain_GetValue(link);
+	if ((elemPtr->flags & HIDE) || (elemPtr->obj.classId != CID_ELEM_BAR)) {
+	    continue;
+	}
+	nPoints = NUMBEROFPOINTS(elemPtr);
+	if (nPoints == 0) {
+	    continue;
+	}
+	name = (elemPtr->groupName != NULL) ? elemPtr->groupName : 
+	    elemPtr->axes.y->obj.name;
+	elemPtr->slots = Blt_AssertMalloc(nPoints * sizeof(BarSlot));
+	elemPtr->nSlots = nPoints;
+	for (sp = elemPtr->slots, i = 0; i < nPoints; i++, sp++) {
+	    Blt_HashEntry *hPtr;
+	    BarGroup *groupPtr;
+	    BarSetKey key;
+	    double offset, width;
+
+	    sp->group = -1;
+	    sp->offset = 0.0;
+	    sp->width = 1.0;
+	    sp->base = 0.0;
+	    memset(&key, 0, sizeof(key));
+	    key.value = elemPtr->x.values[i];
+	    key.axes = elemPtr->axes;
+	    key.axes.y = NULL;
+	    hPtr = Blt_FindHashEntry(&graphPtr->setTable, (char *)&key);
+	    if (hPtr == NULL) {
+		continue;
+	    }
+	    hPtr = Blt_FindHashEntry((Blt_HashTable *)Blt_GetHashValue(hPtr), 
+		name);
+	    if (hPtr == NULL) {
+		continue;
+	    }
+	    groupPtr = Blt_GetHashValue(hPtr);
+	    offset = (part * groupPtr->index) + pad;
+	    width = slice;
+	    switch (graphPtr->mode) {
+	    case BARS_ALIGNED:
+		width /= groupPtr->nSegments;
+		offset += width * groupPtr->count;
+		break;
+		
+	    case BARS_OVERLAP:
+		width /= (groupPtr->nSegments + 1);
+		offset += width * (groupPtr->nSegments - groupPtr->count - 1);
+		width += width;
+		break;
+		
+	    default:
+		break;
+	    }
+	    groupPtr->count++;
+	    sp->group = groupPtr - graphPtr->barGroups;
+	    sp->offset = offset;
+	    sp->width = width;
+	}
+    }
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -2314,6 +2750,7 @@ Blt_InitBarSetTable(Graph *graphPtr)
      * the array of frequency information and the table itself
      */
     Blt_DestroyBarSets(graphPtr);
+    FreeBarSlots(graphPtr);
     if (graphPtr->mode == BARS_INFRONT) {
 	return;				/* No set table is needed for
 					 * "infront" mode */
@@ -2347,6 +2784,7 @@ Blt_InitBarSetTable(Graph *graphPtr)
 	    size_t count;
 	    const char *name;
 
+	    memset(&key, 0, sizeof(key));
 	    key.value = *x;
 	    key.axes = elemPtr->axes;
 	    key.axes.y = NULL;
@@ -2424,6 +2862,7 @@ Blt_InitBarSetTable(Graph *graphPtr)
     }
     graphPtr->maxBarSetSize = max;
     graphPtr->nBarGroups = sum;
+    MakeBarSlots(graphPtr);
 }
 
 /*
@@ -2444,7 +2883,8 @@ Blt_InitBarSetTable(Graph *graphPtr)
  *
  * Side effects:
  *	The heights of each stack is computed. CheckBarGroups will use this
- *	information to adjust the y-axis limits if necessary.
+ *	information to adjust the y-axis limits if necessary.  The base of
+ *	each stacked segment is saved in its slot.
  *
  *---------------------------------------------------------------------------
  */
@@ -2468,57 +2908,33 @@ Blt_ComputeBarStacks(Graph *graphPtr)
     }
 
     /* Consider each bar x-y coordinate. Add the ordinates of duplicate
-     * abscissas. */
+     * abscissas, saving the sum below each segment as its base. */
 
     for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList); 
 	 link != NULL; link = Blt_Chain_NextLink(link)) {
 	BarElement *elemPtr;
-	double *x, *y, *xend;
+	BarSlot *sp, *send;
+	double *y;
 
 	elemPtr = Blt_Chain_GetValue(link);
-	if ((elemPtr->flags & HIDE) || (elemPtr->obj.classId != CID_ELEM_BAR)) {
+	if ((elemPtr->flags & HIDE) || (elemPtr->obj.classId != CID_ELEM_BAR) ||
+	    (elemPtr->slots == NULL)) {
 	    continue;
 	}
-	for (x = elemPtr->x.values, y = elemPtr->y.values, 
-		 xend = x + NUMBEROFPOINTS(elemPtr); x < xend; x++, y++) {
-	    BarSetKey key;
+	for (sp = elemPtr->slots, send = sp + elemPtr->nSlots, 
+		 y = elemPtr->y.values; sp < send; sp++, y++) {
 	    BarGroup *groupPtr;
-	    Blt_HashEntry *hPtr;
-	    Blt_HashTable *tablePtr;
-	    const char *name;
 
-	    key.value = *x;
-	    key.axes = elemPtr->axes;
-	    key.axes.y = NULL;
-	    hPtr = Blt_FindHashEntry(&graphPtr->setTable, (char *)&key);
-	    if (hPtr == NULL) {
+	    if (sp->group < 0) {
 		continue;
 	    }
-	    tablePtr = Blt_GetHashValue(hPtr);
-	    name = (elemPtr->groupName != NULL) ? elemPtr->groupName : 
-		elemPtr->axes.y->obj.name;
-	    hPtr = Blt_FindHashEntry(tablePtr, name);
-	    if (hPtr == NULL) {
-		continue;
-	    }
-	    groupPtr = Blt_GetHashValue(hPtr);
+	    groupPtr = graphPtr->barGroups + sp->group;
+	    sp->base = groupPtr->sum;
 	    groupPtr->sum += *y;
 	}
     }
 }
 
-void
-Blt_ResetBarGroups(Graph *graphPtr)
-{
-    BarGroup *gp, *gend;
-
-    for (gp = graphPtr->barGroups, gend = gp + graphPtr->nBarGroups; gp < gend; 
-	 gp++) {
-	gp->lastY = 0.0;
-	gp->count = 0;
-    }
-}
-
 void
 Blt_DestroyBarSets(Graph *graphPtr)
 {
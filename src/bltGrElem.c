@@ -26,6 +26,17 @@
  *	WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "config.h"
+#ifdef BLT_MAP_THREADS
+/* 
+ * Tcl's mutexes and condition variables are no-ops unless tcl.h sees
+ * TCL_THREADS.  Define it here, for the map pool only, rather than for all
+ * of BLT.
+ */
+#ifndef TCL_THREADS
+#define TCL_THREADS 1
+#endif
+#endif /* BLT_MAP_THREADS */
 #include "bltGraph.h"
 #include "bltOp.h"
 #include "bltChain.h"
@@ -42,6 +53,44 @@ typedef struct {
     int refCount;
 } TableClient;
 
+#ifdef BLT_MAP_THREADS
+#define MAX_MAP_THREADS		8	/* Maximum # of threads mapping
+					 * elements, including the caller's
+					 * thread. */
+#define MIN_THREADED_POINTS	20000	/* Elements with fewer points (in
+					 * total) are mapped serially. */
+
+/*
+ * MapPool --
+ *
+ *	Pool of worker threads used to map line elements in parallel.  The
+ *	pool is shared by all graphs and maps one batch of elements at a
+ *	time.  Each element is mapped entirely by a single thread, so the
+ *	results don't depend upon the number of threads.
+ */
+typedef struct {
+    Tcl_Mutex mutex;			/* Protects the fields below. */
+    Tcl_Condition workReady;		/* Signaled when a new batch is
+					 * started or the pool is shut
+					 * down. */
+    Tcl_Condition workDone;		/* Signaled when the last element of
+					 * the batch has been mapped. */
+    Tcl_ThreadId threads[MAX_MAP_THREADS];
+    int nThreads;			/* # of worker threads started. */
+    int shutdown;			/* Indicates the workers to exit. */
+    int busy;				/* Indicates a batch is in
+					 * progress. */
+    Graph *graphPtr;			/* Graph of the current batch. */
+    Element **elements;			/* Elements of the current batch. */
+    int nElements;			/* # of elements in the batch. */
+    int next;				/* Index of the next element to be
+					 * mapped. */
+    int nDone;				/* # of elements mapped. */
+} MapPool;
+
+static MapPool mapPool;
+#endif /* BLT_MAP_THREADS */
+
 static Blt_OptionParseProc ObjToAlong;
 static Blt_OptionPrintProc AlongToObj;
 static Blt_CustomOption alongOption =
@@ -161,6 +210,47 @@ GetPenStyleFromObj(
     return TCL_OK;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * InvalidateElement --
+ *
+ *	Indicates that the element needs to be redrawn.  If the graph is
+ *	layered, only the element is marked.  Otherwise all the elements in
+ *	the graph's cache pixmap are redrawn.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+InvalidateElement(Graph *graphPtr, Element *elemPtr)
+{
+    if (graphPtr->layered) {
+	elemPtr->flags |= LAYER_DIRTY;
+    } else {
+	graphPtr->flags |= CACHE_DIRTY;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ResetElementExtents --
+ *
+ *	Indicates that the element's data has changed, so its cached
+ *	extents are out-of-date.  The sets of bars sharing the same
+ *	abscissa are rebuilt if it's a bar element.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ResetElementExtents(Element *elemPtr)
+{
+    elemPtr->flags &= ~EXTENTS_CACHED;
+    if (elemPtr->obj.classId == CID_ELEM_BAR) {
+	elemPtr->obj.graphPtr->flags |= RESET_BAR_SETS;
+    }
+}
+
 static void
 FreeVectorSource(ElemValues *valuesPtr)
 {
@@ -169,32 +259,64 @@ FreeVectorSource(ElemValues *valuesPtr)
 	Blt_FreeVectorId(valuesPtr->vectorSource.vector); 
 	valuesPtr->vectorSource.vector = NULL;
     }
+    valuesPtr->values = NULL;		/* The values belong to the vector. */
 }
 
-static int
-FetchVectorValues(Tcl_Interp *interp, ElemValues *valuesPtr, Blt_Vector *vector)
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FetchVectorValues --
+ *
+ *	Points the element's values at the vector's own array, rather than
+ *	a copy of it.  The vector is pinned, so the element is told right
+ *	away when the array moves.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+FetchVectorValues(ElemValues *valuesPtr, Blt_Vector *vector)
 {
-    double *array;
-    
-    if (valuesPtr->values == NULL) {
-	array = Blt_Malloc(Blt_VecLength(vector) * sizeof(double));
-    } else {
-	array = Blt_Realloc(valuesPtr->values, 
-			    Blt_VecLength(vector) * sizeof(double));
-    }
-    if (array == NULL) {
-	if (interp != NULL) {
-	    Tcl_AppendResult(interp, "can't allocate new vector", (char *)NULL);
-	}
-	return TCL_ERROR;
-    }
-    memcpy(array, Blt_VecData(vector), sizeof(double) * Blt_VecLength(vector));
+    valuesPtr->values = Blt_VecData(vector);
+    valuesPtr->nValues = Blt_VecLength(vector);
+    valuesPtr->nLogValues = valuesPtr->nUnchanged = 0;
+    valuesPtr->nIncreasing = 0;
     valuesPtr->min = Blt_VecMin(vector);
     valuesPtr->max = Blt_VecMax(vector);
-    valuesPtr->values = array;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * AppendVectorValues --
+ *
+ *	Picks up the values appended to the vector.  Only the new values
+ *	are scanned to extend the range.  The logs of the old values are
+ *	kept.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+AppendVectorValues(ElemValues *valuesPtr, Blt_Vector *vector)
+{
+    double *vp, *vend;
+    double min, max;
+
+    valuesPtr->values = Blt_VecData(vector);
+    min = valuesPtr->min, max = valuesPtr->max;
+    for (vp = valuesPtr->values + valuesPtr->nValues, 
+	     vend = valuesPtr->values + Blt_VecLength(vector); vp < vend; vp++) {
+	if (FINITE(*vp)) {
+	    if (*vp < min) {
+		min = *vp;
+	    } 
+	    if (*vp > max) {
+		max = *vp;
+	    }
+	}
+    }
+    valuesPtr->min = min, valuesPtr->max = max;
+    valuesPtr->nUnchanged = MIN(valuesPtr->nUnchanged, valuesPtr->nValues);
     valuesPtr->nValues = Blt_VecLength(vector);
-    /* FindRange(valuesPtr); */
-    return TCL_OK;
 }
 
 
@@ -203,6 +325,10 @@ FetchVectorValues(Tcl_Interp *interp, ElemValues *valuesPtr, Blt_Vector *vector)
  *
  * VectorChangedProc --
  *
+ *	Called when the vector sourcing the element's values changes.  If
+ *	values were only appended to the vector and the element's extents
+ *	are unchanged, the axes aren't reset.
+ *
  * Results:
  *     	None.
  *
@@ -218,28 +344,99 @@ VectorChangedProc(
     Blt_VectorNotify notify)
 {
     ElemValues *valuesPtr = clientData;
+    VectorDataSource *srcPtr = &valuesPtr->vectorSource;
+    Element *elemPtr = valuesPtr->elemPtr;
+    Graph *graphPtr = elemPtr->obj.graphPtr;
+    int resetAxes, appended;
 
-    if (notify == BLT_VECTOR_NOTIFY_DESTROY) {
+    resetAxes = TRUE;
+    appended = FALSE;
+    if (notify == BLT_VECTOR_NOTIFY_MOVE) {
+	/* 
+	 * The vector's array has moved, possibly in the middle of an
+	 * operation on the vector.  Just pick up the new array.  If it
+	 * holds fewer values, drop them until the vector's update arrives.
+	 */
+	valuesPtr->values = Blt_VecData(srcPtr->vecPtr);
+	if ((valuesPtr->nValues <= Blt_VecLength(srcPtr->vecPtr)) &&
+	    (valuesPtr->nValues <= Blt_VecSize(srcPtr->vecPtr))) {
+	    return;
+	}
+	valuesPtr->nValues = valuesPtr->nLogValues = 0;
+	valuesPtr->nUnchanged = valuesPtr->nIncreasing = 0;
+	ResetElementExtents(elemPtr);
+    } else if (notify == BLT_VECTOR_NOTIFY_DESTROY) {
 	FreeDataValues(valuesPtr);
+	ResetElementExtents(elemPtr);
     } else {
-	Blt_Vector *vector;
-	
-	Blt_GetVectorById(interp, valuesPtr->vectorSource.vector, &vector);
-	if (FetchVectorValues(NULL, valuesPtr, vector) != TCL_OK) {
-	    return;
+	int first;
+
+	first = Blt_VectorChangedFrom(srcPtr->vector);
+	if ((first >= Blt_VecLength(srcPtr->vecPtr)) &&
+	    (valuesPtr->nValues == Blt_VecLength(srcPtr->vecPtr))) {
+	    return;			/* Nothing changed. */
+	}
+	if ((valuesPtr->nValues > 0) && (first >= valuesPtr->nValues) &&
+	    (Blt_VecLength(srcPtr->vecPtr) > valuesPtr->nValues)) {
+	    Region2d exts1, exts2;
+
+	    /* Values were only appended to the vector. */
+	    Blt_GetElementExtents(elemPtr, &exts1);
+	    AppendVectorValues(valuesPtr, srcPtr->vecPtr);
+	    ResetElementExtents(elemPtr);
+	    Blt_GetElementExtents(elemPtr, &exts2);
+	    /* The bar layout depends upon all the x-coordinates. */
+	    resetAxes = ((elemPtr->obj.classId == CID_ELEM_BAR) ||
+			 (exts1.left != exts2.left) || 
+			 (exts1.right != exts2.right) ||
+			 (exts1.top != exts2.top) || 
+			 (exts1.bottom != exts2.bottom));
+	    appended = TRUE;
+	} else {
+	    int nLogValues, nUnchanged, nIncreasing;
+	    int cached;
+	    Region2d exts1, exts2;
+
+	    /* The logs of the values before the first changed are kept. */
+	    nLogValues = MIN(valuesPtr->nLogValues, first);
+	    nUnchanged = MIN(valuesPtr->nUnchanged, first);
+	    nIncreasing = MIN(valuesPtr->nIncreasing, first);
+	    cached = (elemPtr->flags & EXTENTS_CACHED);
+	    if (cached) {
+		Blt_GetElementExtents(elemPtr, &exts1);
+	    }
+	    FetchVectorValues(valuesPtr, srcPtr->vecPtr);
+	    valuesPtr->nLogValues = nLogValues;
+	    valuesPtr->nUnchanged = nUnchanged;
+	    valuesPtr->nIncreasing = nIncreasing;
+	    ResetElementExtents(elemPtr);
+	    if (cached) {
+		/* 
+		 * Values whose changes don't move the extents (such as the
+		 * z-values of a heatmap) don't need the axes to be reset.
+		 */
+		Blt_GetElementExtents(elemPtr, &exts2);
+		resetAxes = ((elemPtr->obj.classId == CID_ELEM_BAR) ||
+			     (exts1.left != exts2.left) || 
+			     (exts1.right != exts2.right) ||
+			     (exts1.top != exts2.top) || 
+			     (exts1.bottom != exts2.bottom));
+	    }
 	}
     }
-    {
-	Element *elemPtr = valuesPtr->elemPtr;
-	Graph *graphPtr;
-	
-	graphPtr = elemPtr->obj.graphPtr;
+    if (resetAxes) {
 	graphPtr->flags |= RESET_AXES;
-	elemPtr->flags |= MAP_ITEM;
-	if (!IGNORE_ELEMENT(elemPtr)) {
-	    graphPtr->flags |= CACHE_DIRTY;
-	    Blt_EventuallyRedrawGraph(graphPtr);
+    }
+    elemPtr->flags |= MAP_ITEM;
+    if (!IGNORE_ELEMENT(elemPtr)) {
+	if ((appended) && (graphPtr->classId == CID_ELEM_STRIP) &&
+	    (!graphPtr->layered)) {
+	    /* The stripchart may only need to be scrolled. */
+	    graphPtr->flags |= APPEND_PENDING;
+	} else {
+	    InvalidateElement(graphPtr, elemPtr);
 	}
+	Blt_EventuallyRedrawGraph(graphPtr);
     }
 }
 
@@ -254,23 +451,68 @@ GetVectorData(Tcl_Interp *interp, ElemValues *valuesPtr, const char *vecName)
     if (Blt_GetVectorById(interp, srcPtr->vector, &vecPtr) != TCL_OK) {
 	return TCL_ERROR;
     }
-    if (FetchVectorValues(interp, valuesPtr, vecPtr) != TCL_OK) {
-	FreeVectorSource(valuesPtr);
-	return TCL_ERROR;
-    }
+    srcPtr->vecPtr = vecPtr;
     Blt_SetVectorChangedProc(srcPtr->vector, VectorChangedProc, valuesPtr);
+    Blt_PinVector(srcPtr->vector, TRUE);
+    FetchVectorValues(valuesPtr, vecPtr);
     valuesPtr->type = ELEM_SOURCE_VECTOR;
     return TCL_OK;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetValuesEpoch --
+ *
+ *	Returns the epoch of the time scale axis the values are mapped to,
+ *	or 0 if they aren't mapped to a time scale axis.
+ *
+ *---------------------------------------------------------------------------
+ */
+static long
+GetValuesEpoch(ElemValues *valuesPtr)
+{
+    Element *elemPtr = valuesPtr->elemPtr;
+    Axis *axisPtr;
+
+    if (valuesPtr == &elemPtr->x) {
+	axisPtr = elemPtr->axes.x;
+    } else if (valuesPtr == &elemPtr->y) {
+	axisPtr = elemPtr->axes.y;
+    } else {
+	return 0;
+    }
+    if ((axisPtr == NULL) || (!axisPtr->timeScale) || (axisPtr->logScale)) {
+	return 0;
+    }
+    return axisPtr->epoch;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FetchTableValues --
+ *
+ *	Copies the values of the datatable column.  The values of integer
+ *	columns may be 64-bit times, such as nanoseconds since 1970, that
+ *	don't fit in a double.  If they are mapped to a time scale axis,
+ *	its epoch is subtracted before they are converted, so that times
+ *	near the epoch are exact.
+ *
+ *---------------------------------------------------------------------------
+ */
 static int
 FetchTableValues(Tcl_Interp *interp, ElemValues *valuesPtr, Blt_TableColumn col)
 {
     long i, j;
     double *array;
     Blt_Table table;
+    long epoch;
+    int isLong;
 
     table = valuesPtr->tableSource.table;
+    epoch = GetValuesEpoch(valuesPtr);
+    isLong = (Blt_Table_ColumnType(col) == TABLE_COLUMN_TYPE_LONG);
     array = Blt_Malloc(sizeof(double) * Blt_Table_NumRows(table));
     if (array == NULL) {
 	return TCL_ERROR;
@@ -280,7 +522,14 @@ FetchTableValues(Tcl_Interp *interp, ElemValues *valuesPtr, Blt_TableColumn col)
 	double value;
 
 	row = Blt_Table_FindRowByIndex(table, i);
-	value = Blt_Table_GetDouble(table, row, col);
+	if (isLong) {
+	    if (!Blt_Table_ValueExists(table, row, col)) {
+		continue;
+	    }
+	    value = (double)(Blt_Table_GetLong(table, row, col, 0) - epoch);
+	} else {
+	    value = Blt_Table_GetDouble(table, row, col);
+	}
 	if (FINITE(value)) {
 	    array[j] = value;
 	    j++;
@@ -291,10 +540,55 @@ FetchTableValues(Tcl_Interp *interp, ElemValues *valuesPtr, Blt_TableColumn col)
     }
     valuesPtr->nValues = j;
     valuesPtr->values = array;
+    valuesPtr->nLogValues = valuesPtr->nUnchanged = 0;
+    valuesPtr->nIncreasing = 0;
+    valuesPtr->epoch = (isLong) ? epoch : 0;
     FindRange(valuesPtr);
     return TCL_OK;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_UpdateElementEpochs --
+ *
+ *	Refetches the values of integer datatable columns if the epoch of
+ *	the time scale axis they are mapped to has changed (or they are now
+ *	mapped to a different axis) since they were fetched.  Called before
+ *	the axes are reset.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_UpdateElementEpochs(Element *elemPtr)
+{
+    ElemValues *valuesPtr;
+    int i;
+
+    for (i = 0, valuesPtr = &elemPtr->x; i < 2; i++, valuesPtr = &elemPtr->y) {
+	Blt_TableColumn col;
+
+	if (valuesPtr->type != ELEM_SOURCE_TABLE) {
+	    continue;
+	}
+	col = valuesPtr->tableSource.column;
+	if ((Blt_Table_ColumnType(col) != TABLE_COLUMN_TYPE_LONG) ||
+	    (valuesPtr->epoch == GetValuesEpoch(valuesPtr))) {
+	    continue;
+	}
+	if (FetchTableValues(elemPtr->obj.graphPtr->interp, valuesPtr, col) 
+	    != TCL_OK) {
+	    continue;
+	}
+	ResetElementExtents(elemPtr);
+	elemPtr->flags |= MAP_ITEM;
+	InvalidateElement(elemPtr->obj.graphPtr, elemPtr);
+    }
+}
+
 static void
 FreeTableSource(ElemValues *valuesPtr)
 {
@@ -356,10 +650,11 @@ TableNotifyProc(ClientData clientData, Blt_TableNotifyEvent *eventPtr)
 	return TCL_ERROR;
     } 
     /* Always redraw the element. */
+    ResetElementExtents(elemPtr);
     graphPtr->flags |= RESET_AXES;
     elemPtr->flags |= MAP_ITEM;
     if (!IGNORE_ELEMENT(elemPtr)) {
-	graphPtr->flags |= CACHE_DIRTY;
+	InvalidateElement(graphPtr, elemPtr);
 	Blt_EventuallyRedrawGraph(graphPtr);
     }
     return TCL_OK;
@@ -395,10 +690,11 @@ TableTraceProc(ClientData clientData, Blt_TableTraceEvent *eventPtr)
 	FreeTableSource(valuesPtr);
 	return TCL_ERROR;
     }
+    ResetElementExtents(elemPtr);
     graphPtr->flags |= RESET_AXES;
     elemPtr->flags |= MAP_ITEM;
     if (!IGNORE_ELEMENT(elemPtr)) {
-	graphPtr->flags |= CACHE_DIRTY;
+	InvalidateElement(graphPtr, elemPtr);
 	Blt_EventuallyRedrawGraph(graphPtr);
     }
     return TCL_OK;
@@ -500,8 +796,14 @@ FreeDataValues(ElemValues *valuesPtr)
     if (valuesPtr->values != NULL) {
 	Blt_Free(valuesPtr->values);
     }
+    if (valuesPtr->logValues != NULL) {
+	Blt_Free(valuesPtr->logValues);
+	valuesPtr->logValues = NULL;
+    }
     valuesPtr->values = NULL;
-    valuesPtr->nValues = 0;
+    valuesPtr->nValues = valuesPtr->nLogValues = 0;
+    valuesPtr->nUnchanged = valuesPtr->nIncreasing = 0;
+    valuesPtr->logArraySize = 0;
     valuesPtr->type = ELEM_SOURCE_VALUES;
 }
 
@@ -597,6 +899,86 @@ Blt_FindElemValuesMinimum(ElemValues *valuesPtr, double minLimit)
     return min;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_GetLogValues --
+ *
+ *	Returns the log10 of the absolute values, as mapped to a log scale
+ *	axis.  Zero maps to zero, like Blt_HMap and Blt_VMap.  The logs are
+ *	kept until the values change, so only values that are new since
+ *	the last call are computed.
+ *
+ * Results:
+ *	Returns the array of logs, or NULL if there are no values.
+ *
+ *---------------------------------------------------------------------------
+ */
+double *
+Blt_GetLogValues(ElemValues *valuesPtr)
+{
+    double *vp, *vend, *lp;
+
+    if (valuesPtr->nValues == 0) {
+	return NULL;
+    }
+    if (valuesPtr->logArraySize < valuesPtr->nValues) {
+	double *array;
+
+	array = Blt_AssertMalloc(valuesPtr->nValues * sizeof(double));
+	if (valuesPtr->logValues != NULL) {
+	    memcpy(array, valuesPtr->logValues, 
+		   valuesPtr->nLogValues * sizeof(double));
+	    Blt_Free(valuesPtr->logValues);
+	}
+	valuesPtr->logValues = array;
+	valuesPtr->logArraySize = valuesPtr->nValues;
+    }
+    lp = valuesPtr->logValues + valuesPtr->nLogValues;
+    for (vp = valuesPtr->values + valuesPtr->nLogValues, 
+	     vend = valuesPtr->values + valuesPtr->nValues; vp < vend; 
+	 vp++, lp++) {
+	*lp = (*vp != 0.0) ? log10(FABS(*vp)) : 0.0;
+    }
+    valuesPtr->nLogValues = valuesPtr->nValues;
+    return valuesPtr->logValues;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_GetElementExtents --
+ *
+ *	Returns the extents of the element's data.  The extents are cached
+ *	and only recomputed when the element's data or configuration, or
+ *	the log scale of its axes, has changed.
+ *
+ * Results:
+ *	The extents are returned via extsPtr.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_GetElementExtents(Element *elemPtr, Region2d *extsPtr)
+{
+    int logScale;
+
+    logScale = 0;
+    if (elemPtr->axes.x->logScale) {
+	logScale |= 0x1;
+    }
+    if (elemPtr->axes.y->logScale) {
+	logScale |= 0x2;
+    }
+    if (((elemPtr->flags & EXTENTS_CACHED) == 0) || 
+	(elemPtr->extsLogScale != logScale)) {
+	(*elemPtr->procsPtr->extentsProc) (elemPtr, &elemPtr->exts);
+	elemPtr->extsLogScale = logScale;
+	elemPtr->flags |= EXTENTS_CACHED;
+    }
+    *extsPtr = elemPtr->exts;
+}
+
 /*ARGSUSED*/
 static void
 FreeValues(
@@ -1258,7 +1640,7 @@ DestroyElement(Element *elemPtr)
     if (elemPtr->link != NULL) {
 	Blt_Chain_DeleteLink(graphPtr->elements.displayList, elemPtr->link);
 	if (!IGNORE_ELEMENT(elemPtr)) {
-	    graphPtr->flags |= RESET_WORLD;
+	    graphPtr->flags |= RESET_WORLD | CACHE_DIRTY | RESET_BAR_SETS;
 	    Blt_EventuallyRedrawGraph(graphPtr);
 	}
     }
@@ -1318,6 +1700,8 @@ CreateElement(Graph *graphPtr, Tcl_Interp *interp, int objc,
     }
     if (classId == CID_ELEM_BAR) {
 	elemPtr = Blt_BarElement(graphPtr, string, classId);
+    } else if (classId == CID_ELEM_HEATMAP) {
+	elemPtr = Blt_HeatmapElement(graphPtr, string, classId);
     } else { 
 	/* Stripcharts are line graphs with some options enabled. */	
 	elemPtr = Blt_LineElement(graphPtr, string, classId);
@@ -1334,10 +1718,11 @@ CreateElement(Graph *graphPtr, Tcl_Interp *interp, int objc,
     }
     (*elemPtr->procsPtr->configProc) (graphPtr, elemPtr);
     elemPtr->link = Blt_Chain_Append(graphPtr->elements.displayList, elemPtr);
-    graphPtr->flags |= CACHE_DIRTY;
+    graphPtr->flags |= CACHE_DIRTY | RESET_BAR_SETS;
     Blt_EventuallyRedrawGraph(graphPtr);
     elemPtr->flags |= MAP_ITEM;
-    graphPtr->flags |= RESET_AXES;
+    /* The legend has a new entry. */
+    graphPtr->flags |= RESET_WORLD;
     Tcl_SetObjResult(interp, objv[3]);
     return TCL_OK;
 }
@@ -1390,14 +1775,325 @@ Blt_ConfigureElements(Graph *graphPtr)
     }
 }
 
-void
-Blt_MapElements(Graph *graphPtr)
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MapElement --
+ *
+ *	Maps the element, timing how long it takes.  This may be called
+ *	from a worker thread, so only the element is updated.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+MapElement(Graph *graphPtr, Element *elemPtr)
+{
+    Tcl_WideInt start;
+
+    start = Blt_PerfClock();
+    elemPtr->nDrawnPoints = 0;
+    (*elemPtr->procsPtr->mapProc) (graphPtr, elemPtr);
+    elemPtr->mapPerf.usecs += Blt_PerfClock() - start;
+    elemPtr->mapPerf.count++;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * CountMappedPoints --
+ *
+ *	Adds the points of the newly mapped element to the graph's
+ *	statistics.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+CountMappedPoints(Graph *graphPtr, Element *elemPtr, int nPoints)
+{
+    GraphPerf *perfPtr = &graphPtr->perf;
+
+    perfPtr->nPointsMapped += nPoints;
+    perfPtr->nPointsDrawn += elemPtr->nDrawnPoints;
+    perfPtr->current.nPointsMapped += nPoints;
+    perfPtr->current.nPointsDrawn += elemPtr->nDrawnPoints;
+}
+
+#ifdef BLT_MAP_THREADS
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MapBatch --
+ *
+ *	Maps elements of the pool's current batch until there are none
+ *	left.  The pool's mutex must be held by the caller.  It's released
+ *	while each element is mapped.
+ *
+ * Side Effects:
+ *	Signals the waiting thread when the last element is mapped.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+MapBatch(MapPool *poolPtr)
+{
+    while (poolPtr->next < poolPtr->nElements) {
+	Element *elemPtr;
+
+	elemPtr = poolPtr->elements[poolPtr->next];
+	poolPtr->next++;
+	Tcl_MutexUnlock(&poolPtr->mutex);
+	MapElement(poolPtr->graphPtr, elemPtr);
+	Tcl_MutexLock(&poolPtr->mutex);
+	poolPtr->nDone++;
+	if (poolPtr->nDone == poolPtr->nElements) {
+	    Tcl_ConditionNotify(&poolPtr->workDone);
+	}
+    }
+}
+
+static Tcl_ThreadCreateType
+MapThreadProc(ClientData clientData)
+{
+    MapPool *poolPtr = clientData;
+
+    /* 
+     * Wait on the state of the pool rather than for a notification.  A
+     * worker started for a batch may not get the mutex until after the
+     * batch was signaled, but it will still find elements left to map.
+     */
+    Tcl_MutexLock(&poolPtr->mutex);
+    for (;;) {
+	while ((!poolPtr->shutdown) && 
+	       ((!poolPtr->busy) || (poolPtr->next >= poolPtr->nElements))) {
+	    Tcl_ConditionWait(&poolPtr->workReady, &poolPtr->mutex, NULL);
+	}
+	if (poolPtr->shutdown) {
+	    break;
+	}
+	MapBatch(poolPtr);
+    }
+    Tcl_MutexUnlock(&poolPtr->mutex);
+    TCL_THREAD_CREATE_RETURN;
+}
+
+static void
+MapPoolExitProc(ClientData clientData)
+{
+    MapPool *poolPtr = clientData;
+    int i;
+
+    Tcl_MutexLock(&poolPtr->mutex);
+    poolPtr->shutdown = TRUE;
+    Tcl_ConditionNotify(&poolPtr->workReady);
+    Tcl_MutexUnlock(&poolPtr->mutex);
+    for (i = 0; i < poolPtr->nThreads; i++) {
+	int result;
+
+	Tcl_JoinThread(poolPtr->threads[i], &result);
+    }
+    poolPtr->nThreads = 0;
+    Tcl_ConditionFinalize(&poolPtr->workReady);
+    Tcl_ConditionFinalize(&poolPtr->workDone);
+    Tcl_MutexFinalize(&poolPtr->mutex);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * NumMapThreads --
+ *
+ *	Returns the number of threads to map the graph's elements with.
+ *	By default, this is the number of processors online.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+NumMapThreads(Graph *graphPtr)
+{
+    int nThreads;
+
+    nThreads = graphPtr->nMapThreads;
+    if (nThreads == 0) {
+	nThreads = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+	nThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif /* _SC_NPROCESSORS_ONLN */
+    }
+    if (nThreads < 1) {
+	nThreads = 1;
+    } else if (nThreads > MAX_MAP_THREADS) {
+	nThreads = MAX_MAP_THREADS;
+    }
+    return nThreads;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MapElementsInParallel --
+ *
+ *	Maps the given elements using the pool of worker threads.  The
+ *	calling thread maps elements too and returns once all of them are
+ *	mapped.  Graph and axis state is only read while mapping.
+ *
+ * Results:
+ *	Returns TCL_OK if the elements were mapped and TCL_ERROR if they
+ *	weren't (the pool is in use by another thread or no worker could be
+ *	started), in which case the caller maps them.
+ *
+ * Side Effects:
+ *	Worker threads are started as needed, up to the graph's
+ *	-mapthreads.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+MapElementsInParallel(Graph *graphPtr, Element **elements, int nElements)
+{
+    MapPool *poolPtr = &mapPool;
+    int nThreads;
+
+    nThreads = NumMapThreads(graphPtr) - 1;
+    Tcl_MutexLock(&poolPtr->mutex);
+    if ((poolPtr->busy) || (poolPtr->shutdown)) {
+	Tcl_MutexUnlock(&poolPtr->mutex);
+	return TCL_ERROR;
+    }
+    if (poolPtr->nThreads == 0) {
+	Tcl_CreateExitHandler(MapPoolExitProc, poolPtr);
+    }
+    while (poolPtr->nThreads < nThreads) {
+	if (Tcl_CreateThread(poolPtr->threads + poolPtr->nThreads, 
+		MapThreadProc, poolPtr, TCL_THREAD_STACK_DEFAULT, 
+		TCL_THREAD_JOINABLE) != TCL_OK) {
+	    break;
+	}
+	poolPtr->nThreads++;
+    }
+    if (poolPtr->nThreads == 0) {
+	Tcl_DeleteExitHandler(MapPoolExitProc, poolPtr);
+	Tcl_MutexUnlock(&poolPtr->mutex);
+	return TCL_ERROR;
+    }
+    poolPtr->busy = TRUE;
+    poolPtr->graphPtr = graphPtr;
+    poolPtr->elements = elements;
+    poolPtr->nElements = nElements;
+    poolPtr->next = poolPtr->nDone = 0;
+    Tcl_ConditionNotify(&poolPtr->workReady);
+    MapBatch(poolPtr);
+    while (poolPtr->nDone < poolPtr->nElements) {
+	Tcl_ConditionWait(&poolPtr->workDone, &poolPtr->mutex, NULL);
+    }
+    poolPtr->graphPtr = NULL;
+    poolPtr->elements = NULL;
+    poolPtr->nElements = poolPtr->next = poolPtr->nDone = 0;
+    poolPtr->busy = FALSE;
+    Tcl_MutexUnlock(&poolPtr->mutex);
+    return TCL_OK;
+}
+#endif /* BLT_MAP_THREADS */
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ScrollElements --
+ *
+ *	Scrolls the elements when the plot has only slid horizontally
+ *	(see the SCROLL_PLOT flag).  Each element shifts its screen
+ *	coordinates and maps only its new points.  An element that can't
+ *	be scrolled is mapped anew, and the plot is then redrawn in full.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ScrollElements(Graph *graphPtr)
 {
     Blt_ChainLink link;
 
-    if (graphPtr->mode != BARS_INFRONT) {
-	Blt_ResetBarGroups(graphPtr);
+    for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList); 
+	 link != NULL; link = Blt_Chain_NextLink(link)) {
+	Element *elemPtr;
+
+	elemPtr = Blt_Chain_GetValue(link);
+	elemPtr->flags &= ~SCROLLED;
+    }
+    for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList); 
+	 link != NULL; link = Blt_Chain_NextLink(link)) {
+	Element *elemPtr;
+	Tcl_WideInt start;
+	int nPoints;
+
+	elemPtr = Blt_Chain_GetValue(link);
+	if (IGNORE_ELEMENT(elemPtr)) {
+	    continue;
+	}
+	if (((graphPtr->flags & MAP_ALL) == 0) && 
+	    ((elemPtr->flags & MAP_ITEM) == 0)) {
+	    continue;
+	}
+	nPoints = -1;
+	if ((graphPtr->flags & SCROLL_PLOT) && 
+	    (elemPtr->procsPtr->scrollProc != NULL)) {
+	    start = Blt_PerfClock();
+	    nPoints = (*elemPtr->procsPtr->scrollProc)(graphPtr, elemPtr, 
+		graphPtr->scrollDx);
+	    elemPtr->mapPerf.usecs += Blt_PerfClock() - start;
+	    elemPtr->mapPerf.count++;
+	}
+	if (nPoints >= 0) {
+	    elemPtr->flags |= SCROLLED;
+	} else {
+	    graphPtr->flags &= ~SCROLL_PLOT;
+	    graphPtr->flags |= CACHE_DIRTY;
+	    MapElement(graphPtr, elemPtr);
+	    nPoints = NUMBEROFPOINTS(elemPtr);
+	}
+	CountMappedPoints(graphPtr, elemPtr, nPoints);
+	elemPtr->flags &= ~MAP_ITEM;
     }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_MapElements --
+ *
+ *	Maps the elements that need it to screen coordinates.  Line and
+ *	strip elements, which are mapped independently of each other, are
+ *	farmed out to worker threads when there's enough data.  Bar elements
+ *	are always mapped by the calling thread.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_MapElements(Graph *graphPtr)
+{
+    Blt_ChainLink link;
+#ifdef BLT_MAP_THREADS
+    Element **elements;
+    int nElements;
+    long nPoints;
+#endif /* BLT_MAP_THREADS */
+
+    if (graphPtr->flags & SCROLL_PLOT) {
+	ScrollElements(graphPtr);
+	return;
+    }
+#ifdef BLT_MAP_THREADS
+    elements = NULL;
+    nElements = 0;
+    nPoints = 0;
+    if ((NumMapThreads(graphPtr) > 1) && 
+	(Blt_Chain_GetLength(graphPtr->elements.displayList) > 1)) {
+	elements = Blt_AssertMalloc(sizeof(Element *) * 
+		Blt_Chain_GetLength(graphPtr->elements.displayList));
+    }
+#endif /* BLT_MAP_THREADS */
     for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList); 
 	 link != NULL; link = Blt_Chain_NextLink(link)) {
 	Element *elemPtr;
@@ -1407,10 +2103,139 @@ Blt_MapElements(Graph *graphPtr)
 	    continue;
 	}
 	if ((graphPtr->flags & MAP_ALL) || (elemPtr->flags & MAP_ITEM)) {
-	    (*elemPtr->procsPtr->mapProc) (graphPtr, elemPtr);
+#ifdef BLT_MAP_THREADS
+	    if ((elements != NULL) && 
+		((elemPtr->obj.classId == CID_ELEM_LINE) ||
+		 (elemPtr->obj.classId == CID_ELEM_STRIP))) {
+		elements[nElements] = elemPtr;
+		nElements++;
+		nPoints += NUMBEROFPOINTS(elemPtr);
+		continue;
+	    }
+#endif /* BLT_MAP_THREADS */
+	    MapElement(graphPtr, elemPtr);
+	    CountMappedPoints(graphPtr, elemPtr, NUMBEROFPOINTS(elemPtr));
 	    elemPtr->flags &= ~MAP_ITEM;
 	}
     }
+#ifdef BLT_MAP_THREADS
+    if (elements != NULL) {
+	int i;
+
+	if ((nElements < 2) || (nPoints < MIN_THREADED_POINTS) ||
+	    (MapElementsInParallel(graphPtr, elements, nElements) != TCL_OK)) {
+	    for (i = 0; i < nElements; i++) {
+		MapElement(graphPtr, elements[i]);
+	    }
+	}
+	for (i = 0; i < nElements; i++) {
+	    CountMappedPoints(graphPtr, elements[i], 
+		NUMBEROFPOINTS(elements[i]));
+	    elements[i]->flags &= ~MAP_ITEM;
+	}
+	Blt_Free(elements);
+    }
+#endif /* BLT_MAP_THREADS */
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FirstLiveLink --
+ *
+ *	Returns the link of the lowest element in the stacking order that
+ *	is drawn over the graph's cache pixmap.  The elements stacked
+ *	above it are drawn over the pixmap too.
+ *
+ * Results:
+ *	The link of the first live element or NULL if all the elements are
+ *	drawn into the cache pixmap.
+ *
+ *---------------------------------------------------------------------------
+ */
+static Blt_ChainLink
+FirstLiveLink(Graph *graphPtr)
+{
+    Blt_ChainLink link;
+
+    if (!graphPtr->layered) {
+	return NULL;
+    }
+    for (link = Blt_Chain_LastLink(graphPtr->elements.displayList); 
+	 link != NULL; link = Blt_Chain_PrevLink(link)) {
+	Element *elemPtr;
+
+	elemPtr = Blt_Chain_GetValue(link);
+	if (elemPtr->flags & LAYER_LIVE) {
+	    break;
+	}
+    }
+    return link;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_UpdateElementLayers --
+ *
+ *	Decides which elements of a layered graph are drawn into the cache
+ *	pixmap.  The cache holds the elements stacked below the first live
+ *	element.  An element changing below that point becomes live
+ *	itself, so the cache is redrawn once without it and afterwards
+ *	only the live elements are redrawn.  When the cache is redrawn for
+ *	some other reason (the axes or window changed), live elements that
+ *	haven't changed since the last time are put back into the cache.
+ *
+ * Results:
+ *	None.
+ *
+ * Side Effects:
+ *	The CACHE_DIRTY flag is set if the cache pixmap must be redrawn.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_UpdateElementLayers(Graph *graphPtr)
+{
+    Blt_ChainLink link;
+    int below;
+
+    if (!graphPtr->layered) {
+	return;
+    }
+    if (graphPtr->flags & CACHE_DIRTY) {
+	for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList); 
+	     link != NULL; link = Blt_Chain_NextLink(link)) {
+	    Element *elemPtr;
+
+	    elemPtr = Blt_Chain_GetValue(link);
+	    if ((elemPtr->flags & (LAYER_LIVE|LAYER_UPDATED|LAYER_DIRTY)) ==
+		LAYER_LIVE) {
+		elemPtr->flags &= ~LAYER_LIVE;
+	    }
+	    elemPtr->flags &= ~LAYER_UPDATED;
+	}
+    }
+    below = TRUE;
+    for (link = Blt_Chain_LastLink(graphPtr->elements.displayList); 
+	 link != NULL; link = Blt_Chain_PrevLink(link)) {
+	Element *elemPtr;
+
+	elemPtr = Blt_Chain_GetValue(link);
+	if (elemPtr->flags & LAYER_LIVE) {
+	    below = FALSE;
+	}
+	if (elemPtr->flags & LAYER_DIRTY) {
+	    if (below) {
+		/* The element's old drawing is in the cache pixmap. */
+		elemPtr->flags |= LAYER_LIVE;
+		graphPtr->flags |= CACHE_DIRTY;
+		below = FALSE;
+	    }
+	    elemPtr->flags &= ~LAYER_DIRTY;
+	    elemPtr->flags |= LAYER_UPDATED;
+	}
+    }
 }
 
 /*
@@ -1419,7 +2244,8 @@ Blt_MapElements(Graph *graphPtr)
  * Blt_DrawElements --
  *
  *	Calls the individual element drawing routines for each
- *	element.
+ *	element.  If the graph is layered, only the elements below the
+ *	live elements are drawn.
  *
  * Results:
  *	None
@@ -1432,6 +2258,37 @@ Blt_MapElements(Graph *graphPtr)
  */
 void
 Blt_DrawElements(Graph *graphPtr, Drawable drawable)
+{
+    Blt_ChainLink link, live;
+
+    live = FirstLiveLink(graphPtr);
+    /* Draw with respect to the stacking order. */
+    for (link = Blt_Chain_LastLink(graphPtr->elements.displayList); 
+	 link != live; link = Blt_Chain_PrevLink(link)) {
+	Element *elemPtr;
+
+	elemPtr = Blt_Chain_GetValue(link);
+	if ((elemPtr->flags & (HIDE|DELETE_PENDING)) == 0) {
+	    (*elemPtr->procsPtr->drawNormalProc)(graphPtr, drawable, elemPtr);
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_DrawScrolledElements --
+ *
+ *	Draws the new segments and symbols of the elements scrolled by
+ *	ScrollElements into the scrolled cache pixmap.
+ *
+ * Results:
+ *	None
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_DrawScrolledElements(Graph *graphPtr, Drawable drawable)
 {
     Blt_ChainLink link;
 
@@ -1440,6 +2297,40 @@ Blt_DrawElements(Graph *graphPtr, Drawable drawable)
 	 link != NULL; link = Blt_Chain_PrevLink(link)) {
 	Element *elemPtr;
 
+	elemPtr = Blt_Chain_GetValue(link);
+	if ((elemPtr->flags & (HIDE|DELETE_PENDING|SCROLLED)) == SCROLLED) {
+	    (*elemPtr->procsPtr->drawScrolledProc)(graphPtr, drawable, elemPtr);
+	}
+	elemPtr->flags &= ~SCROLLED;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_DrawLiveElements --
+ *
+ *	Draws the live elements of a layered graph.  These are the
+ *	elements left out of the cache pixmap by Blt_DrawElements.
+ *
+ * Results:
+ *	None
+ *
+ * Side Effects:
+ *	Elements are drawn into the drawable (pixmap) which will
+ *	eventually be displayed in the graph window.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_DrawLiveElements(Graph *graphPtr, Drawable drawable)
+{
+    Blt_ChainLink link;
+
+    for (link = FirstLiveLink(graphPtr); link != NULL; 
+	 link = Blt_Chain_PrevLink(link)) {
+	Element *elemPtr;
+
 	elemPtr = Blt_Chain_GetValue(link);
 	if ((elemPtr->flags & (HIDE|DELETE_PENDING)) == 0) {
 	    (*elemPtr->procsPtr->drawNormalProc)(graphPtr, drawable, elemPtr);
@@ -1480,6 +2371,45 @@ Blt_DrawActiveElements(Graph *graphPtr, Drawable drawable)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_ElementsToPicture --
+ *
+ *	Paints the elements into the picture, in stacking order, without
+ *	drawing through X.  Only elements whose type has a picture
+ *	procedure can be painted, and only in their normal colors.
+ *
+ * Results:
+ *	Returns 1 if every displayed element was painted.  Otherwise 0 is
+ *	returned and the graph must be drawn through X instead.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_ElementsToPicture(Graph *graphPtr, Blt_Picture picture)
+{
+    Blt_ChainLink link;
+
+    for (link = Blt_Chain_LastLink(graphPtr->elements.displayList); 
+	 link != NULL; link = Blt_Chain_PrevLink(link)) {
+	Element *elemPtr;
+
+	elemPtr = Blt_Chain_GetValue(link);
+	if (elemPtr->flags & (HIDE|DELETE_PENDING)) {
+	    continue;
+	}
+	if ((elemPtr->flags & ACTIVE) || 
+	    (elemPtr->procsPtr->pictureProc == NULL)) {
+	    return FALSE;
+	}
+	if (!(*elemPtr->procsPtr->pictureProc)(graphPtr, picture, elemPtr)) {
+	    return FALSE;
+	}
+    }
+    return TRUE;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1932,8 +2862,9 @@ ConfigureOp(
 	if ((*elemPtr->procsPtr->configProc) (graphPtr, elemPtr) != TCL_OK) {
 	    return TCL_ERROR;	/* Failed to configure element */
 	}
+	ResetElementExtents(elemPtr);
 	if (Blt_ConfigModified(elemPtr->configSpecs, "-hide", (char *)NULL)) {
-	    graphPtr->flags |= RESET_AXES;
+	    graphPtr->flags |= RESET_WORLD;
 	    elemPtr->flags |= MAP_ITEM;
 	}
 	/* If data points or axes have changed, reset the axes (may
@@ -1945,13 +2876,30 @@ ConfigureOp(
 	    graphPtr->flags |= RESET_WORLD;
 	    elemPtr->flags |= MAP_ITEM;
 	}
+	/* 
+	 * If the element was moved to other axes, the limits of the old and
+	 * new axes may be unchanged, but the axes in use and so the layout
+	 * may be different.  Always remap and lay out the whole graph.
+	 */
+	if (Blt_ConfigModified(elemPtr->configSpecs, "-map*", (char *)NULL)) {
+	    graphPtr->flags |= (RESET_AXES | MAP_ALL | GET_AXIS_GEOMETRY | 
+				LAYOUT_NEEDED | CACHE_DIRTY);
+	}
 	/* The new label may change the size of the legend */
 	if (Blt_ConfigModified(elemPtr->configSpecs, "-label", (char *)NULL)) {
-	    graphPtr->flags |= (MAP_WORLD | REDRAW_WORLD);
+	    graphPtr->flags |= (MAP_WORLD | REDRAW_WORLD | CACHE_DIRTY);
+	}
+	/* 
+	 * Update the pixmap if any configuration option changed.  The
+	 * legend is drawn into the pixmap too, so all of it is redrawn if
+	 * the element has an entry there.
+	 */
+	if ((elemPtr->label == NULL) || (Blt_Legend_IsHidden(graphPtr))) {
+	    InvalidateElement(graphPtr, elemPtr);
+	} else {
+	    graphPtr->flags |= CACHE_DIRTY;
 	}
     }
-    /* Update the pixmap if any configuration option changed */
-    graphPtr->flags |= CACHE_DIRTY;
     Blt_EventuallyRedrawGraph(graphPtr);
     return TCL_OK;
 }
@@ -2165,7 +3113,7 @@ LowerOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     }	
     Blt_Chain_Destroy(chain);
     Tcl_SetObjResult(interp, DisplayListObj(graphPtr));
-    graphPtr->flags |= RESET_WORLD;
+    graphPtr->flags |= RESET_WORLD | CACHE_DIRTY | RESET_BAR_SETS;
     Blt_EventuallyRedrawGraph(graphPtr);
     return TCL_OK;
 }
@@ -2276,7 +3224,7 @@ RaiseOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     }	
     Blt_Chain_Destroy(chain);
     Tcl_SetObjResult(interp, DisplayListObj(graphPtr));
-    graphPtr->flags |= RESET_WORLD;
+    graphPtr->flags |= RESET_WORLD | CACHE_DIRTY | RESET_BAR_SETS;
     Blt_EventuallyRedrawGraph(graphPtr);
     return TCL_OK;
 }
@@ -2339,7 +3287,7 @@ ShowOp(
 	    elemPtr = Blt_Chain_GetValue(link);
 	    elemPtr->link = link;
 	}
-	graphPtr->flags |= RESET_WORLD;
+	graphPtr->flags |= RESET_WORLD | CACHE_DIRTY | RESET_BAR_SETS;
 	Blt_EventuallyRedrawGraph(graphPtr);
     }
     Tcl_SetObjResult(interp, DisplayListObj(graphPtr));
@@ -2378,6 +3326,7 @@ TypeOp(
     switch (elemPtr->obj.classId) {
     case CID_ELEM_BAR:		string = "bar";		break;
     case CID_ELEM_CONTOUR:	string = "contour";	break;
+    case CID_ELEM_HEATMAP:	string = "heatmap";	break;
     case CID_ELEM_LINE:		string = "line";	break;
     case CID_ELEM_STRIP:	string = "strip";	break;
     default:			string = "???";		break;
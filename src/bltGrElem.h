@@ -56,6 +56,18 @@
 				 * in the legend should be drawn in its active
 				 * foreground and background colors. */
 #define SCALE_SYMBOL	(1<<10)
+#define LAYER_DIRTY	(1<<11)	/* The element has changed since the graph
+				 * was last displayed. */
+#define LAYER_LIVE	(1<<12)	/* The element (and every element stacked
+				 * above it) is drawn over the graph's cache
+				 * pixmap rather than into it. */
+#define LAYER_UPDATED	(1<<13)	/* The element has changed since the cache
+				 * pixmap was last redrawn. */
+#define EXTENTS_CACHED	(1<<14)	/* The element's cached data extents are
+				 * current. */
+#define SCROLLED	(1<<15)	/* The element was scrolled rather than
+				 * remapped, so only its new segments and
+				 * symbols need to be drawn. */
 
 #define NUMBEROFPOINTS(e)	MIN((e)->x.nValues, (e)->y.nValues)
 
@@ -146,6 +158,8 @@ typedef int (ElementConfigProc) (Graph *graphPtr, Element *elemPtr);
 
 typedef void (ElementMapProc) (Graph *graphPtr, Element *elemPtr);
 
+typedef int (ElementScrollProc) (Graph *graphPtr, Element *elemPtr, int dx);
+
 typedef void (ElementExtentsProc) (Element *elemPtr, Region2d *extsPtr);
 
 typedef void (ElementClosestProc) (Graph *graphPtr, Element *elemPtr, 
@@ -157,6 +171,9 @@ typedef void (ElementDrawSymbolProc) (Graph *graphPtr, Drawable drawable,
 typedef void (ElementSymbolToPostScriptProc) (Graph *graphPtr, 
 	Blt_Ps ps, Element *elemPtr, double x, double y, int symSize);
 
+typedef int (ElementToPictureProc) (Graph *graphPtr, Blt_Picture picture, 
+	Element *elemPtr);
+
 typedef struct {
     ElementClosestProc *closestProc;
     ElementConfigProc *configProc;
@@ -169,10 +186,15 @@ typedef struct {
     ElementToPostScriptProc *printNormalProc;
     ElementSymbolToPostScriptProc *printSymbolProc;
     ElementMapProc *mapProc;
+    ElementScrollProc *scrollProc;
+    ElementDrawProc *drawScrolledProc;
+    ElementToPictureProc *pictureProc;
 } ElementProcs;
 
 typedef struct {
     Blt_VectorId vector;
+    Blt_Vector *vecPtr;			/* Vector whose array is referenced
+					 * (pinned) by the element. */
 } VectorDataSource;
 
 typedef struct {
@@ -192,7 +214,8 @@ typedef struct {
 /* 
  * The data structure below contains information pertaining to a line vector.
  * It consists of an array of floating point data values and for convenience,
- * the number and minimum/maximum values.
+ * the number and minimum/maximum values.  When the values come from a
+ * vector, the array is the vector's own storage, not a copy.
  */
 typedef struct {
     int type;			/* Selects the type of data populating this
@@ -208,6 +231,23 @@ typedef struct {
     int nValues;
     int arraySize;
     double min, max;
+    double *logValues;		/* Log10 of the values, used to map them to
+				 * log scale axes. Computed as needed. */
+    int nLogValues;		/* # of leading values whose logs in the
+				 * above array are current. */
+    int logArraySize;		/* Size of the log array. */
+    int nUnchanged;		/* # of leading values unchanged since the
+				 * element last mapped them.  Elements that
+				 * remap only the changed values reset it
+				 * once mapped. */
+    int nIncreasing;		/* # of leading values known to be
+				 * increasing (ignoring non-finite
+				 * values).  Lets a line element test
+				 * that its x-coordinates are monotonic
+				 * without rescanning unchanged values. */
+    long epoch;			/* Epoch of the time scale axis subtracted
+				 * from the values of an integer datatable
+				 * column. */
 } ElemValues;
 
 
@@ -252,10 +292,22 @@ struct _Element {
 					 * symbol. */
     int state;
     Blt_ChainLink link;			/* Element's link in display list. */
+    Region2d exts;			/* Cached data extents of the
+					 * element. Valid only if the
+					 * EXTENTS_CACHED flag is set. */
+    int extsLogScale;			/* Log scales of the X (bit 0) and Y
+					 * (bit 1) axes when the extents were
+					 * computed. */
+    PerfCounter mapPerf;		/* Time spent mapping the element. */
+    int nDrawnPoints;			/* # of screen points (or bars)
+					 * generated by the last mapping. */
 };
 
 
 BLT_EXTERN double Blt_FindElemValuesMinimum(ElemValues *vecPtr, double minLimit);
+BLT_EXTERN void Blt_GetElementExtents(Element *elemPtr, Region2d *extsPtr);
+BLT_EXTERN void Blt_UpdateElementEpochs(Element *elemPtr);
+BLT_EXTERN double *Blt_GetLogValues(ElemValues *valuesPtr);
 BLT_EXTERN void Blt_ResizeStatusArray(Element *elemPtr, int nPoints);
 BLT_EXTERN int Blt_GetPenStyle(Graph *graphPtr, char *name, size_t classId, 
 	PenStyle *stylePtr);
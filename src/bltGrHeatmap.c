@@ -0,0 +1,1590 @@
+/*
+ * bltGrHeatmap.c --
+ *
+ * This module implements heatmap elements for the BLT graph widget.
+ *
+ *	Copyright 1993-2004 George A Howlett.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining
+ *	a copy of this software and associated documentation files (the
+ *	"Software"), to deal in the Software without restriction, including
+ *	without limitation the rights to use, copy, modify, merge, publish,
+ *	distribute, sublicense, and/or sell copies of the Software, and to
+ *	permit persons to whom the Software is furnished to do so, subject to
+ *	the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be
+ *	included in all copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ *	LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *	OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ *	WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * A heatmap element draws the values of a regular mesh of cells as
+ * colors.  The cells are never drawn one rectangle at a time.  Instead
+ * each time the element is mapped, the visible part of the mesh is
+ * sampled into a picture, one pixel per screen pixel, and the picture is
+ * painted in a single call.  The cost depends upon the number of pixels
+ * covered by the element, not the number of cells in the mesh.
+ */
+
+#include "bltGraph.h"
+#include "bltPicture.h"
+#include "bltPainter.h"
+#include "bltGrElem.h"
+
+#define HEATMAP_LUT_SIZE	1024	/* # of colors in the sampled color
+					 * scale. */
+#define HEATMAP_MAX_SUPERSAMPLE	4	/* Maximum # of samples per pixel
+					 * (in each direction) when the mesh
+					 * is filtered down to the screen. */
+
+#define SAMPLE_NEAREST		0
+#define SAMPLE_BILINEAR		1
+
+typedef struct {
+    Blt_Pixel *colors;			/* Array of colors of the scale,
+					 * from lowest to highest value. */
+    int nColors;
+} HeatmapColors;
+
+/*
+ * HeatmapGrid --
+ *
+ *	Describes the positions of the cells along one dimension (rows or
+ *	columns) of the mesh.  The cells are either evenly spaced or have
+ *	their own coordinates.
+ */
+typedef struct {
+    double *coords;			/* If non-NULL, the coordinates of
+					 * the cells, in increasing order.
+					 * Otherwise the cells are evenly
+					 * spaced. */
+    double first, step;			/* Coordinate of the first cell and
+					 * the distance between cells, if
+					 * evenly spaced. */
+    int nCells;
+} HeatmapGrid;
+
+/*
+ * SampleTable --
+ *
+ *	Holds for each pixel along one screen dimension the cell sampled.
+ *	The offsets are positions in the array of values, so that the
+ *	offsets of a screen row and column are simply added to locate a
+ *	cell.
+ */
+typedef struct {
+    int *offsets;			/* Offset of the (lower) cell
+					 * sampled, or -1 if the pixel lies
+					 * outside of the mesh. */
+    int *steps;				/* Offset to the next cell, for
+					 * bilinear sampling. 0 if there's
+					 * no next cell. */
+    float *weights;			/* Weight of the next cell, for
+					 * bilinear sampling. */
+} SampleTable;
+
+/*
+ * FillKey --
+ *
+ *	Describes how the picture of the heatmap was filled.  If it's the
+ *	same when the element is remapped, the cells sampled by each pixel
+ *	are unchanged and only the pixels of cells whose values changed
+ *	need to be refilled.
+ */
+typedef struct {
+    int x, y, width, height;		/* Screen area of the picture. */
+    int nColumns, nRows;		/* Dimensions of the mesh. */
+    int inverted;
+    double hOrigin, hScale, hOffset;	/* Transforms of the horizontal and */
+    double vOrigin, vScale, vOffset;	/* vertical axes. */
+    double min, max;			/* Limits of the color scale. */
+} FillKey;
+
+typedef struct {
+    GraphObj obj;			/* Must be first field in element. */
+    unsigned int flags;
+    Blt_HashEntry *hashPtr;
+
+    /* Fields specific to elements. */
+    const char *label;			/* Label displayed in legend */
+    unsigned short row, col;		/* Position of the entry in the
+					 * legend. */
+    int legendRelief;			/* Relief of label in legend. */
+    Axis2d axes;			/* X-axis and Y-axis mapping the
+					 * element */
+    ElemValues x, y, w;			/* Contains array of floating point
+					 * graph coordinate values. Also holds
+					 * min/max and the number of
+					 * coordinates */
+    int *activeIndices;			/* Array of indices (malloc-ed) which
+					 * indicate which data points are
+					 * active (drawn with "active"
+					 * colors). */
+    int nActiveIndices;			/* Number of active data points.
+					 * Special case: if nActiveIndices < 0
+					 * and the active bit is set in
+					 * "flags", then all data points are
+					 * drawn active. */
+    ElementProcs *procsPtr;
+    Blt_ConfigSpec *configSpecs;	/* Configuration specifications. */
+    Pen *activePenPtr;			/* Standard Pens */
+    Pen *normalPenPtr;
+    Pen *builtinPenPtr;
+    Blt_Chain stylePalette;		/* Palette of pens. */
+
+    /* Symbol scaling */
+    int scaleSymbols;			/* If non-zero, the symbols will scale
+					 * in size as the graph is zoomed
+					 * in/out.  */
+    double xRange, yRange;		/* Initial X-axis and Y-axis ranges:
+					 * used to scale the size of element's
+					 * symbol. */
+    int state;
+    Blt_ChainLink link;			/* Element's link in display list. */
+    Region2d exts;			/* Cached data extents of the
+					 * element. Valid only if the
+					 * EXTENTS_CACHED flag is set. */
+    int extsLogScale;			/* Log scales of the X (bit 0) and Y
+					 * (bit 1) axes when the extents were
+					 * computed. */
+    PerfCounter mapPerf;		/* Time spent mapping the element. */
+    int nDrawnPoints;			/* # of screen points (or bars)
+					 * generated by the last mapping. */
+
+    /* Fields specific to the heatmap element. */
+
+    ElemValues z;			/* Values of the cells, row by row.
+					 * Rows run along the y-axis and
+					 * columns along the x-axis. */
+    int reqRows, reqColumns;		/* Requested dimensions of the mesh.
+					 * If zero, the dimension is taken
+					 * from the coordinates or the # of
+					 * values. */
+    double reqMin, reqMax;		/* Requested limits of the color
+					 * scale.  If NaN, the limit is the
+					 * minimum or maximum value. */
+    HeatmapColors scale;		/* Colors of the color scale. */
+    Blt_Pixel *lut;			/* Color scale sampled at
+					 * HEATMAP_LUT_SIZE evenly spaced
+					 * values. */
+    int sampling;			/* How cells are sampled by the
+					 * pixels: SAMPLE_NEAREST or
+					 * SAMPLE_BILINEAR. */
+    Blt_ResampleFilter filter;		/* If non-NULL, meshes denser than
+					 * the screen are supersampled and
+					 * filtered down with this filter. */
+    Blt_Painter painter;
+    Blt_Picture picture;		/* Visible part of the mesh at screen
+					 * resolution.  NULL if nothing is
+					 * visible. */
+    int pictX, pictY;			/* Screen position of the picture. */
+    SampleTable hTable, vTable;		/* Cells sampled by the columns and
+					 * rows of the picture.  Kept only if
+					 * the picture isn't supersampled, so
+					 * that it can be partially
+					 * refilled. */
+    FillKey key;			/* How the picture was filled. */
+} HeatmapElement;
+
+BLT_EXTERN Blt_CustomOption bltValuesOption;
+BLT_EXTERN Blt_CustomOption bltXAxisOption;
+BLT_EXTERN Blt_CustomOption bltYAxisOption;
+BLT_EXTERN Blt_CustomOption bltFilterOption;
+
+static Blt_OptionFreeProc FreeColorsProc;
+static Blt_OptionParseProc ObjToColorsProc;
+static Blt_OptionPrintProc ColorsToObjProc;
+static Blt_CustomOption colorsOption = {
+    ObjToColorsProc, ColorsToObjProc, FreeColorsProc, (ClientData)0
+};
+
+static Blt_OptionParseProc ObjToLimitProc;
+static Blt_OptionPrintProc LimitToObjProc;
+static Blt_CustomOption limitOption = {
+    ObjToLimitProc, LimitToObjProc, NULL, (ClientData)0
+};
+
+static Blt_OptionParseProc ObjToSamplingProc;
+static Blt_OptionPrintProc SamplingToObjProc;
+static Blt_CustomOption samplingOption = {
+    ObjToSamplingProc, SamplingToObjProc, NULL, (ClientData)0
+};
+
+#define DEF_HEATMAP_AXIS_X		"x"
+#define DEF_HEATMAP_AXIS_Y		"y"
+#define DEF_HEATMAP_COLORS		"blue cyan green yellow red"
+#define DEF_HEATMAP_COLUMNS		"0"
+#define DEF_HEATMAP_FILTER		(char *)NULL
+#define DEF_HEATMAP_HIDE		"no"
+#define DEF_HEATMAP_LABEL_RELIEF	"flat"
+#define DEF_HEATMAP_MAX			""
+#define DEF_HEATMAP_MIN			""
+#define DEF_HEATMAP_ROWS		"0"
+#define DEF_HEATMAP_SAMPLING		"nearest"
+#define DEF_HEATMAP_STATE		"normal"
+#define DEF_HEATMAP_TAGS		"all"
+
+static Blt_ConfigSpec heatmapElemConfigSpecs[] = {
+    {BLT_CONFIG_LIST, "-bindtags", "bindTags", "BindTags", DEF_HEATMAP_TAGS,
+	Blt_Offset(HeatmapElement, obj.tags), BLT_CONFIG_NULL_OK},
+    {BLT_CONFIG_CUSTOM, "-colors", "colors", "Colors", DEF_HEATMAP_COLORS,
+	Blt_Offset(HeatmapElement, scale), 0, &colorsOption},
+    {BLT_CONFIG_INT_NNEG, "-columns", "columns", "Columns",
+	DEF_HEATMAP_COLUMNS, Blt_Offset(HeatmapElement, reqColumns),
+	BLT_CONFIG_DONT_SET_DEFAULT},
+    {BLT_CONFIG_BITMASK, "-hide", "hide", "Hide", DEF_HEATMAP_HIDE,
+         Blt_Offset(HeatmapElement, flags), BLT_CONFIG_DONT_SET_DEFAULT,
+        (Blt_CustomOption *)HIDE},
+    {BLT_CONFIG_STRING, "-label", "label", "Label", (char *)NULL,
+	Blt_Offset(HeatmapElement, label), BLT_CONFIG_NULL_OK},
+    {BLT_CONFIG_RELIEF, "-legendrelief", "legendRelief", "LegendRelief",
+	DEF_HEATMAP_LABEL_RELIEF, Blt_Offset(HeatmapElement, legendRelief),
+	BLT_CONFIG_DONT_SET_DEFAULT},
+    {BLT_CONFIG_CUSTOM, "-mapx", "mapX", "MapX", DEF_HEATMAP_AXIS_X,
+	Blt_Offset(HeatmapElement, axes.x), 0, &bltXAxisOption},
+    {BLT_CONFIG_CUSTOM, "-mapy", "mapY", "MapY", DEF_HEATMAP_AXIS_Y,
+	Blt_Offset(HeatmapElement, axes.y), 0, &bltYAxisOption},
+    {BLT_CONFIG_CUSTOM, "-max", "max", "Max", DEF_HEATMAP_MAX,
+	Blt_Offset(HeatmapElement, reqMax), 0, &limitOption},
+    {BLT_CONFIG_CUSTOM, "-min", "min", "Min", DEF_HEATMAP_MIN,
+	Blt_Offset(HeatmapElement, reqMin), 0, &limitOption},
+    {BLT_CONFIG_CUSTOM, "-resamplefilter", "resampleFilter", "ResampleFilter",
+	DEF_HEATMAP_FILTER, Blt_Offset(HeatmapElement, filter),
+	BLT_CONFIG_NULL_OK, &bltFilterOption},
+    {BLT_CONFIG_INT_NNEG, "-rows", "rows", "Rows", DEF_HEATMAP_ROWS,
+	Blt_Offset(HeatmapElement, reqRows), BLT_CONFIG_DONT_SET_DEFAULT},
+    {BLT_CONFIG_CUSTOM, "-sampling", "sampling", "Sampling",
+	DEF_HEATMAP_SAMPLING, Blt_Offset(HeatmapElement, sampling),
+	BLT_CONFIG_DONT_SET_DEFAULT, &samplingOption},
+    {BLT_CONFIG_STATE, "-state", "state", "State", DEF_HEATMAP_STATE,
+	Blt_Offset(HeatmapElement, state), BLT_CONFIG_DONT_SET_DEFAULT},
+    {BLT_CONFIG_CUSTOM, "-x", "xdata", "Xdata", (char *)NULL,
+	Blt_Offset(HeatmapElement, x), 0, &bltValuesOption},
+    {BLT_CONFIG_CUSTOM, "-y", "ydata", "Ydata", (char *)NULL,
+	Blt_Offset(HeatmapElement, y), 0, &bltValuesOption},
+    {BLT_CONFIG_CUSTOM, "-z", "zdata", "Zdata", (char *)NULL,
+	Blt_Offset(HeatmapElement, z), 0, &bltValuesOption},
+    {BLT_CONFIG_CUSTOM, "-xdata", "xdata", "Xdata", (char *)NULL,
+	Blt_Offset(HeatmapElement, x), 0, &bltValuesOption},
+    {BLT_CONFIG_CUSTOM, "-ydata", "ydata", "Ydata", (char *)NULL,
+	Blt_Offset(HeatmapElement, y), 0, &bltValuesOption},
+    {BLT_CONFIG_CUSTOM, "-zdata", "zdata", "Zdata", (char *)NULL,
+	Blt_Offset(HeatmapElement, z), 0, &bltValuesOption},
+    {BLT_CONFIG_END, NULL, NULL, NULL, NULL, 0, 0}
+};
+
+/* Forward declarations */
+static ElementClosestProc ClosestHeatmapProc;
+static ElementConfigProc ConfigureHeatmapProc;
+static ElementDestroyProc DestroyHeatmapProc;
+static ElementDrawProc DrawActiveHeatmapProc;
+static ElementDrawProc DrawNormalHeatmapProc;
+static ElementDrawSymbolProc DrawSymbolProc;
+static ElementExtentsProc GetHeatmapExtentsProc;
+static ElementToPostScriptProc ActiveHeatmapToPostScriptProc;
+static ElementToPostScriptProc NormalHeatmapToPostScriptProc;
+static ElementSymbolToPostScriptProc SymbolToPostScriptProc;
+static ElementMapProc MapHeatmapProc;
+
+/*
+ *---------------------------------------------------------------------------
+ * Custom option parse and print procedures
+ *---------------------------------------------------------------------------
+ */
+
+/*ARGSUSED*/
+static void
+FreeColorsProc(
+    ClientData clientData,		/* Not used. */
+    Display *display,			/* Not used. */
+    char *widgRec,
+    int offset)
+{
+    HeatmapColors *scalePtr = (HeatmapColors *)(widgRec + offset);
+
+    if (scalePtr->colors != NULL) {
+	Blt_Free(scalePtr->colors);
+	scalePtr->colors = NULL;
+    }
+    scalePtr->nColors = 0;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ObjToColorsProc --
+ *
+ *	Converts the list of colors of the color scale into an array of
+ *	pixels.
+ *
+ * Results:
+ *	The return value is a standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ObjToColorsProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Interpreter to send results back
+					 * to */
+    Tk_Window tkwin,			/* Not used. */
+    Tcl_Obj *objPtr,			/* List of colors. */
+    char *widgRec,			/* Element record */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    HeatmapColors *scalePtr = (HeatmapColors *)(widgRec + offset);
+    Blt_Pixel *colors;
+    Tcl_Obj **objv;
+    int objc, i;
+
+    if (Tcl_ListObjGetElements(interp, objPtr, &objc, &objv) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    colors = NULL;
+    if (objc > 0) {
+	colors = Blt_AssertMalloc(sizeof(Blt_Pixel) * objc);
+	for (i = 0; i < objc; i++) {
+	    if (Blt_GetPixelFromObj(interp, objv[i], colors + i) != TCL_OK) {
+		Blt_Free(colors);
+		return TCL_ERROR;
+	    }
+	}
+    }
+    if (scalePtr->colors != NULL) {
+	Blt_Free(scalePtr->colors);
+    }
+    scalePtr->colors = colors;
+    scalePtr->nColors = objc;
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ColorsToObjProc --
+ *
+ *	Returns the colors of the color scale as a list.
+ *
+ * Results:
+ *	The list of colors is returned.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static Tcl_Obj *
+ColorsToObjProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,
+    Tk_Window tkwin,			/* Not used. */
+    char *widgRec,			/* Element record */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    HeatmapColors *scalePtr = (HeatmapColors *)(widgRec + offset);
+    Tcl_Obj *listObjPtr;
+    int i;
+
+    listObjPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+    for (i = 0; i < scalePtr->nColors; i++) {
+	Tcl_ListObjAppendElement(interp, listObjPtr,
+		Tcl_NewStringObj(Blt_NameOfPixel(scalePtr->colors + i), -1));
+    }
+    return listObjPtr;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ObjToLimitProc --
+ *
+ *	Converts the string representation of a limit of the color scale
+ *	into its numeric form.  An empty string means the limit is taken
+ *	from the values.
+ *
+ * Results:
+ *	The return value is a standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ObjToLimitProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Interpreter to send results back
+					 * to */
+    Tk_Window tkwin,			/* Not used. */
+    Tcl_Obj *objPtr,			/* String representing new value. */
+    char *widgRec,			/* Pointer to structure record. */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    double *limitPtr = (double *)(widgRec + offset);
+    const char *string;
+
+    string = Tcl_GetString(objPtr);
+    if (string[0] == '\0') {
+	*limitPtr = Blt_NaN();
+    } else if (Blt_ExprDoubleFromObj(interp, objPtr, limitPtr) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * LimitToObjProc --
+ *
+ *	Converts the limit of the color scale into a string.
+ *
+ * Results:
+ *	The string representation of the limit is returned.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static Tcl_Obj *
+LimitToObjProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Not used. */
+    Tk_Window tkwin,			/* Not used. */
+    char *widgRec,			/* Element record */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    double limit = *(double *)(widgRec + offset);
+
+    if (DEFINED(limit)) {
+	return Tcl_NewDoubleObj(limit);
+    }
+    return Tcl_NewStringObj("", -1);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ObjToSamplingProc --
+ *
+ *	Converts the string representing how cells are sampled into its
+ *	numeric form.
+ *
+ * Results:
+ *	The return value is a standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ObjToSamplingProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Interpreter to send results back
+					 * to */
+    Tk_Window tkwin,			/* Not used. */
+    Tcl_Obj *objPtr,			/* String representing new value. */
+    char *widgRec,			/* Pointer to structure record. */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    int *samplingPtr = (int *)(widgRec + offset);
+    const char *string;
+    char c;
+    int length;
+
+    string = Tcl_GetStringFromObj(objPtr, &length);
+    c = string[0];
+    if ((c == 'n') && (strncmp(string, "nearest", length) == 0)) {
+	*samplingPtr = SAMPLE_NEAREST;
+    } else if ((c == 'b') && (strncmp(string, "bilinear", length) == 0)) {
+	*samplingPtr = SAMPLE_BILINEAR;
+    } else {
+	Tcl_AppendResult(interp, "bad sampling \"", string,
+		"\": should be \"nearest\" or \"bilinear\"", (char *)NULL);
+	return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SamplingToObjProc --
+ *
+ *	Returns the name of how cells are sampled.
+ *
+ * Results:
+ *	The string representation of the sampling is returned.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static Tcl_Obj *
+SamplingToObjProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Not used. */
+    Tk_Window tkwin,			/* Not used. */
+    char *widgRec,			/* Element record */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    int sampling = *(int *)(widgRec + offset);
+
+    if (sampling == SAMPLE_BILINEAR) {
+	return Tcl_NewStringObj("bilinear", -1);
+    }
+    return Tcl_NewStringObj("nearest", -1);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SetGrid --
+ *
+ *	Determines the positions of the cells along one dimension of the
+ *	mesh from the coordinates given.  There may be no coordinates (the
+ *	cells are placed at their indices), the coordinates of the first
+ *	and last cells (the cells are evenly spaced), or a coordinate for
+ *	each cell.
+ *
+ * Results:
+ *	Returns 1 if the coordinates describe the cells, 0 otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+SetGrid(HeatmapGrid *gridPtr, ElemValues *valuesPtr, int nCells)
+{
+    double *vp;
+    int i;
+
+    gridPtr->nCells = nCells;
+    gridPtr->coords = NULL;
+    gridPtr->first = 0.0;
+    gridPtr->step = 1.0;
+    vp = valuesPtr->values;
+    if (valuesPtr->nValues == 0) {
+	return TRUE;
+    }
+    if ((valuesPtr->nValues == 1) && (nCells == 1)) {
+	gridPtr->first = vp[0];
+	return FINITE(vp[0]);
+    }
+    if ((valuesPtr->nValues == 2) && (nCells >= 2)) {
+	gridPtr->first = vp[0];
+	gridPtr->step = (vp[1] - vp[0]) / (nCells - 1);
+	return ((FINITE(vp[0])) && (gridPtr->step > 0.0) &&
+		(FINITE(gridPtr->step)));
+    }
+    if (valuesPtr->nValues != nCells) {
+	return FALSE;
+    }
+    if (!FINITE(vp[0])) {
+	return FALSE;
+    }
+    for (i = 1; i < nCells; i++) {
+	if ((!FINITE(vp[i])) || (vp[i] <= vp[i - 1])) {
+	    return FALSE;		/* Coordinates must be increasing. */
+	}
+    }
+    gridPtr->coords = vp;
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GridCoord --
+ *
+ *	Returns the coordinate at the given (fractional) cell index.
+ *	Indices before the first cell or after the last are extrapolated
+ *	from the spacing of the end cells.
+ *
+ *---------------------------------------------------------------------------
+ */
+static double
+GridCoord(HeatmapGrid *gridPtr, double u)
+{
+    double *cp;
+    int i;
+
+    if (gridPtr->coords == NULL) {
+	return gridPtr->first + u * gridPtr->step;
+    }
+    cp = gridPtr->coords;
+    i = (int)floor(u);
+    if (i < 0) {
+	i = 0;
+    } else if (i > (gridPtr->nCells - 2)) {
+	i = gridPtr->nCells - 2;
+    }
+    return cp[i] + (u - i) * (cp[i + 1] - cp[i]);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GridIndex --
+ *
+ *	Returns the (fractional) cell index at the given coordinate.  This
+ *	is the inverse of GridCoord.
+ *
+ *---------------------------------------------------------------------------
+ */
+static double
+GridIndex(HeatmapGrid *gridPtr, double value)
+{
+    double *cp;
+    int low, high;
+
+    if (gridPtr->coords == NULL) {
+	return (value - gridPtr->first) / gridPtr->step;
+    }
+    cp = gridPtr->coords;
+    low = 0, high = gridPtr->nCells - 2;
+    while (low < high) {
+	int mid;
+
+	mid = (low + high + 1) >> 1;
+	if (cp[mid] <= value) {
+	    low = mid;
+	} else {
+	    high = mid - 1;
+	}
+    }
+    return low + (value - cp[low]) / (cp[low + 1] - cp[low]);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetGrids --
+ *
+ *	Determines the dimensions of the mesh and the positions of its
+ *	columns and rows.  A dimension not requested is taken from the #
+ *	of coordinates, or else from the # of values.
+ *
+ * Results:
+ *	Returns 1 if the element has a mesh to draw, 0 otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+GetGrids(HeatmapElement *elemPtr, HeatmapGrid *colsPtr, HeatmapGrid *rowsPtr)
+{
+    int nRows, nColumns;
+
+    nColumns = elemPtr->reqColumns;
+    if ((nColumns == 0) && (elemPtr->x.nValues > 2)) {
+	nColumns = elemPtr->x.nValues;
+    }
+    nRows = elemPtr->reqRows;
+    if ((nRows == 0) && (elemPtr->y.nValues > 2)) {
+	nRows = elemPtr->y.nValues;
+    }
+    if ((nColumns == 0) && (nRows > 0)) {
+	nColumns = elemPtr->z.nValues / nRows;
+    } else if ((nRows == 0) && (nColumns > 0)) {
+	nRows = elemPtr->z.nValues / nColumns;
+    }
+    if ((nRows == 0) || (nColumns == 0) ||
+	(((double)nRows * nColumns) > (double)elemPtr->z.nValues)) {
+	return FALSE;
+    }
+    return ((SetGrid(colsPtr, &elemPtr->x, nColumns)) &&
+	    (SetGrid(rowsPtr, &elemPtr->y, nRows)));
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * BuildColorTable --
+ *
+ *	Samples the color scale at evenly spaced values, interpolating
+ *	between the colors given.  Values are mapped to colors by simply
+ *	indexing the table.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+BuildColorTable(HeatmapElement *elemPtr)
+{
+    Blt_Pixel *colors, *dp;
+    int nColors, i;
+
+    if (elemPtr->lut == NULL) {
+	elemPtr->lut = Blt_AssertMalloc(sizeof(Blt_Pixel) * HEATMAP_LUT_SIZE);
+    }
+    colors = elemPtr->scale.colors;
+    nColors = elemPtr->scale.nColors;
+    for (dp = elemPtr->lut, i = 0; i < HEATMAP_LUT_SIZE; i++, dp++) {
+	Blt_Pixel *p, *q;
+	double t;
+	int k;
+
+	if (nColors == 0) {
+	    dp->u32 = 0;		/* No colors: cells are transparent. */
+	    continue;
+	}
+	t = (double)i * (nColors - 1) / (HEATMAP_LUT_SIZE - 1);
+	k = (int)t;
+	if (k >= (nColors - 1)) {
+	    *dp = colors[nColors - 1];
+	    continue;
+	}
+	t -= k;
+	p = colors + k, q = p + 1;
+	dp->u8.r = (unsigned char)(p->u8.r + (q->u8.r - p->u8.r) * t + 0.5);
+	dp->u8.g = (unsigned char)(p->u8.g + (q->u8.g - p->u8.g) * t + 0.5);
+	dp->u8.b = (unsigned char)(p->u8.b + (q->u8.b - p->u8.b) * t + 0.5);
+	dp->u8.a = (unsigned char)(p->u8.a + (q->u8.a - p->u8.a) * t + 0.5);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MakeSampleTable --
+ *
+ *	Determines the cell sampled by each pixel along one dimension of
+ *	the screen.  The pixels are spaced "delta" apart starting at
+ *	"origin", so that a dimension can be supersampled.  Each pixel is
+ *	mapped back to its graph coordinate and located in the grid.  This
+ *	is done once per screen row and column, not once per pixel.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+MakeSampleTable(SampleTable *tablePtr, HeatmapGrid *gridPtr, Axis *axisPtr,
+		int vertical, double origin, double delta, int length,
+		int stride, int sampling)
+{
+    int i, last;
+
+    tablePtr->offsets = Blt_AssertMalloc(sizeof(int) * length);
+    tablePtr->steps = NULL;
+    tablePtr->weights = NULL;
+    if (sampling == SAMPLE_BILINEAR) {
+	tablePtr->steps = Blt_AssertMalloc(sizeof(int) * length);
+	tablePtr->weights = Blt_AssertMalloc(sizeof(float) * length);
+    }
+    last = gridPtr->nCells - 1;
+    for (i = 0; i < length; i++) {
+	double s, u;
+	int index;
+
+	s = origin + (i + 0.5) * delta;
+	u = GridIndex(gridPtr, (vertical) ? Blt_InvVMap(axisPtr, s) :
+		      Blt_InvHMap(axisPtr, s));
+	if (!((u >= -0.5) && (u < (last + 0.5)))) {
+	    tablePtr->offsets[i] = -1;	/* Outside of the mesh. */
+	    if (sampling == SAMPLE_BILINEAR) {
+		tablePtr->steps[i] = 0;
+		tablePtr->weights[i] = 0.0f;
+	    }
+	    continue;
+	}
+	if (sampling == SAMPLE_BILINEAR) {
+	    double t;
+
+	    /* Cells are interpolated between their centers.  The half
+	     * cells on the edges of the mesh take the edge values. */
+	    if (u <= 0.0) {
+		index = 0, t = 0.0;
+	    } else if (u >= last) {
+		index = last, t = 0.0;
+	    } else {
+		index = (int)u;
+		t = u - index;
+	    }
+	    tablePtr->steps[i] = (t > 0.0) ? stride : 0;
+	    tablePtr->weights[i] = (float)t;
+	} else {
+	    index = (int)(u + 0.5);
+	    if (index > last) {
+		index = last;
+	    }
+	}
+	tablePtr->offsets[i] = index * stride;
+    }
+}
+
+static void
+FreeSampleTable(SampleTable *tablePtr)
+{
+    if (tablePtr->offsets != NULL) {
+	Blt_Free(tablePtr->offsets);
+    }
+    if (tablePtr->steps != NULL) {
+	Blt_Free(tablePtr->steps);
+    }
+    if (tablePtr->weights != NULL) {
+	Blt_Free(tablePtr->weights);
+    }
+    tablePtr->offsets = tablePtr->steps = NULL;
+    tablePtr->weights = NULL;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SupersampleFactor --
+ *
+ *	Returns the # of samples per pixel needed so that each cell
+ *	between the screen coordinates s1 and s2 is sampled at least once.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+SupersampleFactor(HeatmapGrid *gridPtr, Axis *axisPtr, int vertical,
+		  double s1, double s2, int length)
+{
+    double u1, u2, nCells;
+    int factor;
+
+    if (vertical) {
+	u1 = GridIndex(gridPtr, Blt_InvVMap(axisPtr, s1));
+	u2 = GridIndex(gridPtr, Blt_InvVMap(axisPtr, s2));
+    } else {
+	u1 = GridIndex(gridPtr, Blt_InvHMap(axisPtr, s1));
+	u2 = GridIndex(gridPtr, Blt_InvHMap(axisPtr, s2));
+    }
+    nCells = FABS(u2 - u1);
+    if (!FINITE(nCells)) {
+	return 1;
+    }
+    factor = (int)ceil(nCells / length);
+    if (factor > HEATMAP_MAX_SUPERSAMPLE) {
+	factor = HEATMAP_MAX_SUPERSAMPLE;
+    }
+    while ((factor > 1) && ((length * factor) > SHRT_MAX)) {
+	factor--;
+    }
+    return (factor < 1) ? 1 : factor;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetColorRange --
+ *
+ *	Returns the limits of the color scale: the requested limits, or
+ *	else the minimum and maximum values.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+GetColorRange(HeatmapElement *elemPtr, double *minPtr, double *maxPtr)
+{
+    *minPtr = (DEFINED(elemPtr->reqMin)) ? elemPtr->reqMin : elemPtr->z.min;
+    *maxPtr = (DEFINED(elemPtr->reqMax)) ? elemPtr->reqMax : elemPtr->z.max;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FillPicture --
+ *
+ *	Colors each pixel of the picture from the cells sampled by its
+ *	screen row and column.  Cells with missing (NaN) values and pixels
+ *	outside of the mesh are left transparent.
+ *
+ *	Only the screen rows sampling a cell at or after the given index are
+ *	filled.  The values are stored row by row, so if only the last rows
+ *	of the mesh changed, the other screen rows are left as is.
+ *
+ * Results:
+ *	Returns the picture flags describing its transparency.
+ *
+ *---------------------------------------------------------------------------
+ */
+static unsigned int
+FillPicture(HeatmapElement *elemPtr, Blt_Picture picture, SampleTable *hPtr,
+	    SampleTable *vPtr, double min, double max, int first)
+{
+    Blt_Pixel *lut, *destRowPtr;
+    double *values;
+    double scale;
+    unsigned int flags;
+    int x, y, w, h, i, last, hLast;
+
+    scale = (max > min) ? (HEATMAP_LUT_SIZE - 1) / (max - min) : 0.0;
+    lut = elemPtr->lut;
+    last = HEATMAP_LUT_SIZE - 1;
+    values = elemPtr->z.values;
+    w = Blt_PictureWidth(picture);
+    h = Blt_PictureHeight(picture);
+
+    flags = BLT_PIC_COLOR;
+    for (i = 0; i < HEATMAP_LUT_SIZE; i++) {
+	if (lut[i].u8.a != 0xFF) {
+	    flags |= BLT_PIC_BLEND;
+	    break;
+	}
+    }
+    /* Largest offset of a cell sampled by a screen column. */
+    hLast = -1;
+    for (x = 0; x < w; x++) {
+	int offset;
+
+	offset = hPtr->offsets[x];
+	if ((offset >= 0) && (hPtr->steps != NULL)) {
+	    offset += hPtr->steps[x];
+	}
+	if (offset > hLast) {
+	    hLast = offset;
+	}
+    }
+    destRowPtr = Blt_PictureBits(picture);
+    for (y = 0; y < h; y++) {
+	Blt_Pixel *dp;
+	int vOffset, vStep;
+	double vWeight;
+
+	dp = destRowPtr;
+	vOffset = vPtr->offsets[y];
+	if (vOffset < 0) {
+	    if (first == 0) {
+		for (x = 0; x < w; x++, dp++) {
+		    dp->u32 = 0;
+		}
+		flags |= BLT_PIC_MASK;
+	    }
+	    destRowPtr += Blt_PictureStride(picture);
+	    continue;
+	}
+	vStep = 0, vWeight = 0.0;
+	if (vPtr->steps != NULL) {
+	    vStep = vPtr->steps[y];
+	    vWeight = vPtr->weights[y];
+	}
+	if ((vOffset + vStep + hLast) < first) {
+	    /* None of the cells sampled by this row changed. */
+	    destRowPtr += Blt_PictureStride(picture);
+	    continue;
+	}
+	for (x = 0; x < w; x++, dp++) {
+	    double z;
+	    int hOffset, index;
+
+	    hOffset = hPtr->offsets[x];
+	    if (hOffset < 0) {
+		dp->u32 = 0;
+		flags |= BLT_PIC_MASK;
+		continue;
+	    }
+	    index = hOffset + vOffset;
+	    z = values[index];
+	    if (hPtr->steps != NULL) {
+		double z10, z01, z11, hWeight;
+		int hStep;
+
+		hStep = hPtr->steps[x];
+		hWeight = hPtr->weights[x];
+		z10 = values[index + hStep];
+		z01 = values[index + vStep];
+		z11 = values[index + hStep + vStep];
+		if ((FINITE(z)) && (FINITE(z10)) && (FINITE(z01)) &&
+		    (FINITE(z11))) {
+		    z += (z10 - z) * hWeight;
+		    z01 += (z11 - z01) * hWeight;
+		    z += (z01 - z) * vWeight;
+		} else {
+		    /* A neighbor is missing: use the nearest cell. */
+		    z = values[index + ((hWeight < 0.5) ? 0 : hStep) +
+			       ((vWeight < 0.5) ? 0 : vStep)];
+		}
+	    }
+	    if (FINITE(z)) {
+		double t;
+
+		t = (z - min) * scale;
+		if (t <= 0.0) {
+		    *dp = lut[0];
+		} else if (t >= last) {
+		    *dp = lut[last];
+		} else {
+		    *dp = lut[(int)(t + 0.5)];
+		}
+	    } else {
+		dp->u32 = 0;
+		flags |= BLT_PIC_MASK;
+	    }
+	}
+	destRowPtr += Blt_PictureStride(picture);
+    }
+    return flags;
+}
+
+static void
+ResetHeatmap(HeatmapElement *elemPtr)
+{
+    if (elemPtr->picture != NULL) {
+	Blt_FreePicture(elemPtr->picture);
+	elemPtr->picture = NULL;
+    }
+    FreeSampleTable(&elemPtr->hTable);
+    FreeSampleTable(&elemPtr->vTable);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SameFillKey --
+ *
+ *	Indicates if the picture was filled with the same mapping.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+SameFillKey(FillKey *k1Ptr, FillKey *k2Ptr)
+{
+    return ((k1Ptr->x == k2Ptr->x) && (k1Ptr->y == k2Ptr->y) &&
+	    (k1Ptr->width == k2Ptr->width) &&
+	    (k1Ptr->height == k2Ptr->height) &&
+	    (k1Ptr->nColumns == k2Ptr->nColumns) &&
+	    (k1Ptr->nRows == k2Ptr->nRows) &&
+	    (k1Ptr->inverted == k2Ptr->inverted) &&
+	    (k1Ptr->hOrigin == k2Ptr->hOrigin) &&
+	    (k1Ptr->hScale == k2Ptr->hScale) &&
+	    (k1Ptr->hOffset == k2Ptr->hOffset) &&
+	    (k1Ptr->vOrigin == k2Ptr->vOrigin) &&
+	    (k1Ptr->vScale == k2Ptr->vScale) &&
+	    (k1Ptr->vOffset == k2Ptr->vOffset) &&
+	    (k1Ptr->min == k2Ptr->min) && (k1Ptr->max == k2Ptr->max));
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ConfigureHeatmapProc --
+ *
+ *	Sets up the painter and samples the color scale of the heatmap
+ *	element.
+ *
+ * Results:
+ *	The return value is a standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+ConfigureHeatmapProc(Graph *graphPtr, Element *basePtr)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+
+    if (elemPtr->painter == NULL) {
+	elemPtr->painter = Blt_GetPainter(graphPtr->tkwin, 1.0);
+    }
+    BuildColorTable(elemPtr);
+    /* The extents depend upon the dimensions of the mesh. */
+    if (Blt_ConfigModified(elemPtr->configSpecs, "-columns", "-rows",
+	"-z*", (char *)NULL)) {
+	graphPtr->flags |= RESET_WORLD;
+    }
+    if (Blt_ConfigModified(elemPtr->configSpecs, "-colors", "-columns",
+	"-max", "-min", "-resamplefilter", "-rows", "-sampling", "-z*",
+	(char *)NULL)) {
+	ResetHeatmap(elemPtr);		/* Refill the entire picture. */
+	elemPtr->flags |= MAP_ITEM;
+    }
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetHeatmapExtentsProc --
+ *
+ *	Returns the limits of the mesh.  The cells extend halfway to their
+ *	neighbors.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+GetHeatmapExtentsProc(Element *basePtr, Region2d *regPtr)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+    HeatmapGrid cols, rows;
+
+    regPtr->top = regPtr->left = DBL_MAX;
+    regPtr->bottom = regPtr->right = -DBL_MAX;
+    if (!GetGrids(elemPtr, &cols, &rows)) {
+	return;				/* No mesh. */
+    }
+    regPtr->left = GridCoord(&cols, -0.5);
+    regPtr->right = GridCoord(&cols, cols.nCells - 0.5);
+    regPtr->top = GridCoord(&rows, -0.5);
+    regPtr->bottom = GridCoord(&rows, rows.nCells - 0.5);
+    /* Don't let the edge of the first cell fall off a log scale axis. */
+    if ((elemPtr->axes.x->logScale) && (regPtr->left <= 0.0)) {
+	regPtr->left = GridCoord(&cols, 0.0);
+    }
+    if ((elemPtr->axes.y->logScale) && (regPtr->top <= 0.0)) {
+	regPtr->top = GridCoord(&rows, 0.0);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MapHeatmapProc --
+ *
+ *	Samples the visible part of the mesh into a picture at screen
+ *	resolution.  The picture covers only the pixels of the plotting
+ *	area overlapped by the mesh.
+ *
+ *	If a resampling filter is set and there are more cells than
+ *	pixels, the mesh is supersampled and then filtered down to the
+ *	screen, so that small features aren't dropped or aliased.
+ *
+ *	If the mesh, axes, and color scale are unchanged since the picture
+ *	was last filled, only the pixels of the cells whose values changed
+ *	are refilled.  Vectors report the first value changed, so updating
+ *	the last rows of the mesh doesn't redo the entire picture.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The picture of the heatmap is regenerated.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+MapHeatmapProc(Graph *graphPtr, Element *basePtr)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+    HeatmapGrid cols, rows, *hGridPtr, *vGridPtr;
+    Axis *hAxisPtr, *vAxisPtr;
+    SampleTable hTable, vTable;
+    Blt_Picture picture;
+    FillKey key;
+    Point2d p, q;
+    double left, right, top, bottom;
+    unsigned int flags;
+    int x1, y1, x2, y2, w, h, hFactor, vFactor, hStride, vStride;
+
+    if (!GetGrids(elemPtr, &cols, &rows)) {
+	ResetHeatmap(elemPtr);
+	return;
+    }
+    p = Blt_Map2D(graphPtr, GridCoord(&cols, -0.5), GridCoord(&rows, -0.5),
+	&elemPtr->axes);
+    q = Blt_Map2D(graphPtr, GridCoord(&cols, cols.nCells - 0.5),
+	GridCoord(&rows, rows.nCells - 0.5), &elemPtr->axes);
+
+    /* Clip the screen extents of the mesh to the plotting area. */
+    left = MAX(MIN(p.x, q.x), graphPtr->left);
+    right = MIN(MAX(p.x, q.x), graphPtr->right + 1);
+    top = MAX(MIN(p.y, q.y), graphPtr->top);
+    bottom = MIN(MAX(p.y, q.y), graphPtr->bottom + 1);
+    if ((!(left < right)) || (!(top < bottom))) {
+	ResetHeatmap(elemPtr);
+	return;				/* Mesh is offscreen. */
+    }
+    x1 = (int)floor(left), x2 = (int)ceil(right);
+    y1 = (int)floor(top), y2 = (int)ceil(bottom);
+    w = x2 - x1, h = y2 - y1;
+
+    /*
+     * Screen columns run along the x-axis and screen rows along the
+     * y-axis, unless the graph is inverted.  The strides are the
+     * distances between cells in the array of values.
+     */
+    if (graphPtr->inverted) {
+	hGridPtr = &rows, hAxisPtr = elemPtr->axes.y, hStride = cols.nCells;
+	vGridPtr = &cols, vAxisPtr = elemPtr->axes.x, vStride = 1;
+    } else {
+	hGridPtr = &cols, hAxisPtr = elemPtr->axes.x, hStride = 1;
+	vGridPtr = &rows, vAxisPtr = elemPtr->axes.y, vStride = cols.nCells;
+    }
+    memset(&key, 0, sizeof(key));
+    key.x = x1, key.y = y1, key.width = w, key.height = h;
+    key.nColumns = cols.nCells, key.nRows = rows.nCells;
+    key.inverted = graphPtr->inverted;
+    Blt_GetAxisTransform(hAxisPtr, FALSE, &key.hOrigin, &key.hScale, 
+	&key.hOffset);
+    Blt_GetAxisTransform(vAxisPtr, TRUE, &key.vOrigin, &key.vScale, 
+	&key.vOffset);
+    GetColorRange(elemPtr, &key.min, &key.max);
+    if ((elemPtr->picture != NULL) && (elemPtr->hTable.offsets != NULL) &&
+	(elemPtr->x.nUnchanged == elemPtr->x.nValues) &&
+	(elemPtr->y.nUnchanged == elemPtr->y.nValues) &&
+	(SameFillKey(&key, &elemPtr->key))) {
+	if (elemPtr->z.nUnchanged < elemPtr->z.nValues) {
+	    elemPtr->picture->flags |= FillPicture(elemPtr, elemPtr->picture,
+		&elemPtr->hTable, &elemPtr->vTable, key.min, key.max,
+		elemPtr->z.nUnchanged);
+	}
+	elemPtr->z.nUnchanged = elemPtr->z.nValues;
+	return;
+    }
+    ResetHeatmap(elemPtr);
+    hFactor = vFactor = 1;
+    if (elemPtr->filter != NULL) {
+	hFactor = SupersampleFactor(hGridPtr, hAxisPtr, FALSE, x1, x2, w);
+	vFactor = SupersampleFactor(vGridPtr, vAxisPtr, TRUE, y1, y2, h);
+    }
+    MakeSampleTable(&hTable, hGridPtr, hAxisPtr, FALSE, x1, 1.0 / hFactor,
+	w * hFactor, hStride, elemPtr->sampling);
+    MakeSampleTable(&vTable, vGridPtr, vAxisPtr, TRUE, y1, 1.0 / vFactor,
+	h * vFactor, vStride, elemPtr->sampling);
+    picture = Blt_CreatePicture(w * hFactor, h * vFactor);
+    flags = FillPicture(elemPtr, picture, &hTable, &vTable, key.min, key.max,
+	0);
+    picture->flags |= flags;
+    if ((hFactor == 1) && (vFactor == 1)) {
+	/* Keep the sample tables to refill the picture as values change. */
+	elemPtr->hTable = hTable;
+	elemPtr->vTable = vTable;
+	elemPtr->key = key;
+    } else {
+	FreeSampleTable(&hTable);
+	FreeSampleTable(&vTable);
+    }
+    if ((hFactor > 1) || (vFactor > 1)) {
+	Blt_Picture dest;
+
+	dest = Blt_CreatePicture(w, h);
+	Blt_ResamplePicture(dest, picture, elemPtr->filter, elemPtr->filter);
+	Blt_FreePicture(picture);
+	picture = dest;
+	/* Filtering blends transparent pixels with their neighbors. */
+	if (picture->flags & BLT_PIC_MASK) {
+	    picture->flags &= ~BLT_PIC_MASK;
+	    picture->flags |= BLT_PIC_BLEND;
+	}
+    }
+    elemPtr->picture = picture;
+    elemPtr->pictX = x1;
+    elemPtr->pictY = y1;
+    elemPtr->nDrawnPoints = w * h;
+    elemPtr->x.nUnchanged = elemPtr->x.nValues;
+    elemPtr->y.nUnchanged = elemPtr->y.nValues;
+    elemPtr->z.nUnchanged = elemPtr->z.nValues;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ClosestHeatmapProc --
+ *
+ *	Finds the cell under the given screen coordinates.  The index of
+ *	a cell is its position in the array of values (row * columns +
+ *	column).
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ClosestHeatmapProc(Graph *graphPtr, Element *basePtr,
+		   ClosestSearch *searchPtr)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+    HeatmapGrid cols, rows;
+    Point2d p;
+    int row, column;
+
+    if ((elemPtr->picture == NULL) || (searchPtr->dist <= 0.0)) {
+	return;
+    }
+    if ((searchPtr->x < elemPtr->pictX) || (searchPtr->y < elemPtr->pictY) ||
+	(searchPtr->x >=
+	 (elemPtr->pictX + Blt_PictureWidth(elemPtr->picture))) ||
+	(searchPtr->y >=
+	 (elemPtr->pictY + Blt_PictureHeight(elemPtr->picture)))) {
+	return;
+    }
+    if (!GetGrids(elemPtr, &cols, &rows)) {
+	return;
+    }
+    p = Blt_InvMap2D(graphPtr, searchPtr->x + 0.5, searchPtr->y + 0.5,
+	&elemPtr->axes);
+    p.x = floor(GridIndex(&cols, p.x) + 0.5);
+    p.y = floor(GridIndex(&rows, p.y) + 0.5);
+    if ((!(p.x >= 0.0)) || (!(p.y >= 0.0)) || (p.x >= cols.nCells) ||
+	(p.y >= rows.nCells)) {
+	return;
+    }
+    column = (int)p.x, row = (int)p.y;
+    searchPtr->elemPtr = basePtr;
+    searchPtr->dist = 0.0;
+    searchPtr->index = row * cols.nCells + column;
+    searchPtr->point.x = GridCoord(&cols, column);
+    searchPtr->point.y = GridCoord(&rows, row);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DrawNormalHeatmapProc --
+ *
+ *	Paints the picture of the heatmap.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+DrawNormalHeatmapProc(Graph *graphPtr, Drawable drawable, Element *basePtr)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+
+    if (elemPtr->picture != NULL) {
+	Blt_PaintPicture(elemPtr->painter, drawable, elemPtr->picture, 0, 0,
+		Blt_PictureWidth(elemPtr->picture),
+		Blt_PictureHeight(elemPtr->picture), elemPtr->pictX,
+		elemPtr->pictY, 0);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HeatmapToPictureProc --
+ *
+ *	Blends the heatmap's picture into the picture of the graph.
+ *
+ * Results:
+ *	Always returns 1.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+HeatmapToPictureProc(Graph *graphPtr, Blt_Picture picture, Element *basePtr)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+
+    if (elemPtr->picture != NULL) {
+	Blt_BlendPictures(picture, elemPtr->picture, 0, 0, 
+		Blt_PictureWidth(elemPtr->picture),
+		Blt_PictureHeight(elemPtr->picture), elemPtr->pictX, 
+		elemPtr->pictY);
+    }
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DrawActiveHeatmapProc --
+ *
+ *	Heatmaps have no active colors.  Nothing is drawn over the normal
+ *	picture.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static void
+DrawActiveHeatmapProc(Graph *graphPtr, Drawable drawable, Element *basePtr)
+{
+    /* Empty */
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ColorScalePicture --
+ *
+ *	Creates a picture of the color scale, running from the lowest value
+ *	at the bottom to the highest at the top.  It's used as the symbol
+ *	of the element in the legend.
+ *
+ *---------------------------------------------------------------------------
+ */
+static Blt_Picture
+ColorScalePicture(HeatmapElement *elemPtr, int size)
+{
+    Blt_Picture picture;
+    Blt_Pixel *destRowPtr;
+    unsigned int flags;
+    int x, y;
+
+    picture = Blt_CreatePicture(size, size);
+    flags = BLT_PIC_COLOR;
+    destRowPtr = Blt_PictureBits(picture);
+    for (y = 0; y < size; y++) {
+	Blt_Pixel *dp, color;
+
+	color = elemPtr->lut[0];
+	if (size > 1) {
+	    color = elemPtr->lut[(size - 1 - y) * (HEATMAP_LUT_SIZE - 1) /
+				 (size - 1)];
+	}
+	if (color.u8.a != 0xFF) {
+	    flags |= BLT_PIC_BLEND;
+	}
+	for (dp = destRowPtr, x = 0; x < size; x++, dp++) {
+	    *dp = color;
+	}
+	destRowPtr += Blt_PictureStride(picture);
+    }
+    picture->flags |= flags;
+    return picture;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DrawSymbolProc --
+ *
+ * 	Draws the color scale as the symbol of the element in the legend.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static void
+DrawSymbolProc(Graph *graphPtr, Drawable drawable, Element *basePtr,
+	       int x, int y, int size)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+    Blt_Picture picture;
+
+    if ((size < 1) || (elemPtr->painter == NULL)) {
+	return;
+    }
+    picture = ColorScalePicture(elemPtr, size);
+    Blt_PaintPicture(elemPtr->painter, drawable, picture, 0, 0, size, size,
+	x - size / 2, y - size / 2, 0);
+    Blt_FreePicture(picture);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SymbolToPostScriptProc --
+ *
+ * 	Prints the color scale as the symbol of the element in the legend.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static void
+SymbolToPostScriptProc(
+    Graph *graphPtr,
+    Blt_Ps ps,
+    Element *basePtr,
+    double x, double y,
+    int size)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+    Blt_Picture picture;
+
+    if (size < 1) {
+	return;
+    }
+    picture = ColorScalePicture(elemPtr, size);
+    Blt_Ps_DrawPicture(ps, picture, x - size / 2, y - size / 2);
+    Blt_FreePicture(picture);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * NormalHeatmapToPostScriptProc --
+ *
+ *	Prints the picture of the heatmap.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+NormalHeatmapToPostScriptProc(Graph *graphPtr, Blt_Ps ps, Element *basePtr)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+
+    if (elemPtr->picture != NULL) {
+	Blt_Ps_DrawPicture(ps, elemPtr->picture, elemPtr->pictX,
+		elemPtr->pictY);
+    }
+}
+
+/*ARGSUSED*/
+static void
+ActiveHeatmapToPostScriptProc(Graph *graphPtr, Blt_Ps ps, Element *basePtr)
+{
+    /* Empty */
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DestroyHeatmapProc --
+ *
+ *	Releases the resources of the heatmap element.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+DestroyHeatmapProc(Graph *graphPtr, Element *basePtr)
+{
+    HeatmapElement *elemPtr = (HeatmapElement *)basePtr;
+
+    ResetHeatmap(elemPtr);
+    if (elemPtr->painter != NULL) {
+	Blt_FreePainter(elemPtr->painter);
+    }
+    if (elemPtr->lut != NULL) {
+	Blt_Free(elemPtr->lut);
+    }
+    if (elemPtr->activeIndices != NULL) {
+	Blt_Free(elemPtr->activeIndices);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_HeatmapElement --
+ *
+ *	Allocate memory and initialize methods for the new heatmap element.
+ *
+ * Results:
+ *	The pointer to the newly allocated element structure is returned.
+ *
+ * Side effects:
+ *	Memory is allocated for the heatmap element structure.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static ElementProcs heatmapProcs = {
+    ClosestHeatmapProc,
+    ConfigureHeatmapProc,
+    DestroyHeatmapProc,
+    DrawActiveHeatmapProc,
+    DrawNormalHeatmapProc,
+    DrawSymbolProc,
+    GetHeatmapExtentsProc,
+    ActiveHeatmapToPostScriptProc,
+    NormalHeatmapToPostScriptProc,
+    SymbolToPostScriptProc,
+    MapHeatmapProc,
+    NULL,				/* Heatmaps can't be scrolled. */
+    NULL,
+    HeatmapToPictureProc,
+};
+
+Element *
+Blt_HeatmapElement(Graph *graphPtr, const char *name, ClassId classId)
+{
+    HeatmapElement *elemPtr;
+
+    elemPtr = Blt_AssertCalloc(1, sizeof(HeatmapElement));
+    elemPtr->procsPtr = &heatmapProcs;
+    elemPtr->configSpecs = heatmapElemConfigSpecs;
+    elemPtr->legendRelief = TK_RELIEF_FLAT;
+    Blt_GraphSetObjectClass(&elemPtr->obj, classId);
+    elemPtr->obj.name = Blt_AssertStrdup(name);
+    elemPtr->obj.graphPtr = graphPtr;
+    /* By default, an element's name and label are the same. */
+    elemPtr->label = Blt_AssertStrdup(name);
+    elemPtr->reqMin = elemPtr->reqMax = Blt_NaN();
+    elemPtr->sampling = SAMPLE_NEAREST;
+    return (Element *)elemPtr;
+}
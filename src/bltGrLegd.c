@@ -63,6 +63,7 @@
 #define SELECT_SORTED		(1<<20)
 
 #define RAISED			(1<<21)
+#define SCROLL_PENDING		(1<<22)	/* Scrollbars need to be updated. */
 
 #define SELECT_MODE_SINGLE	(1<<0)
 #define SELECT_MODE_MULTIPLE	(1<<1)
@@ -181,6 +182,20 @@ struct _Legend {
 					 * is selected. */
     Blt_Chain selected;			/* List of selected elements. */
 
+    Element **entries;			/* Legend entries in the column-major
+					 * order of the grid.  Used to draw
+					 * only the visible entries and to
+					 * pick entries. */
+    Blt_HashTable labelTable;		/* Extents of the entry labels, keyed
+					 * by label.  Flushed when the font
+					 * changes. */
+    int xOffset, yOffset;		/* Scroll offsets of the view of the
+					 * legend in its own window. */
+    int viewWidth, viewHeight;		/* Size of the legend's window when
+					 * the entries were last laid out. */
+    int xScrollUnits, yScrollUnits;
+    Tcl_Obj *xScrollCmdObjPtr, *yScrollCmdObjPtr;
+
     const char *title;
     unsigned int titleWidth, titleHeight;
     TextStyle titleStyle;		/* Legend title attributes */
@@ -192,6 +207,18 @@ struct _Legend {
 #define padBottom	yPad.side2
 #define PADDING(x)	((x).side1 + (x).side2)
 #define LABEL_PAD	2
+#define FCLAMP(x)	((((x) < 0.0) ? 0.0 : ((x) > 1.0) ? 1.0 : (x)))
+
+/* 
+ * Stale label extents (from relabeled or deleted elements) are dropped when
+ * the cache holds more than twice as many labels as there are elements,
+ * plus this slack.
+ */
+#define LABEL_CACHE_SLACK	100
+
+typedef struct {
+    unsigned int width, height;
+} LabelExtents;
 
 #define DEF_LEGEND_ACTIVEBACKGROUND 	RGB_SKYBLUE4
 #define DEF_LEGEND_ACTIVEBORDERWIDTH    "2"
@@ -220,6 +247,7 @@ struct _Legend {
 #define DEF_LEGEND_SELECT_FG_MONO  	STD_SELECT_FG_MONO
 #define DEF_LEGEND_SELECTFOREGROUND 	RGB_WHITE /*STD_SELECT_FOREGROUND*/
 #define DEF_LEGEND_SELECTRELIEF		"flat"
+#define DEF_LEGEND_SCROLL_INCREMENT	"10"
 #define DEF_LEGEND_FOCUSDASHES		"dot"
 #define DEF_LEGEND_FOCUSEDIT		"no"
 #define DEF_LEGEND_FOCUSFOREGROUND	STD_ACTIVE_FOREGROUND
@@ -343,6 +371,16 @@ static Blt_ConfigSpec configSpecs[] =
 	DEF_LEGEND_TITLECOLOR, Blt_Offset(Legend, titleStyle.color), 0},
     {BLT_CONFIG_FONT, "-titlefont", "titleFont", "Font",
 	DEF_LEGEND_TITLEFONT, Blt_Offset(Legend, titleStyle.font), 0},
+    {BLT_CONFIG_OBJ, "-xscrollcommand", "xScrollCommand", "ScrollCommand",
+	(char *)NULL, Blt_Offset(Legend, xScrollCmdObjPtr), BLT_CONFIG_NULL_OK},
+    {BLT_CONFIG_PIXELS_POS, "-xscrollincrement", "xScrollIncrement",
+	"ScrollIncrement", DEF_LEGEND_SCROLL_INCREMENT, 
+	Blt_Offset(Legend, xScrollUnits), 0},
+    {BLT_CONFIG_OBJ, "-yscrollcommand", "yScrollCommand", "ScrollCommand",
+	(char *)NULL, Blt_Offset(Legend, yScrollCmdObjPtr), BLT_CONFIG_NULL_OK},
+    {BLT_CONFIG_PIXELS_POS, "-yscrollincrement", "yScrollIncrement",
+	"ScrollIncrement", DEF_LEGEND_SCROLL_INCREMENT, 
+	Blt_Offset(Legend, yScrollUnits), 0},
     {BLT_CONFIG_END, NULL, NULL, NULL, NULL, 0, 0}
 };
 
@@ -1058,60 +1096,119 @@ PointerToElement(Legend *legendPtr, int x, int y)
 }
 #endif
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetLabelExtents --
+ *
+ * 	Returns the dimensions of the given label in the legend's font.
+ *	Labels are measured once and their extents cached, so that large
+ *	legends aren't remeasured each time the graph is laid out.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+GetLabelExtents(Legend *legendPtr, const char *label, unsigned int *widthPtr, 
+		unsigned int *heightPtr)
+{
+    Blt_HashEntry *hPtr;
+    LabelExtents *extPtr;
+    int isNew;
+
+    hPtr = Blt_CreateHashEntry(&legendPtr->labelTable, label, &isNew);
+    if (isNew) {
+	extPtr = Blt_AssertMalloc(sizeof(LabelExtents));
+	Blt_Ts_GetExtents(&legendPtr->style, label, &extPtr->width, 
+		&extPtr->height);
+	Blt_SetHashValue(hPtr, extPtr);
+    } else {
+	extPtr = Blt_GetHashValue(hPtr);
+    }
+    *widthPtr = extPtr->width;
+    *heightPtr = extPtr->height;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FlushLabelExtents --
+ *
+ * 	Removes all the cached label extents.  Called when the font of the
+ *	legend changes or the cache has grown much larger than the legend.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+FlushLabelExtents(Legend *legendPtr)
+{
+    Blt_HashEntry *hPtr;
+    Blt_HashSearch iter;
+
+    for (hPtr = Blt_FirstHashEntry(&legendPtr->labelTable, &iter); 
+	 hPtr != NULL; hPtr = Blt_NextHashEntry(&iter)) {
+	LabelExtents *extPtr;
+
+	extPtr = Blt_GetHashValue(hPtr);
+	Blt_Free(extPtr);
+    }
+    Blt_DeleteHashTable(&legendPtr->labelTable);
+    Blt_InitHashTable(&legendPtr->labelTable, BLT_STRING_KEYS);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetEntry --
+ *
+ * 	Returns the element whose legend entry is at the given row and
+ *	column of the legend.
+ *
+ * Results:
+ *	The element or NULL if there is no entry at that position.
+ *
+ *---------------------------------------------------------------------------
+ */
+static Element *
+GetEntry(Legend *legendPtr, int row, int col)
+{
+    if ((legendPtr->entries == NULL) || (row < 0) || (col < 0) || 
+	(row >= legendPtr->nRows) || (col >= legendPtr->nColumns)) {
+	return NULL;
+    }
+    return legendPtr->entries[(col * legendPtr->nRows) + row];
+}
+
 /*ARGSUSED*/
 static ClientData
 PickEntryProc(ClientData clientData, int x, int y, ClientData *contextPtr)
 {
     Graph *graphPtr = clientData;
     Legend *legendPtr;
-    int w, h;
 
     legendPtr = graphPtr->legend;
-    w = legendPtr->width;
-    h = legendPtr->height;
-
+    if ((legendPtr->nEntries == 0) || (legendPtr->entryWidth == 0) ||
+	(legendPtr->entryHeight == 0)) {
+	return NULL;
+    }
+    /* Translate the point to the grid of entries, as drawn. */
+    x -= legendPtr->x + legendPtr->padLeft + legendPtr->borderWidth - 
+	legendPtr->xOffset;
+    y -= legendPtr->y + legendPtr->padTop + legendPtr->borderWidth - 
+	legendPtr->yOffset;
     if (legendPtr->titleHeight > 0) {
 	y -= legendPtr->titleHeight + legendPtr->yPad.side1;
     }
-    x -= legendPtr->x + legendPtr->borderWidth;
-    y -= legendPtr->y + legendPtr->borderWidth;
-    w -= 2 * legendPtr->borderWidth + PADDING(legendPtr->xPad);
-    h -= 2 * legendPtr->borderWidth + PADDING(legendPtr->yPad);
-
-    if ((x >= 0) && (x < w) && (y >= 0) && (y < h)) {
-	int row, column;
-	int n;
-
-	/*
-	 * It's in the bounding box, so compute the index.
-	 */
-	row    = y / legendPtr->entryHeight;
-	column = x / legendPtr->entryWidth;
-	n = (column * legendPtr->nRows) + row;
-	if (n < legendPtr->nEntries) {
-	    Blt_ChainLink link;
-	    int count;
-
-	    /* Legend entries are stored in bottom-to-top. */
-	    count = 0;
-	    for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList);
-		 link != NULL; link = Blt_Chain_NextLink(link)) {
-		Element *elemPtr;
-
-		elemPtr = Blt_Chain_GetValue(link);
-		if (elemPtr->label != NULL) {
-		    if (count == n) {
-			return elemPtr;
-		    }
-		    count++;
-		}
-	    }	      
-	    if (link != NULL) {
-		return Blt_Chain_GetValue(link);
-	    }	
-	}
+    if ((x < 0) || (y < 0)) {
+	return NULL;
     }
-    return NULL;
+    return GetEntry(legendPtr, y / legendPtr->entryHeight, 
+		    x / legendPtr->entryWidth);
 }
 
 /*
@@ -1178,6 +1275,11 @@ Blt_MapLegend(
      * label.  The number of entries would normally be the number of elements,
      * but elements can have no legend entry (-label "").
      */
+    if (legendPtr->labelTable.numEntries > 
+	(2 * Blt_Chain_GetLength(graphPtr->elements.displayList) + 
+	 LABEL_CACHE_SLACK)) {
+	FlushLabelExtents(legendPtr);
+    }
     nEntries = 0;
     maxWidth = maxHeight = 0;
     for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList);
@@ -1189,7 +1291,7 @@ Blt_MapLegend(
 	if (elemPtr->label == NULL) {
 	    continue;			/* Element has no legend entry. */
 	}
-	Blt_Ts_GetExtents(&legendPtr->style, elemPtr->label, &w, &h);
+	GetLabelExtents(legendPtr, elemPtr->label, &w, &h);
 	if (maxWidth < w) {
 	    maxWidth = w;
 	}
@@ -1286,15 +1388,30 @@ Blt_MapLegend(
     legendPtr->entryHeight = maxHeight;
     legendPtr->entryWidth = maxWidth;
 
+    /* 
+     * Lay out the entries in column-major order.  The grid is used to draw
+     * only the visible entries and to find the entry at a given point.
+     */
     {
-	int row, col, count;
+	int row, col, count, nCells;
 
+	nCells = nRows * nColumns;
+	if (legendPtr->entries != NULL) {
+	    Blt_Free(legendPtr->entries);
+	}
+	legendPtr->entries = Blt_AssertCalloc(nCells, sizeof(Element *));
 	row = col = count = 0;
 	for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList);
 	     link != NULL; link = Blt_Chain_NextLink(link)) {
 	    Element *elemPtr;
 	    
 	    elemPtr = Blt_Chain_GetValue(link);
+	    if (elemPtr->label == NULL) {
+		continue;
+	    }
+	    if (count < nCells) {
+		legendPtr->entries[count] = elemPtr;
+	    }
 	    count++;
 	    elemPtr->row = row;
 	    elemPtr->col = col;
@@ -1305,6 +1422,20 @@ Blt_MapLegend(
 	    }
 	}
     }
+    if (legendPtr->site == LEGEND_WINDOW) {
+	/* Keep the view within the legend's new dimensions. */
+	legendPtr->viewWidth = Tk_Width(legendPtr->tkwin);
+	legendPtr->viewHeight = Tk_Height(legendPtr->tkwin);
+	legendPtr->xOffset = Blt_AdjustViewport(legendPtr->xOffset, 
+		legendPtr->width, legendPtr->viewWidth, 
+		legendPtr->xScrollUnits, BLT_SCROLL_MODE_HIERBOX);
+	legendPtr->yOffset = Blt_AdjustViewport(legendPtr->yOffset, 
+		legendPtr->height, legendPtr->viewHeight, 
+		legendPtr->yScrollUnits, BLT_SCROLL_MODE_HIERBOX);
+	legendPtr->flags |= SCROLL_PENDING;
+    } else {
+	legendPtr->xOffset = legendPtr->yOffset = 0;
+    }
     if ((legendPtr->site == LEGEND_WINDOW) &&
 	((Tk_ReqWidth(legendPtr->tkwin) != legendPtr->width) ||
 	 (Tk_ReqHeight(legendPtr->tkwin) != legendPtr->height))) {
@@ -1316,15 +1447,14 @@ void
 Blt_DrawLegend(Graph *graphPtr, Drawable drawable)
 {
     Blt_Background bg;
-    Blt_ChainLink link;
     Blt_FontMetrics fontMetrics;
     Legend *legendPtr = graphPtr->legend;
     Pixmap pixmap;
     Tk_Window tkwin;
-    int count;
+    int row, col, firstRow, lastRow, firstCol, lastCol;
     int symbolSize, xMid, yMid;
     int x, y, w, h;
-    int xLabel, yStart, xSymbol, ySymbol;
+    int xLabel, xStart, yStart, xSymbol, ySymbol;
 
     if ((legendPtr->flags & HIDE) || (legendPtr->nEntries == 0)) {
 	return;
@@ -1383,93 +1513,105 @@ Blt_DrawLegend(Graph *graphPtr, Drawable drawable)
     ySymbol = yMid + legendPtr->iyPad.side1; 
     xSymbol = xMid + LABEL_PAD;
 
-    x = legendPtr->padLeft + legendPtr->borderWidth;
-    y = legendPtr->padTop + legendPtr->borderWidth;
+    x = legendPtr->padLeft + legendPtr->borderWidth - legendPtr->xOffset;
+    y = legendPtr->padTop + legendPtr->borderWidth - legendPtr->yOffset;
     Blt_DrawText(tkwin, pixmap, legendPtr->title, &legendPtr->titleStyle, x, y);
     if (legendPtr->titleHeight > 0) {
 	y += legendPtr->titleHeight + legendPtr->yPad.side1;
     }
-    count = 0;
-    yStart = y;
-    for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList);
-	 link != NULL; link = Blt_Chain_NextLink(link)) {
-	Element *elemPtr;
-	int isSelected;
+    xStart = x, yStart = y;
 
-	elemPtr = Blt_Chain_GetValue(link);
-	if (elemPtr->label == NULL) {
-	    continue;			/* Skip this entry */
-	}
-	isSelected = EntryIsSelected(legendPtr, elemPtr);
-	if (elemPtr->flags & LABEL_ACTIVE) {
-	    int xOrigin, yOrigin;
+    /* 
+     * Draw only the rows and columns of entries that are visible.  Only a
+     * legend in its own (scrolled) window can be partially visible.
+     */
+    firstCol = (xStart < 0) ? -xStart / legendPtr->entryWidth : 0;
+    lastCol = (w - xStart) / legendPtr->entryWidth;
+    if (lastCol >= legendPtr->nColumns) {
+	lastCol = legendPtr->nColumns - 1;
+    }
+    firstRow = (yStart < 0) ? -yStart / legendPtr->entryHeight : 0;
+    lastRow = (h - yStart) / legendPtr->entryHeight;
+    if (lastRow >= legendPtr->nRows) {
+	lastRow = legendPtr->nRows - 1;
+    }
+    for (col = firstCol; col <= lastCol; col++) {
+	for (row = firstRow; row <= lastRow; row++) {
+	    Element *elemPtr;
+	    int isSelected;
 
-	    Blt_GetBackgroundOrigin(legendPtr->activeBg, &xOrigin, &yOrigin);
-	    Blt_SetBackgroundOrigin(tkwin, legendPtr->activeBg, 
-		xOrigin - legendPtr->x, yOrigin - legendPtr->y);
-	    Blt_Ts_SetForeground(legendPtr->style, legendPtr->activeFgColor);
-	    Blt_FillBackgroundRectangle(tkwin, pixmap, legendPtr->activeBg, 
-		x, y, legendPtr->entryWidth, legendPtr->entryHeight, 
-		legendPtr->entryBW, legendPtr->activeRelief);
-	    Blt_SetBackgroundOrigin(tkwin, legendPtr->activeBg, 
-		xOrigin, yOrigin);
-	} else if (isSelected) {
-	    int xOrigin, yOrigin;
-	    Blt_Background bg;
-	    XColor *fg;
-
-	    fg = (legendPtr->flags & FOCUS) ?
-		legendPtr->selInFocusFgColor : legendPtr->selOutFocusFgColor;
-	    bg = (legendPtr->flags & FOCUS) ?
-		    legendPtr->selInFocusBg : legendPtr->selOutFocusBg;
-	    Blt_GetBackgroundOrigin(bg, &xOrigin, &yOrigin);
-	    Blt_SetBackgroundOrigin(tkwin, bg, xOrigin - legendPtr->x, 
-		yOrigin - legendPtr->y);
-	    Blt_Ts_SetForeground(legendPtr->style, fg);
-	    Blt_FillBackgroundRectangle(tkwin, pixmap, bg, x, y, 
-		legendPtr->entryWidth, legendPtr->entryHeight, 
-		legendPtr->selBW, legendPtr->selRelief);
-	    Blt_SetBackgroundOrigin(tkwin, bg, xOrigin, yOrigin);
-	} else {
-	    Blt_Ts_SetForeground(legendPtr->style, legendPtr->fgColor);
-	    if (elemPtr->legendRelief != TK_RELIEF_FLAT) {
-		Blt_FillBackgroundRectangle(tkwin, pixmap, graphPtr->normalBg, 
-			x, y, legendPtr->entryWidth, 
-			legendPtr->entryHeight, legendPtr->entryBW, 
-			elemPtr->legendRelief);
+	    elemPtr = GetEntry(legendPtr, row, col);
+	    if ((elemPtr == NULL) || (elemPtr->label == NULL)) {
+		continue;		/* Skip this entry */
 	    }
-	}
-	(*elemPtr->procsPtr->drawSymbolProc) (graphPtr, pixmap, elemPtr,
-		x + xSymbol, y + ySymbol, symbolSize);
-	Blt_DrawText(tkwin, pixmap, elemPtr->label, &legendPtr->style, 
-		x + xLabel, 
-		y + legendPtr->entryBW + legendPtr->iyPad.side1);
-	count++;
-	if (legendPtr->focusPtr == elemPtr) { /* Focus outline */
-	    if (isSelected) {
-		XColor *color;
-
-		color = (legendPtr->flags & FOCUS) ?
-		    legendPtr->selInFocusFgColor :
+	    x = xStart + (col * legendPtr->entryWidth);
+	    y = yStart + (row * legendPtr->entryHeight);
+	    isSelected = EntryIsSelected(legendPtr, elemPtr);
+	    if (elemPtr->flags & LABEL_ACTIVE) {
+		int xOrigin, yOrigin;
+
+		Blt_GetBackgroundOrigin(legendPtr->activeBg, &xOrigin, 
+			&yOrigin);
+		Blt_SetBackgroundOrigin(tkwin, legendPtr->activeBg, 
+		    xOrigin - legendPtr->x, yOrigin - legendPtr->y);
+		Blt_Ts_SetForeground(legendPtr->style, 
+			legendPtr->activeFgColor);
+		Blt_FillBackgroundRectangle(tkwin, pixmap, legendPtr->activeBg, 
+		    x, y, legendPtr->entryWidth, legendPtr->entryHeight, 
+		    legendPtr->entryBW, legendPtr->activeRelief);
+		Blt_SetBackgroundOrigin(tkwin, legendPtr->activeBg, 
+		    xOrigin, yOrigin);
+	    } else if (isSelected) {
+		int xOrigin, yOrigin;
+		Blt_Background bg;
+		XColor *fg;
+
+		fg = (legendPtr->flags & FOCUS) ?
+		    legendPtr->selInFocusFgColor : 
 		    legendPtr->selOutFocusFgColor;
-		XSetForeground(graphPtr->display, legendPtr->focusGC, 
-			       color->pixel);
+		bg = (legendPtr->flags & FOCUS) ?
+			legendPtr->selInFocusBg : legendPtr->selOutFocusBg;
+		Blt_GetBackgroundOrigin(bg, &xOrigin, &yOrigin);
+		Blt_SetBackgroundOrigin(tkwin, bg, xOrigin - legendPtr->x, 
+		    yOrigin - legendPtr->y);
+		Blt_Ts_SetForeground(legendPtr->style, fg);
+		Blt_FillBackgroundRectangle(tkwin, pixmap, bg, x, y, 
+		    legendPtr->entryWidth, legendPtr->entryHeight, 
+		    legendPtr->selBW, legendPtr->selRelief);
+		Blt_SetBackgroundOrigin(tkwin, bg, xOrigin, yOrigin);
+	    } else {
+		Blt_Ts_SetForeground(legendPtr->style, legendPtr->fgColor);
+		if (elemPtr->legendRelief != TK_RELIEF_FLAT) {
+		    Blt_FillBackgroundRectangle(tkwin, pixmap, 
+			    graphPtr->normalBg, x, y, legendPtr->entryWidth, 
+			    legendPtr->entryHeight, legendPtr->entryBW, 
+			    elemPtr->legendRelief);
+		}
 	    }
-	    XDrawRectangle(graphPtr->display, pixmap, legendPtr->focusGC, 
-		x + 1, y + 1, legendPtr->entryWidth - 3, 
-		legendPtr->entryHeight - 3);
-	    if (isSelected) {
-		XSetForeground(graphPtr->display, legendPtr->focusGC, 
-			legendPtr->focusColor->pixel);
+	    (*elemPtr->procsPtr->drawSymbolProc) (graphPtr, pixmap, elemPtr,
+		    x + xSymbol, y + ySymbol, symbolSize);
+	    Blt_DrawText(tkwin, pixmap, elemPtr->label, &legendPtr->style, 
+		    x + xLabel, 
+		    y + legendPtr->entryBW + legendPtr->iyPad.side1);
+	    if (legendPtr->focusPtr == elemPtr) { /* Focus outline */
+		if (isSelected) {
+		    XColor *color;
+
+		    color = (legendPtr->flags & FOCUS) ?
+			legendPtr->selInFocusFgColor :
+			legendPtr->selOutFocusFgColor;
+		    XSetForeground(graphPtr->display, legendPtr->focusGC, 
+				   color->pixel);
+		}
+		XDrawRectangle(graphPtr->display, pixmap, legendPtr->focusGC, 
+		    x + 1, y + 1, legendPtr->entryWidth - 3, 
+		    legendPtr->entryHeight - 3);
+		if (isSelected) {
+		    XSetForeground(graphPtr->display, legendPtr->focusGC, 
+			    legendPtr->focusColor->pixel);
+		}
 	    }
 	}
-	/* Check when to move to the next column */
-	if ((count % legendPtr->nRows) > 0) {
-	    y += legendPtr->entryHeight;
-	} else {
-	    x += legendPtr->entryWidth;
-	    y = yStart;
-	}
     }
     /*
      * Draw the border and/or background of the legend.
@@ -1622,13 +1764,31 @@ DisplayLegend(ClientData clientData)
 
 	w = Tk_Width(legendPtr->tkwin);
 	h = Tk_Height(legendPtr->tkwin);
-	if ((w != legendPtr->width) || (h != legendPtr->height)) {
+	if ((w != legendPtr->viewWidth) || (h != legendPtr->viewHeight)) {
 	    Blt_MapLegend(graphPtr, w, h);
 	}
     }
     if (Tk_IsMapped(legendPtr->tkwin)) {
 	Blt_DrawLegend(graphPtr, Tk_WindowId(legendPtr->tkwin));
     }
+    if ((legendPtr->site == LEGEND_WINDOW) && 
+	(legendPtr->flags & SCROLL_PENDING)) {
+	Tcl_Interp *interp = graphPtr->interp;
+
+	legendPtr->flags &= ~SCROLL_PENDING;
+	Tcl_Preserve(graphPtr);
+	if (legendPtr->xScrollCmdObjPtr != NULL) {
+	    Blt_UpdateScrollbar(interp, legendPtr->xScrollCmdObjPtr,
+		legendPtr->xOffset, legendPtr->xOffset + legendPtr->viewWidth, 
+		legendPtr->width);
+	}
+	if (legendPtr->yScrollCmdObjPtr != NULL) {
+	    Blt_UpdateScrollbar(interp, legendPtr->yScrollCmdObjPtr,
+		legendPtr->yOffset, legendPtr->yOffset + legendPtr->viewHeight,
+		legendPtr->height);
+	}
+	Tcl_Release(graphPtr);
+    }
 }
 
 /*
@@ -1686,7 +1846,11 @@ Blt_ConfigureLegend(Graph *graphPtr)
      *  position, also indicate that a new layout is needed.
      *
      */
+    if (Blt_ConfigModified(configSpecs, "-font", (char *)NULL)) {
+	FlushLabelExtents(legendPtr);
+    }
     if (legendPtr->site == LEGEND_WINDOW) {
+	legendPtr->flags |= SCROLL_PENDING;
 	Blt_Legend_EventuallyRedraw(graphPtr);
     } else if (Blt_ConfigModified(configSpecs, "-*border*", "-*pad?",
 	"-hide", "-font", "-rows", (char *)NULL)) {
@@ -1722,6 +1886,11 @@ Blt_DestroyLegend(Graph *graphPtr)
     Blt_Ts_FreeStyle(graphPtr->display, &legendPtr->style);
     Blt_Ts_FreeStyle(graphPtr->display, &legendPtr->titleStyle);
     Blt_DestroyBindingTable(legendPtr->bindTable);
+    FlushLabelExtents(legendPtr);
+    Blt_DeleteHashTable(&legendPtr->labelTable);
+    if (legendPtr->entries != NULL) {
+	Blt_Free(legendPtr->entries);
+    }
     
     if (legendPtr->focusGC != NULL) {
 	Blt_FreePrivateGC(graphPtr->display, legendPtr->focusGC);
@@ -1799,6 +1968,7 @@ Blt_CreateLegend(Graph *graphPtr)
 	graphPtr->tkwin, graphPtr, PickEntryProc, Blt_GraphTags);
 
     Blt_InitHashTable(&legendPtr->selectTable, BLT_ONE_WORD_KEYS);
+    Blt_InitHashTable(&legendPtr->labelTable, BLT_STRING_KEYS);
     legendPtr->selected = Blt_Chain_Create();
     Tk_CreateSelHandler(legendPtr->tkwin, XA_PRIMARY, XA_STRING, 
 	SelectionProc, legendPtr, XA_STRING);
@@ -1818,89 +1988,37 @@ Blt_CreateLegend(Graph *graphPtr)
 static Element *
 GetNextRow(Graph *graphPtr, Element *focusPtr)
 {
-    Blt_ChainLink link;
-    int row, col;
-
-    col = focusPtr->col;
-    row = focusPtr->row + 1;
-    for (link = focusPtr->link; link != NULL; link = Blt_Chain_NextLink(link)) {
-	Element *elemPtr;
-
-	elemPtr = Blt_Chain_GetValue(link);
-	if (elemPtr->label == NULL) {
-	    continue;
-	}
-	if ((elemPtr->col == col) && (elemPtr->row == row)) {
-	    return elemPtr;	
-	}
+    if (focusPtr == NULL) {
+	return NULL;
     }
-    return NULL;
+    return GetEntry(graphPtr->legend, focusPtr->row + 1, focusPtr->col);
 }
 
 static Element *
 GetNextColumn(Graph *graphPtr, Element *focusPtr)
 {
-    Blt_ChainLink link;
-    int row, col;
-
-    col = focusPtr->col + 1;
-    row = focusPtr->row;
-    for (link = focusPtr->link; link != NULL; link = Blt_Chain_NextLink(link)) {
-	Element *elemPtr;
-
-	elemPtr = Blt_Chain_GetValue(link);
-	if (elemPtr->label == NULL) {
-	    continue;
-	}
-	if ((elemPtr->col == col) && (elemPtr->row == row)) {
-	    return elemPtr;		/* Don't go beyond legend boundaries. */
-	}
+    if (focusPtr == NULL) {
+	return NULL;
     }
-    return NULL;
+    return GetEntry(graphPtr->legend, focusPtr->row, focusPtr->col + 1);
 }
 
 static Element *
 GetPreviousRow(Graph *graphPtr, Element *focusPtr)
 {
-    Blt_ChainLink link;
-    int row, col;
-
-    col = focusPtr->col;
-    row = focusPtr->row - 1;
-    for (link = focusPtr->link; link != NULL; link = Blt_Chain_PrevLink(link)) {
-	Element *elemPtr;
-
-	elemPtr = Blt_Chain_GetValue(link);
-	if (elemPtr->label == NULL) {
-	    continue;
-	}
-	if ((elemPtr->col == col) && (elemPtr->row == row)) {
-	    return elemPtr;	
-	}
+    if (focusPtr == NULL) {
+	return NULL;
     }
-    return NULL;
+    return GetEntry(graphPtr->legend, focusPtr->row - 1, focusPtr->col);
 }
 
 static Element *
 GetPreviousColumn(Graph *graphPtr, Element *focusPtr)
 {
-    Blt_ChainLink link;
-    int row, col;
-
-    col = focusPtr->col - 1;
-    row = focusPtr->row;
-    for (link = focusPtr->link; link != NULL; link = Blt_Chain_PrevLink(link)) {
-	Element *elemPtr;
-
-	elemPtr = Blt_Chain_GetValue(link);
-	if (elemPtr->label == NULL) {
-	    continue;
-	}
-	if ((elemPtr->col == col) && (elemPtr->row == row)) {
-	    return elemPtr;	
-	}
+    if (focusPtr == NULL) {
+	return NULL;
     }
-    return NULL;
+    return GetEntry(graphPtr->legend, focusPtr->row, focusPtr->col - 1);
 }
 
 static Element *
@@ -2841,6 +2959,116 @@ SelectionOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     return result;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * XviewOp --
+ *
+ *	Scrolls the legend horizontally in its own window.  Without
+ *	arguments, returns the fractions of the legend that are visible.
+ *
+ *	.g legend xview ?moveto fract? ?scroll number what?
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ * Side Effects:
+ *	Legend is redrawn.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+XviewOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    Legend *legendPtr = graphPtr->legend;
+    int w;
+
+    w = (legendPtr->site == LEGEND_WINDOW) ? 
+	Tk_Width(legendPtr->tkwin) : legendPtr->width;
+    if (objc == 3) {
+	double fract;
+	Tcl_Obj *listObjPtr, *objPtr;
+
+	/* Report first and last fractions */
+	listObjPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+	fract = (double)legendPtr->xOffset / (legendPtr->width + 1);
+	objPtr = Tcl_NewDoubleObj(FCLAMP(fract));
+	Tcl_ListObjAppendElement(interp, listObjPtr, objPtr);
+	fract = (double)(legendPtr->xOffset + w) / (legendPtr->width + 1);
+	objPtr = Tcl_NewDoubleObj(FCLAMP(fract));
+	Tcl_ListObjAppendElement(interp, listObjPtr, objPtr);
+	Tcl_SetObjResult(interp, listObjPtr);
+	return TCL_OK;
+    }
+    if (legendPtr->site != LEGEND_WINDOW) {
+	return TCL_OK;			/* Only a legend in its own window can
+					 * be scrolled. */
+    }
+    if (Blt_GetScrollInfoFromObj(interp, objc - 3, objv + 3, 
+	&legendPtr->xOffset, legendPtr->width, w, legendPtr->xScrollUnits, 
+	BLT_SCROLL_MODE_HIERBOX) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    legendPtr->flags |= SCROLL_PENDING;
+    Blt_Legend_EventuallyRedraw(graphPtr);
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * YviewOp --
+ *
+ *	Scrolls the legend vertically in its own window.  Without
+ *	arguments, returns the fractions of the legend that are visible.
+ *
+ *	.g legend yview ?moveto fract? ?scroll number what?
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ * Side Effects:
+ *	Legend is redrawn.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+YviewOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    Legend *legendPtr = graphPtr->legend;
+    int h;
+
+    h = (legendPtr->site == LEGEND_WINDOW) ? 
+	Tk_Height(legendPtr->tkwin) : legendPtr->height;
+    if (objc == 3) {
+	double fract;
+	Tcl_Obj *listObjPtr, *objPtr;
+
+	/* Report first and last fractions */
+	listObjPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+	fract = (double)legendPtr->yOffset / (legendPtr->height + 1);
+	objPtr = Tcl_NewDoubleObj(FCLAMP(fract));
+	Tcl_ListObjAppendElement(interp, listObjPtr, objPtr);
+	fract = (double)(legendPtr->yOffset + h) / (legendPtr->height + 1);
+	objPtr = Tcl_NewDoubleObj(FCLAMP(fract));
+	Tcl_ListObjAppendElement(interp, listObjPtr, objPtr);
+	Tcl_SetObjResult(interp, listObjPtr);
+	return TCL_OK;
+    }
+    if (legendPtr->site != LEGEND_WINDOW) {
+	return TCL_OK;			/* Only a legend in its own window can
+					 * be scrolled. */
+    }
+    if (Blt_GetScrollInfoFromObj(interp, objc - 3, objv + 3, 
+	&legendPtr->yOffset, legendPtr->height, h, legendPtr->yScrollUnits, 
+	BLT_SCROLL_MODE_HIERBOX) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    legendPtr->flags |= SCROLL_PENDING;
+    Blt_Legend_EventuallyRedraw(graphPtr);
+    return TCL_OK;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -2867,6 +3095,10 @@ static Blt_OpSpec legendOps[] =
     {"get",          1, GetOp,           4, 4, "elem",},
     {"icon",         1, IconOp,          5, 5, "elem image",},
     {"selection",    1, SelectionOp,     3, 0, "args"},
+    {"xview",        1, XviewOp,         3, 6, 
+	"?moveto fract? ?scroll number what?",},
+    {"yview",        1, YviewOp,         3, 6, 
+	"?moveto fract? ?scroll number what?",},
 };
 static int nLegendOps = sizeof(legendOps) / sizeof(Blt_OpSpec);
 
@@ -2929,7 +3161,21 @@ Blt_Legend_Y(Graph *graphPtr)
 void
 Blt_Legend_RemoveElement(Graph *graphPtr, Element *elemPtr)
 {
-    Blt_DeleteBindings(graphPtr->legend->bindTable, elemPtr);
+    Legend *legendPtr = graphPtr->legend;
+    
+    Blt_DeleteBindings(legendPtr->bindTable, elemPtr);
+    if (legendPtr->entries != NULL) {
+	int i, nCells;
+
+	/* Don't leave a dangling entry in the grid until the next layout. */
+	nCells = legendPtr->nRows * legendPtr->nColumns;
+	for (i = 0; i < nCells; i++) {
+	    if (legendPtr->entries[i] == elemPtr) {
+		legendPtr->entries[i] = NULL;
+		break;
+	    }
+	}
+    }
 }
 
 /*
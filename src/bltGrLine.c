@@ -35,6 +35,7 @@
 #include "bltBgStyle.h"
 #include "bltImage.h"
 #include "bltBitmap.h"
+#include "bltPainter.h"
 
 #define COLOR_DEFAULT	(XColor *)1
 #define PATTERN_SOLID	((Pixmap)1)
@@ -73,6 +74,29 @@ typedef struct {
     Smoothing value;
 } SmoothingInfo;
 
+typedef enum {
+    DECIMATE_NONE,			/* Map every data point. */
+    DECIMATE_MINMAX			/* Keep the first, last, minimum and
+					 * maximum points of each screen
+					 * column. */
+} Decimation;
+
+typedef enum {
+    REDUCE_DOUGLAS_PEUCKER,		/* Douglas-Peucker. */
+    REDUCE_MONOTONIC,			/* Single pass for increasing
+					 * x-coordinates (time series),
+					 * otherwise Douglas-Peucker. */
+    REDUCE_VISVALINGAM,			/* Visvalingam-Whyatt. */
+    REDUCE_RADIAL			/* Drop points near the last point
+					 * kept. */
+} ReduceMode;
+
+typedef struct {
+    ReduceMode mode;			/* Simplification method. */
+    float tolerance;			/* Tolerance in pixels.  If zero, the
+					 * points aren't reduced. */
+} Reduction;
+
 static SmoothingInfo smoothingInfo[] = {
     { "none",		PEN_SMOOTH_LINEAR	},
     { "linear",		PEN_SMOOTH_LINEAR	},
@@ -163,6 +187,37 @@ typedef struct {
 					 * trace. */
 } Trace;
 
+/*
+ * ClosestIndex --
+ *
+ *	Uniform grid over the screen coordinates of the element's symbol
+ *	points or line segments, used to find the closest one without
+ *	examining each.  Each item is listed in every cell its bounding box
+ *	overlaps.
+ */
+typedef struct {
+    double left, top;			/* Upper left corner of the grid. */
+    double cellWidth, cellHeight;
+    int nCols, nRows;
+    int *cells;				/* Offset of each cell's items in the
+					 * array below. There's one extra
+					 * entry to mark the end of the last
+					 * cell. */
+    int *items;				/* Indices of the points or segments,
+					 * grouped by cell. */
+    Trace **traces;			/* If non-NULL, the items are the
+					 * segments of these traces. */
+    int *firsts;			/* Index of the first segment of each
+					 * trace. */
+    int nTraces;
+    int *candidates;			/* Scratch array of the items found in
+					 * the searched cells. */
+    int nCandidates, candidatesSize;
+} ClosestIndex;
+
+/* Elements with fewer points or segments are searched linearly. */
+#define CLOSEST_INDEX_MIN	1024
+
 typedef struct {
     const char *name;			/* Pen style identifier.  If NULL pen
 					 * was statically allocated. */
@@ -277,6 +332,15 @@ typedef struct {
 					 * symbol. */
     int state;
     Blt_ChainLink link;			/* Element's link in display list. */
+    Region2d exts;			/* Cached data extents of the
+					 * element. Valid only if the
+					 * EXTENTS_CACHED flag is set. */
+    int extsLogScale;			/* Log scales of the X (bit 0) and Y
+					 * (bit 1) axes when the extents were
+					 * computed. */
+    PerfCounter mapPerf;		/* Time spent mapping the element. */
+    int nDrawnPoints;			/* # of screen points (or bars)
+					 * generated by the last mapping. */
 
     /* The line element specific fields start here. */
 
@@ -293,8 +357,10 @@ typedef struct {
     Smoothing reqSmooth;		/* Requested smoothing function to use
 					 * for connecting the data points */
     Smoothing smooth;			/* Smoothing function used. */
-    float rTolerance;			/* Tolerance to reduce the number of
-					 * points displayed. */
+    Reduction reduce;			/* Method and tolerance to reduce the
+					 * number of points displayed. */
+    Decimation decimate;		/* Decimation of the data points
+					 * before they are mapped. */
 
     /* Drawing-related data structures. */
 
@@ -339,8 +405,29 @@ typedef struct {
     GraphSegments lines;		/* Holds the the line segments of the
 					 * element trace. The segments are
 					 * grouped by pen style. */
+    int nMappedPts;			/* # of data points when the element
+					 * was last mapped or scrolled. */
+    int nSortedPts;			/* # of leading data points known to
+					 * have non-decreasing x-coordinates.
+					 * New points can be mapped without
+					 * remapping the others only if all
+					 * of them are. */
+    int scrollLines, scrollSymbols;	/* Indices of the first segment and
+					 * symbol drawn after the element is
+					 * scrolled. The rest are already in
+					 * the scrolled cache pixmap. */
+
+    /* Closest-point search */
+
+    ClosestIndex *pointIndex;		/* Grids of the symbol points and the
+					 * line segments. They're built on */
+    ClosestIndex *segmentIndex;		/* the first search after the element
+					 * is mapped. */
 } LineElement;
 
+typedef void (ItemBoxProc)(LineElement *elemPtr, ClosestIndex *indexPtr,
+	int i, Region2d *regPtr);
+
 static Blt_OptionParseProc ObjToSmoothProc;
 static Blt_OptionPrintProc SmoothToObjProc;
 static Blt_CustomOption smoothOption =
@@ -348,6 +435,20 @@ static Blt_CustomOption smoothOption =
     ObjToSmoothProc, SmoothToObjProc, NULL, (ClientData)0
 };
 
+static Blt_OptionParseProc ObjToDecimateProc;
+static Blt_OptionPrintProc DecimateToObjProc;
+static Blt_CustomOption decimateOption =
+{
+    ObjToDecimateProc, DecimateToObjProc, NULL, (ClientData)0
+};
+
+static Blt_OptionParseProc ObjToReduceProc;
+static Blt_OptionPrintProc ReduceToObjProc;
+static Blt_CustomOption reduceOption =
+{
+    ObjToReduceProc, ReduceToObjProc, NULL, (ClientData)0
+};
+
 static Blt_OptionParseProc ObjToPenDirProc;
 static Blt_OptionPrintProc PenDirToObjProc;
 static Blt_CustomOption penDirOption =
@@ -376,6 +477,7 @@ BLT_EXTERN Blt_CustomOption bltYAxisOption;
 #define DEF_LINE_AXIS_Y			"y"
 #define DEF_LINE_DASHES			(char *)NULL
 #define DEF_LINE_DATA			(char *)NULL
+#define DEF_LINE_DECIMATE		"none"
 #define DEF_LINE_FILL_COLOR    		"defcolor"
 #define DEF_LINE_HIDE			"no"
 #define DEF_LINE_LABEL			(char *)NULL
@@ -443,6 +545,9 @@ static Blt_ConfigSpec lineElemConfigSpecs[] =
 	Blt_Offset(LineElement, builtinPen.traceDashes), BLT_CONFIG_NULL_OK},
     {BLT_CONFIG_CUSTOM, "-data", "data", "Data", DEF_LINE_DATA, 0, 0, 
 	&bltValuePairsOption},
+    {BLT_CONFIG_CUSTOM, "-decimate", "decimate", "Decimate", 
+	DEF_LINE_DECIMATE, Blt_Offset(LineElement, decimate), 
+	BLT_CONFIG_DONT_SET_DEFAULT, &decimateOption},
     {BLT_CONFIG_CUSTOM, "-errorbarcolor", "errorBarColor", "ErrorBarColor",
 	DEF_LINE_ERRORBAR_COLOR, 
 	Blt_Offset(LineElement, builtinPen.errorBarColor), 0, &bltColorOption},
@@ -492,9 +597,9 @@ static Blt_ConfigSpec lineElemConfigSpecs[] =
 	&bltLinePenOption},
     {BLT_CONFIG_PIXELS_NNEG, "-pixels", "pixels", "Pixels", DEF_LINE_PIXELS, 
 	Blt_Offset(LineElement, builtinPen.symbol.size), GRAPH | STRIPCHART}, 
-    {BLT_CONFIG_FLOAT, "-reduce", "reduce", "Reduce",
-	DEF_LINE_REDUCE, Blt_Offset(LineElement, rTolerance),
-	GRAPH | STRIPCHART | BLT_CONFIG_DONT_SET_DEFAULT},
+    {BLT_CONFIG_CUSTOM, "-reduce", "reduce", "Reduce",
+	DEF_LINE_REDUCE, Blt_Offset(LineElement, reduce),
+	GRAPH | STRIPCHART | BLT_CONFIG_DONT_SET_DEFAULT, &reduceOption},
     {BLT_CONFIG_BOOLEAN, "-scalesymbols", "scaleSymbols", "ScaleSymbols",
 	DEF_LINE_SCALE_SYMBOLS, Blt_Offset(LineElement, scaleSymbols),
 	BLT_CONFIG_DONT_SET_DEFAULT},
@@ -579,6 +684,9 @@ static Blt_ConfigSpec stripElemConfigSpecs[] =
 	BLT_CONFIG_NULL_OK},
     {BLT_CONFIG_CUSTOM, "-data", "data", "Data", DEF_LINE_DATA, 0, 0, 
 	&bltValuePairsOption},
+    {BLT_CONFIG_CUSTOM, "-decimate", "decimate", "Decimate", 
+	DEF_LINE_DECIMATE, Blt_Offset(LineElement, decimate), 
+	BLT_CONFIG_DONT_SET_DEFAULT, &decimateOption},
     {BLT_CONFIG_CUSTOM, "-errorbarcolor", "errorBarColor", "ErrorBarColor",
 	DEF_LINE_ERRORBAR_COLOR, 
 	Blt_Offset(LineElement, builtinPen.errorBarColor), 0, &bltColorOption},
@@ -1110,6 +1218,195 @@ SmoothToObjProc(
     return Tcl_NewStringObj(NameOfSmooth(smooth), -1);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ObjToDecimate --
+ *
+ *	Convert the string representation of a decimation mode into its
+ *	numeric form.
+ *
+ * Results:
+ *	The return value is a standard TCL result.  The decimation mode is
+ *	written into the widget record.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ObjToDecimateProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Interpreter to send results back
+					 * to */
+    Tk_Window tkwin,			/* Not used. */
+    Tcl_Obj *objPtr,			/* String representing decimation */
+    char *widgRec,			/* Element information record */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    Decimation *valuePtr = (Decimation *)(widgRec + offset);
+    const char *string;
+
+    string = Tcl_GetString(objPtr);
+    if (strcmp(string, "none") == 0) {
+	*valuePtr = DECIMATE_NONE;
+    } else if (strcmp(string, "minmax") == 0) {
+	*valuePtr = DECIMATE_MINMAX;
+    } else {
+	Tcl_AppendResult(interp, "bad decimate value \"", string, 
+		"\": should be none or minmax", (char *)NULL);
+	return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DecimateToObj --
+ *
+ *	Convert the decimation mode into a string.
+ *
+ * Results:
+ *	The string representing the decimation mode is returned.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static Tcl_Obj *
+DecimateToObjProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Not used. */
+    Tk_Window tkwin,			/* Not used. */
+    char *widgRec,			/* Element information record */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    Decimation decimate = *(Decimation *)(widgRec + offset);
+
+    return Tcl_NewStringObj((decimate == DECIMATE_MINMAX) ? "minmax" : "none",
+	-1);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ObjToReduce --
+ *
+ *	Converts the string representation of a point reduction into its
+ *	method and tolerance.  The string is either a tolerance (for the
+ *	Douglas-Peucker method) or a list of a method and tolerance.
+ *
+ * Results:
+ *	The return value is a standard TCL result.  The reduction is
+ *	written into the widget record.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ObjToReduceProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Interpreter to send results back
+					 * to */
+    Tk_Window tkwin,			/* Not used. */
+    Tcl_Obj *objPtr,			/* String representing reduction */
+    char *widgRec,			/* Element information record */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    Reduction *reducePtr = (Reduction *)(widgRec + offset);
+    Tcl_Obj **objv;
+    int objc;
+    ReduceMode mode;
+    double tolerance;
+
+    if (Tcl_ListObjGetElements(interp, objPtr, &objc, &objv) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    mode = REDUCE_DOUGLAS_PEUCKER;
+    if (objc == 2) {
+	const char *string;
+
+	string = Tcl_GetString(objv[0]);
+	if (strcmp(string, "douglaspeucker") == 0) {
+	    mode = REDUCE_DOUGLAS_PEUCKER;
+	} else if (strcmp(string, "monotonic") == 0) {
+	    mode = REDUCE_MONOTONIC;
+	} else if (strcmp(string, "visvalingam") == 0) {
+	    mode = REDUCE_VISVALINGAM;
+	} else if (strcmp(string, "radial") == 0) {
+	    mode = REDUCE_RADIAL;
+	} else {
+	    Tcl_AppendResult(interp, "bad reduce method \"", string, 
+		"\": should be douglaspeucker, monotonic, visvalingam, or radial",
+		
+		(char *)NULL);
+	    return TCL_ERROR;
+	}
+	objv++;
+    } else if (objc != 1) {
+	Tcl_AppendResult(interp, "bad reduce value \"", Tcl_GetString(objPtr),
+		"\": should be \"?method? tolerance\"", (char *)NULL);
+	return TCL_ERROR;
+    }
+    if (Tcl_GetDoubleFromObj(interp, objv[0], &tolerance) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (tolerance < 0.0) {
+	Tcl_AppendResult(interp, "bad reduce tolerance \"", 
+		Tcl_GetString(objv[0]), "\": can't be negative", (char *)NULL);
+	return TCL_ERROR;
+    }
+    reducePtr->mode = mode;
+    reducePtr->tolerance = (float)tolerance;
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ReduceToObj --
+ *
+ *	Converts the point reduction into a string.  The Douglas-Peucker
+ *	method is represented by its tolerance alone.
+ *
+ * Results:
+ *	The string representing the reduction is returned.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static Tcl_Obj *
+ReduceToObjProc(
+    ClientData clientData,		/* Not used. */
+    Tcl_Interp *interp,			/* Not used. */
+    Tk_Window tkwin,			/* Not used. */
+    char *widgRec,			/* Element information record */
+    int offset,				/* Offset to field in structure */
+    int flags)				/* Not used. */
+{
+    Reduction *reducePtr = (Reduction *)(widgRec + offset);
+    Tcl_Obj *listObjPtr;
+    const char *string;
+
+    switch (reducePtr->mode) {
+    case REDUCE_MONOTONIC:
+	string = "monotonic";		break;
+    case REDUCE_VISVALINGAM:
+	string = "visvalingam";		break;
+    case REDUCE_RADIAL:
+	string = "radial";		break;
+    default:
+	return Tcl_NewDoubleObj(reducePtr->tolerance);
+    }
+    listObjPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+    Tcl_ListObjAppendElement(interp, listObjPtr, Tcl_NewStringObj(string, -1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewDoubleObj(reducePtr->tolerance));
+    return listObjPtr;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1518,6 +1815,25 @@ ScaleSymbol(LineElement *elemPtr, int normalSize)
     return newSize;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetAxisValues --
+ *
+ *	Returns the values as they are mapped onto the axis.  For log scale
+ *	axes, these are the (cached) logs of the values.
+ *
+ *---------------------------------------------------------------------------
+ */
+static double *
+GetAxisValues(Axis *axisPtr, ElemValues *valuesPtr)
+{
+    if (axisPtr->logScale) {
+	return Blt_GetLogValues(valuesPtr);
+    }
+    return valuesPtr->values;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1527,6 +1843,10 @@ ScaleSymbol(LineElement *elemPtr, int normalSize)
  *	the data points.  Coordinates with Inf, -Inf, or NaN values are
  *	removed.
  *
+ *	Each axis is reduced to a scale and offset, so that the points are
+ *	mapped in a single pass without branches or calls to log10.  The
+ *	invalid points are squeezed out afterwards.
+ *
  * Results:
  *	The transformed screen coordinates are returned.
  *
@@ -1543,41 +1863,251 @@ ScaleSymbol(LineElement *elemPtr, int normalSize)
 static void
 GetScreenPoints(Graph *graphPtr, LineElement *elemPtr, MapInfo *mapPtr)
 {
-    double *x, *y;
+    double *x, *y, *h, *v;
+    double hOrigin, hScale, hOffset, vOrigin, vScale, vOffset;
     int i, np;
     int count;
     Point2d *points;
     int *map;
+    Axis *hAxisPtr, *vAxisPtr;
+    ElemValues *hValuesPtr, *vValuesPtr;
 
     np = NUMBEROFPOINTS(elemPtr);
     x = elemPtr->x.values;
     y = elemPtr->y.values;
-    points = Blt_AssertMalloc(sizeof(Point2d) * np);
-    map = Blt_AssertMalloc(sizeof(int) * np);
-
-    count = 0;			      /* Count the valid screen coordinates */
+    points = Blt_AssertMalloc(sizeof(Point2d) * MAX(np, 1));
+    map = Blt_AssertMalloc(sizeof(int) * MAX(np, 1));
     if (graphPtr->inverted) {
+	hAxisPtr = elemPtr->axes.y, hValuesPtr = &elemPtr->y;
+	vAxisPtr = elemPtr->axes.x, vValuesPtr = &elemPtr->x;
+    } else {
+	hAxisPtr = elemPtr->axes.x, hValuesPtr = &elemPtr->x;
+	vAxisPtr = elemPtr->axes.y, vValuesPtr = &elemPtr->y;
+    }
+    count = 0;			      /* Count the valid screen coordinates */
+    if (np > 0) {
+	h = GetAxisValues(hAxisPtr, hValuesPtr);
+	v = GetAxisValues(vAxisPtr, vValuesPtr);
+	Blt_GetAxisTransform(hAxisPtr, FALSE, &hOrigin, &hScale, &hOffset);
+	Blt_GetAxisTransform(vAxisPtr, TRUE, &vOrigin, &vScale, &vOffset);
+	for (i = 0; i < np; i++) {
+	    points[i].x = (h[i] - hOrigin) * hScale + hOffset;
+	    points[i].y = (v[i] - vOrigin) * vScale + vOffset;
+	}
 	for (i = 0; i < np; i++) {
 	    if ((FINITE(x[i])) && (FINITE(y[i]))) {
- 		points[count].x = Blt_HMap(elemPtr->axes.y, y[i]);
-		points[count].y = Blt_VMap(elemPtr->axes.x, x[i]);
+		points[count] = points[i];
 		map[count] = i;
 		count++;
 	    }
 	}
+    }
+    mapPtr->screenPts = points;
+    mapPtr->nScreenPts = count;
+    mapPtr->map = map;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * IsIncreasing --
+ *
+ *	Indicates if the finite values are increasing.  The number of
+ *	leading values already known to be increasing is kept with the
+ *	values, so only values changed or appended since the last test are
+ *	scanned.  For values that aren't increasing, the test stops at the
+ *	same value each time.
+ *
+ * Results:
+ *	Returns 1 if the values are increasing, 0 otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+IsIncreasing(ElemValues *valuesPtr)
+{
+    double *x;
+    double last;
+    int i, n;
+
+    x = valuesPtr->values;
+    n = MIN(valuesPtr->nIncreasing, valuesPtr->nValues);
+    last = -DBL_MAX;
+    for (i = n - 1; i >= 0; i--) {
+	if (FINITE(x[i])) {
+	    last = x[i];
+	    break;
+	}
+    }
+    for (i = n; i < valuesPtr->nValues; i++) {
+	if (FINITE(x[i])) {
+	    if (x[i] < last) {
+		break;
+	    }
+	    last = x[i];
+	}
+    }
+    valuesPtr->nIncreasing = i;
+    return (i == valuesPtr->nValues);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetDecimatedScreenPoints --
+ *
+ *	Generates the screen coordinates of the data points, keeping only
+ *	the first, last, minimum, and maximum points that fall into each
+ *	screen column along the x-axis (M4 decimation).  Since the line
+ *	drawn through these points covers the same pixels as the line
+ *	through all of the data points, there's no visible difference, but
+ *	at most four points are generated per column.
+ *
+ *	This requires that the x-coordinates are increasing, both as data
+ *	and on the screen.  On a log scale, non-positive x-coordinates map
+ *	back and forth on the screen, so the columns are checked as they
+ *	are visited.  Points left or right of the plotting area are
+ *	collected into a single column on each side.  Coordinates with Inf,
+ *	-Inf, or NaN values are removed.
+ *
+ * Results:
+ *	Returns 1 if the points were generated, 0 if the x-coordinates
+ *	aren't monotonic.  In that case, no memory is left allocated.
+ *
+ * Side effects:
+ *	Memory is allocated for the coordinate array.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+GetDecimatedScreenPoints(Graph *graphPtr, LineElement *elemPtr, 
+			 MapInfo *mapPtr)
+{
+    double *x, *y, *xMap, *yMap;
+    double xOrigin, xScale, xOffset, yOrigin, yScale, yOffset;
+    int i, np, count, nCols;
+    int lo, hi, column, direction;
+    int indices[4];
+    int nIndices;
+    Point2d *points;
+    int *map;
+    Axis *xAxisPtr, *yAxisPtr;
+
+    np = NUMBEROFPOINTS(elemPtr);
+    if ((np == 0) || (!IsIncreasing(&elemPtr->x))) {
+	return 0;			/* Not monotonic. */
+    }
+    x = elemPtr->x.values;
+    y = elemPtr->y.values;
+    xAxisPtr = elemPtr->axes.x;
+    yAxisPtr = elemPtr->axes.y;
+    xMap = GetAxisValues(xAxisPtr, &elemPtr->x);
+    yMap = GetAxisValues(yAxisPtr, &elemPtr->y);
+    Blt_GetAxisTransform(xAxisPtr, graphPtr->inverted, &xOrigin, &xScale, 
+	&xOffset);
+    Blt_GetAxisTransform(yAxisPtr, !graphPtr->inverted, &yOrigin, &yScale, 
+	&yOffset);
+    if (graphPtr->inverted) {
+	lo = graphPtr->top, hi = graphPtr->bottom;
     } else {
-	for (i = 0; i < np; i++) {
-	    if ((FINITE(x[i])) && (FINITE(y[i]))) {
-		points[count].x = Blt_HMap(elemPtr->axes.x, x[i]);
-		points[count].y = Blt_VMap(elemPtr->axes.y, y[i]);
-		map[count] = i;
+	lo = graphPtr->left, hi = graphPtr->right;
+    }
+    /* Columns run from lo - 1 to hi + 1, at most 4 points each. */
+    nCols = hi - lo + 3;
+    count = MIN(np, 4 * nCols);
+    points = Blt_AssertMalloc(sizeof(Point2d) * MAX(count, 1));
+    map = Blt_AssertMalloc(sizeof(int) * MAX(count, 1));
+
+    count = 0;
+    nIndices = 0;
+    column = lo - 2;			/* No current column. */
+    direction = (xScale < 0.0) ? -1 : 1;
+    for (i = 0; i <= np; i++) {
+	int c;
+
+	c = lo - 2;
+	if (i < np) {
+	    double screen;
+
+	    if ((!FINITE(x[i])) || (!FINITE(y[i]))) {
+		continue;
+	    }
+	    screen = (xMap[i] - xOrigin) * xScale + xOffset;
+	    if (screen < lo) {
+		c = lo - 1;
+	    } else if (screen > hi) {
+		c = hi + 1;
+	    } else {
+		c = (int)screen;
+	    }
+	    if (c == column) {
+		/* 
+		 * Same column. The first point stays, the current point
+		 * becomes the last, and the minimum and maximum are
+		 * updated.
+		 */
+		if (y[i] < y[indices[1]]) {
+		    indices[1] = i;
+		} 
+		if (y[i] > y[indices[2]]) {
+		    indices[2] = i;
+		}
+		indices[3] = i;
+		continue;
+	    }
+	}
+	if (nIndices > 0) {
+	    int j, k;
+
+	    /* Emit the points of the previous column in data order. */
+	    for (j = 1; j < 4; j++) {
+		int index;
+
+		index = indices[j];
+		for (k = j; (k > 0) && (indices[k - 1] > index); k--) {
+		    indices[k] = indices[k - 1];
+		}
+		indices[k] = index;
+	    }
+	    for (j = 0; j < 4; j++) {
+		int index;
+
+		index = indices[j];
+		if ((j > 0) && (index == indices[j - 1])) {
+		    continue;		/* Duplicate point. */
+		}
+		if (graphPtr->inverted) {
+		    points[count].x = (yMap[index] - yOrigin) * yScale + yOffset;
+		    points[count].y = (xMap[index] - xOrigin) * xScale + xOffset;
+		} else {
+		    points[count].x = (xMap[index] - xOrigin) * xScale + xOffset;
+		    points[count].y = (yMap[index] - yOrigin) * yScale + yOffset;
+		}
+		map[count] = index;
 		count++;
 	    }
 	}
+	if (i < np) {
+	    if ((nIndices > 0) && (((c - column) * direction) < 0)) {
+		/* 
+		 * The screen x-coordinates turned back, so the column would
+		 * be visited again and more than 4 points could be
+		 * generated for it.
+		 */
+		Blt_Free(points);
+		Blt_Free(map);
+		return 0;
+	    }
+	    /* Start a new column. */
+	    column = c;
+	    indices[0] = indices[1] = indices[2] = indices[3] = i;
+	    nIndices = 1;
+	}
     }
     mapPtr->screenPts = points;
     mapPtr->nScreenPts = count;
     mapPtr->map = map;
+    return 1;
 }
 
 /*
@@ -1585,46 +2115,63 @@ GetScreenPoints(Graph *graphPtr, LineElement *elemPtr, MapInfo *mapPtr)
  *
  * ReducePoints --
  *
- *	Generates a coordinate array of transformed screen coordinates from
- *	the data points.
+ *	Removes screen points that don't visibly change the line, using the
+ *	element's reduction method.
  *
  * Results:
- *	The transformed screen coordinates are returned.
+ *	None.
  *
  * Side effects:
- *	Memory is allocated for the coordinate array.
+ *	The coordinate and index arrays are compacted in place.
  *
  *---------------------------------------------------------------------------
  */
 static void
-ReducePoints(MapInfo *mapPtr, double tolerance)
+ReducePoints(MapInfo *mapPtr, Reduction *reducePtr)
 {
     int i, np;
-    Point2d *screenPts;
-    int *map, *simple;
+    Point2d *points;
+    int *simple;
+
+    points = mapPtr->screenPts;
+    simple = Blt_AssertMalloc(mapPtr->nScreenPts * sizeof(int));
+    switch (reducePtr->mode) {
+    case REDUCE_RADIAL:
+	np = Blt_SimplifyLineRadial(points, mapPtr->nScreenPts, 
+		reducePtr->tolerance, simple);
+	break;
+
+    case REDUCE_VISVALINGAM:
+	np = Blt_SimplifyLineVW(points, mapPtr->nScreenPts, 
+		reducePtr->tolerance, simple);
+	break;
 
-    simple    = Blt_AssertMalloc(mapPtr->nScreenPts * sizeof(int));
-    map	      = Blt_AssertMalloc(mapPtr->nScreenPts * sizeof(int));
-    screenPts = Blt_AssertMalloc(mapPtr->nScreenPts * sizeof(Point2d));
-    np = Blt_SimplifyLine(mapPtr->screenPts, 0, mapPtr->nScreenPts - 1, 
-		 tolerance, simple);
+    case REDUCE_MONOTONIC:
+	for (i = 1; i < mapPtr->nScreenPts; i++) {
+	    if (points[i].x < points[i - 1].x) {
+		break;
+	    }
+	}
+	if (i == mapPtr->nScreenPts) {
+	    np = Blt_SimplifyMonotonicLine(points, mapPtr->nScreenPts, 
+		reducePtr->tolerance, simple);
+	    break;
+	}
+	/*FALLTHRU*/
+    default:
+	np = Blt_SimplifyLine(points, 0, mapPtr->nScreenPts - 1, 
+		reducePtr->tolerance, simple);
+	break;
+    }
+    /* The indices are increasing, so the points can be moved in place. */
     for (i = 0; i < np; i++) {
 	int k;
 
 	k = simple[i];
-	screenPts[i] = mapPtr->screenPts[k];
-	map[i] = mapPtr->map[k];
+	points[i] = points[k];
+	mapPtr->map[i] = mapPtr->map[k];
     }
-#ifdef notdef
-    if (np < mapPtr->nScreenPts) {
-	fprintf(stderr, "reduced from %d to %d\n", mapPtr->nScreenPts, np);
-    }
-#endif
-    Blt_Free(mapPtr->screenPts);
-    Blt_Free(mapPtr->map);
     Blt_Free(simple);
-    mapPtr->screenPts = screenPts;
-    mapPtr->map = map;
     mapPtr->nScreenPts = np;
 }
 
@@ -2385,21 +2932,441 @@ SaveTrace(
 /*
  *---------------------------------------------------------------------------
  *
- * FreeTraces --
- *
- *	Deletes all the traces for the line.
+ * PointBoxProc --
  *
- * Results:
- *	None.
+ *	Returns the bounding box of a symbol point.
  *
  *---------------------------------------------------------------------------
  */
+/*ARGSUSED*/
 static void
-FreeTraces(LineElement *elemPtr)
+PointBoxProc(LineElement *elemPtr, ClosestIndex *indexPtr, int i, 
+	     Region2d *regPtr)
 {
-    Blt_ChainLink link;
+    Point2d *p;
 
-    for (link = Blt_Chain_FirstLink(elemPtr->traces); link != NULL;
+    p = elemPtr->symbolPts.points + i;
+    regPtr->left = regPtr->right = p->x;
+    regPtr->top = regPtr->bottom = p->y;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetIndexedSegment --
+ *
+ *	Returns the end points of the *i*th indexed line segment.  The
+ *	segments are either the element's strip segments, or the segments
+ *	between successive points of its traces.
+ *
+ * Results:
+ *	Returns the index of the data point the segment maps to.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+GetIndexedSegment(LineElement *elemPtr, ClosestIndex *indexPtr, int i, 
+		  Point2d **pPtr, Point2d **qPtr)
+{
+    Trace *tracePtr;
+    int low, high;
+
+    if (indexPtr->traces == NULL) {
+	Segment2d *sp;
+
+	sp = elemPtr->lines.segments + i;
+	*pPtr = &sp->p, *qPtr = &sp->q;
+	return elemPtr->lines.map[i];
+    }
+    /* Binary search for the trace holding the segment. */
+    low = 0, high = indexPtr->nTraces - 1;
+    while (low < high) {
+	int mid;
+
+	mid = (low + high + 1) >> 1;
+	if (indexPtr->firsts[mid] <= i) {
+	    low = mid;
+	} else {
+	    high = mid - 1;
+	}
+    }
+    tracePtr = indexPtr->traces[low];
+    i -= indexPtr->firsts[low];
+    *pPtr = tracePtr->screenPts.points + i;
+    *qPtr = *pPtr + 1;
+    return tracePtr->screenPts.map[i];
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SegmentBoxProc --
+ *
+ *	Returns the bounding box of a line segment.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+SegmentBoxProc(LineElement *elemPtr, ClosestIndex *indexPtr, int i, 
+	       Region2d *regPtr)
+{
+    Point2d *p, *q;
+
+    GetIndexedSegment(elemPtr, indexPtr, i, &p, &q);
+    regPtr->left = MIN(p->x, q->x), regPtr->right = MAX(p->x, q->x);
+    regPtr->top = MIN(p->y, q->y), regPtr->bottom = MAX(p->y, q->y);
+}
+
+static int
+GridColumn(ClosestIndex *indexPtr, double x)
+{
+    double col;
+
+    col = (x - indexPtr->left) / indexPtr->cellWidth;
+    if (col < 0.0) {
+	return 0;
+    }
+    return (col < indexPtr->nCols) ? (int)col : indexPtr->nCols - 1;
+}
+
+static int
+GridRow(ClosestIndex *indexPtr, double y)
+{
+    double row;
+
+    row = (y - indexPtr->top) / indexPtr->cellHeight;
+    if (row < 0.0) {
+	return 0;
+    }
+    return (row < indexPtr->nRows) ? (int)row : indexPtr->nRows - 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetGridCoverage --
+ *
+ *	Computes the number of cells each item would be listed in.
+ *
+ * Results:
+ *	Returns the total number of cell entries.
+ *
+ *---------------------------------------------------------------------------
+ */
+static size_t
+GetGridCoverage(LineElement *elemPtr, ClosestIndex *indexPtr, int nItems, 
+		ItemBoxProc *proc)
+{
+    size_t total;
+    int i;
+
+    total = 0;
+    for (i = 0; i < nItems; i++) {
+	Region2d r;
+	size_t nCols, nRows;
+
+	(*proc)(elemPtr, indexPtr, i, &r);
+	nCols = GridColumn(indexPtr, r.right) - GridColumn(indexPtr, r.left) + 1;
+	nRows = GridRow(indexPtr, r.bottom) - GridRow(indexPtr, r.top) + 1;
+	total += nCols * nRows;
+    }
+    return total;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FillClosestIndex --
+ *
+ *	Builds a grid over the given points or line segments.  The grid has
+ *	a few items per cell.  If long segments would be listed in too many
+ *	cells, the grid is made coarser.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+FillClosestIndex(LineElement *elemPtr, ClosestIndex *indexPtr, int nItems,
+		 ItemBoxProc *proc)
+{
+    Region2d exts;
+    double width, height;
+    int nCells, i;
+    int *counts;
+
+    exts.left = exts.top = DBL_MAX;
+    exts.right = exts.bottom = -DBL_MAX;
+    for (i = 0; i < nItems; i++) {
+	Region2d r;
+
+	(*proc)(elemPtr, indexPtr, i, &r);
+	if (r.left < exts.left) {
+	    exts.left = r.left;
+	}
+	if (r.right > exts.right) {
+	    exts.right = r.right;
+	}
+	if (r.top < exts.top) {
+	    exts.top = r.top;
+	}
+	if (r.bottom > exts.bottom) {
+	    exts.bottom = r.bottom;
+	}
+    }
+    width = MAX(exts.right - exts.left, 1.0);
+    height = MAX(exts.bottom - exts.top, 1.0);
+
+    /* Aim for a few items per cell, but not cells smaller than a pixel. */
+    nCells = MAX(nItems / 4, 1);
+    indexPtr->nCols = (int)sqrt(nCells * width / height);
+    indexPtr->nCols = MAX(MIN(indexPtr->nCols, (int)width), 1);
+    indexPtr->nRows = nCells / indexPtr->nCols;
+    indexPtr->nRows = MAX(MIN(indexPtr->nRows, (int)height), 1);
+    indexPtr->left = exts.left, indexPtr->top = exts.top;
+    for (;;) {
+	indexPtr->cellWidth = width / indexPtr->nCols;
+	indexPtr->cellHeight = height / indexPtr->nRows;
+	if (((indexPtr->nCols == 1) && (indexPtr->nRows == 1)) ||
+	    (GetGridCoverage(elemPtr, indexPtr, nItems, proc) <= 
+	     (size_t)nItems * 8)) {
+	    break;
+	}
+	indexPtr->nCols = (indexPtr->nCols + 1) / 2;
+	indexPtr->nRows = (indexPtr->nRows + 1) / 2;
+    }
+
+    /* Count the items of each cell, then convert the counts into
+     * offsets. */
+    nCells = indexPtr->nCols * indexPtr->nRows;
+    indexPtr->cells = Blt_AssertCalloc(nCells + 1, sizeof(int));
+    for (i = 0; i < nItems; i++) {
+	Region2d r;
+	int c1, c2, r1, r2, row, col;
+
+	(*proc)(elemPtr, indexPtr, i, &r);
+	c1 = GridColumn(indexPtr, r.left), c2 = GridColumn(indexPtr, r.right);
+	r1 = GridRow(indexPtr, r.top), r2 = GridRow(indexPtr, r.bottom);
+	for (row = r1; row <= r2; row++) {
+	    for (col = c1; col <= c2; col++) {
+		indexPtr->cells[row * indexPtr->nCols + col + 1]++;
+	    }
+	}
+    }
+    for (i = 1; i <= nCells; i++) {
+	indexPtr->cells[i] += indexPtr->cells[i - 1];
+    }
+    indexPtr->items = Blt_AssertMalloc(sizeof(int) * 
+	MAX(indexPtr->cells[nCells], 1));
+    counts = Blt_AssertCalloc(nCells, sizeof(int));
+    for (i = 0; i < nItems; i++) {
+	Region2d r;
+	int c1, c2, r1, r2, row, col;
+
+	(*proc)(elemPtr, indexPtr, i, &r);
+	c1 = GridColumn(indexPtr, r.left), c2 = GridColumn(indexPtr, r.right);
+	r1 = GridRow(indexPtr, r.top), r2 = GridRow(indexPtr, r.bottom);
+	for (row = r1; row <= r2; row++) {
+	    for (col = c1; col <= c2; col++) {
+		int cell;
+
+		cell = row * indexPtr->nCols + col;
+		indexPtr->items[indexPtr->cells[cell] + counts[cell]] = i;
+		counts[cell]++;
+	    }
+	}
+    }
+    Blt_Free(counts);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * NewPointIndex --
+ *
+ *	Builds the grid of the element's symbol points.
+ *
+ *---------------------------------------------------------------------------
+ */
+static ClosestIndex *
+NewPointIndex(LineElement *elemPtr)
+{
+    ClosestIndex *indexPtr;
+
+    indexPtr = Blt_AssertCalloc(1, sizeof(ClosestIndex));
+    FillClosestIndex(elemPtr, indexPtr, elemPtr->symbolPts.length, 
+		     PointBoxProc);
+    return indexPtr;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * NewSegmentIndex --
+ *
+ *	Builds the grid of the element's line segments: the strip segments
+ *	of a stripchart element, otherwise the segments of its traces.  The
+ *	segments of the traces are numbered consecutively.
+ *
+ *---------------------------------------------------------------------------
+ */
+static ClosestIndex *
+NewSegmentIndex(LineElement *elemPtr)
+{
+    ClosestIndex *indexPtr;
+    int nSegments;
+
+    indexPtr = Blt_AssertCalloc(1, sizeof(ClosestIndex));
+    if (elemPtr->obj.classId == CID_ELEM_STRIP) {
+	nSegments = elemPtr->lines.length;
+    } else {
+	Blt_ChainLink link;
+	int nTraces;
+
+	nTraces = Blt_Chain_GetLength(elemPtr->traces);
+	indexPtr->traces = Blt_AssertMalloc(sizeof(Trace *) * MAX(nTraces, 1));
+	indexPtr->firsts = Blt_AssertMalloc(sizeof(int) * MAX(nTraces, 1));
+	nSegments = 0;
+	for (link = Blt_Chain_FirstLink(elemPtr->traces); link != NULL;
+	     link = Blt_Chain_NextLink(link)) {
+	    Trace *tracePtr;
+
+	    tracePtr = Blt_Chain_GetValue(link);
+	    if (tracePtr->screenPts.length < 2) {
+		continue;
+	    }
+	    indexPtr->traces[indexPtr->nTraces] = tracePtr;
+	    indexPtr->firsts[indexPtr->nTraces] = nSegments;
+	    indexPtr->nTraces++;
+	    nSegments += tracePtr->screenPts.length - 1;
+	}
+    }
+    FillClosestIndex(elemPtr, indexPtr, nSegments, SegmentBoxProc);
+    return indexPtr;
+}
+
+static void
+FreeClosestIndex(ClosestIndex *indexPtr)
+{
+    if (indexPtr == NULL) {
+	return;
+    }
+    Blt_Free(indexPtr->cells);
+    Blt_Free(indexPtr->items);
+    Blt_Free(indexPtr->traces);
+    Blt_Free(indexPtr->firsts);
+    Blt_Free(indexPtr->candidates);
+    Blt_Free(indexPtr);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetCandidates --
+ *
+ *	Collects the items of the cells that may hold an item within the
+ *	distance *h* of the search point.  Along the x-axis, that's the
+ *	points whose x-coordinate is within *h*, or the segments crossing
+ *	the x-coordinate whose y-coordinate there is within *h*.  Likewise
+ *	along the y-axis.  Items may be listed more than once.
+ *
+ * Results:
+ *	Returns 1 if the searched cells cover the whole grid (so every item
+ *	has been examined), 0 otherwise.  The items are left in the
+ *	candidates array of the index.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+GetCandidates(ClosestIndex *indexPtr, ClosestSearch *searchPtr, double h, 
+	      int isSegments)
+{
+    double x, y, right, bottom;
+    double x1, x2, y1, y2;
+    int c1, c2, r1, r2, row, col;
+    int allCols, allRows;
+
+    x = (double)searchPtr->x, y = (double)searchPtr->y;
+    if (isSegments) {
+	h += 1.0;			/* Allow for round off in the
+					 * projections onto the segments. */
+    }
+    right = indexPtr->left + indexPtr->cellWidth * indexPtr->nCols;
+    bottom = indexPtr->top + indexPtr->cellHeight * indexPtr->nRows;
+    x1 = x - h, x2 = x + h;
+    y1 = y - h, y2 = y + h;
+    if (searchPtr->along == SEARCH_X) {
+	if (isSegments) {
+	    x1 = x2 = x;
+	} else {
+	    y1 = -DBL_MAX, y2 = DBL_MAX;
+	}
+    } else if (searchPtr->along == SEARCH_Y) {
+	if (isSegments) {
+	    y1 = y2 = y;
+	} else {
+	    x1 = -DBL_MAX, x2 = DBL_MAX;
+	}
+    }
+    indexPtr->nCandidates = 0;
+    if ((x2 < indexPtr->left) || (x1 > right) || 
+	(y2 < indexPtr->top) || (y1 > bottom)) {
+	/* The search area lies outside of the grid. */
+	return (((x1 == x2) || ((x1 <= indexPtr->left) && (x2 >= right))) &&
+		((y1 == y2) || ((y1 <= indexPtr->top) && (y2 >= bottom))));
+    }
+    allCols = (x1 == x2) || ((x1 <= indexPtr->left) && (x2 >= right));
+    allRows = (y1 == y2) || ((y1 <= indexPtr->top) && (y2 >= bottom));
+    c1 = GridColumn(indexPtr, x1), c2 = GridColumn(indexPtr, x2);
+    r1 = GridRow(indexPtr, y1), r2 = GridRow(indexPtr, y2);
+    for (row = r1; row <= r2; row++) {
+	for (col = c1; col <= c2; col++) {
+	    int cell, n;
+
+	    cell = row * indexPtr->nCols + col;
+	    n = indexPtr->cells[cell + 1] - indexPtr->cells[cell];
+	    if ((indexPtr->nCandidates + n) > indexPtr->candidatesSize) {
+		int *candidates;
+
+		indexPtr->candidatesSize = 
+		    MAX(indexPtr->nCandidates + n, 
+			indexPtr->candidatesSize * 2);
+		candidates = Blt_AssertMalloc(sizeof(int) * 
+					      indexPtr->candidatesSize);
+		if (indexPtr->nCandidates > 0) {
+		    memcpy(candidates, indexPtr->candidates, 
+			   sizeof(int) * indexPtr->nCandidates);
+		}
+		Blt_Free(indexPtr->candidates);
+		indexPtr->candidates = candidates;
+	    }
+	    memcpy(indexPtr->candidates + indexPtr->nCandidates, 
+		   indexPtr->items + indexPtr->cells[cell], sizeof(int) * n);
+	    indexPtr->nCandidates += n;
+	}
+    }
+    return (allCols && allRows);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FreeTraces --
+ *
+ *	Deletes all the traces for the line.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+FreeTraces(LineElement *elemPtr)
+{
+    Blt_ChainLink link;
+
+    for (link = Blt_Chain_FirstLink(elemPtr->traces); link != NULL;
 	link = Blt_Chain_NextLink(link)) {
 	Trace *tracePtr;
 
@@ -2586,6 +3553,9 @@ MapFillArea(Graph *graphPtr, LineElement *elemPtr, MapInfo *mapPtr)
 static void
 ResetLine(LineElement *elemPtr)
 {
+    FreeClosestIndex(elemPtr->pointIndex);
+    FreeClosestIndex(elemPtr->segmentIndex);
+    elemPtr->pointIndex = elemPtr->segmentIndex = NULL;
     FreeTraces(elemPtr);
     ResetStylePalette(elemPtr->styles);
     if (elemPtr->symbolPts.points != NULL) {
@@ -2807,10 +3777,15 @@ MapLineProc(Graph *graphPtr, Element *basePtr)
     
     ResetLine(elemPtr);
     np = NUMBEROFPOINTS(elemPtr);
+    elemPtr->nMappedPts = np;
+    elemPtr->nSortedPts = 0;
     if (np < 1) {
 	return;				/* No data points */
     }
-    GetScreenPoints(graphPtr, elemPtr, &mi);
+    if ((elemPtr->decimate != DECIMATE_MINMAX) ||
+	(!GetDecimatedScreenPoints(graphPtr, elemPtr, &mi))) {
+	GetScreenPoints(graphPtr, elemPtr, &mi);
+    }
     MapSymbols(graphPtr, elemPtr, &mi);
 
     if ((elemPtr->flags & ACTIVE_PENDING) && (elemPtr->nActiveIndices > 0)) {
@@ -2841,55 +3816,273 @@ MapLineProc(Graph *graphPtr, Element *basePtr)
 	    }
 	    break;
 
-	case PEN_SMOOTH_CATROM:
-	    if (mi.nScreenPts < 3) {
-		/* Can't interpolate with less than three points. */
-		elemPtr->smooth = PEN_SMOOTH_LINEAR;
-	    } else {
-		GenerateParametricSpline(graphPtr, elemPtr, &mi);
-	    }
-	    break;
+	case PEN_SMOOTH_CATROM:
+	    if (mi.nScreenPts < 3) {
+		/* Can't interpolate with less than three points. */
+		elemPtr->smooth = PEN_SMOOTH_LINEAR;
+	    } else {
+		GenerateParametricSpline(graphPtr, elemPtr, &mi);
+	    }
+	    break;
+
+	default:
+	    break;
+	}
+	if (elemPtr->reduce.tolerance > 0.0) {
+	    ReducePoints(&mi, &elemPtr->reduce);
+	}
+	if (elemPtr->fillBg != NULL) {
+	    MapFillArea(graphPtr, elemPtr, &mi);
+	}
+	if (graphPtr->classId == CID_ELEM_STRIP) {
+	    MapStrip(graphPtr, elemPtr, &mi);
+	} else {
+	    MapTraces(graphPtr, elemPtr, &mi);
+	}
+    }
+    Blt_Free(mi.screenPts);
+    Blt_Free(mi.map);
+
+    /* Set the symbol size of all the pen styles. */
+    for (link = Blt_Chain_FirstLink(elemPtr->styles); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	LineStyle *stylePtr;
+	LinePen *penPtr;
+
+	stylePtr = Blt_Chain_GetValue(link);
+	penPtr = (LinePen *)stylePtr->penPtr;
+	size = ScaleSymbol(elemPtr, penPtr->symbol.size);
+	stylePtr->symbolSize = size;
+	stylePtr->errorBarCapWidth = (penPtr->errorBarCapWidth > 0) 
+	    ? penPtr->errorBarCapWidth : Round(size * 0.6666666);
+	stylePtr->errorBarCapWidth /= 2;
+    }
+    styleMap = (LineStyle **)Blt_StyleMap((Element *)elemPtr);
+    if (((elemPtr->yHigh.nValues > 0) && (elemPtr->yLow.nValues > 0)) ||
+	((elemPtr->xHigh.nValues > 0) && (elemPtr->xLow.nValues > 0)) ||
+	(elemPtr->xError.nValues > 0) || (elemPtr->yError.nValues > 0)) {
+	MapErrorBars(graphPtr, elemPtr, styleMap);
+    }
+    MergePens(elemPtr, styleMap);
+    Blt_Free(styleMap);
+
+    /* 
+     * Count the screen points of the traces (or strip segments) left after
+     * clipping and reduction.  If only symbols are drawn, count them.
+     */
+    elemPtr->nDrawnPoints = elemPtr->lines.length;
+    for (link = Blt_Chain_FirstLink(elemPtr->traces); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	Trace *tracePtr;
+
+	tracePtr = Blt_Chain_GetValue(link);
+	elemPtr->nDrawnPoints += tracePtr->screenPts.length;
+    }
+    if (elemPtr->nDrawnPoints == 0) {
+	elemPtr->nDrawnPoints = elemPtr->symbolPts.length;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ScrollLineProc --
+ *
+ *	Updates the screen coordinates of the stripchart element when the
+ *	x-axis has only slid left by dx pixels.  The segments and symbols
+ *	are shifted rather than remapped, and only the points appended
+ *	since the element was last mapped are transformed.
+ *
+ *	This requires that the x-coordinates are non-decreasing, so that no
+ *	old point can come into view.  The last segments reaching the old
+ *	right edge of the plotting area may have been clipped, so they are
+ *	regenerated too.  Elements with smoothing, point reduction, error
+ *	bars, or multiple pen styles can't be scrolled.
+ *
+ * Results:
+ *	Returns the number of points mapped or -1 if the element can't be
+ *	scrolled.  In that case, it must be remapped.
+ *
+ * Side effects:
+ *	The arrays of segments and symbols are reallocated.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+ScrollLineProc(Graph *graphPtr, Element *basePtr, int dx)
+{
+    LineElement *elemPtr = (LineElement *)basePtr;
+    LineStyle *stylePtr;
+    Region2d exts;
+    Segment2d *segments, *sp;
+    Point2d *points, *pp, prev;
+    int *segMap, *symMap;
+    double *x, *y, *h, *v;
+    double hOrigin, hScale, hOffset, vOrigin, vScale, vOffset;
+    double last, edge;
+    int np, i, nSegments, nSymbols, first, lastIndex, symbolStart, prevIndex;
+
+    np = NUMBEROFPOINTS(elemPtr);
+    if ((graphPtr->classId != CID_ELEM_STRIP) || (graphPtr->inverted) ||
+	(Blt_Chain_GetLength(elemPtr->styles) != 1) ||
+	(elemPtr->lines.length == 0) || (np < elemPtr->nMappedPts) || 
+	(elemPtr->reqSmooth != PEN_SMOOTH_LINEAR) || 
+	(elemPtr->reduce.tolerance > 0.0) ||
+	(elemPtr->decimate != DECIMATE_NONE) || (elemPtr->fillBg != NULL) || 
+	(elemPtr->reqMaxSymbols > 0) || (elemPtr->nActiveIndices > 0) ||
+	(elemPtr->flags & (ACTIVE|ACTIVE_PENDING|SCALE_SYMBOL)) ||
+	(elemPtr->yHigh.nValues > 0) || (elemPtr->yLow.nValues > 0) || 
+	(elemPtr->xHigh.nValues > 0) || (elemPtr->xLow.nValues > 0) || 
+	(elemPtr->xError.nValues > 0) || (elemPtr->yError.nValues > 0)) {
+	return -1;
+    }
+    stylePtr = Blt_Chain_FirstValue(elemPtr->styles);
+    if (((LinePen *)stylePtr->penPtr)->valueShow != SHOW_NONE) {
+	return -1;
+    }
+    x = elemPtr->x.values;
+    y = elemPtr->y.values;
+
+    /* Check that the x-coordinates of the new points are non-decreasing.
+     * The old points were checked the last time around. */
+    last = -DBL_MAX;
+    for (i = elemPtr->nSortedPts - 1; i >= 0; i--) {
+	if (FINITE(x[i])) {
+	    last = x[i];
+	    break;
+	}
+    }
+    for (i = elemPtr->nSortedPts; i < np; i++) {
+	if (FINITE(x[i])) {
+	    if (x[i] < last) {
+		break;
+	    }
+	    last = x[i];
+	}
+    }
+    elemPtr->nSortedPts = i;
+    if (i < np) {
+	return -1;
+    }
+
+    /* 
+     * Drop the last segments that reach the old right edge of the plotting
+     * area.  They may have been clipped.  Every point before the start of
+     * the last segment kept lies left of the edge.
+     */
+    Blt_GraphExtents(graphPtr, &exts);
+    nSegments = elemPtr->lines.length;
+    segments = elemPtr->lines.segments;
+    while ((nSegments > 0) && 
+	   (MAX(segments[nSegments - 1].p.x, segments[nSegments - 1].q.x) >=
+	    (exts.right - 1.0))) {
+	nSegments--;
+    }
+    if (nSegments == 0) {
+	return -1;
+    }
+    lastIndex = elemPtr->lines.map[nSegments - 1];
+    symbolStart = lastIndex + 1;
+    if (elemPtr->symbolPts.length > 0) {
+	symbolStart = MAX(symbolStart, 
+		elemPtr->symbolPts.map[elemPtr->symbolPts.length - 1] + 1);
+    }
+
+    /* Shift the segments and symbols that are kept.  Clip them against
+     * the left edge of the plotting area. */
+    segments = Blt_AssertMalloc(sizeof(Segment2d) * (nSegments + np - lastIndex));
+    segMap = Blt_AssertMalloc(sizeof(int) * (nSegments + np - lastIndex));
+    first = nSegments;
+    nSegments = 0;
+    for (i = 0; i < first; i++) {
+	sp = segments + nSegments;
+	*sp = elemPtr->lines.segments[i];
+	sp->p.x += dx, sp->q.x += dx;
+	if ((MIN(sp->p.x, sp->q.x) < exts.left) && 
+	    (!Blt_LineRectClip(&exts, &sp->p, &sp->q))) {
+	    continue;
+	}
+	segMap[nSegments] = elemPtr->lines.map[i];
+	nSegments++;
+    }
+    points = Blt_AssertMalloc(sizeof(Point2d) * 
+		(elemPtr->symbolPts.length + np - lastIndex));
+    symMap = Blt_AssertMalloc(sizeof(int) * 
+		(elemPtr->symbolPts.length + np - lastIndex));
+    nSymbols = 0;
+    for (i = 0; i < elemPtr->symbolPts.length; i++) {
+	pp = points + nSymbols;
+	*pp = elemPtr->symbolPts.points[i];
+	pp->x += dx;
+	if (PointInRegion(&exts, pp->x, pp->y)) {
+	    symMap[nSymbols] = elemPtr->symbolPts.map[i];
+	    nSymbols++;
+	}
+    }
+
+    /* Symbols that overlapped the old right edge were cut off when the
+     * plot was scrolled, so they're drawn again. */
+    edge = graphPtr->right + dx - stylePtr->symbolSize;
+    elemPtr->scrollLines = nSegments;
+    elemPtr->scrollSymbols = nSymbols;
+    while ((elemPtr->scrollSymbols > 0) && 
+	   (points[elemPtr->scrollSymbols - 1].x > edge)) {
+	elemPtr->scrollSymbols--;
+    }
+
+    /* Map the points following the last segment kept. */
+    h = GetAxisValues(elemPtr->axes.x, &elemPtr->x);
+    v = GetAxisValues(elemPtr->axes.y, &elemPtr->y);
+    Blt_GetAxisTransform(elemPtr->axes.x, FALSE, &hOrigin, &hScale, &hOffset);
+    Blt_GetAxisTransform(elemPtr->axes.y, TRUE, &vOrigin, &vScale, &vOffset);
+    prevIndex = -1;
+    prev.x = prev.y = 0.0;
+    for (i = lastIndex + 1; i < np; i++) {
+	Point2d p;
 
-	default:
-	    break;
-	}
-	if (elemPtr->rTolerance > 0.0) {
-	    ReducePoints(&mi, elemPtr->rTolerance);
+	if ((!FINITE(x[i])) || (!FINITE(y[i]))) {
+	    continue;
 	}
-	if (elemPtr->fillBg != NULL) {
-	    MapFillArea(graphPtr, elemPtr, &mi);
+	p.x = (h[i] - hOrigin) * hScale + hOffset;
+	p.y = (v[i] - vOrigin) * vScale + vOffset;
+	if ((i >= symbolStart) && (PointInRegion(&exts, p.x, p.y))) {
+	    points[nSymbols] = p;
+	    symMap[nSymbols] = i;
+	    nSymbols++;
 	}
-	if (graphPtr->classId == CID_ELEM_STRIP) {
-	    MapStrip(graphPtr, elemPtr, &mi);
-	} else {
-	    MapTraces(graphPtr, elemPtr, &mi);
+	if (prevIndex >= 0) {
+	    sp = segments + nSegments;
+	    sp->p = prev, sp->q = p;
+	    if (Blt_LineRectClip(&exts, &sp->p, &sp->q)) {
+		segMap[nSegments] = prevIndex;
+		nSegments++;
+	    }
 	}
+	prev = p;
+	prevIndex = i;
     }
-    Blt_Free(mi.screenPts);
-    Blt_Free(mi.map);
-
-    /* Set the symbol size of all the pen styles. */
-    for (link = Blt_Chain_FirstLink(elemPtr->styles); link != NULL;
-	 link = Blt_Chain_NextLink(link)) {
-	LineStyle *stylePtr;
-	LinePen *penPtr;
 
-	stylePtr = Blt_Chain_GetValue(link);
-	penPtr = (LinePen *)stylePtr->penPtr;
-	size = ScaleSymbol(elemPtr, penPtr->symbol.size);
-	stylePtr->symbolSize = size;
-	stylePtr->errorBarCapWidth = (penPtr->errorBarCapWidth > 0) 
-	    ? penPtr->errorBarCapWidth : Round(size * 0.6666666);
-	stylePtr->errorBarCapWidth /= 2;
+    FreeClosestIndex(elemPtr->pointIndex);
+    FreeClosestIndex(elemPtr->segmentIndex);
+    elemPtr->pointIndex = elemPtr->segmentIndex = NULL;
+    Blt_Free(elemPtr->lines.segments);
+    Blt_Free(elemPtr->lines.map);
+    if (elemPtr->symbolPts.points != NULL) {
+	Blt_Free(elemPtr->symbolPts.points);
     }
-    styleMap = (LineStyle **)Blt_StyleMap((Element *)elemPtr);
-    if (((elemPtr->yHigh.nValues > 0) && (elemPtr->yLow.nValues > 0)) ||
-	((elemPtr->xHigh.nValues > 0) && (elemPtr->xLow.nValues > 0)) ||
-	(elemPtr->xError.nValues > 0) || (elemPtr->yError.nValues > 0)) {
-	MapErrorBars(graphPtr, elemPtr, styleMap);
+    if (elemPtr->symbolPts.map != NULL) {
+	Blt_Free(elemPtr->symbolPts.map);
     }
-    MergePens(elemPtr, styleMap);
-    Blt_Free(styleMap);
+    elemPtr->lines.segments = segments;
+    elemPtr->lines.map = segMap;
+    elemPtr->lines.length = nSegments;
+    elemPtr->symbolPts.points = points;
+    elemPtr->symbolPts.map = symMap;
+    elemPtr->symbolPts.length = nSymbols;
+    MergePens(elemPtr, NULL);
+    elemPtr->nDrawnPoints = (nSegments > 0) ? nSegments : nSymbols;
+    elemPtr->nMappedPts = np;
+    return np - lastIndex - 1;
 }
 
 static double
@@ -3020,6 +4213,74 @@ DistanceToYProc(
     return FABS(d);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ClosestIndexedSegment --
+ *
+ *	Find the line segment closest to the given window coordinate using
+ *	the grid of the element's segments.  The search area is widened
+ *	until it holds the closest segment.
+ *
+ * Results:
+ *	If a new minimum distance is found, the information regarding it is
+ *	returned via searchPtr.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+ClosestIndexedSegment(
+    Graph *graphPtr,			/* Graph widget record */
+    LineElement *elemPtr,
+    ClosestSearch *searchPtr,		/* Info about closest point in
+					 * element */
+    DistanceProc *distProc)
+{
+    ClosestIndex *indexPtr = elemPtr->segmentIndex;
+    Point2d closest;
+    double dMin, h;
+    int iClose, iSegment;
+
+    iClose = iSegment = -1;
+    dMin = searchPtr->dist;
+    closest.x = closest.y = 0;		/* Suppress compiler warning. */
+    h = MIN(MAX(indexPtr->cellWidth, indexPtr->cellHeight), dMin);
+    for (;;) {
+	int covered, i;
+
+	covered = GetCandidates(indexPtr, searchPtr, h, TRUE);
+	for (i = 0; i < indexPtr->nCandidates; i++) {
+	    Point2d *p, *q, b;
+	    double d;
+	    int index, segment;
+
+	    segment = indexPtr->candidates[i];
+	    index = GetIndexedSegment(elemPtr, indexPtr, segment, &p, &q);
+	    d = (*distProc)(searchPtr->x, searchPtr->y, p, q, &b);
+	    /* Ties go to the first segment, as in a linear search. */
+	    if ((d < dMin) || ((d == dMin) && (segment < iSegment))) {
+		closest = b;
+		iClose = index;
+		iSegment = segment;
+		dMin = d;
+	    }
+	}
+	if ((covered) || (dMin < h) || (h >= searchPtr->dist)) {
+	    break;
+	}
+	h = MIN(h + h, searchPtr->dist);
+    }
+    if (dMin < searchPtr->dist) {
+	searchPtr->dist = dMin;
+	searchPtr->elemPtr = (Element *)elemPtr;
+	searchPtr->index = iClose;
+	searchPtr->point = Blt_InvMap2D(graphPtr, closest.x, closest.y,
+	    &elemPtr->axes);
+	return TRUE;
+    }
+    return FALSE;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -3047,6 +4308,24 @@ ClosestTrace(
     double dMin;
     int iClose;
 
+    if (elemPtr->segmentIndex == NULL) {
+	int nSegments;
+
+	nSegments = 0;
+	for (link = Blt_Chain_FirstLink(elemPtr->traces); link != NULL;
+	     link = Blt_Chain_NextLink(link)) {
+	    Trace *tracePtr;
+
+	    tracePtr = Blt_Chain_GetValue(link);
+	    nSegments += MAX(tracePtr->screenPts.length - 1, 0);
+	}
+	if (nSegments >= CLOSEST_INDEX_MIN) {
+	    elemPtr->segmentIndex = NewSegmentIndex(elemPtr);
+	}
+    }
+    if (elemPtr->segmentIndex != NULL) {
+	return ClosestIndexedSegment(graphPtr, elemPtr, searchPtr, distProc);
+    }
     iClose = -1;			/* Suppress compiler warning. */
     dMin = searchPtr->dist;
     closest.x = closest.y = 0;		/* Suppress compiler warning. */
@@ -3108,6 +4387,12 @@ ClosestStrip(
     int iClose;
     Segment2d *sp;
 
+    if (elemPtr->lines.length >= CLOSEST_INDEX_MIN) {
+	if (elemPtr->segmentIndex == NULL) {
+	    elemPtr->segmentIndex = NewSegmentIndex(elemPtr);
+	}
+	return ClosestIndexedSegment(graphPtr, elemPtr, searchPtr, distProc);
+    }
     iClose = 0;
     dMin = searchPtr->dist;
     closest.x = closest.y = 0;
@@ -3134,6 +4419,21 @@ ClosestStrip(
     return FALSE;
 }
 
+static double
+PointDistance(ClosestSearch *searchPtr, Point2d *p)
+{
+    double dx, dy;
+
+    dx = (double)searchPtr->x - p->x;
+    dy = (double)searchPtr->y - p->y;
+    if (searchPtr->along == SEARCH_X) {
+	return FABS(dx);
+    } else if (searchPtr->along == SEARCH_Y) {
+	return FABS(dy);
+    }
+    return hypot(dx, dy);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -3167,26 +4467,51 @@ ClosestPoint(
      *   1) only examine points that are visible (unclipped), and
      *   2) the computed distance is already in screen coordinates.
      */
-    for (pp = elemPtr->symbolPts.points, count = 0; 
-	 count < elemPtr->symbolPts.length; count++, pp++) {
-	double dx, dy;
-	double d;
+    if (elemPtr->symbolPts.length >= CLOSEST_INDEX_MIN) {
+	ClosestIndex *indexPtr;
+	double h;
+	int iPoint;
 
-	dx = (double)(searchPtr->x - pp->x);
-	dy = (double)(searchPtr->y - pp->y);
-	if (searchPtr->along == SEARCH_BOTH) {
-	    d = hypot(dx, dy);
-	} else if (searchPtr->along == SEARCH_X) {
-	    d = fabs( dx );
-	} else if (searchPtr->along == SEARCH_Y) {
-	    d = fabs( dy );
-	} else {
-	    /* This can't happen */
-	    continue;
+	if (elemPtr->pointIndex == NULL) {
+	    elemPtr->pointIndex = NewPointIndex(elemPtr);
 	}
-	if (d < dMin) {
-	    iClose = elemPtr->symbolPts.map[count];
-	    dMin = d;
+	indexPtr = elemPtr->pointIndex;
+	iPoint = -1;
+	/* Widen the search area until it holds the closest point. */
+	h = MIN(MAX(indexPtr->cellWidth, indexPtr->cellHeight), dMin);
+	for (;;) {
+	    int covered, i;
+
+	    covered = GetCandidates(indexPtr, searchPtr, h, FALSE);
+	    for (i = 0; i < indexPtr->nCandidates; i++) {
+		double d;
+
+		count = indexPtr->candidates[i];
+		d = PointDistance(searchPtr, elemPtr->symbolPts.points + count);
+		/* Ties go to the first point, as in a linear search. */
+		if ((d < dMin) || ((d == dMin) && (count < iPoint))) {
+		    iPoint = count;
+		    dMin = d;
+		}
+	    }
+	    if ((covered) || (dMin < h) || (h >= searchPtr->dist)) {
+		break;
+	    }
+	    h = MIN(h + h, searchPtr->dist);
+	}
+	if (iPoint >= 0) {
+	    iClose = elemPtr->symbolPts.map[iPoint];
+	}
+    } else {
+	for (pp = elemPtr->symbolPts.points, count = 0; 
+	     count < elemPtr->symbolPts.length; count++, pp++) {
+	    double d;
+
+	    d = PointDistance(searchPtr, pp);
+	    if (d < dMin) {
+		iClose = elemPtr->symbolPts.map[count];
+		dMin = d;
+	    }
 	}
     }
     if (dMin < searchPtr->dist) {
@@ -4677,6 +6002,44 @@ DrawNormalLineProc(Graph *graphPtr, Drawable drawable, Element *basePtr)
     elemPtr->symbolInterval = 0;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DrawScrolledLineProc --
+ *
+ *	Draws the segments and symbols of the stripchart element that
+ *	aren't already in the graph's scrolled cache pixmap.  See
+ *	ScrollLineProc.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+DrawScrolledLineProc(Graph *graphPtr, Drawable drawable, Element *basePtr)
+{
+    LineElement *elemPtr = (LineElement *)basePtr;
+    LineStyle *stylePtr;
+    LinePen *penPtr;
+
+    stylePtr = Blt_Chain_FirstValue(elemPtr->styles);
+    penPtr = (LinePen *)stylePtr->penPtr;
+    /* Same test as DrawNormalLineProc. */
+    if ((elemPtr->lines.length > elemPtr->scrollLines) && 
+	(penPtr->errorBarLineWidth > 0)) {
+	Blt_Draw2DSegments(graphPtr->display, drawable, penPtr->traceGC,
+		elemPtr->lines.segments + elemPtr->scrollLines, 
+		elemPtr->lines.length - elemPtr->scrollLines);
+    }
+    if ((elemPtr->symbolPts.length > elemPtr->scrollSymbols) && 
+	(penPtr->symbol.type != SYMBOL_NONE)) {
+	DrawSymbols(graphPtr, drawable, elemPtr, penPtr, stylePtr->symbolSize,
+		elemPtr->symbolPts.length - elemPtr->scrollSymbols, 
+		elemPtr->symbolPts.points + elemPtr->scrollSymbols);
+    }
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -4900,11 +6263,79 @@ SetLineAttributes(Blt_Ps ps, LinePen *penPtr)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DecimateTrace --
+ *
+ *	Reduces each run of consecutive trace points that fall into the
+ *	same screen column to its first, minimum, maximum, and last points
+ *	(in that order along the trace).  The line through the reduced
+ *	points covers the same pixels at screen resolution, but has at most
+ *	four points per column.  Columns run along the y-axis if the graph
+ *	is inverted.
+ *
+ * Results:
+ *	Returns the number of points written into the output array, which
+ *	must be as large as the input array.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+DecimateTrace(Point2d *points, int nPoints, int inverted, Point2d *outPts)
+{
+    int i, count;
+
+    count = 0;
+    for (i = 0; i < nPoints; /*empty*/) {
+	int j, column, lo, hi, first, last;
+	double loValue, hiValue;
+
+	first = lo = hi = i;
+	column = (int)floor((inverted) ? points[i].y : points[i].x);
+	loValue = hiValue = (inverted) ? points[i].x : points[i].y;
+	for (j = i + 1; j < nPoints; j++) {
+	    double value;
+
+	    if ((int)floor((inverted) ? points[j].y : points[j].x) != column) {
+		break;
+	    }
+	    value = (inverted) ? points[j].x : points[j].y;
+	    if (value < loValue) {
+		loValue = value, lo = j;
+	    }
+	    if (value > hiValue) {
+		hiValue = value, hi = j;
+	    }
+	}
+	last = j - 1;
+	if (lo > hi) {
+	    int tmp;
+
+	    tmp = lo, lo = hi, hi = tmp;
+	}
+	outPts[count++] = points[first];
+	if ((lo != first) && (lo != last)) {
+	    outPts[count++] = points[lo];
+	}
+	if ((hi != first) && (hi != last) && (hi != lo)) {
+	    outPts[count++] = points[hi];
+	}
+	if (last != first) {
+	    outPts[count++] = points[last];
+	}
+	i = j;
+    }
+    return count;
+}
+
 static void
 TracesToPostScript(Blt_Ps ps, LineElement *elemPtr, LinePen *penPtr)
 {
     Blt_ChainLink link;
+    int inverted;
 
+    inverted = elemPtr->obj.graphPtr->inverted;
     SetLineAttributes(ps, penPtr);
     for (link = Blt_Chain_FirstLink(elemPtr->traces); link != NULL;
 	link = Blt_Chain_NextLink(link)) {
@@ -4912,10 +6343,17 @@ TracesToPostScript(Blt_Ps ps, LineElement *elemPtr, LinePen *penPtr)
 
 	tracePtr = Blt_Chain_GetValue(link);
 	if (tracePtr->screenPts.length > 0) {
+	    Point2d *points;
+	    int nPoints;
+
+	    points = Blt_AssertMalloc(tracePtr->screenPts.length * 
+		sizeof(Point2d));
+	    nPoints = DecimateTrace(tracePtr->screenPts.points, 
+		tracePtr->screenPts.length, inverted, points);
 	    Blt_Ps_Append(ps, "% start trace\n");
-	    Blt_Ps_DrawPolyline(ps, tracePtr->screenPts.points, 
-		tracePtr->screenPts.length);
+	    Blt_Ps_DrawPolyline(ps, points, nPoints);
 	    Blt_Ps_Append(ps, "% end trace\n");
+	    Blt_Free(points);
 	}
     }
 }
@@ -5169,6 +6607,158 @@ DestroyLineProc(Graph *graphPtr, Element *basePtr)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SymbolsToPicture --
+ *
+ *	Paints the square or circle symbols centered at each of the given
+ *	points into the picture.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+SymbolsToPicture(Blt_Picture picture, LinePen *penPtr, int size, 
+		 int nSymbolPts, Point2d *symbolPts)
+{
+    Blt_Pixel fill, outline;
+    Point2d *pp, *pend;
+    XColor *colorPtr;
+    int r, hasFill;
+
+    colorPtr = penPtr->symbol.fillColor;
+    if (colorPtr == COLOR_DEFAULT) {
+	colorPtr = penPtr->traceColor;
+    }
+    hasFill = (colorPtr != NULL);
+    if (hasFill) {
+	fill = Blt_XColorToPixel(colorPtr);
+    }
+    colorPtr = penPtr->symbol.outlineColor;
+    if (colorPtr == COLOR_DEFAULT) {
+	colorPtr = penPtr->traceColor;
+    }
+    outline = Blt_XColorToPixel(colorPtr);
+    if (size < 3) {
+	if (hasFill) {
+	    for (pp = symbolPts, pend = pp + nSymbolPts; pp < pend; pp++) {
+		Blt_PaintRectangle(picture, Round(pp->x), Round(pp->y), 1, 1, 
+			0, 0, &fill);
+	    }
+	}
+	return;
+    }
+    if (penPtr->symbol.type == SYMBOL_CIRCLE) {
+	r = (int)ceil(size * 0.5);
+    } else {
+	r = (int)ceil(size * S_RATIO * 0.5);
+    }
+    for (pp = symbolPts, pend = pp + nSymbolPts; pp < pend; pp++) {
+	int x, y;
+
+	x = Round(pp->x), y = Round(pp->y);
+	if (penPtr->symbol.type == SYMBOL_CIRCLE) {
+	    if (hasFill) {
+		Blt_PaintCircle(picture, x, y, r, 0, &fill);
+	    }
+	    if (penPtr->symbol.outlineWidth > 0) {
+		Blt_PaintCircle(picture, x, y, r, penPtr->symbol.outlineWidth, 
+			&outline);
+	    }
+	} else {
+	    if (hasFill) {
+		Blt_PaintRectangle(picture, x - r, y - r, r + r, r + r, 0, 0, 
+			&fill);
+	    }
+	    if (penPtr->symbol.outlineWidth > 0) {
+		Blt_PaintRectangle(picture, x - r, y - r, r + r + 1, r + r + 1, 
+			0, penPtr->symbol.outlineWidth, &outline);
+	    }
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * LineToPictureProc --
+ *
+ *	Paints the traces and symbols of the line element into the picture,
+ *	without drawing through X.  Only one pixel wide, solid traces and
+ *	square or circle symbols can be painted.
+ *
+ * Results:
+ *	Returns 1 if the element was painted.  Returns 0, before anything is
+ *	painted, if the element has area fills, error bars, values, or
+ *	other features that can only be drawn through X.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+LineToPictureProc(Graph *graphPtr, Blt_Picture picture, Element *basePtr)
+{
+    LineElement *elemPtr = (LineElement *)basePtr;
+    LinePen *penPtr;
+    Blt_ChainLink link;
+
+    if ((elemPtr->fillPts != NULL) || (elemPtr->lines.length > 0) ||
+	(elemPtr->reqMaxSymbols > 0)) {
+	return FALSE;
+    }
+    for (link = Blt_Chain_FirstLink(elemPtr->styles); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	LineStyle *stylePtr;
+
+	stylePtr = Blt_Chain_GetValue(link);
+	penPtr = (LinePen *)stylePtr->penPtr;
+	if (((stylePtr->xeb.length > 0) && (penPtr->errorBarShow & SHOW_X)) ||
+	    ((stylePtr->yeb.length > 0) && (penPtr->errorBarShow & SHOW_Y)) ||
+	    (penPtr->valueShow != SHOW_NONE)) {
+	    return FALSE;
+	}
+	if ((stylePtr->symbolPts.length > 0) &&
+	    (penPtr->symbol.type != SYMBOL_NONE) &&
+	    (penPtr->symbol.type != SYMBOL_SQUARE) &&
+	    (penPtr->symbol.type != SYMBOL_CIRCLE)) {
+	    return FALSE;
+	}
+    }
+    penPtr = NORMALPEN(elemPtr);
+    if ((Blt_Chain_GetLength(elemPtr->traces) > 0) && 
+	(penPtr->traceWidth > 0)) {
+	Blt_Pixel color;
+
+	if ((penPtr->traceWidth > 1) || (LineIsDashed(penPtr->traceDashes))) {
+	    return FALSE;
+	}
+	color = Blt_XColorToPixel(penPtr->traceColor);
+	for (link = Blt_Chain_FirstLink(elemPtr->traces); link != NULL;
+	     link = Blt_Chain_NextLink(link)) {
+	    Trace *tracePtr;
+
+	    tracePtr = Blt_Chain_GetValue(link);
+	    Blt_PaintPolyline(picture, tracePtr->screenPts.length, 
+		tracePtr->screenPts.points, &color);
+	}
+    }
+    for (link = Blt_Chain_FirstLink(elemPtr->styles); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	LineStyle *stylePtr;
+
+	stylePtr = Blt_Chain_GetValue(link);
+	penPtr = (LinePen *)stylePtr->penPtr;
+	if ((stylePtr->symbolPts.length > 0) && 
+	    (penPtr->symbol.type != SYMBOL_NONE)) {
+	    SymbolsToPicture(picture, penPtr, stylePtr->symbolSize, 
+		stylePtr->symbolPts.length, stylePtr->symbolPts.points);
+	}
+    }
+    return TRUE;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -5199,8 +6789,13 @@ static ElementProcs lineProcs =
     ActiveLineToPostScriptProc,		/* Prints active element. */
     NormalLineToPostScriptProc,		/* Prints normal element. */
     SymbolToPostScriptProc,		/* Prints the line's symbol. */
-    MapLineProc				/* Compute element's screen
+    MapLineProc,			/* Compute element's screen
+					 * coordinates. */
+    ScrollLineProc,			/* Shift element's screen
 					 * coordinates. */
+    DrawScrolledLineProc,		/* Draws new segments and symbols of
+					 * scrolled element. */
+    LineToPictureProc			/* Paints element into a picture. */
 };
 
 Element *
@@ -5306,8 +6901,8 @@ MapLineProc(Graph *graphPtr, Element *basePtr)
 	default:
 	    break;
 	}
-	if (elemPtr->rTolerance > 0.0) {
-	    ReducePoints(&mi, elemPtr->rTolerance);
+	if (elemPtr->reduce.tolerance > 0.0) {
+	    ReducePoints(&mi, &elemPtr->reduce);
 	}
 	if (elemPtr->fillBg != NULL) {
 	    MapFillArea(graphPtr, elemPtr, &mi);
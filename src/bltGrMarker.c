@@ -44,6 +44,12 @@ typedef int (GraphMarkerProc)(Graph *graphPtr, Tcl_Interp *interp, int objc,
 #define MAX_OUTLINE_POINTS	12
 
 #define IMAGE_PHOTO		(1<<7)
+#define CULLED			(1<<8)	/* The marker lies outside of the
+					 * plotting area and wasn't mapped.
+					 * Its screen coordinates are
+					 * invalid. */
+#define INDEXED			(1<<9)	/* The marker has an entry in the
+					 * marker index. */
 
 /* Map graph coordinates to normalized coordinates [0..1] */
 #define NORMALIZE(A,x) 	(((x) - (A)->axisRange.min) * (A)->axisRange.scale)
@@ -184,11 +190,122 @@ struct _Marker {
 
     unsigned int flags;		
 
+    int indexPos;			/* Position of the marker's entry in
+					 * the marker index.  Valid only if
+					 * the INDEXED flag is set. */
 
     int xOffset, yOffset;		/* Pixel offset from graph position */
 
     int state;
 };
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MarkerIndex --
+ *
+ *	Index of the graph's markers sorted by the extents of their
+ *	x-coordinates.  When the axes change, only the markers whose extents
+ *	overlap the visible ranges of both their x and y axes are mapped.
+ *	The others are culled.  Markers whose screen size isn't known
+ *	beforehand (windows) or whose x-coordinates are elastic (-Inf or
+ *	Inf) can't be indexed and are always mapped.
+ *
+ *	When a marker is reconfigured, its entry is updated in place.  The
+ *	index is rebuilt lazily, the next time all the markers are mapped,
+ *	only after a marker is created or deleted, or changes its x-axis or
+ *	whether it can be indexed.
+ *
+ * -------------------------------------------------------------------------- 
+ */
+typedef struct {
+    Axis *axisPtr;			/* X-axis of the marker. */
+    double min, max;			/* Extents of the marker's
+					 * x-coordinates. */
+    Axis *yAxisPtr;			/* Y-axis of the marker. */
+    double yMin, yMax;			/* Extents of the marker's
+					 * y-coordinates.  If they are elastic
+					 * or there's no y-axis, the marker
+					 * isn't culled on y. */
+    int margin;				/* # of pixels the marker may extend
+					 * beyond its coordinates. */
+    Marker *markerPtr;
+} MarkerIndexEntry;
+
+typedef struct {
+    int first, last;			/* Range of entries sharing the
+					 * x-axis. */
+    double maxSpan;			/* Largest extent (max - min) of the
+					 * above entries. */
+    int maxMargin;			/* Largest margin of the above
+					 * entries. */
+} MarkerIndexGroup;
+
+struct _MarkerIndex {
+    int dirty;				/* Indicates the index must be rebuilt
+					 * before it's used again. */
+    MarkerIndexEntry *entries;		/* Indexed markers sorted by x-axis
+					 * and then minimum x-coordinate. */
+    int nEntries;
+    MarkerIndexGroup *groups;		/* Entries grouped by x-axis. */
+    int nGroups;
+    Marker **others;			/* Markers that can't be indexed. */
+    int nOthers;
+    Marker **visible;			/* Indexed markers that were mapped.
+					 * They are culled again before the
+					 * index is next queried. */
+    int nVisible;
+};
+
+static void
+InvalidateMarkerIndex(Graph *graphPtr)
+{
+    if (graphPtr->markerIndex != NULL) {
+	graphPtr->markerIndex->dirty = TRUE;
+    }
+}
+
+static void UpdateMarkerIndex(Marker *markerPtr);
+
+static void
+UncullMarker(Marker *markerPtr)
+{
+    MarkerIndex *indexPtr = markerPtr->obj.graphPtr->markerIndex;
+
+    if (markerPtr->flags & CULLED) {
+	markerPtr->flags &= ~CULLED;
+	/* Track the marker as visible, so that it's culled again before
+	 * the index is next queried. */
+	if ((indexPtr != NULL) && (!indexPtr->dirty) && 
+	    (markerPtr->flags & INDEXED)) {
+	    indexPtr->visible[indexPtr->nVisible++] = markerPtr;
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MapCulledMarker --
+ *
+ *	Maps a marker that was culled.  This is done only when its screen
+ *	coordinates are needed other than for drawing, such as for
+ *	PostScript output or searching for markers.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+MapCulledMarker(Marker *markerPtr)
+{
+    if (markerPtr->flags & CULLED) {
+	(*markerPtr->classPtr->mapProc) (markerPtr);
+	UncullMarker(markerPtr);
+    }
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -226,6 +343,9 @@ typedef struct {
 
     unsigned int flags;		
 
+    int indexPos;			/* Position of the marker's entry in
+					 * the marker index.  Valid only if
+					 * the INDEXED flag is set. */
 
     int xOffset, yOffset;		/* Pixel offset from graph position */
 
@@ -363,6 +483,9 @@ typedef struct {
 
     unsigned int flags;		
 
+    int indexPos;			/* Position of the marker's entry in
+					 * the marker index.  Valid only if
+					 * the INDEXED flag is set. */
 
     int xOffset, yOffset;		/* Pixel offset from graph position */
 
@@ -476,6 +599,9 @@ typedef struct {
 
     unsigned int flags;		
 
+    int indexPos;			/* Position of the marker's entry in
+					 * the marker index.  Valid only if
+					 * the INDEXED flag is set. */
 
     int xOffset, yOffset;		/* Pixel offset from graph position */
 
@@ -608,6 +734,9 @@ typedef struct {
 
     unsigned int flags;		
 
+    int indexPos;			/* Position of the marker's entry in
+					 * the marker index.  Valid only if
+					 * the INDEXED flag is set. */
 
     int xOffset, yOffset;		/* Pixel offset from graph position */
 
@@ -755,6 +884,9 @@ typedef struct {
 					 * clipped by the plotting area. */
     unsigned int flags;		
 
+    int indexPos;			/* Position of the marker's entry in
+					 * the marker index.  Valid only if
+					 * the INDEXED flag is set. */
 
     int xOffset, yOffset;		/* Pixel offset from graph position */
     int state;
@@ -773,6 +905,12 @@ typedef struct {
     int width, height;			/* Dimension of bounding box. */
     TextStyle style;			/* Text attributes (font, fg, anchor,
 					 * etc) */
+    TextLayout *layoutPtr;		/* Layout of the text.  It's computed
+					 * when the marker is configured,
+					 * rather than each time the marker
+					 * is mapped or drawn. */
+    const char *layoutString;		/* String of the above layout.  The
+					 * layout points into it. */
     Point2d outline[5];
     XColor *fillColor;
     GC fillGC;
@@ -892,6 +1030,9 @@ typedef struct {
 
     unsigned int flags;		
 
+    int indexPos;			/* Position of the marker's entry in
+					 * the marker index.  Valid only if
+					 * the INDEXED flag is set. */
 
     int xOffset, yOffset;		/* Pixel offset from graph position */
 
@@ -1531,6 +1672,8 @@ ImageChangedProc(
     }
     graphPtr->flags |= CACHE_DIRTY;
     imPtr->flags |= MAP_ITEM;
+    UpdateMarkerIndex((Marker *)imPtr); /* The image's size may have
+					 * changed. */
     Blt_EventuallyRedrawGraph(graphPtr);
 }
 
@@ -1801,6 +1944,7 @@ CreateMarker(
     markerPtr->flags |= MAP_ITEM;
     markerPtr->obj.name = Blt_AssertStrdup(name);
     Blt_GraphSetObjectClass(&markerPtr->obj, classId);
+    InvalidateMarkerIndex(graphPtr);
     return markerPtr;
 }
 
@@ -1815,6 +1959,7 @@ DestroyMarker(Marker *markerPtr)
 	 * elements, then backing store needs to be repaired. */
 	graphPtr->flags |= CACHE_DIRTY;
     }
+    InvalidateMarkerIndex(graphPtr);
     /* 
      * Call the marker's type-specific deallocation routine. We do it first
      * while all the marker fields are still valid.
@@ -2711,6 +2856,52 @@ CreateImageProc(void)
     return (Marker *)imPtr;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * LayoutText --
+ *
+ *	Computes the layout and the bounding box of the text marker's string.
+ *	They depend only upon the string and the text style, so they are
+ *	kept until the marker is reconfigured.  Mapping and drawing the
+ *	marker then don't need to measure the text again.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The old layout is freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+LayoutText(TextMarker *tmPtr)
+{
+    if (tmPtr->layoutPtr != NULL) {
+	Blt_Free(tmPtr->layoutPtr);
+	tmPtr->layoutPtr = NULL;
+    }
+    tmPtr->layoutString = tmPtr->string;
+    tmPtr->width = tmPtr->height = 0;
+    if (tmPtr->string != NULL) {
+	double rw, rh;
+	int i;
+
+	tmPtr->layoutPtr = Blt_Ts_CreateLayout(tmPtr->string, -1, 
+		&tmPtr->style);
+	Blt_GetBoundingBox(tmPtr->layoutPtr->width, tmPtr->layoutPtr->height,
+		tmPtr->style.angle, &rw, &rh, tmPtr->outline);
+	tmPtr->width = ROUND(rw);
+	tmPtr->height = ROUND(rh);
+	for (i = 0; i < 4; i++) {
+	    tmPtr->outline[i].x += ROUND(rw * 0.5);
+	    tmPtr->outline[i].y += ROUND(rh * 0.5);
+	}
+	tmPtr->outline[4].x = tmPtr->outline[0].x;
+	tmPtr->outline[4].y = tmPtr->outline[0].y;
+    }
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -2754,6 +2945,7 @@ ConfigureTextProc(Marker *markerPtr)
     }
     tmPtr->fillGC = newGC;
 
+    LayoutText(tmPtr);
     markerPtr->flags |= MAP_ITEM;
     if (markerPtr->drawUnder) {
 	graphPtr->flags |= CACHE_DIRTY;
@@ -2788,24 +2980,14 @@ MapTextProc(Marker *markerPtr)
     TextMarker *tmPtr = (TextMarker *)markerPtr;
     Region2d extents;
     Point2d anchorPt;
-    int i;
-    unsigned int w, h;
-    double rw, rh;
 
-    tmPtr->width = tmPtr->height = 0;
+    if (tmPtr->layoutString != tmPtr->string) {
+	LayoutText(tmPtr);		/* String changed without the marker
+					 * being configured again. */
+    }
     if (tmPtr->string == NULL) {
 	return;
     }
-    Blt_Ts_GetExtents(&tmPtr->style, tmPtr->string, &w, &h);
-    Blt_GetBoundingBox(w, h, tmPtr->style.angle, &rw, &rh, tmPtr->outline);
-    tmPtr->width = ROUND(rw);
-    tmPtr->height = ROUND(rh);
-    for (i = 0; i < 4; i++) {
-	tmPtr->outline[i].x += ROUND(rw * 0.5);
-	tmPtr->outline[i].y += ROUND(rh * 0.5);
-    }
-    tmPtr->outline[4].x = tmPtr->outline[0].x;
-    tmPtr->outline[4].y = tmPtr->outline[0].y;
     anchorPt = MapPoint(markerPtr->worldPts, &markerPtr->axes);
     anchorPt = Blt_AnchorPoint(anchorPt.x, anchorPt.y, (double)(tmPtr->width), 
 	(double)(tmPtr->height), tmPtr->anchor);
@@ -2933,7 +3115,7 @@ DrawTextProc(Marker *markerPtr, Drawable drawable)
 	    Convex, CoordModeOrigin);
     }
     if (tmPtr->style.color != NULL) {
-	Blt_Ts_DrawText(graphPtr->tkwin, drawable, tmPtr->string, -1,
+	Blt_Ts_DrawLayout(graphPtr->tkwin, drawable, tmPtr->layoutPtr,
 	    &tmPtr->style, (int)tmPtr->anchorPt.x, (int)tmPtr->anchorPt.y);
     }
 }
@@ -3004,6 +3186,9 @@ FreeTextProc(Marker *markerPtr)
     Graph *graphPtr = markerPtr->obj.graphPtr;
 
     Blt_Ts_FreeStyle(graphPtr->display, &tmPtr->style);
+    if (tmPtr->layoutPtr != NULL) {
+	Blt_Free(tmPtr->layoutPtr);
+    }
 }
 
 /*
@@ -4380,19 +4565,22 @@ ConfigureOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 	if (Blt_ConfigureWidgetFromObj(interp, graphPtr->tkwin, 
 		markerPtr->classPtr->configSpecs, nOpts, options, 
 		(char *)markerPtr, flags) != TCL_OK) {
+	    InvalidateMarkerIndex(graphPtr);
 	    return TCL_ERROR;
 	}
 	if (oldName != markerPtr->obj.name) {
 	    if (RenameMarker(graphPtr, markerPtr, oldName, markerPtr->obj.name)
 		!= TCL_OK) {
 		markerPtr->obj.name = oldName;
+		InvalidateMarkerIndex(graphPtr);
 		return TCL_ERROR;
 	    }
 	}
 	if ((*markerPtr->classPtr->configProc) (markerPtr) != TCL_OK) {
-
+	    InvalidateMarkerIndex(graphPtr);
 	    return TCL_ERROR;
 	}
+	UpdateMarkerIndex(markerPtr);
 	if (markerPtr->drawUnder != under) {
 	    graphPtr->flags |= CACHE_DIRTY;
 	}
@@ -4705,6 +4893,7 @@ FindOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 	if ((markerPtr->elemName != NULL) && (IsElementHidden(markerPtr))) {
 	    continue;
 	}
+	MapCulledMarker(markerPtr);
 	if ((*markerPtr->classPtr->regionProc)(markerPtr, &extents, enclosed)) {
 	    Tcl_Obj *objPtr;
 
@@ -4860,12 +5049,222 @@ Blt_MarkersToPostScript(Graph *graphPtr, Blt_Ps ps, int under)
 	if ((markerPtr->elemName != NULL) && (IsElementHidden(markerPtr))) {
 	    continue;
 	}
+	MapCulledMarker(markerPtr);
 	Blt_Ps_VarAppend(ps, "\n% Marker \"", markerPtr->obj.name, 
 		"\" is a ", markerPtr->obj.className, ".\n", (char *)NULL);
 	(*markerPtr->classPtr->postscriptProc) (markerPtr, ps);
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * IsMarkerDrawn --
+ *
+ *	Indicates if the marker is drawn at the given level (above/below
+ *	the elements).  See Blt_DrawMarkers.
+ *
+ * Results:
+ *	Returns 1 if the marker is drawn, 0 otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+IsMarkerDrawn(Marker *markerPtr, int under)
+{
+    if ((markerPtr->nWorldPts == 0) || 
+	(markerPtr->drawUnder != under) ||
+	(markerPtr->clipped) ||
+	(markerPtr->flags & (DELETE_PENDING|HIDE))) {
+	return FALSE;
+    }
+    if ((markerPtr->elemName != NULL) && (IsElementHidden(markerPtr))) {
+	return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DrawLineMarkers --
+ *
+ *	Draws the line markers starting at the given link of the display
+ *	list.  Consecutive line markers sharing the same GC are drawn with a
+ *	single XDrawSegments call.  Markers that aren't drawn may lie between
+ *	them.  XOR-ed markers are drawn individually.
+ *
+ * Results:
+ *	Returns the link of the next marker to be drawn.
+ *
+ *---------------------------------------------------------------------------
+ */
+static Blt_ChainLink
+DrawLineMarkers(Graph *graphPtr, Drawable drawable, Blt_ChainLink link, 
+		int under)
+{
+    LineMarker *firstPtr;
+    Blt_ChainLink next, last;
+    XSegment *segments, *dp;
+    int nMarkers, nSegments;
+
+    firstPtr = Blt_Chain_GetValue(link);
+    if (firstPtr->xor) {
+	DrawLineProc((Marker *)firstPtr, drawable);
+	return Blt_Chain_PrevLink(link);
+    }
+    /* Find the markers in the batch. */
+    nSegments = nMarkers = 0;
+    for (last = link; last != NULL; last = Blt_Chain_PrevLink(last)) {
+	LineMarker *lmPtr;
+
+	lmPtr = Blt_Chain_GetValue(last);
+	if (!IsMarkerDrawn((Marker *)lmPtr, under)) {
+	    continue;
+	}
+	if ((lmPtr->obj.classId != CID_MARKER_LINE) || (lmPtr->xor) || 
+	    (lmPtr->gc != firstPtr->gc)) {
+	    break;
+	}
+	nSegments += lmPtr->nSegments;
+	nMarkers++;
+    }
+    if (nMarkers == 1) {
+	DrawLineProc((Marker *)firstPtr, drawable);
+	return last;
+    }
+    segments = Blt_AssertMalloc(nSegments * sizeof(XSegment));
+    dp = segments;
+    for (next = link; next != last; next = Blt_Chain_PrevLink(next)) {
+	LineMarker *lmPtr;
+	Segment2d *sp, *send;
+
+	lmPtr = Blt_Chain_GetValue(next);
+	if (!IsMarkerDrawn((Marker *)lmPtr, under)) {
+	    continue;
+	}
+	for (sp = lmPtr->segments, send = sp + lmPtr->nSegments; sp < send; 
+	     sp++) {
+	    dp->x1 = (short int)sp->p.x;
+	    dp->y1 = (short int)sp->p.y;
+	    dp->x2 = (short int)sp->q.x;
+	    dp->y2 = (short int)sp->q.y;
+	    dp++;
+	}
+    }
+    XDrawSegments(graphPtr->display, drawable, firstPtr->gc, segments, 
+	nSegments);
+    Blt_Free(segments);
+    return last;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DrawTextMarkers --
+ *
+ *	Draws the text markers starting at the given link of the display
+ *	list.  The backgrounds of consecutive, unrotated text markers sharing
+ *	the same fill GC are drawn with a single XFillRectangles call before
+ *	their text.  This is done only while the backgrounds don't overlap
+ *	(tested against the bounding box of the batch), so that the markers
+ *	look the same as if drawn one at a time.
+ *
+ * Results:
+ *	Returns the link of the next marker to be drawn.
+ *
+ *---------------------------------------------------------------------------
+ */
+static Blt_ChainLink
+DrawTextMarkers(Graph *graphPtr, Drawable drawable, Blt_ChainLink link, 
+		int under)
+{
+    TextMarker *firstPtr;
+    Blt_ChainLink next, last;
+    XRectangle *rects;
+    Region2d exts;
+    int nMarkers;
+
+    firstPtr = Blt_Chain_GetValue(link);
+    if ((firstPtr->fillGC == NULL) || (firstPtr->style.angle != 0.0f) ||
+	(firstPtr->string == NULL)) {
+	DrawTextProc((Marker *)firstPtr, drawable);
+	return Blt_Chain_PrevLink(link);
+    }
+    /* Find the markers in the batch. */
+    nMarkers = 0;
+    exts.left = exts.top = DBL_MAX;
+    exts.right = exts.bottom = -DBL_MAX;
+    for (last = link; last != NULL; last = Blt_Chain_PrevLink(last)) {
+	TextMarker *tmPtr;
+	double right, bottom;
+
+	tmPtr = Blt_Chain_GetValue(last);
+	if (!IsMarkerDrawn((Marker *)tmPtr, under)) {
+	    continue;
+	}
+	if ((tmPtr->obj.classId != CID_MARKER_TEXT) || 
+	    (tmPtr->fillGC != firstPtr->fillGC) || 
+	    (tmPtr->style.angle != 0.0f) || (tmPtr->string == NULL)) {
+	    break;
+	}
+	right = tmPtr->anchorPt.x + tmPtr->width;
+	bottom = tmPtr->anchorPt.y + tmPtr->height;
+	if ((tmPtr->anchorPt.x < exts.right) && (right > exts.left) &&
+	    (tmPtr->anchorPt.y < exts.bottom) && (bottom > exts.top)) {
+	    break;			/* Overlaps an earlier marker. */
+	}
+	if (tmPtr->anchorPt.x < exts.left) {
+	    exts.left = tmPtr->anchorPt.x;
+	}
+	if (tmPtr->anchorPt.y < exts.top) {
+	    exts.top = tmPtr->anchorPt.y;
+	}
+	if (right > exts.right) {
+	    exts.right = right;
+	}
+	if (bottom > exts.bottom) {
+	    exts.bottom = bottom;
+	}
+	nMarkers++;
+    }
+    if (nMarkers == 1) {
+	DrawTextProc((Marker *)firstPtr, drawable);
+	return last;
+    }
+    rects = Blt_AssertMalloc(nMarkers * sizeof(XRectangle));
+    nMarkers = 0;
+    for (next = link; next != last; next = Blt_Chain_PrevLink(next)) {
+	TextMarker *tmPtr;
+	XRectangle *rp;
+
+	tmPtr = Blt_Chain_GetValue(next);
+	if (!IsMarkerDrawn((Marker *)tmPtr, under)) {
+	    continue;
+	}
+	rp = rects + nMarkers;
+	rp->x = (short int)(tmPtr->outline[0].x + tmPtr->anchorPt.x);
+	rp->y = (short int)(tmPtr->outline[0].y + tmPtr->anchorPt.y);
+	rp->width = (unsigned short int)tmPtr->width;
+	rp->height = (unsigned short int)tmPtr->height;
+	nMarkers++;
+    }
+    XFillRectangles(graphPtr->display, drawable, firstPtr->fillGC, rects, 
+	nMarkers);
+    Blt_Free(rects);
+    for (next = link; next != last; next = Blt_Chain_PrevLink(next)) {
+	TextMarker *tmPtr;
+
+	tmPtr = Blt_Chain_GetValue(next);
+	if ((IsMarkerDrawn((Marker *)tmPtr, under)) && 
+	    (tmPtr->style.color != NULL)) {
+	    Blt_Ts_DrawLayout(graphPtr->tkwin, drawable, tmPtr->layoutPtr,
+		&tmPtr->style, (int)tmPtr->anchorPt.x, (int)tmPtr->anchorPt.y);
+	}
+    }
+    return last;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -4902,25 +5301,61 @@ Blt_DrawMarkers(Graph *graphPtr, Drawable drawable, int under)
 {
     Blt_ChainLink link;
 
-    for (link = Blt_Chain_LastLink(graphPtr->markers.displayList); 
-	 link != NULL; link = Blt_Chain_PrevLink(link)) {
+    link = Blt_Chain_LastLink(graphPtr->markers.displayList); 
+    while (link != NULL) {
 	Marker *markerPtr;
 
 	markerPtr = Blt_Chain_GetValue(link);
-
-	if ((markerPtr->nWorldPts == 0) || 
-	    (markerPtr->drawUnder != under) ||
-	    (markerPtr->clipped) ||
-	    (markerPtr->flags & (DELETE_PENDING|HIDE))) {
+	if (!IsMarkerDrawn(markerPtr, under)) {
+	    link = Blt_Chain_PrevLink(link);
 	    continue;
 	}
-	if ((markerPtr->elemName != NULL) && (IsElementHidden(markerPtr))) {
-	    continue;
+	switch (markerPtr->obj.classId) {
+	case CID_MARKER_LINE:
+	    link = DrawLineMarkers(graphPtr, drawable, link, under);
+	    break;
+	case CID_MARKER_TEXT:
+	    link = DrawTextMarkers(graphPtr, drawable, link, under);
+	    break;
+	default:
+	    (*markerPtr->classPtr->drawProc) (markerPtr, drawable);
+	    link = Blt_Chain_PrevLink(link);
+	    break;
 	}
-	(*markerPtr->classPtr->drawProc) (markerPtr, drawable);
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_HasMarkersUnder --
+ *
+ *	Indicates if any markers are drawn under the elements, that is,
+ *	into the graph's cache pixmap.
+ *
+ * Results:
+ *	Returns 1 if a marker is drawn under the elements, 0 otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_HasMarkersUnder(Graph *graphPtr)
+{
+    Blt_ChainLink link;
+
+    for (link = Blt_Chain_FirstLink(graphPtr->markers.displayList); 
+	 link != NULL; link = Blt_Chain_NextLink(link)) {
+	Marker *markerPtr;
+
+	markerPtr = Blt_Chain_GetValue(link);
+	if ((markerPtr->drawUnder) && 
+	    ((markerPtr->flags & (DELETE_PENDING|HIDE)) == 0)) {
+	    return TRUE;
+	}
+    }
+    return FALSE;
+}
+
 void
 Blt_ConfigureMarkers(Graph *graphPtr)
 {
@@ -4933,13 +5368,474 @@ Blt_ConfigureMarkers(Graph *graphPtr)
 	markerPtr = Blt_Chain_GetValue(link);
 	(*markerPtr->classPtr->configProc) (markerPtr);
     }
+    InvalidateMarkerIndex(graphPtr);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetMarkerMargin --
+ *
+ *	Returns the number of pixels the marker may extend beyond the screen
+ *	position of its coordinates.  This is the size of a marker anchored
+ *	at a single coordinate, plus its offsets.
+ *
+ * Results:
+ *	Returns the margin in pixels, or -1 if the size of the marker can't
+ *	be known before it's mapped.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+GetMarkerMargin(Marker *markerPtr)
+{
+    int margin;
+
+    margin = ABS(markerPtr->xOffset) + ABS(markerPtr->yOffset) + 1;
+    switch (markerPtr->obj.classId) {
+    case CID_MARKER_TEXT:
+	{
+	    TextMarker *tmPtr = (TextMarker *)markerPtr;
+
+	    if (tmPtr->layoutString != tmPtr->string) {
+		LayoutText(tmPtr);
+	    }
+	    margin += MAX(tmPtr->width, tmPtr->height);
+	}
+	break;
+    case CID_MARKER_BITMAP:
+	{
+	    BitmapMarker *bmPtr = (BitmapMarker *)markerPtr;
+
+	    if ((markerPtr->nWorldPts == 1) && (bmPtr->srcBitmap != None)) {
+		int w, h;
+
+		Tk_SizeOfBitmap(markerPtr->obj.graphPtr->display, 
+			bmPtr->srcBitmap, &w, &h);
+		margin += MAX(w, h);
+	    }
+	}
+	break;
+    case CID_MARKER_IMAGE:
+	{
+	    ImageMarker *imPtr = (ImageMarker *)markerPtr;
+
+	    if ((markerPtr->nWorldPts == 1) && (imPtr->picture != NULL)) {
+		margin += MAX(Blt_PictureWidth(imPtr->picture), 
+			      Blt_PictureHeight(imPtr->picture));
+	    }
+	}
+	break;
+    case CID_MARKER_LINE:
+	margin += ((LineMarker *)markerPtr)->lineWidth;
+	break;
+    case CID_MARKER_POLYGON:
+	margin += ((PolygonMarker *)markerPtr)->lineWidth;
+	break;
+    default:
+	return -1;			/* Window markers take the size of
+					 * their child window. */
+    }
+    return margin;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FillIndexEntry --
+ *
+ *	Computes the index entry of the marker from its world coordinates.
+ *
+ * Results:
+ *	Returns TRUE if the marker can be indexed and FALSE if it must
+ *	always be mapped (window markers, markers without an x-axis or with
+ *	elastic x-coordinates).
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+FillIndexEntry(Marker *markerPtr, MarkerIndexEntry *entryPtr)
+{
+    int i;
+
+    entryPtr->margin = GetMarkerMargin(markerPtr);
+    if ((entryPtr->margin < 0) || (markerPtr->axes.x == NULL)) {
+	return FALSE;
+    }
+    entryPtr->min = entryPtr->yMin = DBL_MAX;
+    entryPtr->max = entryPtr->yMax = -DBL_MAX;
+    for (i = 0; i < markerPtr->nWorldPts; i++) {
+	double x, y;
+
+	x = markerPtr->worldPts[i].x;
+	if ((!FINITE(x)) || (x == DBL_MAX) || (x == -DBL_MAX)) {
+	    return FALSE;		/* Elastic coordinate. */
+	}
+	if (x < entryPtr->min) {
+	    entryPtr->min = x;
+	} 
+	if (x > entryPtr->max) {
+	    entryPtr->max = x;
+	}
+	y = markerPtr->worldPts[i].y;
+	if ((!FINITE(y)) || (y == DBL_MAX) || (y == -DBL_MAX)) {
+	    y = entryPtr->yMin = -DBL_MAX;
+	    entryPtr->yMax = DBL_MAX;
+	}
+	if (y < entryPtr->yMin) {
+	    entryPtr->yMin = y;
+	} 
+	if (y > entryPtr->yMax) {
+	    entryPtr->yMax = y;
+	}
+    }
+    if (markerPtr->axes.y == NULL) {
+	entryPtr->yMin = -DBL_MAX, entryPtr->yMax = DBL_MAX;
+    }
+    entryPtr->axisPtr = markerPtr->axes.x;
+    entryPtr->yAxisPtr = markerPtr->axes.y;
+    entryPtr->markerPtr = markerPtr;
+    return TRUE;
+}
+
+static int
+CompareIndexEntries(const void *a, const void *b)
+{
+    const MarkerIndexEntry *e1 = a;
+    const MarkerIndexEntry *e2 = b;
+
+    if (e1->axisPtr != e2->axisPtr) {
+	return (e1->axisPtr < e2->axisPtr) ? -1 : 1;
+    }
+    if (e1->min < e2->min) {
+	return -1;
+    }
+    return (e1->min > e2->min);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * BuildMarkerIndex --
+ *
+ *	Rebuilds the index of markers from the display list.  Every indexed
+ *	marker is culled until the index is queried.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+BuildMarkerIndex(Graph *graphPtr)
+{
+    MarkerIndex *indexPtr = graphPtr->markerIndex;
+    Blt_ChainLink link;
+    int n, i;
+
+    if (indexPtr->entries != NULL) {
+	Blt_Free(indexPtr->entries);
+	Blt_Free(indexPtr->others);
+	Blt_Free(indexPtr->visible);
+    }
+    if (indexPtr->groups != NULL) {
+	Blt_Free(indexPtr->groups);
+	indexPtr->groups = NULL;
+    }
+    n = Blt_Chain_GetLength(graphPtr->markers.displayList) + 1;
+    indexPtr->entries = Blt_AssertMalloc(n * sizeof(MarkerIndexEntry));
+    indexPtr->others = Blt_AssertMalloc(n * sizeof(Marker *));
+    indexPtr->visible = Blt_AssertMalloc(n * sizeof(Marker *));
+    indexPtr->nEntries = indexPtr->nOthers = indexPtr->nVisible = 0;
+    indexPtr->nGroups = 0;
+    for (link = Blt_Chain_FirstLink(graphPtr->markers.displayList); 
+	 link != NULL; link = Blt_Chain_NextLink(link)) {
+	Marker *markerPtr;
+
+	markerPtr = Blt_Chain_GetValue(link);
+	markerPtr->flags &= ~(CULLED|INDEXED);
+	if ((markerPtr->nWorldPts == 0) || 
+	    (markerPtr->flags & (HIDE|DELETE_PENDING))) {
+	    continue;
+	}
+	if (!FillIndexEntry(markerPtr, indexPtr->entries + indexPtr->nEntries)) {
+	    indexPtr->others[indexPtr->nOthers++] = markerPtr;
+	    continue;
+	}
+	indexPtr->nEntries++;
+	markerPtr->flags |= (CULLED|INDEXED);
+	markerPtr->flags &= ~MAP_ITEM;
+	markerPtr->clipped = TRUE;
+    }
+    qsort(indexPtr->entries, indexPtr->nEntries, sizeof(MarkerIndexEntry),
+	  CompareIndexEntries);
+
+    /* Group the entries by x-axis. */
+    indexPtr->groups = Blt_AssertMalloc(n * sizeof(MarkerIndexGroup));
+    for (i = 0; i < indexPtr->nEntries; i++) {
+	MarkerIndexEntry *entryPtr;
+	MarkerIndexGroup *groupPtr;
+
+	entryPtr = indexPtr->entries + i;
+	entryPtr->markerPtr->indexPos = i;
+	if ((i == 0) || (entryPtr->axisPtr != entryPtr[-1].axisPtr)) {
+	    groupPtr = indexPtr->groups + indexPtr->nGroups;
+	    groupPtr->first = i;
+	    groupPtr->maxSpan = 0.0;
+	    groupPtr->maxMargin = 0;
+	    indexPtr->nGroups++;
+	}
+	groupPtr = indexPtr->groups + indexPtr->nGroups - 1;
+	groupPtr->last = i + 1;
+	if ((entryPtr->max - entryPtr->min) > groupPtr->maxSpan) {
+	    groupPtr->maxSpan = entryPtr->max - entryPtr->min;
+	}
+	if (entryPtr->margin > groupPtr->maxMargin) {
+	    groupPtr->maxMargin = entryPtr->margin;
+	}
+    }
+    indexPtr->dirty = FALSE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * UpdateMarkerIndex --
+ *
+ *	Updates the index entry of a marker that was reconfigured.  The entry
+ *	is moved within the entries of its x-axis to keep them sorted.  If
+ *	the marker changed its x-axis, was hidden or shown, or can no longer
+ *	be indexed, the index is rebuilt instead.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+UpdateMarkerIndex(Marker *markerPtr)
+{
+    MarkerIndex *indexPtr = markerPtr->obj.graphPtr->markerIndex;
+    MarkerIndexEntry entry, *entries;
+    MarkerIndexGroup *groupPtr, *gend;
+    int pos;
+
+    if ((indexPtr == NULL) || (indexPtr->dirty)) {
+	return;
+    }
+    entries = indexPtr->entries;
+    if (((markerPtr->flags & INDEXED) == 0) || (markerPtr->nWorldPts == 0) ||
+	(markerPtr->flags & (HIDE|DELETE_PENDING)) ||
+	(!FillIndexEntry(markerPtr, &entry)) ||
+	(entry.axisPtr != entries[markerPtr->indexPos].axisPtr)) {
+	indexPtr->dirty = TRUE;
+	return;
+    }
+    for (groupPtr = indexPtr->groups, gend = groupPtr + indexPtr->nGroups; 
+	 groupPtr < gend; groupPtr++) {
+	if (entries[groupPtr->first].axisPtr == entry.axisPtr) {
+	    break;
+	}
+    }
+    pos = markerPtr->indexPos;
+    while ((pos > groupPtr->first) && (entries[pos - 1].min > entry.min)) {
+	entries[pos] = entries[pos - 1];
+	entries[pos].markerPtr->indexPos = pos;
+	pos--;
+    }
+    while ((pos < (groupPtr->last - 1)) && (entries[pos + 1].min < entry.min)) {
+	entries[pos] = entries[pos + 1];
+	entries[pos].markerPtr->indexPos = pos;
+	pos++;
+    }
+    entries[pos] = entry;
+    markerPtr->indexPos = pos;
+    if ((entry.max - entry.min) > groupPtr->maxSpan) {
+	groupPtr->maxSpan = entry.max - entry.min;
+    }
+    if (entry.margin > groupPtr->maxMargin) {
+	groupPtr->maxMargin = entry.margin;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetVisibleRange --
+ *
+ *	Converts the screen range of the plotting area, widened by the given
+ *	number of pixels, back to world coordinates of the axis.
+ *
+ * Results:
+ *	The range is returned via loPtr and hiPtr.  It's unbounded if the
+ *	axis isn't mapped.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+GetVisibleRange(Graph *graphPtr, Axis *axisPtr, int vertical, int margin, 
+		double *loPtr, double *hiPtr)
+{
+    double lo, hi, w1, w2;
+
+    if (vertical) {
+	w1 = Blt_InvVMap(axisPtr, graphPtr->top - margin);
+	w2 = Blt_InvVMap(axisPtr, graphPtr->bottom + margin);
+    } else {
+	w1 = Blt_InvHMap(axisPtr, graphPtr->left - margin);
+	w2 = Blt_InvHMap(axisPtr, graphPtr->right + margin);
+    }
+    if ((!FINITE(w1)) || (!FINITE(w2))) {
+	lo = -DBL_MAX, hi = DBL_MAX;	/* Axis isn't mapped. */
+    } else {
+	lo = MIN(w1, w2), hi = MAX(w1, w2);
+    }
+    if ((axisPtr->logScale) && (lo <= 1.0)) {
+	lo = -DBL_MAX;			/* Non-positive coordinates are
+					 * mapped as 1.0 on log scales. */
+    }
+    *loPtr = lo, *hiPtr = hi;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MapIndexedMarkers --
+ *
+ *	Maps the indexed markers that may be visible in the plotting area.
+ *	For each x-axis, the screen range of the plotting area (widened by
+ *	the largest margin of the markers) is converted back to world
+ *	coordinates.  The markers overlapping that range are then checked
+ *	against the range of their y-axis, widened by their own margin.
+ *	Only the markers overlapping both ranges are mapped.  The markers
+ *	mapped the last time are culled beforehand.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Culled markers are marked as clipped, so they aren't drawn.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+MapIndexedMarkers(Graph *graphPtr)
+{
+    MarkerIndex *indexPtr = graphPtr->markerIndex;
+    MarkerIndexGroup *groupPtr, *gend;
+    Axis *yAxisPtr;
+    double yLo, yHi;
+    int yMargin;
+    int i;
+
+    for (i = 0; i < indexPtr->nVisible; i++) {
+	Marker *markerPtr;
+
+	markerPtr = indexPtr->visible[i];
+	markerPtr->flags |= CULLED;
+	markerPtr->flags &= ~MAP_ITEM;
+	markerPtr->clipped = TRUE;
+    }
+    indexPtr->nVisible = 0;
+    yAxisPtr = NULL;
+    yLo = -DBL_MAX, yHi = DBL_MAX;
+    yMargin = -1;
+    for (groupPtr = indexPtr->groups, gend = groupPtr + indexPtr->nGroups; 
+	 groupPtr < gend; groupPtr++) {
+	MarkerIndexEntry *entries;
+	double lo, hi;
+	int low, high;
+
+	entries = indexPtr->entries;
+	GetVisibleRange(graphPtr, entries[groupPtr->first].axisPtr, 
+		graphPtr->inverted, groupPtr->maxMargin, &lo, &hi);
+	/* Find the first entry that may reach the low end of the range. */
+	low = groupPtr->first, high = groupPtr->last;
+	while (low < high) {
+	    int mid;
+
+	    mid = (low + high) >> 1;
+	    if (entries[mid].min < (lo - groupPtr->maxSpan)) {
+		low = mid + 1;
+	    } else {
+		high = mid;
+	    }
+	}
+	for (i = low; (i < groupPtr->last) && (entries[i].min <= hi); i++) {
+	    MarkerIndexEntry *entryPtr;
+	    Marker *markerPtr;
+
+	    entryPtr = entries + i;
+	    markerPtr = entryPtr->markerPtr;
+	    if ((entryPtr->max < lo) || 
+		(markerPtr->flags & (HIDE|DELETE_PENDING))) {
+		continue;
+	    }
+	    if ((entryPtr->yMin > -DBL_MAX) || (entryPtr->yMax < DBL_MAX)) {
+		/* Markers of the same y-axis and size share the range. */
+		if ((entryPtr->yAxisPtr != yAxisPtr) || 
+		    (entryPtr->margin != yMargin)) {
+		    yAxisPtr = entryPtr->yAxisPtr;
+		    yMargin = entryPtr->margin;
+		    GetVisibleRange(graphPtr, yAxisPtr, !graphPtr->inverted, 
+			yMargin, &yLo, &yHi);
+		}
+		if ((entryPtr->yMax < yLo) || (entryPtr->yMin > yHi)) {
+		    continue;
+		}
+	    }
+	    (*markerPtr->classPtr->mapProc) (markerPtr);
+	    markerPtr->flags &= ~(CULLED|MAP_ITEM);
+	    indexPtr->visible[indexPtr->nVisible++] = markerPtr;
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_MapMarkers --
+ *
+ *	Maps the markers whose configuration has changed.  When the layout
+ *	of the graph changes (MAP_ALL), the markers are mapped using the
+ *	marker index.  Markers that lie outside of the plotting area aren't
+ *	mapped at all.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
 void
 Blt_MapMarkers(Graph *graphPtr)
 {
     Blt_ChainLink link;
 
+    if (graphPtr->flags & MAP_ALL) {
+	MarkerIndex *indexPtr;
+	int i;
+
+	if (graphPtr->markerIndex == NULL) {
+	    graphPtr->markerIndex = Blt_AssertCalloc(1, sizeof(MarkerIndex));
+	    graphPtr->markerIndex->dirty = TRUE;
+	}
+	indexPtr = graphPtr->markerIndex;
+	if (indexPtr->dirty) {
+	    BuildMarkerIndex(graphPtr);
+	}
+	MapIndexedMarkers(graphPtr);
+	for (i = 0; i < indexPtr->nOthers; i++) {
+	    Marker *markerPtr;
+
+	    markerPtr = indexPtr->others[i];
+	    if (markerPtr->flags & (HIDE|DELETE_PENDING)) {
+		continue;
+	    }
+	    (*markerPtr->classPtr->mapProc) (markerPtr);
+	    markerPtr->flags &= ~MAP_ITEM;
+	}
+	return;
+    }
     for (link = Blt_Chain_FirstLink(graphPtr->markers.displayList); 
 	 link != NULL; link = Blt_Chain_NextLink(link)) {
 	Marker *markerPtr;
@@ -4951,9 +5847,10 @@ Blt_MapMarkers(Graph *graphPtr)
 	if (markerPtr->flags & (HIDE|DELETE_PENDING)) {
 	    continue;
 	}
-	if ((graphPtr->flags & MAP_ALL) || (markerPtr->flags & MAP_ITEM)) {
+	if (markerPtr->flags & MAP_ITEM) {
 	    (*markerPtr->classPtr->mapProc) (markerPtr);
 	    markerPtr->flags &= ~MAP_ITEM;
+	    UncullMarker(markerPtr);
 	}
     }
 }
@@ -4979,6 +5876,20 @@ Blt_DestroyMarkers(Graph *graphPtr)
     Blt_DeleteHashTable(&graphPtr->markers.table);
     Blt_DeleteHashTable(&graphPtr->markers.tagTable);
     Blt_Chain_Destroy(graphPtr->markers.displayList);
+    if (graphPtr->markerIndex != NULL) {
+	MarkerIndex *indexPtr = graphPtr->markerIndex;
+
+	if (indexPtr->entries != NULL) {
+	    Blt_Free(indexPtr->entries);
+	    Blt_Free(indexPtr->others);
+	    Blt_Free(indexPtr->visible);
+	}
+	if (indexPtr->groups != NULL) {
+	    Blt_Free(indexPtr->groups);
+	}
+	Blt_Free(indexPtr);
+	graphPtr->markerIndex = NULL;
+    }
 }
 
 Marker *
@@ -4998,14 +5909,14 @@ Blt_NearestMarker(
 
 	markerPtr = Blt_Chain_GetValue(link);
 	if ((markerPtr->nWorldPts == 0) ||
-	    (markerPtr->flags & (HIDE|DELETE_PENDING|MAP_ITEM))) {
+	    (markerPtr->flags & (HIDE|DELETE_PENDING|MAP_ITEM|CULLED))) {
 	    continue;			/* Don't consider markers that are
 					 * pending to be mapped. Even if the
 					 * marker has already been mapped, the
 					 * coordinates could be invalid now.
 					 * Better to pick no marker than the
-					 * wrong marker. */
-
+					 * wrong marker. Culled markers lie
+					 * outside of the plotting area. */
 	}
 	if ((markerPtr->elemName != NULL) && (IsElementHidden(markerPtr))) {
 	    continue;
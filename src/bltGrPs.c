@@ -592,6 +592,7 @@ OutputOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 					 * output If NULL, output is returned
 					 * via interp->result. */
     int length;
+    Tcl_WideInt start;
 
     fileName = NULL;			/* Used to identify the output sink. */
     channel = NULL;
@@ -603,36 +604,41 @@ OutputOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 	    if (channel == NULL) {
 		return TCL_ERROR;
 	    }
-	    if (Tcl_SetChannelOption(interp, channel, "-translation", "binary") 
-		!= TCL_OK) {
-		return TCL_ERROR;
-	    }
 	}
     }
 
     psPtr = Blt_Ps_Create(graphPtr->interp, graphPtr->pageSetup);
+    if ((channel != NULL) &&
+	(Tcl_SetChannelOption(interp, channel, "-translation", "binary") 
+	 != TCL_OK)) {
+	goto error;
+    }
     if (Blt_ConfigureWidgetFromObj(interp, graphPtr->tkwin, configSpecs, 
 	objc - 3, objv + 3, (char *)graphPtr->pageSetup, BLT_CONFIG_OBJV_ONLY) 
 	!= TCL_OK) {
-	return TCL_ERROR;
+	goto error;
     }
+    /*
+     * If a file name was given, the output is streamed to the file in
+     * large chunks as it is generated, rather than building the entire
+     * document in memory first.
+     */
+    Blt_Ps_SetChannel(psPtr, channel);
+    start = Blt_PerfClock();
     if (GraphToPostScript(graphPtr, fileName, psPtr) != TCL_OK) {
 	goto error;
     }
-    buffer = Blt_Ps_GetValue(psPtr, &length);
     if (channel != NULL) {
-	int nBytes;
-	/*
-	 * If a file name was given, write the results to that file
-	 */
-	nBytes = Tcl_Write(channel, buffer, length);
-	if (nBytes < 0) {
-	    Tcl_AppendResult(interp, "error writing file \"", fileName, "\": ",
-		Tcl_PosixError(interp), (char *)NULL);
+	if (Blt_Ps_Flush(psPtr) != TCL_OK) {
+	    Tcl_AppendResult(interp, " in file \"", fileName, "\"", 
+		(char *)NULL);
 	    goto error;
 	}
+	Blt_PerfAdd(graphPtr, PERF_POSTSCRIPT, start);
         Tcl_Close(interp, channel);
     } else {
+	Blt_PerfAdd(graphPtr, PERF_POSTSCRIPT, start);
+	buffer = Blt_Ps_GetValue(psPtr, &length);
 	Tcl_SetStringObj(Tcl_GetObjResult(interp), buffer, length);
     }
     Blt_Ps_Free(psPtr);
@@ -640,7 +646,17 @@ OutputOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 
   error:
     if (channel != NULL) {
-        Tcl_Close(interp, channel);
+	Tcl_Obj *objPtr;
+
+	/* 
+	 * Parts of the document may already have been written.  Don't
+	 * leave a truncated file behind.
+	 */
+        Tcl_Close((Tcl_Interp *)NULL, channel);
+	objPtr = Tcl_NewStringObj(fileName, -1);
+	Tcl_IncrRefCount(objPtr);
+	Tcl_FSDeleteFile(objPtr);
+	Tcl_DecrRefCount(objPtr);
     }
     Blt_Ps_Free(psPtr);
     return TCL_ERROR;
@@ -71,6 +71,7 @@ static const char *objectClassNames[] = {
     "YAxis",
     "BarElement", 
     "ContourElement",
+    "HeatmapElement",
     "LineElement", 
     "StripElement", 
     "BitmapMarker", 
@@ -103,7 +104,9 @@ BLT_EXTERN Blt_CustomOption bltBarModeOption;
 #define DEF_GRAPH_HIGHLIGHT_WIDTH	"2"
 #define DEF_GRAPH_INVERT_XY		"0"
 #define DEF_GRAPH_JUSTIFY		"center"
+#define DEF_GRAPH_LAYERED		"no"
 #define DEF_GRAPH_MARGIN		"0"
+#define DEF_GRAPH_MAP_THREADS		"0"
 #define DEF_GRAPH_MARGIN_VAR		(char *)NULL
 #define DEF_GRAPH_PLOT_BACKGROUND	RGB_WHITE
 #define DEF_GRAPH_PLOT_BORDERWIDTH	"1"
@@ -184,6 +187,8 @@ static Blt_ConfigSpec configSpecs[] =
 	BLT_CONFIG_DONT_SET_DEFAULT},
     {BLT_CONFIG_JUSTIFY, "-justify", "justify", "Justify", DEF_GRAPH_JUSTIFY, 
 	Blt_Offset(Graph, titleTextStyle.justify), BLT_CONFIG_DONT_SET_DEFAULT},
+    {BLT_CONFIG_BOOLEAN, "-layered", "layered", "Layered", DEF_GRAPH_LAYERED,
+	Blt_Offset(Graph, layered), BLT_CONFIG_DONT_SET_DEFAULT},
     {BLT_CONFIG_PIXELS_NNEG, "-leftmargin", "leftMargin", "Margin", 
 	DEF_GRAPH_MARGIN, Blt_Offset(Graph, leftMargin.reqSize), 
 	BLT_CONFIG_DONT_SET_DEFAULT},
@@ -191,6 +196,9 @@ static Blt_ConfigSpec configSpecs[] =
 	DEF_GRAPH_MARGIN_VAR, Blt_Offset(Graph, leftMargin.varName), 
 	BLT_CONFIG_NULL_OK},
     {BLT_CONFIG_SYNONYM, "-lm", "leftMargin", (char *)NULL, (char *)NULL, 0, 0},
+    {BLT_CONFIG_INT_NNEG, "-mapthreads", "mapThreads", "MapThreads", 
+	DEF_GRAPH_MAP_THREADS, Blt_Offset(Graph, nMapThreads), 
+	BLT_CONFIG_DONT_SET_DEFAULT},
     {BLT_CONFIG_BACKGROUND, "-plotbackground", "plotBackground", "Background",
 	DEF_GRAPH_PLOT_BACKGROUND, Blt_Offset(Graph, plotBg), 0},
     {BLT_CONFIG_PIXELS_NNEG, "-plotborderwidth", "plotBorderWidth", 
@@ -247,9 +255,13 @@ typedef struct {
     const char *name;
     int width, height;
     int format;
+    const char *fmtName;		/* Name of the picture format used to
+					 * export the snapshot. */
 } SnapSwitches;
 
-enum SnapFormats { FORMAT_PICTURE, FORMAT_PHOTO, FORMAT_EMF, FORMAT_WMF };
+enum SnapFormats { 
+    FORMAT_PICTURE, FORMAT_PHOTO, FORMAT_EMF, FORMAT_WMF, FORMAT_EXPORT 
+};
 
 static Blt_SwitchSpec snapSwitches[] = 
 {
@@ -262,6 +274,28 @@ static Blt_SwitchSpec snapSwitches[] =
     {BLT_SWITCH_END}
 };
 
+typedef struct {
+    unsigned int flags;
+    int maxRecords;			/* # of redisplay records to keep. */
+} PerfSwitches;
+
+#define PERF_RESET	(1<<0)
+
+static Blt_SwitchSpec perfSwitches[] = 
+{
+    {BLT_SWITCH_INT_NNEG, "-records", "number",
+	Blt_Offset(PerfSwitches, maxRecords), 0},
+    {BLT_SWITCH_BITMASK,  "-reset",   "",
+	Blt_Offset(PerfSwitches, flags), 0, PERF_RESET},
+    {BLT_SWITCH_END}
+};
+
+static const char *perfPhaseNames[PERF_NUM_PHASES] = {
+    "resetaxes", "layout", "mapaxes", "mapelements", "mapmarkers", 
+    "drawplot", "drawelements", "drawmarkers", "drawlegend", "copy", 
+    "postscript", "redraw"
+};
+
 static Tcl_IdleProc DisplayGraph;
 static Tcl_FreeProc DestroyGraph;
 static Tk_EventProc GraphEventProc;
@@ -326,6 +360,31 @@ Blt_EventuallyRedrawGraph(Graph *graphPtr)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_RedrawGraphNow --
+ *
+ *	Redisplays the graph right away if a redraw is pending, instead of
+ *	at the next idle point.  This lets graphs with shared axes be
+ *	redrawn together from a single idle handler.
+ *
+ * Results: None.
+ *
+ * Side effects:
+ *	The window is redisplayed.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_RedrawGraphNow(Graph *graphPtr) 
+{
+    if (graphPtr->flags & REDRAW_PENDING) {
+	Tcl_CancelIdleCall(DisplayGraph, graphPtr);
+	DisplayGraph(graphPtr);
+    }
+}
+
 const char *
 Blt_GraphClassName(ClassId classId) 
 {
@@ -524,6 +583,7 @@ Blt_GraphTags(
     switch (graphObjPtr->classId) {
     case CID_ELEM_BAR:		
     case CID_ELEM_CONTOUR:
+    case CID_ELEM_HEATMAP:
     case CID_ELEM_LINE: 
     case CID_ELEM_STRIP: 
 	tagProc = Blt_MakeElementTag;
@@ -750,7 +810,11 @@ ConfigureGraph(Graph *graphPtr)
 		"-unmaphiddenelements", (char *)NULL)) {
 	graphPtr->flags |= RESET_WORLD | CACHE_DIRTY;
     }
-    if (Blt_ConfigModified(configSpecs, "-plot*", "-*background",
+    if (Blt_ConfigModified(configSpecs, "-bar*", "-baseline", 
+		"-unmaphiddenelements", (char *)NULL)) {
+	graphPtr->flags |= RESET_BAR_SETS;
+    }
+    if (Blt_ConfigModified(configSpecs, "-plot*", "-*background", "-layered",
 			   (char *)NULL)) {
 	graphPtr->flags |= CACHE_DIRTY;
     }
@@ -810,6 +874,9 @@ DestroyGraph(DestroyData dataPtr)
     if (graphPtr->cache != None) {
 	Tk_FreePixmap(graphPtr->display, graphPtr->cache);
     }
+    if (graphPtr->perf.records != NULL) {
+	Blt_Free(graphPtr->perf.records);
+    }
     Blt_Free(graphPtr);
 }
 
@@ -857,7 +924,7 @@ CreateGraph(Tcl_Interp *interp, int objc, Tcl_Obj *const *objv, ClassId classId)
     graphPtr->highlightWidth = 2;
     graphPtr->plotRelief = TK_RELIEF_SOLID;
     graphPtr->relief = TK_RELIEF_FLAT;
-    graphPtr->flags = RESET_WORLD;
+    graphPtr->flags = RESET_WORLD | RESET_BAR_SETS;
     graphPtr->nextMarkerId = 1;
     graphPtr->padLeft = graphPtr->padRight = 0;
     graphPtr->padTop = graphPtr->padBottom = 0;
@@ -978,6 +1045,13 @@ BarOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     return Blt_ElementOp(graphPtr, interp, objc, objv, CID_ELEM_BAR);
 }
 
+/*ARGSUSED*/
+static int
+HeatmapOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    return Blt_ElementOp(graphPtr, interp, objc, objv, CID_ELEM_HEATMAP);
+}
+
 /*ARGSUSED*/
 static int
 LineOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
@@ -1247,6 +1321,177 @@ TransformOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     return TCL_OK;
 }
 
+static Tcl_Obj *
+PerfCounterToObj(Tcl_Interp *interp, PerfCounter *counterPtr)
+{
+    Tcl_Obj *listObjPtr;
+
+    listObjPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+    Tcl_ListObjAppendElement(interp, listObjPtr, Tcl_NewStringObj("count",-1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewLongObj(counterPtr->count));
+    Tcl_ListObjAppendElement(interp, listObjPtr, Tcl_NewStringObj("usecs",-1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewWideIntObj(counterPtr->usecs));
+    return listObjPtr;
+}
+
+static Tcl_Obj *
+PerfRecordToObj(Tcl_Interp *interp, PerfRecord *recPtr)
+{
+    Tcl_Obj *listObjPtr;
+    int i;
+
+    listObjPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+    Tcl_ListObjAppendElement(interp, listObjPtr, Tcl_NewStringObj("start",-1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewWideIntObj(recPtr->start));
+    for (i = 0; i < PERF_NUM_PHASES; i++) {
+	Tcl_ListObjAppendElement(interp, listObjPtr, 
+		Tcl_NewStringObj(perfPhaseNames[i], -1));
+	Tcl_ListObjAppendElement(interp, listObjPtr, 
+		Tcl_NewWideIntObj(recPtr->usecs[i]));
+    }
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewStringObj("mapped", -1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewWideIntObj(recPtr->nPointsMapped));
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewStringObj("drawn", -1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewWideIntObj(recPtr->nPointsDrawn));
+    return listObjPtr;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * PerfOp --
+ *
+ *	Reports the timing statistics of the graph.
+ *
+ *	.g perf ?-reset? ?-records number?
+ *
+ *	The result is a list of key value pairs.  "phases" holds the
+ *	cumulative time (in microseconds) and count of each phase of
+ *	redisplaying the graph.  "elements" holds the mapping time of each
+ *	element, the number of data points mapped and the number of screen
+ *	points left after reduction.  "points" holds the totals of the
+ *	latter.  "records" holds the most recent redisplays, if they are
+ *	kept (see the -records switch).
+ *
+ * Results:
+ *	Returns a standard TCL result.
+ *
+ * Side Effects:
+ *	If the -reset switch is given, the statistics are cleared after
+ *	they are reported.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+PerfOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    GraphPerf *perfPtr = &graphPtr->perf;
+    PerfSwitches switches;
+    Tcl_Obj *listObjPtr, *objPtr;
+    Blt_ChainLink link;
+    int i;
+
+    switches.flags = 0;
+    switches.maxRecords = perfPtr->maxRecords;
+    if (Blt_ParseSwitches(interp, perfSwitches, objc - 2, objv + 2, &switches, 
+	BLT_SWITCH_DEFAULTS) < 0) {
+	return TCL_ERROR;
+    }
+    listObjPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+
+    objPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+    for (i = 0; i < PERF_NUM_PHASES; i++) {
+	Tcl_ListObjAppendElement(interp, objPtr, 
+		Tcl_NewStringObj(perfPhaseNames[i], -1));
+	Tcl_ListObjAppendElement(interp, objPtr, 
+		PerfCounterToObj(interp, perfPtr->phases + i));
+    }
+    Tcl_ListObjAppendElement(interp, listObjPtr, Tcl_NewStringObj("phases",-1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, objPtr);
+
+    objPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+    for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList); 
+	 link != NULL; link = Blt_Chain_NextLink(link)) {
+	Element *elemPtr;
+	Tcl_Obj *subObjPtr;
+
+	elemPtr = Blt_Chain_GetValue(link);
+	subObjPtr = PerfCounterToObj(interp, &elemPtr->mapPerf);
+	Tcl_ListObjAppendElement(interp, subObjPtr, 
+		Tcl_NewStringObj("points", -1));
+	Tcl_ListObjAppendElement(interp, subObjPtr, 
+		Tcl_NewIntObj(NUMBEROFPOINTS(elemPtr)));
+	Tcl_ListObjAppendElement(interp, subObjPtr, 
+		Tcl_NewStringObj("drawn", -1));
+	Tcl_ListObjAppendElement(interp, subObjPtr, 
+		Tcl_NewIntObj(elemPtr->nDrawnPoints));
+	Tcl_ListObjAppendElement(interp, objPtr, 
+		Tcl_NewStringObj(elemPtr->obj.name, -1));
+	Tcl_ListObjAppendElement(interp, objPtr, subObjPtr);
+    }
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewStringObj("elements", -1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, objPtr);
+
+    objPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+    Tcl_ListObjAppendElement(interp, objPtr, Tcl_NewStringObj("mapped", -1));
+    Tcl_ListObjAppendElement(interp, objPtr, 
+	Tcl_NewWideIntObj(perfPtr->nPointsMapped));
+    Tcl_ListObjAppendElement(interp, objPtr, Tcl_NewStringObj("drawn", -1));
+    Tcl_ListObjAppendElement(interp, objPtr, 
+	Tcl_NewWideIntObj(perfPtr->nPointsDrawn));
+    Tcl_ListObjAppendElement(interp, listObjPtr, Tcl_NewStringObj("points",-1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, objPtr);
+
+    objPtr = Tcl_NewListObj(0, (Tcl_Obj **)NULL);
+    for (i = 0; i < perfPtr->nRecords; i++) {
+	PerfRecord *recPtr;
+
+	recPtr = perfPtr->records + 
+	    ((perfPtr->firstRecord + i) % perfPtr->maxRecords);
+	Tcl_ListObjAppendElement(interp, objPtr, 
+		PerfRecordToObj(interp, recPtr));
+    }
+    Tcl_ListObjAppendElement(interp, listObjPtr, 
+	Tcl_NewStringObj("records", -1));
+    Tcl_ListObjAppendElement(interp, listObjPtr, objPtr);
+    Tcl_SetObjResult(interp, listObjPtr);
+
+    if (switches.flags & PERF_RESET) {
+	memset(perfPtr->phases, 0, sizeof(perfPtr->phases));
+	perfPtr->nPointsMapped = perfPtr->nPointsDrawn = 0;
+	perfPtr->nRecords = perfPtr->firstRecord = 0;
+	for (link = Blt_Chain_FirstLink(graphPtr->elements.displayList); 
+	     link != NULL; link = Blt_Chain_NextLink(link)) {
+	    Element *elemPtr;
+
+	    elemPtr = Blt_Chain_GetValue(link);
+	    elemPtr->mapPerf.usecs = 0;
+	    elemPtr->mapPerf.count = 0;
+	}
+    }
+    if (switches.maxRecords != perfPtr->maxRecords) {
+	if (perfPtr->records != NULL) {
+	    Blt_Free(perfPtr->records);
+	    perfPtr->records = NULL;
+	}
+	if (switches.maxRecords > 0) {
+	    perfPtr->records = Blt_AssertMalloc(switches.maxRecords * 
+		sizeof(PerfRecord));
+	}
+	perfPtr->maxRecords = switches.maxRecords;
+	perfPtr->nRecords = perfPtr->firstRecord = 0;
+    }
+    return TCL_OK;
+}
+
 #ifndef NO_PRINTER
 
 /*
@@ -1451,7 +1696,10 @@ Print2Op(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
  *
  * ObjToFormat --
  *
- *	Convert a string represent a node number into its integer value.
+ *	Convert a string representing a snapshot format into its integer
+ *	value.  Names other than the built-in formats must be registered
+ *	picture formats that can export, used to write the snapshot to a
+ *	file.
  *
  * Results:
  *	The return value is a standard TCL result.
@@ -1469,6 +1717,7 @@ ObjToFormat(
     int offset,				/* Offset to field in structure */
     int flags)				/* Not used. */
 {
+    SnapSwitches *switchesPtr = (SnapSwitches *)record;
     int *formatPtr = (int *)(record + offset);
     char c;
     const char *string;
@@ -1476,7 +1725,7 @@ ObjToFormat(
     string = Tcl_GetString(objPtr);
     c = string[0];
     if ((c == 'p') && (strcmp(string, "picture") == 0)) {
-	*formatPtr = FORMAT_PHOTO;
+	*formatPtr = FORMAT_PICTURE;
     } else if ((c == 'p') && (strcmp(string, "photo") == 0)) {
 	*formatPtr = FORMAT_PHOTO;
 #ifdef WIN32
@@ -1485,13 +1734,20 @@ ObjToFormat(
     } else if ((c == 'w') && (strcmp(string, "wmf") == 0)) {
 	*formatPtr = FORMAT_WMF;
 #endif /* WIN32 */
+    } else if (Blt_GetPictureExportFormat(interp, string) == TCL_OK) {
+	/* Any other format is a picture format that exports to a file. */
+	*formatPtr = FORMAT_EXPORT;
+	switchesPtr->fmtName = string;
     } else {
+	Tcl_ResetResult(interp);
 #ifdef WIN32
 	Tcl_AppendResult(interp, "bad format \"", string, 
-		 "\": should be picture, photo, emf, or wmf.", (char *)NULL);
+		"\": should be picture, photo, emf, wmf, or a picture export "
+		"format", (char *)NULL);
 #else
 	Tcl_AppendResult(interp, "bad format \"", string, 
-		 "\": should be picture or photo.", (char *)NULL);
+		"\": should be picture, photo, or a picture export format", 
+		(char *)NULL);
 #endif /* WIN32 */
 	return TCL_ERROR;
     }
@@ -1588,6 +1844,59 @@ CreateAPMetaFile(Tcl_Interp *interp, HANDLE hMetaFile, HDC hDC,
 }
 #endif /*WIN32*/
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GraphToPicture --
+ *
+ *	Paints the graph directly into a picture, rather than drawing it
+ *	into a pixmap and reading the pixmap back from the X server.  The
+ *	picture routines can't draw text, 3D borders, or background
+ *	patterns.  So this is only possible for graphs without a title,
+ *	axes, legend, or markers, whose backgrounds are solid and flat, and
+ *	whose elements can all be painted into a picture.
+ *
+ * Results:
+ *	Returns the picture, or NULL if the graph must be drawn through X.
+ *
+ *---------------------------------------------------------------------------
+ */
+static Blt_Picture
+GraphToPicture(Graph *graphPtr)
+{
+    Blt_Picture picture;
+    Blt_Pixel color;
+
+    if ((graphPtr->title != NULL) || (!Blt_AxesAreHidden(graphPtr)) ||
+	((!Blt_Legend_IsHidden(graphPtr)) && 
+	 (Blt_Legend_Site(graphPtr) != LEGEND_WINDOW)) ||
+	(Blt_Chain_GetLength(graphPtr->markers.displayList) > 0)) {
+	return NULL;
+    }
+    if ((!Blt_BackgroundIsSolid(graphPtr->normalBg)) ||
+	(!Blt_BackgroundIsSolid(graphPtr->plotBg)) ||
+	((graphPtr->borderWidth > 0) && 
+	 (graphPtr->relief != TK_RELIEF_FLAT)) ||
+	((graphPtr->plotBW > 0) && (graphPtr->plotRelief != TK_RELIEF_FLAT)) ||
+	((graphPtr->highlightWidth > 0) && (graphPtr->flags & FOCUS))) {
+	return NULL;
+    }
+    picture = Blt_CreatePicture(graphPtr->width, graphPtr->height);
+    color = Blt_XColorToPixel(Blt_BackgroundBorderColor(graphPtr->normalBg));
+    Blt_BlankPicture(picture, &color);
+    color = Blt_XColorToPixel(Blt_BackgroundBorderColor(graphPtr->plotBg));
+    Blt_BlankRegion(picture, 
+	graphPtr->left   - graphPtr->plotBW, 
+	graphPtr->top    - graphPtr->plotBW, 
+	graphPtr->right  - graphPtr->left + 1 + 2 * graphPtr->plotBW,
+	graphPtr->bottom - graphPtr->top  + 1 + 2 * graphPtr->plotBW, &color);
+    if (!Blt_ElementsToPicture(graphPtr, picture)) {
+	Blt_FreePicture(picture);
+	return NULL;
+    }
+    return picture;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1621,6 +1930,7 @@ SnapOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 	switches.width = graphPtr->reqWidth;
     }
     switches.format = FORMAT_PICTURE;
+    switches.fmtName = NULL;
     /* Process switches  */
     i = Blt_ParseSwitches(interp, snapSwitches, objc - 2, objv + 2, &switches, 
 	BLT_SWITCH_OBJV_PARTIAL);
@@ -1638,7 +1948,7 @@ SnapOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 	switches.width = Tk_ReqWidth(graphPtr->tkwin);
     }
     if (switches.height < 2) {
-	switches.width = Tk_ReqHeight(graphPtr->tkwin);
+	switches.height = Tk_ReqHeight(graphPtr->tkwin);
     }
     /* Always re-compute the layout of the graph before snapping the picture. */
     graphPtr->width = switches.width;
@@ -1648,6 +1958,50 @@ SnapOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     drawable = Tk_WindowId(graphPtr->tkwin);
     switch (switches.format) {
     case FORMAT_PICTURE:
+    case FORMAT_EXPORT:
+	{
+	    Blt_Picture picture;
+
+	    /* Paint the graph straight into a picture when possible. */
+	    picture = GraphToPicture(graphPtr);
+	    if (picture == NULL) {
+		drawable = Tk_GetPixmap(graphPtr->display, drawable, 
+			graphPtr->width, graphPtr->height, 
+			Tk_Depth(graphPtr->tkwin));
+		Blt_DrawGraph(graphPtr, drawable);
+		picture = Blt_DrawableToPicture(graphPtr->tkwin, drawable, 
+			0, 0, switches.width, switches.height, 1.0);
+		Tk_FreePixmap(graphPtr->display, drawable);
+	    }
+	    graphPtr->flags |= RESET_WORLD;
+	    if (picture == NULL) {
+		Tcl_AppendResult(interp, "can't grab pixmap", (char *)NULL);
+		result = TCL_ERROR;
+		break;
+	    }
+	    if (switches.format == FORMAT_PICTURE) {
+		result = Blt_ResetPicture(interp, switches.name, picture);
+		if (result != TCL_OK) {
+		    Blt_FreePicture(picture);
+		}
+	    } else {
+		Tcl_Obj *fileObjv[2];
+
+		/* The output name is the file written by the picture
+		 * format. */
+		fileObjv[0] = Tcl_NewStringObj("-file", 5);
+		fileObjv[1] = Tcl_NewStringObj(switches.name, -1);
+		Tcl_IncrRefCount(fileObjv[0]);
+		Tcl_IncrRefCount(fileObjv[1]);
+		result = Blt_ExportPicture(interp, picture, switches.fmtName, 2,
+			fileObjv);
+		Tcl_DecrRefCount(fileObjv[0]);
+		Tcl_DecrRefCount(fileObjv[1]);
+		Blt_FreePicture(picture);
+	    }
+	}
+	break;
+
     case FORMAT_PHOTO:
 	drawable = Tk_GetPixmap(graphPtr->display, drawable, graphPtr->width, 
 		graphPtr->height, Tk_Depth(graphPtr->tkwin));
@@ -1656,15 +2010,9 @@ SnapOp(Graph *graphPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 #endif
 	graphPtr->flags |= RESET_WORLD;
 	Blt_DrawGraph(graphPtr, drawable);
-	if (switches.format == FORMAT_PICTURE) {
-	    result = Blt_SnapPicture(interp, graphPtr->tkwin, drawable, 0, 0, 
-		switches.width, switches.height, switches.width, 
-		switches.height, switches.name, 1.0);
-	} else {
-	    result = Blt_SnapPhoto(interp, graphPtr->tkwin, drawable, 0, 0, 
+	result = Blt_SnapPhoto(interp, graphPtr->tkwin, drawable, 0, 0, 
 		switches.width, switches.height, switches.width, 
 		switches.height, switches.name, 1.0);
-	}
 	Tk_FreePixmap(graphPtr->display, drawable);
 	break;
 
@@ -1775,12 +2123,14 @@ static Blt_OpSpec graphOps[] =
     {"crosshairs",   2, Blt_CrosshairsOp,  2, 0, "oper ?args?",},
     {"element",      2, ElementOp,         2, 0, "oper ?args?",},
     {"extents",      2, ExtentsOp,         3, 3, "item",},
+    {"heatmap",      1, HeatmapOp,         2, 0, "oper ?args?",},
     {"inside",       3, InsideOp,          4, 4, "winX winY",},
     {"invtransform", 3, InvtransformOp,    4, 4, "winX winY",},
     {"legend",       2, Blt_LegendOp,      2, 0, "oper ?args?",},
     {"line",         2, LineOp,            2, 0, "oper ?args?",},
     {"marker",       2, Blt_MarkerOp,      2, 0, "oper ?args?",},
     {"pen",          2, Blt_PenOp,         2, 0, "oper ?args?",},
+    {"perf",         3, PerfOp,            2, 0, "?-reset? ?-records number?",},
     {"postscript",   2, Blt_PostScriptOp,  2, 0, "oper ?args?",},
 #ifndef NO_PRINTER
     {"print1",       2, Print1Op,          2, 3, "?printerName?",},
@@ -2090,7 +2440,9 @@ static void
 DrawPlot(Graph *graphPtr, Drawable drawable)
 {
     int site;
+    Tcl_WideInt start, t;
 
+    start = Blt_PerfClock();
     DrawMargins(graphPtr, drawable);
 
     /* Draw the background of the plotting area with 3D border. */
@@ -2104,44 +2456,249 @@ DrawPlot(Graph *graphPtr, Drawable drawable)
     /* Draw the elements, markers, legend, and axis limits. */
     Blt_DrawAxes(graphPtr, drawable);
     Blt_DrawGrids(graphPtr, drawable);
+    t = Blt_PerfClock();
     Blt_DrawMarkers(graphPtr, drawable, MARKER_UNDER);
+    Blt_PerfAdd(graphPtr, PERF_DRAW_MARKERS, t);
 
     site = Blt_Legend_Site(graphPtr);
     if ((site & LEGEND_PLOTAREA_MASK) && (!Blt_Legend_IsRaised(graphPtr))) {
+	t = Blt_PerfClock();
 	Blt_DrawLegend(graphPtr, drawable);
+	Blt_PerfAdd(graphPtr, PERF_DRAW_LEGEND, t);
     } else if (site == LEGEND_WINDOW) {
 	Blt_Legend_EventuallyRedraw(graphPtr);
     }
     Blt_DrawAxisLimits(graphPtr, drawable);
+    t = Blt_PerfClock();
     Blt_DrawElements(graphPtr, drawable);
+    Blt_PerfAdd(graphPtr, PERF_DRAW_ELEMENTS, t);
     /* Blt_DrawAxes(graphPtr, drawable); */
+    Blt_PerfAdd(graphPtr, PERF_DRAW_PLOT, start);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ScrollPlot --
+ *
+ *	Updates the cache pixmap of a stripchart whose x-axes have only
+ *	slid (see the SCROLL_PLOT flag).  The plotting area is scrolled
+ *	left and only the strip exposed on the right is redrawn.  The new
+ *	segments and symbols of the elements are drawn over it.  The
+ *	margins are redrawn since the axes have changed.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+ScrollPlot(Graph *graphPtr)
+{
+    Tcl_WideInt start, t;
+    int x, y, w, h, d;
+
+    start = Blt_PerfClock();
+    d = -graphPtr->scrollDx;
+    if (d > 0) {
+	XRectangle strip;
+	TkRegion rgn;
+
+	x = graphPtr->left, y = graphPtr->top;
+	w = graphPtr->right - graphPtr->left + 1;
+	h = graphPtr->bottom - graphPtr->top + 1;
+	t = Blt_PerfClock();
+	XCopyArea(graphPtr->display, graphPtr->cache, graphPtr->cache,
+		graphPtr->drawGC, x + d, y, w - d, h, x, y);
+	Blt_PerfAdd(graphPtr, PERF_COPY, t);
+
+	/* Redraw the background and grid of the exposed strip. */
+	strip.x = x + w - d;
+	strip.y = y;
+	strip.width = d;
+	strip.height = h;
+	rgn = TkCreateRegion();
+	TkUnionRectWithRegion(&strip, rgn, rgn);
+	Blt_SetBackgroundClipRegion(graphPtr->tkwin, graphPtr->plotBg, rgn);
+	Blt_FillBackgroundRectangle(graphPtr->tkwin, graphPtr->cache, 
+		graphPtr->plotBg, x, y, w, h, 0, TK_RELIEF_FLAT);
+	Blt_UnsetBackgroundClipRegion(graphPtr->tkwin, graphPtr->plotBg);
+	Blt_DrawGridRegion(graphPtr, graphPtr->cache, rgn);
+	TkDestroyRegion(rgn);
+	DrawMargins(graphPtr, graphPtr->cache);
+    }
+    t = Blt_PerfClock();
+    Blt_DrawScrolledElements(graphPtr, graphPtr->cache);
+    Blt_PerfAdd(graphPtr, PERF_DRAW_ELEMENTS, t);
+    Blt_PerfAdd(graphPtr, PERF_DRAW_PLOT, start);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_PerfClock --
+ *
+ *	Returns the current time in microseconds, used to time the phases
+ *	of redisplaying the graph.
+ *
+ *---------------------------------------------------------------------------
+ */
+Tcl_WideInt
+Blt_PerfClock(void)
+{
+    Tcl_Time now;
+
+    Tcl_GetTime(&now);
+    return (Tcl_WideInt)now.sec * 1000000 + now.usec;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SavePerfRecord --
+ *
+ *	Saves the record of the redisplay just completed in the graph's
+ *	ring of records, replacing the oldest record if the ring is full.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+SavePerfRecord(Graph *graphPtr)
+{
+    GraphPerf *perfPtr = &graphPtr->perf;
+
+    if (perfPtr->records == NULL) {
+	return;
+    }
+    if (perfPtr->nRecords < perfPtr->maxRecords) {
+	perfPtr->records[(perfPtr->firstRecord + perfPtr->nRecords) % 
+			 perfPtr->maxRecords] = perfPtr->current;
+	perfPtr->nRecords++;
+    } else {
+	perfPtr->records[perfPtr->firstRecord] = perfPtr->current;
+	perfPtr->firstRecord = (perfPtr->firstRecord + 1) % perfPtr->maxRecords;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_PerfAdd --
+ *
+ *	Adds the time elapsed since start to the given phase's statistics
+ *	and to the record of the current redisplay.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_PerfAdd(Graph *graphPtr, PerfPhase phase, Tcl_WideInt start)
+{
+    Tcl_WideInt usecs;
+
+    usecs = Blt_PerfClock() - start;
+    graphPtr->perf.phases[phase].usecs += usecs;
+    graphPtr->perf.phases[phase].count++;
+    graphPtr->perf.current.usecs[phase] += usecs;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * CanScrollPlot --
+ *
+ *	Indicates if data was only appended to the stripchart, so that its
+ *	cache pixmap may be scrolled rather than redrawn.  Nothing else in
+ *	the cache can have changed.  The legend and markers drawn in the
+ *	plotting area wouldn't scroll with the data.
+ *
+ * Results:
+ *	Returns 1 if the plot may be scrolled, 0 otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+CanScrollPlot(Graph *graphPtr)
+{
+    if ((graphPtr->flags & (APPEND_PENDING|CACHE_DIRTY)) != APPEND_PENDING) {
+	return FALSE;
+    }
+    if ((graphPtr->classId != CID_ELEM_STRIP) || (!graphPtr->backingStore) || 
+	(graphPtr->cache == None) || (graphPtr->layered)) {
+	return FALSE;
+    }
+    if ((Blt_Legend_Site(graphPtr) & LEGEND_PLOTAREA_MASK) &&
+	(!Blt_Legend_IsHidden(graphPtr)) && (!Blt_Legend_IsRaised(graphPtr))) {
+	return FALSE;
+    }
+    return !Blt_HasMarkersUnder(graphPtr);
 }
 
 void
 Blt_MapGraph(Graph *graphPtr)
 {
+    Tcl_WideInt start;
+    int scroll;
+    int left, right, top, bottom;
+
+    if (graphPtr->flags & SCROLL_PLOT) {
+	/* The last scroll was never drawn.  Redraw the plot instead. */
+	graphPtr->flags &= ~SCROLL_PLOT;
+	graphPtr->flags |= CACHE_DIRTY;
+    }
+    scroll = CanScrollPlot(graphPtr);
+    if (scroll) {
+	Blt_SaveAxisTransforms(graphPtr);
+	left = graphPtr->left, right = graphPtr->right;
+	top = graphPtr->top, bottom = graphPtr->bottom;
+    }
     if (graphPtr->flags & RESET_AXES) {
+	start = Blt_PerfClock();
 	Blt_ResetAxes(graphPtr);
+	Blt_PerfAdd(graphPtr, PERF_RESET_AXES, start);
     }
     if (graphPtr->flags & LAYOUT_NEEDED) {
+	start = Blt_PerfClock();
 	Blt_LayoutGraph(graphPtr);
 	graphPtr->flags &= ~LAYOUT_NEEDED;
+	Blt_PerfAdd(graphPtr, PERF_LAYOUT, start);
     }
     /* Compute coordinate transformations for graph components */
     if ((graphPtr->vRange > 1) && (graphPtr->hRange > 1)) {
 	if (graphPtr->flags & MAP_WORLD) {
+	    start = Blt_PerfClock();
 	    Blt_MapAxes(graphPtr);
+	    Blt_PerfAdd(graphPtr, PERF_MAP_AXES, start);
 	}
+	if ((scroll) && (left == graphPtr->left) && 
+	    (right == graphPtr->right) && (top == graphPtr->top) && 
+	    (bottom == graphPtr->bottom) && 
+	    (Blt_GetAxisScroll(graphPtr, &graphPtr->scrollDx))) {
+	    /* The x-axes only slid.  Scroll the plot instead of redrawing
+	     * it. */
+	    graphPtr->flags &= ~CACHE_DIRTY;
+	    graphPtr->flags |= SCROLL_PLOT;
+	}
+	start = Blt_PerfClock();
 	Blt_MapElements(graphPtr);
+	Blt_PerfAdd(graphPtr, PERF_MAP_ELEMENTS, start);
+	start = Blt_PerfClock();
 	Blt_MapMarkers(graphPtr);
+	Blt_PerfAdd(graphPtr, PERF_MAP_MARKERS, start);
 	graphPtr->flags &= ~(MAP_ALL);
     }
+    if (graphPtr->flags & APPEND_PENDING) {
+	if ((graphPtr->flags & SCROLL_PLOT) == 0) {
+	    graphPtr->flags |= CACHE_DIRTY;
+	}
+	graphPtr->flags &= ~APPEND_PENDING;
+    }
 }
 
 void
 Blt_DrawGraph(Graph *graphPtr, Drawable drawable)
 {
     DrawPlot(graphPtr, drawable);
+    Blt_DrawLiveElements(graphPtr, drawable);
     /* Draw markers above elements */
     Blt_DrawMarkers(graphPtr, drawable, MARKER_ABOVE);
     Blt_DrawActiveElements(graphPtr, drawable);
@@ -2214,6 +2771,7 @@ DisplayGraph(ClientData clientData)
     Pixmap drawable;
     Tk_Window tkwin;
     int site;
+    Tcl_WideInt start, t;
 
     graphPtr->flags &= ~REDRAW_PENDING;
     if (graphPtr->tkwin == NULL) {
@@ -2229,6 +2787,9 @@ DisplayGraph(ClientData clientData)
 	 * something reasonable. */
 	return;
     }
+    start = Blt_PerfClock();
+    memset(&graphPtr->perf.current, 0, sizeof(PerfRecord));
+    graphPtr->perf.current.start = start;
     graphPtr->width = Tk_Width(tkwin);
     graphPtr->height = Tk_Height(tkwin);
     Blt_MapGraph(graphPtr);
@@ -2266,25 +2827,41 @@ DisplayGraph(ClientData clientData)
     assert(drawable != None);
 #endif
     if (graphPtr->backingStore) {
+	Blt_UpdateElementLayers(graphPtr);
 	if (graphPtr->flags & CACHE_DIRTY) {
 	    /* The backing store is new or out-of-date. */
 	    DrawPlot(graphPtr, graphPtr->cache);
-	    graphPtr->flags &= ~CACHE_DIRTY;
+	    graphPtr->flags &= ~(CACHE_DIRTY | SCROLL_PLOT);
+	} else if (graphPtr->flags & SCROLL_PLOT) {
+	    ScrollPlot(graphPtr);
+	    graphPtr->flags &= ~SCROLL_PLOT;
 	}
 	/* Copy the pixmap to the one used for drawing the entire graph. */
+	t = Blt_PerfClock();
 	XCopyArea(graphPtr->display, graphPtr->cache, drawable,
 		graphPtr->drawGC, 0, 0, Tk_Width(graphPtr->tkwin),
 		Tk_Height(graphPtr->tkwin), 0, 0);
+	Blt_PerfAdd(graphPtr, PERF_COPY, t);
     } else {
 	DrawPlot(graphPtr, drawable);
     }
+    /* Draw the elements left out of the backing store. */
+    t = Blt_PerfClock();
+    Blt_DrawLiveElements(graphPtr, drawable);
+    Blt_PerfAdd(graphPtr, PERF_DRAW_ELEMENTS, t);
     /* Draw markers above elements */
+    t = Blt_PerfClock();
     Blt_DrawMarkers(graphPtr, drawable, MARKER_ABOVE);
+    Blt_PerfAdd(graphPtr, PERF_DRAW_MARKERS, t);
+    t = Blt_PerfClock();
     Blt_DrawActiveElements(graphPtr, drawable);
+    Blt_PerfAdd(graphPtr, PERF_DRAW_ELEMENTS, t);
     /* Don't draw legend in the plot area. */
     site = Blt_Legend_Site(graphPtr);
     if ((site & LEGEND_PLOTAREA_MASK) && (Blt_Legend_IsRaised(graphPtr))) {
+	t = Blt_PerfClock();
 	Blt_DrawLegend(graphPtr, drawable);
+	Blt_PerfAdd(graphPtr, PERF_DRAW_LEGEND, t);
     }
     if (site == LEGEND_WINDOW) {
 	Blt_Legend_EventuallyRedraw(graphPtr);
@@ -2308,14 +2885,18 @@ DisplayGraph(ClientData clientData)
     }
     /* Disable crosshairs before redisplaying to the screen */
     Blt_DisableCrosshairs(graphPtr);
+    t = Blt_PerfClock();
     XCopyArea(graphPtr->display, drawable, Tk_WindowId(tkwin),
 	graphPtr->drawGC, 0, 0, graphPtr->width, graphPtr->height, 0, 0);
+    Blt_PerfAdd(graphPtr, PERF_COPY, t);
     Blt_EnableCrosshairs(graphPtr);
     if (graphPtr->doubleBuffer) {
 	Tk_FreePixmap(graphPtr->display, drawable);
     }
     graphPtr->flags &= ~RESET_WORLD;
     UpdateMarginTraces(graphPtr);
+    Blt_PerfAdd(graphPtr, PERF_REDRAW, start);
+    SavePerfRecord(graphPtr);
 }
 
 /*LINTLIBRARY*/
@@ -44,6 +44,7 @@ typedef enum {
     CID_AXIS_Y,
     CID_ELEM_BAR,
     CID_ELEM_CONTOUR,
+    CID_ELEM_HEATMAP,
     CID_ELEM_LINE,
     CID_ELEM_STRIP,
     CID_MARKER_BITMAP,
@@ -144,11 +145,10 @@ typedef struct {
     float sum;				/* Sum of the ordinates (y-coorinate) of
 					 * each duplicate abscissa. Used to
 					 * determine height of stacked bars. */
-    int count;				/* Current number of bars seen.  Used to
-					 * position of the next bar in the
+    int count;				/* Current number of bars seen.  Used
+					 * while the bar sets are rebuilt to
+					 * position the next bar in the
 					 * group. */
-    float lastY;			/* y-cooridinate position of the
-					 * last bar seen. */
     size_t index;			/* Order of group in set (an unique
 					 * abscissa may have more than one
 					 * group). */
@@ -194,6 +194,7 @@ typedef enum BarModes {
 
 typedef struct _Pen Pen;
 typedef struct _Marker Marker;
+typedef struct _MarkerIndex MarkerIndex;
 
 typedef Pen *(PenCreateProc)(void);
 typedef int (PenConfigureProc)(Graph *graphPtr, Pen *penPtr);
@@ -261,6 +262,68 @@ typedef struct {
 #define topMargin	margins[MARGIN_TOP]
 #define bottomMargin	margins[MARGIN_BOTTOM]
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GraphPerf --
+ *
+ *	Timing statistics of the graph, reported by the "perf" operation.
+ *	Times are in microseconds, as measured by the client.  Since X
+ *	requests are asynchronous, drawing times don't include the time the
+ *	X server takes to render.
+ *
+ *---------------------------------------------------------------------------
+ */
+typedef enum {
+    PERF_RESET_AXES,			/* Blt_ResetAxes */
+    PERF_LAYOUT,			/* Blt_LayoutGraph */
+    PERF_MAP_AXES,			/* Blt_MapAxes */
+    PERF_MAP_ELEMENTS,			/* Blt_MapElements */
+    PERF_MAP_MARKERS,			/* Blt_MapMarkers */
+    PERF_DRAW_PLOT,			/* Drawing the plot area, including
+					 * the elements, markers and legend
+					 * drawn into it. */
+    PERF_DRAW_ELEMENTS,			/* Drawing elements. */
+    PERF_DRAW_MARKERS,			/* Drawing markers. */
+    PERF_DRAW_LEGEND,			/* Drawing the legend in the plot
+					 * area. */
+    PERF_COPY,				/* Copying pixmaps to the window. */
+    PERF_POSTSCRIPT,			/* Generating PostScript output. */
+    PERF_REDRAW,			/* Redisplaying the graph, start to
+					 * finish. */
+    PERF_NUM_PHASES
+} PerfPhase;
+
+typedef struct {
+    Tcl_WideInt usecs;			/* Cumulative time. */
+    long count;				/* # of times measured. */
+} PerfCounter;
+
+typedef struct {
+    Tcl_WideInt start;			/* Time the redisplay started, in
+					 * microseconds since the epoch. */
+    Tcl_WideInt usecs[PERF_NUM_PHASES];
+    Tcl_WideInt nPointsMapped;		/* # of data points mapped. */
+    Tcl_WideInt nPointsDrawn;		/* # of screen points left after
+					 * reduction. */
+} PerfRecord;
+
+typedef struct {
+    PerfCounter phases[PERF_NUM_PHASES];
+    Tcl_WideInt nPointsMapped;		/* Cumulative # of data points
+					 * mapped. */
+    Tcl_WideInt nPointsDrawn;		/* Cumulative # of screen points
+					 * generated by mapping. */
+    PerfRecord current;			/* Record of the redisplay in
+					 * progress. */
+    PerfRecord *records;		/* Ring of the most recent redisplay
+					 * records. NULL if records aren't
+					 * kept. */
+    int maxRecords;			/* Size of the ring. */
+    int nRecords;			/* # of records in the ring. */
+    int firstRecord;			/* Index of the oldest record. */
+} GraphPerf;
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -333,6 +396,10 @@ struct _Graph {
     Blt_BindTable bindTable;
     int nextMarkerId;			/* Tracks next marker identifier
 					 * available */
+    MarkerIndex *markerIndex;		/* Markers sorted by their
+					 * x-coordinates, so that only those
+					 * in the plotting area are mapped.
+					 * See bltGrMarker.c. */
     Blt_Chain axisChain[4];		/* Chain of axes for each of the
 					 * margins.  They're separate from the
 					 * margin structures to make it easier
@@ -379,6 +446,13 @@ struct _Graph {
 					 * pixmap first to reduce flashing. */
     int backingStore;			/* If non-zero, cache elements by
 					 * drawing them into a pixmap */
+    int nMapThreads;			/* Maximum # of threads used to map
+					 * elements. If zero, one per
+					 * processor. */
+    int layered;			/* If non-zero, elements whose data
+					 * or style changes are drawn above
+					 * the cache pixmap instead of
+					 * forcing it to be redrawn. */
     Pixmap cache;			/* Pixmap used to cache elements
 					 * displayed.  If *backingStore* is
 					 * non-zero, each element is drawn into
@@ -392,6 +466,9 @@ struct _Graph {
 					 * element. */
     short int cacheWidth, cacheHeight;	/* Size of element backing store
 					 * pixmap. */
+    int scrollDx;			/* # of pixels the cache pixmap is
+					 * to be scrolled horizontally when
+					 * the SCROLL_PLOT flag is set. */
 
     /*
      * barchart specific information
@@ -419,7 +496,7 @@ struct _Graph {
 					 * stacked. */
     int maxBarSetSize;
     const char *dataCmd;		/* New data callback? */
-
+    GraphPerf perf;			/* Timing statistics. */
 };
 
 /*
@@ -481,6 +558,20 @@ struct _Graph {
  *				3) titles have changed
  *				4) window was resized. 
  *
+ *	RESET_BAR_SETS		Indicates that the sets of bars sharing
+ *				an abscissa (and the bar stacks) need to be
+ *				rebuilt before the axes are reset.
+ *
+ *	APPEND_PENDING		Indicates that data was appended to the
+ *				vectors of a stripchart's elements.  If
+ *				the x-axes only slid by whole pixels, the
+ *				cache pixmap is scrolled instead of
+ *				redrawn.  Otherwise CACHE_DIRTY is set.
+ *
+ *	SCROLL_PLOT		Indicates that the cache pixmap is to be
+ *				scrolled by scrollDx pixels and only the
+ *				newly exposed strip and new points drawn.
+ *
  *	GRAPH_FOCUS	
  */
 
@@ -503,6 +594,9 @@ struct _Graph {
 #define	CACHE_DIRTY		(1<<14)/* 0x4000 */
 #define REQ_BACKING_STORE	(1<<15)/* 0x8000 */
 #define UNMAP_HIDDEN		(1<<16)
+#define RESET_BAR_SETS		(1<<17)
+#define APPEND_PENDING		(1<<18)
+#define SCROLL_PLOT		(1<<19)
 
 #define	MAP_WORLD		(MAP_ALL|RESET_AXES|GET_AXIS_GEOMETRY)
 #define REDRAW_WORLD		(DRAW_LEGEND)
@@ -524,6 +618,9 @@ BLT_EXTERN double Blt_HMap(Axis *axisPtr, double x);
 
 BLT_EXTERN double Blt_VMap(Axis *axisPtr, double y);
 
+BLT_EXTERN void Blt_GetAxisTransform(Axis *axisPtr, int vertical, 
+	double *originPtr, double *scalePtr, double *offsetPtr);
+
 BLT_EXTERN Point2d Blt_InvMap2D(Graph *graphPtr, double x, double y, 
 	Axis2d *pairPtr);
 
@@ -558,16 +655,28 @@ BLT_EXTERN void Blt_DestroyPageSetup(Graph *graphPtr);
 
 BLT_EXTERN void Blt_DrawAxes(Graph *graphPtr, Drawable drawable);
 
+BLT_EXTERN int Blt_AxesAreHidden(Graph *graphPtr);
+
 BLT_EXTERN void Blt_DrawAxisLimits(Graph *graphPtr, Drawable drawable);
 
 BLT_EXTERN void Blt_DrawElements(Graph *graphPtr, Drawable drawable);
 
+BLT_EXTERN void Blt_DrawLiveElements(Graph *graphPtr, Drawable drawable);
+
+BLT_EXTERN void Blt_DrawScrolledElements(Graph *graphPtr, Drawable drawable);
+
+BLT_EXTERN void Blt_UpdateElementLayers(Graph *graphPtr);
+
 BLT_EXTERN void Blt_DrawActiveElements(Graph *graphPtr, Drawable drawable);
 
+BLT_EXTERN int Blt_ElementsToPicture(Graph *graphPtr, Blt_Picture picture);
+
 BLT_EXTERN void Blt_DrawGraph(Graph *graphPtr, Drawable drawable);
 
 BLT_EXTERN void Blt_DrawMarkers(Graph *graphPtr, Drawable drawable, int under);
 
+BLT_EXTERN int Blt_HasMarkersUnder(Graph *graphPtr);
+
 BLT_EXTERN void Blt_Draw2DSegments(Display *display, Drawable drawable, GC gc, 
 	Segment2d *segments, int nSegments);
 
@@ -580,9 +689,9 @@ BLT_EXTERN void Blt_LayoutGraph(Graph *graphPtr);
 
 BLT_EXTERN void Blt_EventuallyRedrawGraph(Graph *graphPtr);
 
-BLT_EXTERN void Blt_ResetAxes(Graph *graphPtr);
+BLT_EXTERN void Blt_RedrawGraphNow(Graph *graphPtr);
 
-BLT_EXTERN void Blt_ResetBarGroups(Graph *graphPtr);
+BLT_EXTERN void Blt_ResetAxes(Graph *graphPtr);
 
 BLT_EXTERN void Blt_GraphExtents(Graph *graphPtr, Region2d *extsPtr);
 
@@ -594,10 +703,19 @@ BLT_EXTERN void Blt_MapGraph(Graph *graphPtr);
 
 BLT_EXTERN void Blt_MapAxes(Graph *graphPtr);
 
+BLT_EXTERN void Blt_SaveAxisTransforms(Graph *graphPtr);
+
+BLT_EXTERN int Blt_GetAxisScroll(Graph *graphPtr, int *dxPtr);
+
 BLT_EXTERN void Blt_MapElements(Graph *graphPtr);
 
 BLT_EXTERN void Blt_MapMarkers(Graph *graphPtr);
 
+BLT_EXTERN Tcl_WideInt Blt_PerfClock(void);
+
+BLT_EXTERN void Blt_PerfAdd(Graph *graphPtr, PerfPhase phase, 
+	Tcl_WideInt start);
+
 BLT_EXTERN void Blt_UpdateCrosshairs(Graph *graphPtr);
 
 BLT_EXTERN void Blt_DestroyPens(Graph *graphPtr);
@@ -685,8 +803,12 @@ BLT_EXTERN Element *Blt_LineElement(Graph *graphPtr, const char *name,
 	ClassId classId);
 BLT_EXTERN Element *Blt_BarElement(Graph *graphPtr, const char *name, 
 	ClassId classId);
+BLT_EXTERN Element *Blt_HeatmapElement(Graph *graphPtr, const char *name, 
+	ClassId classId);
 
 BLT_EXTERN void Blt_DrawGrids(Graph *graphPtr, Drawable drawable);
+BLT_EXTERN void Blt_DrawGridRegion(Graph *graphPtr, Drawable drawable, 
+	TkRegion rgn);
 
 BLT_EXTERN void Blt_GridsToPostScript(Graph *graphPtr, Blt_Ps ps);
 BLT_EXTERN void Blt_InitBarSetTable(Graph *graphPtr);
@@ -543,6 +543,15 @@ BLT_EXTERN int Blt_QuadraticSpline (Point2d *origPts, int nOrigPts,
 BLT_EXTERN int Blt_SimplifyLine (Point2d *origPts, int low, int high, 
 	double tolerance, int *indices);
 
+BLT_EXTERN int Blt_SimplifyMonotonicLine (Point2d *points, int nPoints, 
+	double tolerance, int *indices);
+
+BLT_EXTERN int Blt_SimplifyLineRadial (Point2d *points, int nPoints, 
+	double tolerance, int *indices);
+
+BLT_EXTERN int Blt_SimplifyLineVW (Point2d *points, int nPoints, 
+	double tolerance, int *indices);
+
 BLT_EXTERN int Blt_NaturalParametricSpline (Point2d *origPts, int nOrigPts, 
 	Region2d *extsPtr, int isClosed, Point2d *intpPts, int nIntpPts);
 
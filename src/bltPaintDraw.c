@@ -1462,3 +1462,15 @@ Blt_PaintRectangle(
 {
     PaintRectangle(picture, x, y, w, h, r, lineWidth, colorPtr);
 }
+
+void
+Blt_PaintCircle(
+    Blt_Picture picture, 
+    int x, int y,		/* Center of the circle. */
+    int r,			/* Radius of the circle. */
+    int lineWidth,		/* Line width of the circle.  If zero, then
+				 * draw a solid filled circle. */
+    Blt_Pixel *colorPtr)
+{
+    PaintEllipse(picture, x, y, r, r, lineWidth, colorPtr, 1);
+}
@@ -82,4 +82,10 @@ BLT_EXTERN void Blt_PaintRectangle(Blt_Picture picture, int x, int y, int w,
 
 BLT_EXTERN void Blt_PaintPolygon(Blt_Picture picture, int n, Point2f *vertices,
 	Blt_Pixel *colorPtr);
+
+BLT_EXTERN void Blt_PaintPolyline(Blt_Picture picture, int n, Point2d *points,
+	Blt_Pixel *colorPtr);
+
+BLT_EXTERN void Blt_PaintCircle(Blt_Picture picture, int x, int y, int r, 
+	int lineWidth, Blt_Pixel *colorPtr);
 #endif /* _BLT_PAINTER_H */
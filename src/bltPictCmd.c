@@ -913,6 +913,117 @@ LoadFormat(Tcl_Interp *interp, const char *name)
     return (result != NULL);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetExportFormat --
+ *
+ *	Finds the named picture format, loading it if necessary, and checks
+ *	that it can export pictures.
+ *
+ * Results:
+ *	Returns the format, or NULL if there's no such format or it has no
+ *	export procedure.  In that case an error message is left in
+ *	interp->result.
+ *
+ *---------------------------------------------------------------------------
+ */
+static PictFormat *
+GetExportFormat(Tcl_Interp *interp, const char *fmt)
+{
+    Blt_HashEntry *hPtr;
+    PictFormat *fmtPtr;
+
+    hPtr = Blt_FindHashEntry(&fmtTable, fmt);
+    if (hPtr == NULL) {
+	Tcl_AppendResult(interp, "can't export \"", fmt,
+			 "\": format not registered", (char *)NULL);
+	return NULL;
+    }
+    fmtPtr = Blt_GetHashValue(hPtr);
+    if ((fmtPtr->flags & BLT_PIC_FMT_LOADED) == 0) {
+	LoadFormat(interp, fmt);
+    }
+    if (fmtPtr->exportProc == NULL) {
+	Tcl_AppendResult(interp, "no export procedure registered for \"", 
+			 fmtPtr->name, "\"", (char *)NULL);
+	return NULL;
+    }
+    return fmtPtr;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_GetPictureExportFormat --
+ *
+ *	Checks that the named picture format is registered and can export
+ *	pictures.  Widgets use this to validate a format when it's
+ *	configured, rather than when the picture is exported.
+ *
+ * Results:
+ *	Returns a standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_GetPictureExportFormat(Tcl_Interp *interp, const char *fmt)
+{
+    return (GetExportFormat(interp, fmt) == NULL) ? TCL_ERROR : TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_ExportPicture --
+ *
+ *	Exports the picture using the named picture format, as if the
+ *	picture was held by a picture image and its "export" operation was
+ *	called.  This lets widgets write pictures to files without creating
+ *	a picture image first.
+ *
+ * Results:
+ *	Returns a standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_ExportPicture(
+    Tcl_Interp *interp,			/* Interpreter to report errors. */
+    Blt_Picture picture,		/* Picture to be exported. */
+    const char *fmt,			/* Name of picture format. */
+    int objc,				/* # of export switches. */
+    Tcl_Obj *const *objv)		/* Export switches for the format. */
+{
+    Blt_Chain chain;
+    PictFormat *fmtPtr;
+    Tcl_Obj **argv, *fmtObjPtr;
+    int i, result;
+
+    fmtPtr = GetExportFormat(interp, fmt);
+    if (fmtPtr == NULL) {
+	return TCL_ERROR;
+    }
+    /* 
+     * Export procedures expect the arguments of the picture's "export"
+     * operation: "imageName export format ?switches?".
+     */
+    argv = Blt_AssertMalloc(sizeof(Tcl_Obj *) * (objc + 3));
+    fmtObjPtr = Tcl_NewStringObj(fmt, -1);
+    Tcl_IncrRefCount(fmtObjPtr);
+    argv[0] = argv[1] = argv[2] = fmtObjPtr;
+    for (i = 0; i < objc; i++) {
+	argv[i + 3] = objv[i];
+    }
+    chain = Blt_Chain_Create();
+    Blt_Chain_Append(chain, picture);
+    result = (*fmtPtr->exportProc)(interp, 0, chain, objc + 3, argv);
+    Blt_Chain_Destroy(chain);
+    Tcl_DecrRefCount(fmtObjPtr);
+    Blt_Free(argv);
+    return result;
+}
+
 static PictFormat *
 QueryExternalFormat(
     Tcl_Interp *interp,			/* Interpreter to load new format
@@ -1054,6 +1054,37 @@ PaintPolyline(
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_PaintPolyline --
+ *
+ *	Paints a one pixel wide polyline into the picture.  The segments
+ *	are clipped to the picture.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_PaintPolyline(Pict *destPtr, int nPoints, Point2d *points, 
+		  Blt_Pixel *colorPtr)
+{
+    Region2d r;
+    int i;
+
+    r.left = r.top = 0;
+    r.right = destPtr->width - 1;
+    r.bottom = destPtr->height - 1;
+    for (i = 1; i < nPoints; i++) {
+	Point2d p, q;
+
+	p = points[i - 1], q = points[i];
+	if (Blt_LineRectClip(&r, &p, &q)) {
+	    PaintLineSegment(destPtr, ROUND(p.x), ROUND(p.y), ROUND(q.x), 
+		ROUND(q.y), 0, colorPtr);
+	}
+    }
+}
+
 #if DRAWTEXT
 
 #undef __FTERRORS_H__
@@ -307,6 +307,11 @@ BLT_EXTERN int Blt_GetPicture(Tcl_Interp *interp, const char *string,
 BLT_EXTERN int Blt_GetPictureFromObj(Tcl_Interp *interp, Tcl_Obj *objPtr, 
 	Blt_Picture *picturePtr);
 
+BLT_EXTERN int Blt_ExportPicture(Tcl_Interp *interp, Blt_Picture picture, 
+	const char *fmt, int objc, Tcl_Obj *const *objv);
+
+BLT_EXTERN int Blt_GetPictureExportFormat(Tcl_Interp *interp, const char *fmt);
+
 BLT_EXTERN int Blt_GetResampleFilterFromObj(Tcl_Interp *interp, Tcl_Obj *objPtr,
 	Blt_ResampleFilter *filterPtr);
 
@@ -236,10 +236,82 @@ Blt_Ps_Create(Tcl_Interp *interp, PageSetup *setupPtr)
     psPtr = Blt_AssertMalloc(sizeof(PostScript));
     psPtr->setupPtr = setupPtr;
     psPtr->interp = interp;
+    psPtr->channel = NULL;
+    psPtr->nErrors = 0;
     Tcl_DStringInit(&psPtr->dString);
     return psPtr;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Ps_SetChannel --
+ *
+ *      Directs the PostScript output to the given channel.  Rather than
+ *      accumulating the entire document in memory, the output is written
+ *      in PS_CHUNKSIZE pieces as it is generated.  Blt_Ps_Flush must be
+ *      called to write the remainder.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_Ps_SetChannel(PostScript *psPtr, Tcl_Channel channel)
+{
+    psPtr->channel = channel;
+    psPtr->nErrors = 0;
+}
+
+static void
+WriteChunk(PostScript *psPtr)
+{
+    int nBytes;
+
+    nBytes = Tcl_DStringLength(&psPtr->dString);
+    if (Tcl_Write(psPtr->channel, Tcl_DStringValue(&psPtr->dString), nBytes)
+	!= nBytes) {
+	psPtr->nErrors++;
+    }
+    Tcl_DStringSetLength(&psPtr->dString, 0);
+}
+
+#define CheckChunk(psPtr) \
+    if (((psPtr)->channel != NULL) && \
+	(Tcl_DStringLength(&(psPtr)->dString) >= PS_CHUNKSIZE)) { \
+	WriteChunk(psPtr); \
+    }
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Ps_Flush --
+ *
+ *      Writes any PostScript output still buffered to the channel set by
+ *      Blt_Ps_SetChannel.
+ *
+ * Results:
+ *      Returns a standard TCL result.  If any write to the channel failed,
+ *      TCL_ERROR is returned and an error message is left in the
+ *      interpreter result.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_Ps_Flush(PostScript *psPtr)
+{
+    if (psPtr->channel == NULL) {
+	return TCL_OK;
+    }
+    if (Tcl_DStringLength(&psPtr->dString) > 0) {
+	WriteChunk(psPtr);
+    }
+    if ((psPtr->nErrors > 0) || (Tcl_Flush(psPtr->channel) != TCL_OK)) {
+	Tcl_AppendResult(psPtr->interp, "error writing PostScript: ",
+		Tcl_PosixError(psPtr->interp), (char *)NULL);
+	return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
 void 
 Blt_Ps_SetPrinting(PostScript *psPtr, int state)
 {
@@ -331,18 +403,22 @@ TCL_VARARGS_DEF(PostScript *, arg1)
 	}
 	Tcl_DStringAppend(&psPtr->dString, string, -1);
     }
+    va_end(argList);
+    CheckChunk(psPtr);
 }
 
 void
 Blt_Ps_AppendBytes(PostScript *psPtr, const char *bytes, int length)
 {
     Tcl_DStringAppend(&psPtr->dString, bytes, length);
+    CheckChunk(psPtr);
 }
 
 void
 Blt_Ps_Append(PostScript *psPtr, const char *string)
 {
     Tcl_DStringAppend(&psPtr->dString, string, -1);
+    CheckChunk(psPtr);
 }
 
 void
@@ -358,6 +434,7 @@ TCL_VARARGS_DEF(PostScript *, arg1)
     vsnprintf(psPtr->scratchArr, POSTSCRIPT_BUFSIZ, fmt, argList);
     va_end(argList);
     Tcl_DStringAppend(&psPtr->dString, psPtr->scratchArr, -1);
+    CheckChunk(psPtr);
 }
 
 int
@@ -824,45 +901,168 @@ Blt_Ps_XFillRectangle(Blt_Ps ps, double x, double y, int width, int height)
     Blt_Ps_Append(ps, "fill\n");
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Path generation --
+ *
+ *      Paths are generated with coordinates rounded to 1/PS_PATH_UNITS of a
+ *      point, well below the resolution of any output device.  Points that
+ *      fall on the previous point at that resolution are dropped, as are
+ *      interior points of straight runs (common with step and clipped
+ *      traces).  Each remaining point is written as a short "rlineto"
+ *      relative to the previous one.  This keeps the output for dense
+ *      traces small without changing what is rendered.
+ *
+ *---------------------------------------------------------------------------
+ */
+#define PS_PATH_UNITS	100
+
+typedef struct {
+    PostScript *psPtr;
+    long x0, y0;			/* Last point written. */
+    long x1, y1;			/* Pending point, not yet written. */
+    int pending;
+} PathWriter;
+
+static char *
+FormatPathUnits(char *bp, long value)
+{
+    long ipart, fpart;
+
+    if (value < 0) {
+	*bp++ = '-';
+	value = -value;
+    }
+    ipart = value / PS_PATH_UNITS;
+    fpart = value % PS_PATH_UNITS;
+    bp += sprintf(bp, "%ld", ipart);
+    if (fpart != 0) {
+	if ((fpart % 10) == 0) {
+	    bp += sprintf(bp, ".%ld", fpart / 10);
+	} else {
+	    bp += sprintf(bp, ".%02ld", fpart);
+	}
+    }
+    return bp;
+}
+
+static void
+WritePathOp(PathWriter *writerPtr, long x, long y, const char *op)
+{
+    char string[200];
+    char *bp;
+
+    bp = string;
+    *bp++ = ' ';
+    *bp++ = ' ';
+    bp = FormatPathUnits(bp, x);
+    *bp++ = ' ';
+    bp = FormatPathUnits(bp, y);
+    sprintf(bp, " %s\n", op);
+    Blt_Ps_Append(writerPtr->psPtr, string);
+}
+
+static void
+BeginPath(PathWriter *writerPtr, PostScript *psPtr, double x, double y)
+{
+    writerPtr->psPtr = psPtr;
+    writerPtr->x0 = ROUND(x * PS_PATH_UNITS);
+    writerPtr->y0 = ROUND(y * PS_PATH_UNITS);
+    writerPtr->pending = FALSE;
+    Blt_Ps_Append(psPtr, "newpath\n");
+    WritePathOp(writerPtr, writerPtr->x0, writerPtr->y0, "moveto");
+}
+
+static void
+AddPathPoint(PathWriter *writerPtr, double x, double y)
+{
+    long x2, y2;
+
+    x2 = ROUND(x * PS_PATH_UNITS);
+    y2 = ROUND(y * PS_PATH_UNITS);
+    if (writerPtr->pending) {
+	long ax, ay, bx, by;
+	Tcl_WideInt cross, dot;
+
+	if ((x2 == writerPtr->x1) && (y2 == writerPtr->y1)) {
+	    return;			/* Same point at device resolution. */
+	}
+	ax = writerPtr->x1 - writerPtr->x0;
+	ay = writerPtr->y1 - writerPtr->y0;
+	bx = x2 - writerPtr->x1;
+	by = y2 - writerPtr->y1;
+	/* 
+	 * The products are computed in 64 bits: with longs of 32 bits, they
+	 * overflow for deltas of a few hundred points.
+	 */
+	cross = ((Tcl_WideInt)ax * by) - ((Tcl_WideInt)ay * bx);
+	dot = ((Tcl_WideInt)ax * bx) + ((Tcl_WideInt)ay * by);
+	if ((cross == 0) && (dot > 0)) {
+	    /* Pending point lies on a straight run. Extend the run. */
+	    writerPtr->x1 = x2, writerPtr->y1 = y2;
+	    return;
+	}
+	WritePathOp(writerPtr, ax, ay, "rlineto");
+	writerPtr->x0 = writerPtr->x1, writerPtr->y0 = writerPtr->y1;
+    } else if ((x2 == writerPtr->x0) && (y2 == writerPtr->y0)) {
+	return;
+    }
+    writerPtr->x1 = x2, writerPtr->y1 = y2;
+    writerPtr->pending = TRUE;
+}
+
+static void
+EndPath(PathWriter *writerPtr)
+{
+    if (writerPtr->pending) {
+	WritePathOp(writerPtr, writerPtr->x1 - writerPtr->x0, 
+		writerPtr->y1 - writerPtr->y0, "rlineto");
+	writerPtr->x0 = writerPtr->x1, writerPtr->y0 = writerPtr->y1;
+	writerPtr->pending = FALSE;
+    }
+}
+
 void
 Blt_Ps_PolylineFromXPoints(Blt_Ps ps, XPoint *points, int n)
 {
+    PathWriter writer;
     XPoint *pp, *pend;
 
     pp = points;
-    Blt_Ps_Append(ps, "newpath\n");
-    Blt_Ps_Format(ps, "  %d %d moveto\n", pp->x, pp->y);
-    pp++;
-    for (pend = points + n; pp < pend; pp++) {
-	Blt_Ps_Format(ps, "  %d %d lineto\n", pp->x, pp->y);
+    BeginPath(&writer, ps, pp->x, pp->y);
+    for (pp++, pend = points + n; pp < pend; pp++) {
+	AddPathPoint(&writer, pp->x, pp->y);
     }
+    EndPath(&writer);
 }
 
 void
 Blt_Ps_Polyline(Blt_Ps ps, Point2d *screenPts, int nScreenPts)
 {
+    PathWriter writer;
     Point2d *pp, *pend;
 
     pp = screenPts;
-    Blt_Ps_Append(ps, "newpath\n");
-    Blt_Ps_Format(ps, "  %g %g moveto\n", pp->x, pp->y);
+    BeginPath(&writer, ps, pp->x, pp->y);
     for (pp++, pend = screenPts + nScreenPts; pp < pend; pp++) {
-	Blt_Ps_Format(ps, "  %g %g lineto\n", pp->x, pp->y);
+	AddPathPoint(&writer, pp->x, pp->y);
     }
+    EndPath(&writer);
 }
 
 void
 Blt_Ps_Polygon(Blt_Ps ps, Point2d *screenPts, int nScreenPts)
 {
+    PathWriter writer;
     Point2d *pp, *pend;
 
     pp = screenPts;
-    Blt_Ps_Append(ps, "newpath\n");
-    Blt_Ps_Format(ps, "  %g %g moveto\n", pp->x, pp->y);
+    BeginPath(&writer, ps, pp->x, pp->y);
     for (pp++, pend = screenPts + nScreenPts; pp < pend; pp++) {
-	Blt_Ps_Format(ps, "  %g %g lineto\n", pp->x, pp->y);
+	AddPathPoint(&writer, pp->x, pp->y);
     }
-    Blt_Ps_Format(ps, "  %g %g lineto\n", screenPts[0].x, screenPts[0].y);
+    EndPath(&writer);
     Blt_Ps_Append(ps, "closepath\n");
 }
 
@@ -1044,22 +1244,12 @@ Base85Encode(Blt_DBuffer dBuffer, Tcl_DString *resultPtr)
 
     n = count = 0;
     dp = Tcl_DStringValue(resultPtr) + oldLength;
-    for (sp = Blt_DBuffer_Bytes(dBuffer), send = sp + nBytes; sp < send; 
-	 sp += 4) {
+    sp = Blt_DBuffer_Bytes(dBuffer);
+    /* The tuples are always read in big-endian (stream) order. */
+    for (send = sp + (nBytes & ~0x3); sp < send; sp += 4) {
 	unsigned int tuple;
 	
-	tuple = 0;
-#ifdef WORDS_BIGENDIAN
-	tuple |= (sp[3] << 24);
-	tuple |= (sp[2] << 16); 
-	tuple |= (sp[1] <<  8);
-	tuple |= sp[0];
-#else 
-	tuple |= (sp[0] << 24);
-	tuple |= (sp[1] << 16); 
-	tuple |= (sp[2] <<  8);
-	tuple |= sp[3];
-#endif
+	tuple = (sp[0] << 24) | (sp[1] << 16) | (sp[2] << 8) | sp[3];
 	if (tuple == 0) {
 	    *dp++ = 'z';
 	    count++;
@@ -1087,49 +1277,37 @@ Base85Encode(Blt_DBuffer dBuffer, Tcl_DString *resultPtr)
     
     {
 	unsigned int tuple;
+	char tmp[5];
+	int i;
 
-	/* Handle remaining bytes (0-3). */
+	/* 
+	 * Handle remaining bytes (0-3).  The last tuple is padded with
+	 * zeros and only the first nBytes + 1 characters are written.
+	 */
 	nBytes = (nBytes & 0x3);
-	sp -= nBytes;
 	tuple = 0;
 	switch (nBytes) {
-#ifdef WORDS_BIGENDIAN
 	case 3:
 	    tuple |= (sp[2] <<  8);
 	case 2:
 	    tuple |= (sp[1] << 16); 
 	case 1:
 	    tuple |= (sp[0] << 24);
-#else
-	case 3:
-	    tuple |= (sp[2] << 24);
-	case 2:
-	    tuple |= (sp[1] << 16); 
-	case 1:
-	    tuple |= (sp[0] <<  8);
-#endif
 	default:
 	    break;
 	}
 	if (nBytes > 0) {
-	    tuple /= 85;	
-	    if (nBytes > 2) {
-		dp[3] = '!' + (tuple % 85);
-		n++;
+	    for (i = 4; i >= 0; i--) {
+		tmp[i] = '!' + (tuple % 85);
+		tuple /= 85;
 	    }
-	    tuple /= 85;	
-	    if (nBytes > 1) { 
-		dp[2] = '!' + (tuple % 85);
-		n++;
+	    for (i = 0; i <= nBytes; i++) {
+		*dp++ = tmp[i];
 	    }
-	    tuple /= 85;	
-	    dp[1] = '!' + (tuple % 85);
-	    tuple /= 85;	
-	    dp[0] = '!' + (tuple % 85);
 	    *dp++ = '\n';
-	    n += 3;
+	    n += nBytes + 2;
 	}
-	Tcl_DStringSetLength(resultPtr, n);
+	Tcl_DStringSetLength(resultPtr, oldLength + n);
     }
 }
 
@@ -1176,6 +1354,65 @@ AsciiHexEncode(Blt_DBuffer dBuffer, Tcl_DString *resultPtr)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * RunLengthEncode --
+ *
+ *      Compresses the bytes of the buffer using the PostScript Level 2
+ *      RunLengthDecode format.  Runs of 2 to 128 identical bytes are
+ *      encoded as a count and the byte; everything else is copied as
+ *      literal blocks of up to 128 bytes.  The output is terminated by
+ *      the EOD marker (128).
+ *
+ * Results:
+ *      Returns a new buffer containing the encoded bytes.
+ *
+ *---------------------------------------------------------------------------
+ */
+static Blt_DBuffer
+RunLengthEncode(Blt_DBuffer srcBuffer)
+{
+    Blt_DBuffer destBuffer;
+    unsigned char *sp, *send, *literal;
+
+    destBuffer = Blt_DBuffer_Create();
+    sp = literal = Blt_DBuffer_Bytes(srcBuffer);
+    send = sp + Blt_DBuffer_Length(srcBuffer);
+    while (sp < send) {
+	unsigned char *rp;
+
+	for (rp = sp + 1; (rp < send) && (*rp == *sp) && ((rp - sp) < 128); 
+	     rp++) {
+	    /*empty*/
+	}
+	if ((rp - sp) > 1) {
+	    /* Write out any pending literal block, then the run. */
+	    if (literal < sp) {
+		Blt_DBuffer_AppendByte(destBuffer, 
+			(unsigned char)(sp - literal - 1));
+		Blt_DBuffer_AppendData(destBuffer, literal, sp - literal);
+	    }
+	    Blt_DBuffer_AppendByte(destBuffer, (unsigned char)(257 - (rp - sp)));
+	    Blt_DBuffer_AppendByte(destBuffer, *sp);
+	    literal = sp = rp;
+	    continue;
+	}
+	sp++;
+	if ((sp - literal) == 128) {
+	    Blt_DBuffer_AppendByte(destBuffer, 127);
+	    Blt_DBuffer_AppendData(destBuffer, literal, 128);
+	    literal = sp;
+	}
+    }
+    if (literal < sp) {
+	Blt_DBuffer_AppendByte(destBuffer, (unsigned char)(sp - literal - 1));
+	Blt_DBuffer_AppendData(destBuffer, literal, sp - literal);
+    }
+    Blt_DBuffer_AppendByte(destBuffer, 128);	/* EOD */
+    return destBuffer;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1226,8 +1463,25 @@ Blt_Ps_DrawPicture(PostScript *psPtr, Blt_Picture picture, double x, double y)
 	    dBuffer = Blt_PictureToDBuffer(picture, 3);
 	}
 	AsciiHexEncode(dBuffer, &psPtr->dString);
-	Blt_DBuffer_Free(dBuffer);
+	Blt_DBuffer_Destroy(dBuffer);
     } else {
+	Blt_DBuffer rleBuffer;
+	const char *filter;
+
+	/* 
+	 * Run-length compress the pixels when it pays.  Plots and
+	 * screenshots usually have large areas of constant color.
+	 */
+	dBuffer = Blt_PictureToDBuffer(picture, 3);
+	rleBuffer = RunLengthEncode(dBuffer);
+	if (Blt_DBuffer_Length(rleBuffer) < Blt_DBuffer_Length(dBuffer)) {
+	    Blt_DBuffer_Destroy(dBuffer);
+	    dBuffer = rleBuffer;
+	    filter = " /RunLengthDecode filter";
+	} else {
+	    Blt_DBuffer_Destroy(rleBuffer);
+	    filter = "";
+	}
 	Blt_Ps_Format(psPtr, 
 	    "<<\n"
 	    "/ImageType 1\n"
@@ -1237,12 +1491,14 @@ Blt_Ps_DrawPicture(PostScript *psPtr, Blt_Picture picture, double x, double y)
 	    "/Decode [0 1 0 1 0 1]\n"
 	    "/ImageMatrix [%d 0 0 %d 0 %d]\n"
 	    "/Interpolate true\n"
-	    "/DataSource  currentfile /ASCII85Decode filter\n"
+	    "/DataSource  currentfile /ASCII85Decode filter%s\n"
 	    ">>\n"
-	    "image\n", w, h, w, -h, h);
-	dBuffer = Blt_PictureToDBuffer(picture, 3);
+	    "image\n", w, h, w, -h, h, filter);
 	Base85Encode(dBuffer, &psPtr->dString);
-	Blt_DBuffer_Free(dBuffer);
+	Blt_DBuffer_Destroy(dBuffer);
+	if (filter[0] != '\0') {
+	    Blt_Ps_Append(psPtr, "~>\n");
+	}
     } 
     Blt_Ps_Append(psPtr, "\ngrestore\n\n");
 }
@@ -1583,12 +1839,19 @@ Blt_Ps_DrawBitmap(
 void
 Blt_Ps_Draw2DSegments(Blt_Ps ps, Segment2d *segments, int nSegments)
 {
+    PathWriter writer;
     Segment2d *sp, *send;
 
+    writer.psPtr = ps;
     Blt_Ps_Append(ps, "newpath\n");
     for (sp = segments, send = sp + nSegments; sp < send; sp++) {
-	Blt_Ps_Format(ps, "  %g %g moveto %g %g lineto\n", 
-		sp->p.x, sp->p.y, sp->q.x, sp->q.y);
+	long x, y;
+
+	x = ROUND(sp->p.x * PS_PATH_UNITS);
+	y = ROUND(sp->p.y * PS_PATH_UNITS);
+	WritePathOp(&writer, x, y, "moveto");
+	WritePathOp(&writer, ROUND(sp->q.x * PS_PATH_UNITS) - x, 
+		ROUND(sp->q.y * PS_PATH_UNITS) - y, "rlineto");
 	Blt_Ps_Append(ps, "DashesProc stroke\n");
     }
 }
@@ -131,6 +131,10 @@ BLT_EXTERN void Blt_Ps_Rectangle(Blt_Ps ps, int x, int y, int w, int h);
 BLT_EXTERN int Blt_Ps_SaveFile(Tcl_Interp *interp, Blt_Ps ps, 
 	const char *fileName);
 
+BLT_EXTERN void Blt_Ps_SetChannel(Blt_Ps ps, Tcl_Channel channel);
+
+BLT_EXTERN int Blt_Ps_Flush(Blt_Ps ps);
+
 #ifdef _TK
 
 #include "bltFont.h"
@@ -36,6 +36,12 @@ struct _Blt_Ps {
 				 * PostScript generated. */
     PageSetup *setupPtr;
 
+    Tcl_Channel channel;	/* If non-NULL, output is streamed to this
+				 * channel whenever the dynamic string grows
+				 * beyond PS_CHUNKSIZE bytes. */
+    int nErrors;		/* # of failed writes to the channel. */
+
+#define PS_CHUNKSIZE		(1<<16)
 #define POSTSCRIPT_BUFSIZ	((BUFSIZ*2)-1)
     /*
      * Utility space for building strings.  Currently used to create
@@ -1,746 +1,881 @@
 #include "bltInt.h"
-#include "bltChain.h"
 
-#define DELETED		((Edge *)-2)
-#define LE 0
-#define RE 1
-
-#define Dist(p,q)    \
-	hypot((p)->point.x - (q)->point.x, (p)->point.y - (q)->point.y)
-
-typedef struct _HalfEdge HalfEdge;
-typedef struct _FreeNode FreeNode;
+/*
+ * Delaunay triangulation of scattered points.
+ *
+ * The triangulation is computed by a sweep-hull algorithm.  The points are
+ * sorted by their distance from the center of a seed triangle and added in
+ * that order.  Each new point lies outside of the current convex hull: it
+ * is connected to the hull edges visible from it, and the new triangles
+ * are made Delaunay by flipping edges.  A hash of the hull vertices by
+ * angle finds the visible edges in constant expected time, so the whole
+ * triangulation is about O(n log n) and needs only a few arrays of
+ * integers.
+ *
+ * The orientation and in-circle tests use Shewchuk's floating point
+ * filters.  When the filter can't decide the sign, the determinant is
+ * evaluated exactly with expansion arithmetic.  Collinear and cocircular
+ * points (for example, points on a grid) are therefore handled
+ * consistently.
+ */
 
 typedef struct {
     int a, b, c;
     float min, max;
 } Triplet;
 
-struct _FreeNode {
-    FreeNode *nextPtr;
-};
-
-typedef struct {
-    FreeNode *headPtr;
-    int nodesize;
-} FreeList;
-
 typedef struct {
-    Point2d point;
-    int neighbor;
-    int refCount;
-} Site;
+    double x, y;
+} TriPoint;
 
 typedef struct {
-    double a, b, c;
-    Site *ep[2];
-    Site *leftReg, *rightReg;
-    int neighbor;
-} Edge;
-
-struct _HalfEdge {
-    HalfEdge *leftPtr, *rightPtr;
-    Edge *edgePtr;
-    int refCount;
-    int pm;
-    Site *vertex;
-    double ystar;
-    HalfEdge *pqNext;
-};
-
-/* Static variables */
+    TriPoint *points;			/* Coordinates of the points. */
+    int nPoints;
+
+    int *triangles;			/* Vertices of the triangles, 3 per
+					 * triangle, counter-clockwise.
+					 * Half-edge e starts at vertex
+					 * triangles[e]. */
+    int *halfEdges;			/* Opposite half-edge of each
+					 * half-edge, or -1 on the hull. */
+    int nHalfEdges;
+
+    int *hullNext, *hullPrev;		/* Hull as a circular list of
+					 * vertices, counter-clockwise. */
+    int *hullTri;			/* Half-edge from each hull vertex
+					 * to its successor on the hull. */
+    int *hullHash;			/* Hull vertices hashed by angle from
+					 * the center. */
+    int hashSize;
+    int hullStart;
+    double cx, cy;			/* Center of the seed triangle. */
+
+    int *edgeStack;			/* Pending edges to be legalized. */
+    int stackSize;
+} Sweep;
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Robust geometric predicates --
+ *
+ *	Orient2d(a, b, c) is positive if a, b, c are counter-clockwise,
+ *	negative if clockwise, and zero if collinear.  InCircle(a, b, c, d)
+ *	is positive if d lies inside the circle through the counter-clockwise
+ *	points a, b, c, negative if outside, and zero if cocircular.
+ *
+ *	Both first evaluate the determinant in floating point with a
+ *	bound on its error (J. R. Shewchuk, "Adaptive Precision
+ *	Floating-Point Arithmetic and Fast Robust Geometric Predicates").
+ *	If the bound can't guarantee the sign, the determinant is computed
+ *	exactly as an expansion (an unevaluated sum of non-overlapping
+ *	doubles).
+ *
+ *---------------------------------------------------------------------------
+ */
+#define EPSILON		1.1102230246251565e-16	/* 2^-53 */
+#define SPLITTER	134217729.0		/* 2^27 + 1 */
+#define CCW_ERRBOUND	((3.0 + 16.0 * EPSILON) * EPSILON)
+#define ICC_ERRBOUND	((10.0 + 96.0 * EPSILON) * EPSILON)
 
-typedef struct {
-    double xMin, xMax, yMin, yMax, xDelta, yDelta;
-    Site *sites;
-    int nSites;
-    int siteIndex;
-    int sqrtNumSites;
-    int nVertices;
-    Site *bottomsite;
-    int nEdges;
-    FreeList freeSites;
-    FreeList freeEdges;
-    FreeList freeHalfEdges;
-    HalfEdge *elLeftEnd, *elRightEnd;
-    int elHashsize;
-    HalfEdge **elHash;
-    int pqHashsize;
-    HalfEdge *pqHash;
-    int pqCount;
-    int pqMin;
-    Blt_Chain allocChain;
-} Voronoi;
+#define MAX_EXPANSION	2048
 
-static void
-FreeInit(FreeList *listPtr, int size)
+static INLINE void
+TwoSum(double a, double b, double *xPtr, double *yPtr)
 {
-    listPtr->headPtr = NULL;
-    listPtr->nodesize = size;
-}
+    volatile double x, bv, av;
 
-static void
-InitMemorySystem(Voronoi *v)
-{
-    if (v->allocChain == NULL) {
-	v->allocChain = Blt_Chain_Create();
-    }
-    FreeInit(&v->freeSites, sizeof(Site));
+    x = a + b;
+    bv = x - a;
+    av = x - bv;
+    *xPtr = x;
+    *yPtr = (a - av) + (b - bv);
 }
 
-static void *
-AllocMemory(Voronoi *v, size_t size)
+static INLINE void
+TwoDiff(double a, double b, double *xPtr, double *yPtr)
 {
-    void *ptr;
+    volatile double x, bv, av;
 
-    ptr = Blt_Malloc(size);
-    if (ptr == NULL) {
-	return NULL;
-    }
-    Blt_Chain_Append(v->allocChain, ptr);
-    return ptr;
+    x = a - b;
+    bv = a - x;
+    av = x + bv;
+    *xPtr = x;
+    *yPtr = (a - av) + (bv - b);
 }
-    
-static void
-ReleaseMemorySystem(Voronoi *v)
-{
-    Blt_ChainLink link;
-
-    for (link = Blt_Chain_LastLink(v->allocChain); link != NULL;
-	link = Blt_Chain_PrevLink(link)) {
-	void *ptr;
 
-	ptr = Blt_Chain_GetValue(link);
-	if (ptr != NULL) {
-	    Blt_Free(ptr);
-	}
-    }
-    Blt_Chain_Destroy(v->allocChain);
-    v->allocChain = NULL;
-}
-
-INLINE static void
-MakeFree(void *item, FreeList *listPtr)
+static INLINE void
+Split(double a, double *hiPtr, double *loPtr)
 {
-    FreeNode *nodePtr = item;
+    volatile double c, big;
 
-    nodePtr->nextPtr = listPtr->headPtr;
-    listPtr->headPtr = nodePtr;
+    c = SPLITTER * a;
+    big = c - a;
+    *hiPtr = c - big;
+    *loPtr = a - *hiPtr;
 }
 
-
-static void *
-GetFree(Voronoi *v, FreeList *listPtr)
+static INLINE void
+TwoProduct(double a, double b, double *xPtr, double *yPtr)
 {
-    FreeNode *nodePtr;
-
-    if (listPtr->headPtr == NULL) {
-	int i;
+    volatile double x;
+    double ahi, alo, bhi, blo, err1, err2, err3;
 
-	nodePtr = AllocMemory(v, v->sqrtNumSites * listPtr->nodesize);
-	/* Thread the free nodes as a list */
-	for (i = 0; i < v->sqrtNumSites; i++) {
-	    MakeFree(((char *)nodePtr + i * listPtr->nodesize), listPtr);
-	}
-    }
-    nodePtr = listPtr->headPtr;
-    listPtr->headPtr = listPtr->headPtr->nextPtr;
-    return nodePtr;
+    x = a * b;
+    Split(a, &ahi, &alo);
+    Split(b, &bhi, &blo);
+    err1 = x - (ahi * bhi);
+    err2 = err1 - (alo * bhi);
+    err3 = err2 - (ahi * blo);
+    *xPtr = x;
+    *yPtr = (alo * blo) - err3;
 }
 
-INLINE static void
-DecrRefCount(Voronoi *v, Site *vertexPtr)
-{
-    vertexPtr->refCount--;
-    if (vertexPtr->refCount == 0) {
-	MakeFree(vertexPtr, &v->freeSites);
+/*
+ * Sums two expansions, eliminating zero components.  Returns the length of
+ * the resulting expansion.
+ */
+static int
+ExpansionSum(int elen, const double *e, int flen, const double *f, double *h)
+{
+    double q, qnew, hh, enow, fnow;
+    int eindex, findex, hindex;
+
+    if (elen == 0) {
+	memcpy(h, f, sizeof(double) * flen);
+	return flen;
+    }
+    if (flen == 0) {
+	memcpy(h, e, sizeof(double) * elen);
+	return elen;
+    }
+#define NEXT(x, i, len)	(((++(i)) < (len)) ? (x)[i] : 0.0)
+    enow = e[0];
+    fnow = f[0];
+    eindex = findex = 0;
+    if ((fnow > enow) == (fnow > -enow)) {
+	q = enow;
+	enow = NEXT(e, eindex, elen);
+    } else {
+	q = fnow;
+	fnow = NEXT(f, findex, flen);
+    }
+    hindex = 0;
+    while ((eindex < elen) && (findex < flen)) {
+	if ((fnow > enow) == (fnow > -enow)) {
+	    TwoSum(q, enow, &qnew, &hh);
+	    enow = NEXT(e, eindex, elen);
+	} else {
+	    TwoSum(q, fnow, &qnew, &hh);
+	    fnow = NEXT(f, findex, flen);
+	}
+	q = qnew;
+	if (hh != 0.0) {
+	    h[hindex++] = hh;
+	}
     }
-}
-
-INLINE static void
-IncrRefCount(Site *vertexPtr)
-{
-    vertexPtr->refCount++;
-}
-
-INLINE static HalfEdge *
-HECreate(Voronoi *v, Edge *edgePtr, int pm)
-{
-    HalfEdge *hePtr;
-
-    hePtr = GetFree(v, &v->freeHalfEdges);
-    hePtr->edgePtr = edgePtr;
-    hePtr->pm = pm;
-    hePtr->pqNext = NULL;
-    hePtr->vertex = NULL;
-    hePtr->refCount = 0;
-    return hePtr;
-}
-
-
-static void
-ElInitialize(Voronoi *v)
-{
-    FreeInit(&v->freeHalfEdges, sizeof(HalfEdge));
-
-    v->elHashsize = 2 * v->sqrtNumSites;
-    v->elHash = AllocMemory(v, v->elHashsize * sizeof(HalfEdge *));
-    assert(v->elHash);
-    memset(v->elHash, 0, v->elHashsize * sizeof(HalfEdge *));
-
-    v->elLeftEnd = HECreate(v, (Edge *)NULL, 0);
-    v->elRightEnd = HECreate(v, (Edge *)NULL, 0);
-    v->elLeftEnd->leftPtr = NULL;
-    v->elLeftEnd->rightPtr = v->elRightEnd;
-    v->elRightEnd->leftPtr = v->elLeftEnd;
-    v->elRightEnd->rightPtr = NULL;
-    v->elHash[0] = v->elLeftEnd;
-    v->elHash[v->elHashsize - 1] = v->elRightEnd;
-}
-
-INLINE static void
-ElInsert(HalfEdge *lb, HalfEdge *edgePtr)
-{
-    edgePtr->leftPtr = lb;
-    edgePtr->rightPtr = lb->rightPtr;
-    lb->rightPtr->leftPtr = edgePtr;
-    lb->rightPtr = edgePtr;
-}
-
-static HalfEdge *
-ElGetHash(Voronoi *v, int b)
-{
-    HalfEdge *hePtr;
-
-    if ((b < 0) || (b >= v->elHashsize)) {
-	return NULL;
+    while (eindex < elen) {
+	TwoSum(q, enow, &qnew, &hh);
+	enow = NEXT(e, eindex, elen);
+	q = qnew;
+	if (hh != 0.0) {
+	    h[hindex++] = hh;
+	}
     }
-    hePtr = v->elHash[b];
-    if ((hePtr == NULL) || (hePtr->edgePtr != DELETED)) {
-	return hePtr;
+    while (findex < flen) {
+	TwoSum(q, fnow, &qnew, &hh);
+	fnow = NEXT(f, findex, flen);
+	q = qnew;
+	if (hh != 0.0) {
+	    h[hindex++] = hh;
+	}
     }
-    /* Hash table points to deleted half edge.  Patch as necessary. */
-
-    v->elHash[b] = NULL;
-    hePtr->refCount--;
-    if (hePtr->refCount == 0) {
-	MakeFree(hePtr, &v->freeHalfEdges);
+#undef NEXT
+    if ((q != 0.0) || (hindex == 0)) {
+	h[hindex++] = q;
     }
-    return NULL;
+    return hindex;
 }
 
+/*
+ * Multiplies an expansion by a double, eliminating zero components.
+ */
 static int
-RightOf(HalfEdge *hePtr, Point2d *p)
+ScaleExpansion(int elen, const double *e, double b, double *h)
 {
-    Edge *e;
-    Site *topsite;
-    int rightOfSite, above, fast;
-    double dxp, dyp, dxs, t1, t2, t3, yl;
-
-    e = hePtr->edgePtr;
-    topsite = e->rightReg;
-    rightOfSite = p->x > topsite->point.x;
-    if ((rightOfSite) && (hePtr->pm == LE)) {
-	return 1;
-    }
-    if ((!rightOfSite) && (hePtr->pm == RE)) {
-	return 0;
+    double q, sum, hh, product1, product0;
+    int i, hindex;
+
+    hindex = 0;
+    TwoProduct(e[0], b, &q, &hh);
+    if (hh != 0.0) {
+	h[hindex++] = hh;
     }
-    if (e->a == 1.0) {
-	dyp = p->y - topsite->point.y;
-	dxp = p->x - topsite->point.x;
-	fast = 0;
-	if ((!rightOfSite & e->b < 0.0) | (rightOfSite & e->b >= 0.0)) {
-	    above = dyp >= e->b * dxp;
-	    fast = above;
-	} else {
-	    above = p->x + p->y * e->b > e->c;
-	    if (e->b < 0.0) {
-		above = !above;
-	    }
-	    if (!above) {
-		fast = 1;
-	    }
+    for (i = 1; i < elen; i++) {
+	TwoProduct(e[i], b, &product1, &product0);
+	TwoSum(q, product0, &sum, &hh);
+	if (hh != 0.0) {
+	    h[hindex++] = hh;
 	}
-	if (!fast) {
-	    dxs = topsite->point.x - (e->leftReg)->point.x;
-	    above = e->b * (dxp * dxp - dyp * dyp) <
-		dxs * dyp * (1.0 + 2.0 * dxp / dxs + e->b * e->b);
-	    if (e->b < 0.0) {
-		above = !above;
-	    }
+	TwoSum(product1, sum, &q, &hh);
+	if (hh != 0.0) {
+	    h[hindex++] = hh;
 	}
-    } else {			/* e->b==1.0 */
-	yl = e->c - e->a * p->x;
-	t1 = p->y - yl;
-	t2 = p->x - topsite->point.x;
-	t3 = yl - topsite->point.y;
-	above = t1 * t1 > t2 * t2 + t3 * t3;
-    }
-    return (hePtr->pm == LE ? above : !above);
+    }
+    if ((q != 0.0) || (hindex == 0)) {
+	h[hindex++] = q;
+    }
+    return hindex;
 }
 
-static HalfEdge *
-ElLeftBnd(Voronoi *v, Point2d *p)
+/*
+ * Multiplies two expansions.  The result may hold up to 2 * elen * flen
+ * components.
+ */
+static int
+ExpansionProduct(int elen, const double *e, int flen, const double *f,
+		 double *h)
 {
-    int i, bucket;
-    HalfEdge *hePtr;
-
-    /* Use hash table to get close to desired halfedge */
-
-    bucket = (p->x - v->xMin) / v->xDelta * v->elHashsize;
-    if (bucket < 0) {
-	bucket = 0;
-    } else if (bucket >= v->elHashsize) {
-	bucket = v->elHashsize - 1;
-    }
-    hePtr = ElGetHash(v, bucket);
-    if (hePtr == NULL) {
-	for (i = 1; /* empty */ ; i++) {
-	    hePtr = ElGetHash(v, bucket - i);
-	    if (hePtr != NULL) {
-		break;
-	    }
-	    hePtr = ElGetHash(v, bucket + i);
-	    if (hePtr != NULL) {
-		break;
-	    }
-	}
-    }
+    double part[MAX_EXPANSION], sum[MAX_EXPANSION];
+    int i, n;
 
-    /* Now search linear list of halfedges for the correct one */
+    n = 0;
+    for (i = 0; i < flen; i++) {
+	int m;
 
-    if ((hePtr == v->elLeftEnd) || 
-	(hePtr != v->elRightEnd && RightOf(hePtr, p))) {
-	do {
-	    hePtr = hePtr->rightPtr;
-	} while ((hePtr != v->elRightEnd) && (RightOf(hePtr, p)));
-	hePtr = hePtr->leftPtr;
-    } else {
-	do {
-	    hePtr = hePtr->leftPtr;
-	} while ((hePtr != v->elLeftEnd) && (!RightOf(hePtr, p)));
+	m = ScaleExpansion(elen, e, f[i], part);
+	n = ExpansionSum(n, h, m, part, sum);
+	memcpy(h, sum, sizeof(double) * n);
     }
-
-    /* Update hash table and reference counts */
-
-    if ((bucket > 0) && (bucket < (v->elHashsize - 1))) {
-	if (v->elHash[bucket] != NULL) {
-	    v->elHash[bucket]->refCount--;
-	}
-	v->elHash[bucket] = hePtr;
-	v->elHash[bucket]->refCount++;
-    }
-    return hePtr;
+    return n;
 }
 
-/* 
- * This delete routine can't reclaim node, since pointers from hash table may
- * be present.
- */
-INLINE static void
-ElDelete(HalfEdge *hePtr)
+static INLINE double
+ExpansionSign(int n, const double *e)
 {
-    hePtr->leftPtr->rightPtr = hePtr->rightPtr;
-    hePtr->rightPtr->leftPtr = hePtr->leftPtr;
-    hePtr->edgePtr = DELETED;
+    return e[n - 1];			/* Largest component. */
 }
 
-INLINE static Site *
-LeftRegion(Voronoi *v, HalfEdge *hePtr)
+static double
+Orient2dExact(const TriPoint *a, const TriPoint *b, const TriPoint *c)
 {
-    if (hePtr->edgePtr == NULL) {
-	return v->bottomsite;
-    }
-    return (hePtr->pm == LE) ? hePtr->edgePtr->leftReg : hePtr->edgePtr->rightReg;
-}
+    double acx[2], acy[2], bcx[2], bcy[2];
+    double left[8], right[8], det[16];
+    int nLeft, nRight, n;
 
-INLINE static Site *
-RightRegion(Voronoi *v, HalfEdge *hePtr)
-{
-    if (hePtr->edgePtr == NULL) {
-	return v->bottomsite;
+    TwoDiff(a->x, c->x, acx + 1, acx);
+    TwoDiff(a->y, c->y, acy + 1, acy);
+    TwoDiff(b->x, c->x, bcx + 1, bcx);
+    TwoDiff(b->y, c->y, bcy + 1, bcy);
+    nLeft = ExpansionProduct(2, acx, 2, bcy, left);
+    nRight = ExpansionProduct(2, acy, 2, bcx, right);
+    for (n = 0; n < nRight; n++) {
+	right[n] = -right[n];
     }
-    return (hePtr->pm == LE) ? hePtr->edgePtr->rightReg : hePtr->edgePtr->leftReg;
+    n = ExpansionSum(nLeft, left, nRight, right, det);
+    return ExpansionSign(n, det);
 }
 
-static void
-GeomInit(Voronoi *v)
+static INLINE double
+Orient2d(const TriPoint *a, const TriPoint *b, const TriPoint *c)
 {
-    FreeInit(&v->freeEdges, sizeof(Edge));
-    v->nVertices = v->nEdges = 0;
-    v->sqrtNumSites = sqrt((double)(v->nSites + 4));
-    v->yDelta = v->xMax - v->xMax;
-    v->xDelta = v->yMax - v->yMin;
-}
+    double left, right, det, sum;
 
-static Edge *
-Bisect(Voronoi *v, Site *s1, Site *s2)
-{
-    double dx, dy, adx, ady;
-    Edge *edgePtr;
-
-    edgePtr = GetFree(v, &v->freeEdges);
-
-    edgePtr->leftReg = s1;
-    edgePtr->rightReg = s2;
-    IncrRefCount(s1);
-    IncrRefCount(s2);
-    edgePtr->ep[0] = edgePtr->ep[1] = NULL;
-
-    dx = s2->point.x - s1->point.x;
-    dy = s2->point.y - s1->point.y;
-    adx = FABS(dx);
-    ady = FABS(dy);
-    edgePtr->c = (s1->point.x * dx) + (s1->point.y * dy) +
-	((dx * dx) + (dy * dy)) * 0.5;
-    if (adx > ady) {
-	edgePtr->a = 1.0;
-	edgePtr->b = dy / dx;
-	edgePtr->c /= dx;
+    left = (a->x - c->x) * (b->y - c->y);
+    right = (a->y - c->y) * (b->x - c->x);
+    det = left - right;
+    if (left > 0.0) {
+	if (right <= 0.0) {
+	    return det;
+	}
+	sum = left + right;
+    } else if (left < 0.0) {
+	if (right >= 0.0) {
+	    return det;
+	}
+	sum = -left - right;
     } else {
-	edgePtr->b = 1.0;
-	edgePtr->a = dx / dy;
-	edgePtr->c /= dy;
+	return det;
     }
-
-    edgePtr->neighbor = v->nEdges;
-    v->nEdges++;
-    return edgePtr;
+    if ((det >= CCW_ERRBOUND * sum) || (-det >= CCW_ERRBOUND * sum)) {
+	return det;
+    }
+    return Orient2dExact(a, b, c);
 }
 
-static Site *
-Intersect(Voronoi *v, HalfEdge *hePtr1, HalfEdge *hePtr2)
+/* Computes e * (f * g - h * i) for 2-component expansions. */
+static int
+LiftTerm(const double *lift, int nLift, const double *f, const double *g,
+	 const double *h, const double *i, double *result)
 {
-    Edge *e1, *e2, *e;
-    HalfEdge *hePtr;
-    double d, xint, yint;
-    int rightOfSite;
-    Site *sitePtr;
-
-    e1 = hePtr1->edgePtr;
-    e2 = hePtr2->edgePtr;
-    if ((e1 == NULL) || (e2 == NULL)) {
-	return NULL;
-    }
-    if (e1->rightReg == e2->rightReg) {
-	return NULL;
-    }
-    d = (e1->a * e2->b) - (e1->b * e2->a);
-    if ((-1.0e-10 < d) && (d < 1.0e-10)) {
-	return NULL;
-    }
-    xint = ((e1->c * e2->b) - (e2->c * e1->b)) / d;
-    yint = ((e2->c * e1->a) - (e1->c * e2->a)) / d;
-
-    if ((e1->rightReg->point.y < e2->rightReg->point.y) ||
-	((e1->rightReg->point.y == e2->rightReg->point.y) &&
-	    (e1->rightReg->point.x < e2->rightReg->point.x))) {
-	hePtr = hePtr1;
-	e = e1;
-    } else {
-	hePtr = hePtr2;
-	e = e2;
-    }
-    rightOfSite = (xint >= e->rightReg->point.x);
-    if ((rightOfSite && hePtr->pm == LE) || (!rightOfSite && hePtr->pm == RE)) {
-	return NULL;
-    }
-    sitePtr = GetFree(v, &v->freeSites);
-    sitePtr->refCount = 0;
-    sitePtr->point.x = xint;
-    sitePtr->point.y = yint;
-    return sitePtr;
+    double fg[8], hi[8], cross[16], tmp[MAX_EXPANSION];
+    int nFg, nHi, nCross, n;
+
+    nFg = ExpansionProduct(2, f, 2, g, fg);
+    nHi = ExpansionProduct(2, h, 2, i, hi);
+    for (n = 0; n < nHi; n++) {
+	hi[n] = -hi[n];
+    }
+    nCross = ExpansionSum(nFg, fg, nHi, hi, cross);
+    n = ExpansionProduct(nLift, lift, nCross, cross, tmp);
+    memcpy(result, tmp, sizeof(double) * n);
+    return n;
 }
 
-INLINE static void
-EndPoint(Voronoi *v, Edge *e, int lr, Site *s)
-{
-    e->ep[lr] = s;
-    IncrRefCount(s);
-    if (e->ep[RE - lr] == NULL) {
-	return;
-    }
-    DecrRefCount(v, e->leftReg);
-    DecrRefCount(v, e->rightReg);
-    MakeFree(e, &v->freeEdges);
+static int
+Lift(const double *dx, const double *dy, double *result)
+{
+    double xx[8], yy[8];
+    int nx, ny;
+
+    nx = ExpansionProduct(2, dx, 2, dx, xx);
+    ny = ExpansionProduct(2, dy, 2, dy, yy);
+    return ExpansionSum(nx, xx, ny, yy, result);
+}
+
+static double
+InCircleExact(const TriPoint *a, const TriPoint *b, const TriPoint *c,
+	      const TriPoint *d)
+{
+    double adx[2], ady[2], bdx[2], bdy[2], cdx[2], cdy[2];
+    double alift[16], blift[16], clift[16];
+    double aterm[MAX_EXPANSION], bterm[MAX_EXPANSION], cterm[MAX_EXPANSION];
+    double ab[MAX_EXPANSION], det[MAX_EXPANSION];
+    int na, nb, nc, nab, n;
+
+    TwoDiff(a->x, d->x, adx + 1, adx);
+    TwoDiff(a->y, d->y, ady + 1, ady);
+    TwoDiff(b->x, d->x, bdx + 1, bdx);
+    TwoDiff(b->y, d->y, bdy + 1, bdy);
+    TwoDiff(c->x, d->x, cdx + 1, cdx);
+    TwoDiff(c->y, d->y, cdy + 1, cdy);
+    na = Lift(adx, ady, alift);
+    nb = Lift(bdx, bdy, blift);
+    nc = Lift(cdx, cdy, clift);
+    na = LiftTerm(alift, na, bdx, cdy, bdy, cdx, aterm);
+    nb = LiftTerm(blift, nb, cdx, ady, cdy, adx, bterm);
+    nc = LiftTerm(clift, nc, adx, bdy, ady, bdx, cterm);
+    nab = ExpansionSum(na, aterm, nb, bterm, ab);
+    n = ExpansionSum(nab, ab, nc, cterm, det);
+    return ExpansionSign(n, det);
+}
+
+static INLINE double
+InCircle(const TriPoint *a, const TriPoint *b, const TriPoint *c,
+	 const TriPoint *d)
+{
+    double adx, ady, bdx, bdy, cdx, cdy;
+    double bdxcdy, cdxbdy, cdxady, adxcdy, adxbdy, bdxady;
+    double alift, blift, clift;
+    double det, permanent;
+
+    adx = a->x - d->x, ady = a->y - d->y;
+    bdx = b->x - d->x, bdy = b->y - d->y;
+    cdx = c->x - d->x, cdy = c->y - d->y;
+    bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    alift = adx * adx + ady * ady;
+    cdxady = cdx * ady, adxcdy = adx * cdy;
+    blift = bdx * bdx + bdy * bdy;
+    adxbdy = adx * bdy, bdxady = bdx * ady;
+    clift = cdx * cdx + cdy * cdy;
+    det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) +
+	clift * (adxbdy - bdxady);
+    permanent = (fabs(bdxcdy) + fabs(cdxbdy)) * alift +
+	(fabs(cdxady) + fabs(adxcdy)) * blift +
+	(fabs(adxbdy) + fabs(bdxady)) * clift;
+    if ((det > ICC_ERRBOUND * permanent) || (-det > ICC_ERRBOUND * permanent)) {
+	return det;
+    }
+    return InCircleExact(a, b, c, d);
+}
+
+static double
+CircumRadius2(const TriPoint *a, const TriPoint *b, const TriPoint *c)
+{
+    double dx, dy, ex, ey, bl, cl, d, x, y;
+
+    dx = b->x - a->x, dy = b->y - a->y;
+    ex = c->x - a->x, ey = c->y - a->y;
+    bl = dx * dx + dy * dy;
+    cl = ex * ex + ey * ey;
+    d = 0.5 / (dx * ey - dy * ex);
+    x = (ey * bl - dy * cl) * d;
+    y = (dx * cl - ex * bl) * d;
+    return x * x + y * y;
 }
 
-INLINE static void
-MakeVertex(Voronoi *v, Site *vertex)
+static void
+CircumCenter(const TriPoint *a, const TriPoint *b, const TriPoint *c,
+	     double *xPtr, double *yPtr)
 {
-    vertex->neighbor = v->nVertices;
-    v->nVertices++;
+    double dx, dy, ex, ey, bl, cl, d;
+
+    dx = b->x - a->x, dy = b->y - a->y;
+    ex = c->x - a->x, ey = c->y - a->y;
+    bl = dx * dx + dy * dy;
+    cl = ex * ex + ey * ey;
+    d = 0.5 / (dx * ey - dy * ex);
+    *xPtr = a->x + (ey * bl - dy * cl) * d;
+    *yPtr = a->y + (dx * cl - ex * bl) * d;
 }
 
-static int
-PQBucket(Voronoi *v, HalfEdge *hePtr)
+static INLINE int
+HashKey(Sweep *sweepPtr, const TriPoint *p)
 {
-    int bucket;
+    double dx, dy, angle;
+    int key;
 
-    bucket = (hePtr->ystar - v->yMin) / v->yDelta * v->pqHashsize;
-    if (bucket < 0) {
-	bucket = 0;
-    }
-    if (bucket >= v->pqHashsize) {
-	bucket = v->pqHashsize - 1;
-    }
-    if (bucket < v->pqMin) {
-	v->pqMin = bucket;
+    /* Monotonic pseudo-angle in [0..1) */
+    dx = p->x - sweepPtr->cx;
+    dy = p->y - sweepPtr->cy;
+    if ((dx == 0.0) && (dy == 0.0)) {
+	return 0;
     }
-    return bucket;
+    angle = dx / (fabs(dx) + fabs(dy));
+    angle = ((dy > 0.0) ? 3.0 - angle : 1.0 + angle) * 0.25;
+    key = (int)floor(angle * sweepPtr->hashSize);
+    return (key < 0) ? 0 : (key >= sweepPtr->hashSize) ?
+	sweepPtr->hashSize - 1 : key;
 }
 
-static void
-PQInsert(Voronoi *v, HalfEdge *hePtr, Site *vertex, double offset)
+static INLINE void
+LinkHalfEdges(Sweep *sweepPtr, int a, int b)
 {
-    HalfEdge *last, *next;
-
-    hePtr->vertex = vertex;
-    IncrRefCount(vertex);
-    hePtr->ystar = vertex->point.y + offset;
-    last = v->pqHash + PQBucket(v, hePtr);
-    while (((next = last->pqNext) != NULL) &&
-	   ((hePtr->ystar > next->ystar) || 
-	    ((hePtr->ystar == next->ystar) &&
-	     (vertex->point.x > next->vertex->point.x)))) {
-	last = next;
-    }
-    hePtr->pqNext = last->pqNext;
-    last->pqNext = hePtr;
-    v->pqCount++;
+    sweepPtr->halfEdges[a] = b;
+    if (b >= 0) {
+	sweepPtr->halfEdges[b] = a;
+    }
 }
 
+static int
+AddTriangle(Sweep *sweepPtr, int i0, int i1, int i2, int a, int b, int c)
+{
+    int t;
+
+    t = sweepPtr->nHalfEdges;
+    sweepPtr->triangles[t] = i0;
+    sweepPtr->triangles[t + 1] = i1;
+    sweepPtr->triangles[t + 2] = i2;
+    LinkHalfEdges(sweepPtr, t, a);
+    LinkHalfEdges(sweepPtr, t + 1, b);
+    LinkHalfEdges(sweepPtr, t + 2, c);
+    sweepPtr->nHalfEdges += 3;
+    return t;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Legalize --
+ *
+ *	Restores the Delaunay condition across the given half-edge and,
+ *	recursively, across the edges exposed by each flip.  The recursion
+ *	is replaced by an explicit stack of edges.
+ *
+ *	           pl                    pl
+ *	          /||\                  /  \
+ *	       al/ || \bl            al/    \a
+ *	        /  ||  \              /      \
+ *	       /  a||b  \    flip    /___ar___\
+ *	     p0\   ||   /p1   =>   p0\---bl---/p1
+ *	        \  ||  /              \      /
+ *	       ar\ || /br             b\    /br
+ *	          \||/                  \  /
+ *	           pr                    pr
+ *
+ *---------------------------------------------------------------------------
+ */
 static void
-PQDelete(Voronoi *v, HalfEdge *hePtr)
+Legalize(Sweep *sweepPtr, int a)
 {
-    if (hePtr->vertex != NULL) {
-	HalfEdge *last;
+    int *triangles = sweepPtr->triangles;
+    int *halfEdges = sweepPtr->halfEdges;
+    int n;
+
+    n = 0;
+    for (;;) {
+	int a0, b0, al, ar, bl, br, b, hbl, har;
+	int p0, pr, pl, p1;
 
-	last = v->pqHash + PQBucket(v, hePtr);
-	while (last->pqNext != hePtr) {
-	    last = last->pqNext;
+	b = halfEdges[a];
+	if (b < 0) {
+	    if (n == 0) {
+		break;
+	    }
+	    a = sweepPtr->edgeStack[--n];
+	    continue;
+	}
+	a0 = a - a % 3;
+	b0 = b - b % 3;
+	al = a0 + (a + 1) % 3;
+	ar = a0 + (a + 2) % 3;
+	bl = b0 + (b + 2) % 3;
+	br = b0 + (b + 1) % 3;
+	p0 = triangles[ar];
+	pr = triangles[a];
+	pl = triangles[al];
+	p1 = triangles[bl];
+	if (InCircle(sweepPtr->points + pr, sweepPtr->points + pl,
+		     sweepPtr->points + p0, sweepPtr->points + p1) <= 0.0) {
+	    if (n == 0) {
+		break;
+	    }
+	    a = sweepPtr->edgeStack[--n];
+	    continue;
 	}
-	last->pqNext = hePtr->pqNext;
-	v->pqCount--;
-	DecrRefCount(v, hePtr->vertex);
-	hePtr->vertex = NULL;
+	triangles[a] = p1;
+	triangles[b] = p0;
+	hbl = halfEdges[bl];
+	har = halfEdges[ar];
+	/* Flipping may move a hull edge into the other triangle. */
+	if ((hbl < 0) && (sweepPtr->hullTri[p1] == bl)) {
+	    sweepPtr->hullTri[p1] = a;
+	}
+	if ((har < 0) && (sweepPtr->hullTri[p0] == ar)) {
+	    sweepPtr->hullTri[p0] = b;
+	}
+	LinkHalfEdges(sweepPtr, a, hbl);
+	LinkHalfEdges(sweepPtr, b, har);
+	LinkHalfEdges(sweepPtr, ar, bl);
+	if (n == sweepPtr->stackSize) {
+	    int *stack;
+
+	    stack = Blt_AssertMalloc(sizeof(int) * 2 * sweepPtr->stackSize);
+	    memcpy(stack, sweepPtr->edgeStack, sizeof(int) * n);
+	    Blt_Free(sweepPtr->edgeStack);
+	    sweepPtr->edgeStack = stack;
+	    sweepPtr->stackSize += sweepPtr->stackSize;
+	}
+	sweepPtr->edgeStack[n++] = br;
     }
 }
 
-INLINE static int
-PQEmpty(Voronoi *v)
-{
-    return (v->pqCount == 0);
-}
+typedef struct {
+    double dist;			/* Squared distance from center. */
+    int index;				/* Index of point. */
+} SweepOrder;
 
-INLINE static Point2d
-PQMin(Voronoi *v)
+static int
+CompareDists(const void *a, const void *b)
 {
-    Point2d p;
+    const SweepOrder *o1 = a;
+    const SweepOrder *o2 = b;
 
-    while (v->pqHash[v->pqMin].pqNext == NULL) {
-	v->pqMin++;
+    if (o1->dist < o2->dist) {
+	return -1;
     }
-    p.x = v->pqHash[v->pqMin].pqNext->vertex->point.x;
-    p.y = v->pqHash[v->pqMin].pqNext->ystar;
-    return p;
-}
-
-INLINE static HalfEdge *
-PQExtractMin(Voronoi *v)
+    if (o1->dist > o2->dist) {
+	return 1;
+    }
+    return o1->index - o2->index;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * FindSeeds --
+ *
+ *	Picks the seed triangle: the point nearest the center of the
+ *	bounding box, the point nearest to it, and the point making the
+ *	smallest circumcircle with them.
+ *
+ * Results:
+ *	Returns TCL_OK if a seed triangle was found, TCL_ERROR if all the
+ *	points are collinear.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+FindSeeds(Sweep *sweepPtr, int *seeds)
 {
-    HalfEdge *curr;
+    TriPoint *points = sweepPtr->points;
+    double xMin, xMax, yMin, yMax, cx, cy, dMin, rMin;
+    int i, i0, i1, i2;
 
-    curr = v->pqHash[v->pqMin].pqNext;
-    v->pqHash[v->pqMin].pqNext = curr->pqNext;
-    v->pqCount--;
-    return curr;
-}
+    xMin = yMin = DBL_MAX;
+    xMax = yMax = -DBL_MAX;
+    for (i = 0; i < sweepPtr->nPoints; i++) {
+	if (points[i].x < xMin) {
+	    xMin = points[i].x;
+	}
+	if (points[i].x > xMax) {
+	    xMax = points[i].x;
+	}
+	if (points[i].y < yMin) {
+	    yMin = points[i].y;
+	}
+	if (points[i].y > yMax) {
+	    yMax = points[i].y;
+	}
+    }
+    cx = (xMin + xMax) * 0.5;
+    cy = (yMin + yMax) * 0.5;
+    i0 = i1 = i2 = -1;
+    dMin = DBL_MAX;
+    for (i = 0; i < sweepPtr->nPoints; i++) {
+	double d;
+
+	d = (points[i].x - cx) * (points[i].x - cx) +
+	    (points[i].y - cy) * (points[i].y - cy);
+	if (d < dMin) {
+	    i0 = i, dMin = d;
+	}
+    }
+    dMin = DBL_MAX;
+    for (i = 0; i < sweepPtr->nPoints; i++) {
+	double d;
 
-static void
-PQInitialize(Voronoi *v)
-{
-    size_t nBytes;
-
-    v->pqCount = v->pqMin = 0;
-    v->pqHashsize = 4 * v->sqrtNumSites;
-    nBytes = v->pqHashsize * sizeof(HalfEdge);
-    v->pqHash = AllocMemory(v, nBytes);
-    assert(v->pqHash);
-    memset(v->pqHash, 0, nBytes);
-}
+	d = (points[i].x - points[i0].x) * (points[i].x - points[i0].x) +
+	    (points[i].y - points[i0].y) * (points[i].y - points[i0].y);
+	if ((d > 0.0) && (d < dMin)) {
+	    i1 = i, dMin = d;
+	}
+    }
+    if (i1 < 0) {
+	return TCL_ERROR;		/* All points are the same. */
+    }
+    rMin = DBL_MAX;
+    for (i = 0; i < sweepPtr->nPoints; i++) {
+	double r;
 
-INLINE static Site *
-NextSite(Voronoi *v)
-{
-    if (v->siteIndex < v->nSites) {
-	Site *s;
+	if ((i == i0) || (i == i1) ||
+	    (Orient2d(points + i0, points + i1, points + i) == 0.0)) {
+	    continue;
+	}
+	r = CircumRadius2(points + i0, points + i1, points + i);
+	if (r < rMin) {
+	    i2 = i, rMin = r;
+	}
+    }
+    if (i2 < 0) {
+	return TCL_ERROR;		/* All points are collinear. */
+    }
+    if (Orient2d(points + i0, points + i1, points + i2) < 0.0) {
+	int tmp;
 
-	s = v->sites + v->siteIndex;
-	v->siteIndex++;
-	return s;
+	tmp = i1, i1 = i2, i2 = tmp;	/* Make counter-clockwise. */
     }
-    return NULL;
+    seeds[0] = i0, seeds[1] = i1, seeds[2] = i2;
+    return TCL_OK;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SweepHull --
+ *
+ *	Triangulates the points.  Points that duplicate an earlier point
+ *	are left out of the triangulation.
+ *
+ * Results:
+ *	Returns the number of triangles generated.
+ *
+ *---------------------------------------------------------------------------
+ */
 static int
-ComputeVoronoi(Voronoi *v, Triplet *triplets)
-{
-    Site *newsite, *bot, *top, *temp, *p;
-    Site *vertex;
-    Point2d newintstar;
-    int pm, count = 0;
-    HalfEdge *lbnd, *rbnd, *llbnd, *rrbnd, *bisector;
-    Edge *e;
-
-    PQInitialize(v);
-    v->bottomsite = NextSite(v);
-    ElInitialize(v);
-
-    newsite = NextSite(v);
-    for (;;) {
-	if (!PQEmpty(v)) {
-	    newintstar = PQMin(v);
+SweepHull(Sweep *sweepPtr, int *seeds)
+{
+    TriPoint *points = sweepPtr->points;
+    SweepOrder *order;
+    int *hullNext, *hullPrev, *hullTri, *hullHash;
+    int i, k, i0, i1, i2, n, last;
+
+    n = sweepPtr->nPoints;
+    i0 = seeds[0], i1 = seeds[1], i2 = seeds[2];
+    CircumCenter(points + i0, points + i1, points + i2, &sweepPtr->cx,
+	&sweepPtr->cy);
+
+    /* Sort the points by distance from the seed triangle's center. */
+    order = Blt_AssertMalloc(sizeof(SweepOrder) * n);
+    for (i = 0; i < n; i++) {
+	double dx, dy;
+
+	dx = points[i].x - sweepPtr->cx;
+	dy = points[i].y - sweepPtr->cy;
+	order[i].dist = dx * dx + dy * dy;
+	order[i].index = i;
+    }
+    qsort(order, n, sizeof(SweepOrder), CompareDists);
+
+    sweepPtr->hashSize = (int)ceil(sqrt((double)n));
+    hullNext = sweepPtr->hullNext = Blt_AssertMalloc(sizeof(int) * n);
+    hullPrev = sweepPtr->hullPrev = Blt_AssertMalloc(sizeof(int) * n);
+    hullTri = sweepPtr->hullTri = Blt_AssertMalloc(sizeof(int) * n);
+    hullHash = sweepPtr->hullHash =
+	Blt_AssertMalloc(sizeof(int) * sweepPtr->hashSize);
+    for (i = 0; i < sweepPtr->hashSize; i++) {
+	hullHash[i] = -1;
+    }
+    sweepPtr->hullStart = i0;
+    hullNext[i0] = hullPrev[i2] = i1;
+    hullNext[i1] = hullPrev[i0] = i2;
+    hullNext[i2] = hullPrev[i1] = i0;
+    hullTri[i0] = 0;
+    hullTri[i1] = 1;
+    hullTri[i2] = 2;
+    hullHash[HashKey(sweepPtr, points + i0)] = i0;
+    hullHash[HashKey(sweepPtr, points + i1)] = i1;
+    hullHash[HashKey(sweepPtr, points + i2)] = i2;
+    AddTriangle(sweepPtr, i0, i1, i2, -1, -1, -1);
+
+    last = -1;
+    for (k = 0; k < n; k++) {
+	TriPoint *p;
+	int e, q, start, key, j, t;
+
+	i = order[k].index;
+	p = points + i;
+	/* Skip duplicate points and the seeds.  Duplicates that aren't
+	 * adjacent in the sweep order are found on the hull below. */
+	if ((last >= 0) && (p->x == points[last].x) &&
+	    (p->y == points[last].y)) {
+	    continue;
+	}
+	last = i;
+	if ((i == i0) || (i == i1) || (i == i2)) {
+	    continue;
 	}
-	if ((newsite != NULL)
-	    && ((PQEmpty(v)) || 
-		(newsite->point.y < newintstar.y) ||
-		(newsite->point.y == newintstar.y) && 
-		(newsite->point.x < newintstar.x))) {
-
-	    /* New site is smallest */
-
-	    lbnd = ElLeftBnd(v, &newsite->point);
-	    rbnd = lbnd->rightPtr;
-	    bot = RightRegion(v, lbnd);
-	    e = Bisect(v, bot, newsite);
-	    bisector = HECreate(v, e, LE);
-	    ElInsert(lbnd, bisector);
-	    p = Intersect(v, lbnd, bisector);
-	    if (p != NULL) {
-		PQDelete(v, lbnd);
-		PQInsert(v, lbnd, p, Dist(p, newsite));
+	/* Find a visible edge on the hull, starting near the point's
+	 * angle. */
+	start = 0;
+	key = HashKey(sweepPtr, p);
+	for (j = 0; j < sweepPtr->hashSize; j++) {
+	    start = hullHash[(key + j) % sweepPtr->hashSize];
+	    if ((start >= 0) && (start != hullNext[start])) {
+		break;
 	    }
-	    lbnd = bisector;
-	    bisector = HECreate(v, e, RE);
-	    ElInsert(lbnd, bisector);
-	    p = Intersect(v, bisector, rbnd);
-	    if (p != NULL) {
-		PQInsert(v, bisector, p, Dist(p, newsite));
+	}
+	start = hullPrev[start];
+	e = start;
+	for (;;) {
+	    q = hullNext[e];
+	    if (Orient2d(points + e, points + q, p) < 0.0) {
+		break;			/* Edge e->q is visible. */
 	    }
-	    newsite = NextSite(v);
-	} else if (!PQEmpty(v)) {
-
-	    /* Intersection is smallest */
-
-	    lbnd = PQExtractMin(v);
-	    llbnd = lbnd->leftPtr;
-	    rbnd = lbnd->rightPtr;
-	    rrbnd = rbnd->rightPtr;
-	    bot = LeftRegion(v, lbnd);
-	    top = RightRegion(v, rbnd);
-	    triplets[count].a = bot->neighbor;
-	    triplets[count].b = top->neighbor;
-	    triplets[count].c = RightRegion(v, lbnd)->neighbor;
-	    ++count;
-	    vertex = lbnd->vertex;
-	    MakeVertex(v, vertex);
-	    EndPoint(v, lbnd->edgePtr, lbnd->pm, vertex);
-	    EndPoint(v, rbnd->edgePtr, rbnd->pm, vertex);
-	    ElDelete(lbnd);
-	    PQDelete(v, rbnd);
-	    ElDelete(rbnd);
-	    pm = LE;
-	    if (bot->point.y > top->point.y) {
-		temp = bot, bot = top, top = temp;
-		pm = RE;
+	    e = q;
+	    if (e == start) {
+		e = -1;
+		break;
 	    }
-	    e = Bisect(v, bot, top);
-	    bisector = HECreate(v, e, pm);
-	    ElInsert(llbnd, bisector);
-	    EndPoint(v, e, RE - pm, vertex);
-	    DecrRefCount(v, vertex);
-	    p = Intersect(v, llbnd, bisector);
-	    if (p != NULL) {
-		PQDelete(v, llbnd);
-		PQInsert(v, llbnd, p, Dist(p, bot));
+	}
+	if (e < 0) {
+	    continue;			/* Point is on the hull. */
+	}
+	/* Add the first triangle from the point. */
+	t = AddTriangle(sweepPtr, e, i, hullNext[e], -1, -1, hullTri[e]);
+	hullTri[i] = t + 1;
+	hullTri[e] = t;
+	Legalize(sweepPtr, t + 2);
+
+	/* Walk forward along the hull, adding more triangles. */
+	q = hullNext[e];
+	for (;;) {
+	    int r;
+
+	    r = hullNext[q];
+	    if (Orient2d(points + q, points + r, p) >= 0.0) {
+		break;
 	    }
-	    p = Intersect(v, bisector, rrbnd);
-	    if (p != NULL) {
-		PQInsert(v, bisector, p, Dist(p, bot));
+	    t = AddTriangle(sweepPtr, q, i, r, hullTri[i], -1, hullTri[q]);
+	    hullTri[i] = t + 1;
+	    Legalize(sweepPtr, t + 2);
+	    hullNext[q] = q;		/* Mark as removed. */
+	    q = r;
+	}
+	/* Walk backward from the other side, adding more triangles. */
+	if (e == start) {
+	    for (;;) {
+		int r;
+
+		r = hullPrev[e];
+		if (Orient2d(points + r, points + e, p) >= 0.0) {
+		    break;
+		}
+		t = AddTriangle(sweepPtr, r, i, e, -1, hullTri[e], hullTri[r]);
+		hullTri[r] = t;
+		Legalize(sweepPtr, t + 2);
+		hullNext[e] = e;	/* Mark as removed. */
+		e = r;
 	    }
-	} else {
-	    break;
 	}
-    }
-    return count;
-}
-
-static int
-CompareSites(const void *a, const void *b)
-{
-    const Site *s1 = a;
-    const Site *s2 = b;
-
-    if (s1->point.y < s2->point.y) {
-	return -1;
-    }
-    if (s1->point.y > s2->point.y) {
-	return 1;
-    }
-    if (s1->point.x < s2->point.x) {
-	return -1;
-    }
-    if (s1->point.x > s2->point.x) {
-	return 1;
-    }
-    return 0;
-}
-
+	/* Update the hull. */
+	sweepPtr->hullStart = hullPrev[i] = e;
+	hullNext[e] = hullPrev[q] = i;
+	hullNext[i] = q;
+	hullHash[HashKey(sweepPtr, p)] = i;
+	hullHash[HashKey(sweepPtr, points + e)] = e;
+    }
+    Blt_Free(order);
+    return sweepPtr->nHalfEdges / 3;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Triangulate --
+ *
+ *	Computes the Delaunay triangulation of the given points.
+ *
+ * Results:
+ *	Returns a standard TCL result.  The number of triangles and a
+ *	malloc-ed array of triangles (vertex indices, counter-clockwise) are
+ *	returned via nTrianglesPtr and trianglesPtr.  It's an error if there
+ *	are fewer than 3 distinct points or they are all collinear.
+ *
+ *---------------------------------------------------------------------------
+ */
 int
-Blt_Triangulate(Tcl_Interp *interp, size_t nPoints, Point2f *points, 
-		int sorted, int *nTrianglesPtr, Triplet **trianglesPtr)
+Blt_Triangulate(Tcl_Interp *interp, size_t nPoints, Point2f *points,
+		int *nTrianglesPtr, Triplet **trianglesPtr)
 {
-    int i;
-    Site *sp, *send;
-    int n;
-    Voronoi v;
+    Sweep sweep;
     Triplet *triangles;
-    
-    memset(&v, 0, sizeof(v));
-
-    InitMemorySystem(&v);
-
-    v.nSites = nPoints;
-    v.sites = AllocMemory(&v, nPoints * sizeof(Site));
-    
-    for (sp = v.sites, send = sp + nPoints, i = 0; sp < send; i++, sp++) {
-	sp->point.x = points[i].x;
-	sp->point.y = points[i].y;
-	sp->neighbor = i;
-	sp->refCount = 0;
-    }
-    if (!sorted) {
-	qsort(v.sites, v.nSites, sizeof(Site), CompareSites);
-    }
-    sp = v.sites;
-    v.xMin = v.xMax = sp->point.x;
-    v.yMin = sp->point.y;
-    v.yMax = v.sites[nPoints - 1].point.y;
-    for (sp++, send = v.sites + nPoints; sp < send; sp++) {
-	if (sp->point.x < v.xMin) {
-	    v.xMin = sp->point.x;
-	} else if (sp->point.x > v.xMax) {
-	    v.xMax = sp->point.x;
-	}
-    }
-    v.siteIndex = 0;
-    GeomInit(&v);
-    n = ComputeVoronoi(&v, triangles);
-    /* Release memory allocated for triangulation */
-    ReleaseMemorySystem(&v);
-    *nTrianglesPtr = n;
+    int seeds[3];
+    int i, n, nTriangles;
+
+    memset(&sweep, 0, sizeof(sweep));
+    n = (int)nPoints;
+    if (n < 3) {
+	Tcl_AppendResult(interp, "need at least 3 points to triangulate",
+		(char *)NULL);
+	return TCL_ERROR;
+    }
+    sweep.nPoints = n;
+    sweep.points = Blt_AssertMalloc(sizeof(TriPoint) * n);
+    for (i = 0; i < n; i++) {
+	sweep.points[i].x = points[i].x;
+	sweep.points[i].y = points[i].y;
+    }
+    if (FindSeeds(&sweep, seeds) != TCL_OK) {
+	Tcl_AppendResult(interp, "can't triangulate points: ",
+		"all points are collinear", (char *)NULL);
+	Blt_Free(sweep.points);
+	return TCL_ERROR;
+    }
+    /* A triangulation of n points has at most 2n - 5 triangles. */
+    sweep.triangles = Blt_AssertMalloc(sizeof(int) * 3 * (2 * n));
+    sweep.halfEdges = Blt_AssertMalloc(sizeof(int) * 3 * (2 * n));
+    sweep.stackSize = 512;
+    sweep.edgeStack = Blt_AssertMalloc(sizeof(int) * sweep.stackSize);
+
+    nTriangles = SweepHull(&sweep, seeds);
+
+    triangles = Blt_AssertMalloc(sizeof(Triplet) * MAX(nTriangles, 1));
+    for (i = 0; i < nTriangles; i++) {
+	triangles[i].a = sweep.triangles[3 * i];
+	triangles[i].b = sweep.triangles[3 * i + 1];
+	triangles[i].c = sweep.triangles[3 * i + 2];
+	triangles[i].min = triangles[i].max = 0.0f;
+    }
+    Blt_Free(sweep.points);
+    Blt_Free(sweep.triangles);
+    Blt_Free(sweep.halfEdges);
+    Blt_Free(sweep.hullNext);
+    Blt_Free(sweep.hullPrev);
+    Blt_Free(sweep.hullTri);
+    Blt_Free(sweep.hullHash);
+    Blt_Free(sweep.edgeStack);
+    *nTrianglesPtr = nTriangles;
     *trianglesPtr = triangles;
     return TCL_OK;
 }
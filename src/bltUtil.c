@@ -1079,6 +1079,50 @@ Blt_FindUid(const char *string)		/* String to find. */
 
 
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * AbbrevOpSearch --
+ *
+ *      Looks for an operation abbreviated by the string among the
+ *	specifications around the given one.  All the operations that
+ *	start with the string are next to each other in the sorted array.
+ *	For example, "c" is ambiguous for "convolve", but may still be the
+ *	abbreviation of "clear".
+ *
+ * Results:
+ *	Returns the index of the only operation that can be abbreviated by
+ *	the string.  Otherwise -2 is returned.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+AbbrevOpSearch(Blt_OpSpec *specs, int nSpecs, int index, const char *string, 
+	       int length)
+{
+    int i, first, last, nMatches;
+
+    for (first = index; first > 0; first--) {
+	if (strncmp(string, specs[first - 1].name, length) != 0) {
+	    break;
+	}
+    }
+    for (last = index; last < (nSpecs - 1); last++) {
+	if (strncmp(string, specs[last + 1].name, length) != 0) {
+	    break;
+	}
+    }
+    nMatches = 0;
+    index = -2;				/* Ambiguous operation name */
+    for (i = first; i <= last; i++) {
+	if (length >= specs[i].minChars) {
+	    index = i;
+	    nMatches++;
+	}
+    }
+    return (nMatches == 1) ? index : -2;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1120,7 +1164,10 @@ BinaryOpSearch(Blt_OpSpec *specs, int nSpecs, const char *string, int length)
 	    compare = strncmp(string, specPtr->name, length);
 	    if (compare == 0) {
 		if ((int)length < specPtr->minChars) {
-		    return -2;	/* Ambiguous operation name */
+		    /* Too short for this operation.  It may still be the
+		     * abbreviation of a neighboring one. */
+		    return AbbrevOpSearch(specs, nSpecs, median, string, 
+			length);
 		}
 	    }
 	}
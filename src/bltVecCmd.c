@@ -49,6 +49,7 @@
 #include "bltOp.h"
 #include "bltNsUtil.h"
 #include "bltSwitch.h"
+#include <bltMath.h>
 
 typedef int (VectorCmdProc)(Vector *vPtr, Tcl_Interp *interp, int objc, 
 	Tcl_Obj *const *objv);
@@ -63,6 +64,11 @@ static Blt_SwitchCustom indexSwitch = {
     ObjToIndex, NULL, (ClientData)0,
 };
 
+static Blt_SwitchParseProc ObjToOutputVector;
+static Blt_SwitchCustom outputSwitch = {
+    ObjToOutputVector, NULL, (ClientData)0,
+};
+
 typedef struct {
     Tcl_Obj *formatObjPtr;
     int from, to;
@@ -123,6 +129,58 @@ static Blt_SwitchSpec fftSwitches[] = {
     {BLT_SWITCH_END}
 };
 
+/* 
+ * Switches shared by the filter operations (convolve, cumsum, decimate,
+ * diff, interpolate, and movavg).  By default the result replaces the
+ * contents of the vector.
+ */
+typedef struct {
+    Vector *outputPtr;		/* If non-NULL, vector to receive the
+				 * result. */
+    int flags;
+} FilterSwitches;
+
+#define FILTER_MINMAX	(1<<0)	/* Decimate to the minimum and maximum of
+				 * each bucket. */
+#define FILTER_LINEAR	(1<<1)	/* Linear interpolation. */
+#define FILTER_SPLINE	(1<<2)	/* Natural cubic spline interpolation. */
+
+static Blt_SwitchSpec filterSwitches[] = 
+{
+    {BLT_SWITCH_CUSTOM, "-output", "vecName",
+	Blt_Offset(FilterSwitches, outputPtr), 0, 0, &outputSwitch},
+    {BLT_SWITCH_END}
+};
+
+static Blt_SwitchSpec convolveSwitches[] = 
+{
+    {BLT_SWITCH_BITMASK, "-fft",    "",
+	Blt_Offset(FilterSwitches, flags),     0, CONVOLVE_FFT},
+    {BLT_SWITCH_CUSTOM, "-output", "vecName",
+	Blt_Offset(FilterSwitches, outputPtr), 0, 0, &outputSwitch},
+    {BLT_SWITCH_END}
+};
+
+static Blt_SwitchSpec decimateSwitches[] = 
+{
+    {BLT_SWITCH_BITMASK, "-minmax", "",
+	Blt_Offset(FilterSwitches, flags),     0, FILTER_MINMAX},
+    {BLT_SWITCH_CUSTOM, "-output", "vecName",
+	Blt_Offset(FilterSwitches, outputPtr), 0, 0, &outputSwitch},
+    {BLT_SWITCH_END}
+};
+
+static Blt_SwitchSpec interpolateSwitches[] = 
+{
+    {BLT_SWITCH_VALUE, "-linear",  "",
+	Blt_Offset(FilterSwitches, flags),     0, FILTER_LINEAR},
+    {BLT_SWITCH_CUSTOM, "-output", "vecName",
+	Blt_Offset(FilterSwitches, outputPtr), 0, 0, &outputSwitch},
+    {BLT_SWITCH_VALUE, "-spline",  "",
+	Blt_Offset(FilterSwitches, flags),     0, FILTER_SPLINE},
+    {BLT_SWITCH_END}
+};
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -198,6 +256,111 @@ ObjToIndex(
 
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ObjToOutputVector --
+ *
+ *	Convert a string representing a vector into its vector structure,
+ *	creating the vector if it doesn't already exist.
+ *
+ * Results:
+ *	The return value is a standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ObjToOutputVector(
+    ClientData clientData,	/* Vector interpreter data. */
+    Tcl_Interp *interp,		/* Interpreter to send results back to */
+    const char *switchName,	/* Not used. */
+    Tcl_Obj *objPtr,		/* Name of vector. */
+    char *record,		/* Structure record */
+    int offset,			/* Offset to field in structure */
+    int flags)			/* Not used. */
+{
+    VectorInterpData *dataPtr = clientData;
+    Vector *vPtr;
+    Vector **vPtrPtr = (Vector **)(record + offset);
+    int isNew;			/* Not used. */
+    char *string;
+
+    string = Tcl_GetString(objPtr);
+    vPtr = Blt_Vec_Create(dataPtr, string, string, string, &isNew);
+    if (vPtr == NULL) {
+	return TCL_ERROR;
+    }
+    *vPtrPtr = vPtr;
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ParseFilterSwitches --
+ *
+ *	Parses the switches of a filter operation.  The output vector
+ *	defaults to the vector itself.
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+ParseFilterSwitches(Vector *vPtr, Tcl_Interp *interp, Blt_SwitchSpec *specs,
+		    int objc, Tcl_Obj *const *objv, FilterSwitches *switchesPtr)
+{
+    memset(switchesPtr, 0, sizeof(FilterSwitches));
+    outputSwitch.clientData = vPtr->dataPtr;
+    if (Blt_ParseSwitches(interp, specs, objc, objv, switchesPtr, 
+	BLT_SWITCH_DEFAULTS) < 0) {
+	return TCL_ERROR;
+    }
+    if (switchesPtr->outputPtr == NULL) {
+	switchesPtr->outputPtr = vPtr;
+    }
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * StoreFilterResult --
+ *
+ *	Replaces the contents of the output vector with the array of values
+ *	computed by a filter operation.  The vector takes ownership of the
+ *	array.  If the length is unchanged, the values are copied into the
+ *	existing storage so that views of the vector stay attached.
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ * Side Effects:
+ *	Clients of the vector are notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+StoreFilterResult(Vector *destPtr, double *valueArr, int length)
+{
+    if ((length == 0) || (length != destPtr->length)) {
+	if (length == 0) {
+	    Blt_Free(valueArr);
+	    valueArr = NULL;
+	}
+	return Blt_Vec_Reset(destPtr, valueArr, length, length, TCL_DYNAMIC);
+    }
+    memcpy(destPtr->valueArr, valueArr, length * sizeof(double));
+    Blt_Free(valueArr);
+    if (destPtr->flush) {
+	Blt_Vec_FlushCache(destPtr);
+    }
+    Blt_Vec_UpdateClients(destPtr);
+    return TCL_OK;
+}
+
 static Tcl_Obj *
 GetValues(Vector *vPtr, int first, int last)
 { 
@@ -313,8 +476,10 @@ AppendOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 {
     int i;
     int result;
+    int oldLength;
     Vector *v2Ptr;
 
+    oldLength = vPtr->length;
     for (i = 2; i < objc; i++) {
 	v2Ptr = Blt_Vec_ParseElement((Tcl_Interp *)NULL, vPtr->dataPtr, 
 	       Tcl_GetString(objv[i]), (const char **)NULL, NS_SEARCH_BOTH);
@@ -338,7 +503,7 @@ AppendOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 	if (vPtr->flush) {
 	    Blt_Vec_FlushCache(vPtr);
 	}
-	Blt_Vec_UpdateClients(vPtr);
+	Blt_Vec_UpdateClientsFrom(vPtr, oldLength);
     }
     return TCL_OK;
 }
@@ -368,6 +533,97 @@ ClearOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     return TCL_OK;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ConvolveOp --
+ *
+ *	Convolves the vector with the kernel vector.  The result has the same
+ *	length as the vector, with the kernel centered on each component.
+ *	If the -fft switch is given, the convolution is computed using the
+ *	FFT, which is faster for long kernels.
+ *
+ *	  $v convolve kernelName ?-fft? ?-output vecName?
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ * Side Effects:
+ *	The output vector is reset.  Its clients are notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ConvolveOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    FilterSwitches switches;
+    Vector *kernelPtr;
+    double *valueArr;
+    int length;
+
+    if (Blt_Vec_LookupName(vPtr->dataPtr, Tcl_GetString(objv[2]), 
+	&kernelPtr) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (ParseFilterSwitches(vPtr, interp, convolveSwitches, objc - 3, 
+	objv + 3, &switches) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    /* Like the other filter operations, Blt_Vec_Convolve uses only the
+     * selected range of the vector and the kernel. */
+    length = MAX(vPtr->last - vPtr->first + 1, 0);
+    valueArr = Blt_AssertMalloc(MAX(length, 1) * sizeof(double));
+    if ((length > 0) && (Blt_Vec_Convolve(interp, vPtr, kernelPtr, 
+		switches.flags, valueArr) != TCL_OK)) {
+	Blt_Free(valueArr);
+	return TCL_ERROR;
+    }
+    return StoreFilterResult(switches.outputPtr, valueArr, length);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * CumsumOp --
+ *
+ *	Computes the cumulative sum of the vector.  Each component of the
+ *	result is the sum of the vector's components up to and including it.
+ *
+ *	  $v cumsum ?-output vecName?
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ * Side Effects:
+ *	The output vector is reset.  Its clients are notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+CumsumOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    FilterSwitches switches;
+    double *src, *valueArr;
+    double sum;
+    int i, length;
+
+    if (ParseFilterSwitches(vPtr, interp, filterSwitches, objc - 2, objv + 2,
+	&switches) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    src = vPtr->valueArr + vPtr->first;
+    length = MAX(vPtr->last - vPtr->first + 1, 0);
+    valueArr = Blt_AssertMalloc(MAX(length, 1) * sizeof(double));
+    sum = 0.0;
+    for (i = 0; i < length; i++) {
+	sum += src[i];
+	valueArr[i] = sum;
+    }
+    return StoreFilterResult(switches.outputPtr, valueArr, length);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -420,6 +676,8 @@ DeleteOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
 	    SetBit(j);		/* Mark the range of elements for deletion. */
 	}
     }
+    /* Don't compact the values in the storage shared with a parent. */
+    Blt_Vec_DetachView(vPtr, TRUE);
     count = 0;
     for (i = 0; i < vPtr->length; i++) {
 	if (GetBit(i)) {
@@ -439,6 +697,121 @@ DeleteOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     return TCL_OK;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DecimateOp --
+ *
+ *	Decimates the vector, keeping every nth component.  If the -minmax
+ *	switch is given, the vector is instead split into buckets of n
+ *	components and the minimum and maximum of each bucket are kept, in
+ *	the order they appear.  This preserves the peaks of the data.
+ *
+ *	  $v decimate n ?-minmax? ?-output vecName?
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ * Side Effects:
+ *	The output vector is reset.  Its clients are notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+DecimateOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    FilterSwitches switches;
+    double *src, *valueArr;
+    int i, n, count, length;
+
+    if (Tcl_GetIntFromObj(interp, objv[2], &n) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (n < 1) {
+	Tcl_AppendResult(interp, "bad decimation factor \"", 
+		Tcl_GetString(objv[2]), "\": must be greater than zero", 
+		(char *)NULL);
+	return TCL_ERROR;
+    }
+    if (ParseFilterSwitches(vPtr, interp, decimateSwitches, objc - 3, 
+	objv + 3, &switches) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    src = vPtr->valueArr + vPtr->first;
+    length = MAX(vPtr->last - vPtr->first + 1, 0);
+    count = 0;
+    if (switches.flags & FILTER_MINMAX) {
+	valueArr = Blt_AssertMalloc(MAX(2 * ((length + n - 1) / n), 1) * 
+		sizeof(double));
+	for (i = 0; i < length; i += n) {
+	    int j, last, iMin, iMax;
+
+	    last = MIN(i + n, length);
+	    iMin = iMax = i;
+	    for (j = i + 1; j < last; j++) {
+		if (src[j] < src[iMin]) {
+		    iMin = j;
+		} else if (src[j] > src[iMax]) {
+		    iMax = j;
+		}
+	    }
+	    if (iMin == iMax) {
+		valueArr[count++] = src[iMin];
+	    } else {
+		valueArr[count++] = src[MIN(iMin, iMax)];
+		valueArr[count++] = src[MAX(iMin, iMax)];
+	    }
+	}
+    } else {
+	valueArr = Blt_AssertMalloc(MAX((length + n - 1) / n, 1) * 
+		sizeof(double));
+	for (i = 0; i < length; i += n) {
+	    valueArr[count++] = src[i];
+	}
+    }
+    return StoreFilterResult(switches.outputPtr, valueArr, count);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DiffOp --
+ *
+ *	Computes the differences between successive components of the
+ *	vector.  The result has one less component than the vector.
+ *
+ *	  $v diff ?-output vecName?
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ * Side Effects:
+ *	The output vector is reset.  Its clients are notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+DiffOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    FilterSwitches switches;
+    double *src, *valueArr;
+    int i, length;
+
+    if (ParseFilterSwitches(vPtr, interp, filterSwitches, objc - 2, objv + 2,
+	&switches) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    src = vPtr->valueArr + vPtr->first;
+    length = MAX(vPtr->last - vPtr->first, 0);
+    valueArr = Blt_AssertMalloc(MAX(length, 1) * sizeof(double));
+    for (i = 0; i < length; i++) {
+	valueArr[i] = src[i + 1] - src[i];
+    }
+    return StoreFilterResult(switches.outputPtr, valueArr, length);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -645,6 +1018,160 @@ IndexOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     return TCL_OK;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * InterpolateOp --
+ *
+ *	Resamples the vector.  The components of the vector are the y-values
+ *	at the x-coordinates in the first vector given.  The result holds
+ *	the y-values interpolated at the x-coordinates of the second vector.
+ *	Coordinates outside of the range of the source are clamped to the
+ *	first or last value.
+ *
+ *	  $v interpolate xVecName newXVecName ?-linear|-spline? 
+ *		?-output vecName?
+ *
+ *	Linear interpolation walks both sets of coordinates together when
+ *	the new coordinates are increasing, so it is O(n) for the common
+ *	case.  Spline interpolation uses a natural cubic spline.
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ * Side Effects:
+ *	The output vector is reset.  Its clients are notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+InterpolateOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    FilterSwitches switches;
+    Vector *xPtr, *newXPtr;
+    double *x, *y, *newX, *valueArr;
+    int i, n, length, xLength;
+
+    y = vPtr->valueArr + vPtr->first;
+    n = MAX(vPtr->last - vPtr->first + 1, 0);
+    /* 
+     * Save the selected range of each vector as soon as it's looked up.
+     * Both names may refer to the same vector, with different ranges.
+     */
+    if (Blt_Vec_LookupName(vPtr->dataPtr, Tcl_GetString(objv[2]), &xPtr) 
+	!= TCL_OK) {
+	return TCL_ERROR;
+    }
+    x = xPtr->valueArr + xPtr->first;
+    xLength = MAX(xPtr->last - xPtr->first + 1, 0);
+    if (Blt_Vec_LookupName(vPtr->dataPtr, Tcl_GetString(objv[3]), &newXPtr)
+	!= TCL_OK) {
+	return TCL_ERROR;
+    }
+    newX = newXPtr->valueArr + newXPtr->first;
+    length = MAX(newXPtr->last - newXPtr->first + 1, 0);
+    if (ParseFilterSwitches(vPtr, interp, interpolateSwitches, objc - 4, 
+	objv + 4, &switches) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (xLength != n) {
+	Tcl_AppendResult(interp, "vectors \"", vPtr->name, "\" and \"", 
+		xPtr->name, "\" must be the same length", (char *)NULL);
+	return TCL_ERROR;
+    }
+    if (n < 1) {
+	Tcl_AppendResult(interp, "vector \"", vPtr->name, "\" is empty", 
+		(char *)NULL);
+	return TCL_ERROR;
+    }
+    for (i = 1; i < n; i++) {
+	if (x[i] <= x[i - 1]) {
+	    Tcl_AppendResult(interp, "x-coordinates in \"", xPtr->name, 
+		"\" must be increasing", (char *)NULL);
+	    return TCL_ERROR;
+	}
+    }
+    valueArr = Blt_AssertMalloc(MAX(length, 1) * sizeof(double));
+    if ((switches.flags & FILTER_SPLINE) && (n > 2)) {
+	Point2d *orig, *intp;
+
+	orig = Blt_AssertMalloc(n * sizeof(Point2d));
+	intp = Blt_AssertMalloc(MAX(length, 1) * sizeof(Point2d));
+	for (i = 0; i < n; i++) {
+	    orig[i].x = x[i];
+	    orig[i].y = y[i];
+	}
+	for (i = 0; i < length; i++) {
+	    intp[i].x = newX[i];
+	}
+	if (!Blt_NaturalSpline(orig, n, intp, length)) {
+	    Blt_Free(orig);
+	    Blt_Free(intp);
+	    Blt_Free(valueArr);
+	    Tcl_AppendResult(interp, "can't compute spline for \"", 
+		vPtr->name, "\"", (char *)NULL);
+	    return TCL_ERROR;
+	}
+	for (i = 0; i < length; i++) {
+	    double xi;
+
+	    xi = intp[i].x;
+	    if (xi <= x[0]) {
+		valueArr[i] = y[0];
+	    } else if (xi >= x[n - 1]) {
+		valueArr[i] = y[n - 1];
+	    } else {
+		valueArr[i] = intp[i].y;
+	    }
+	}
+	Blt_Free(orig);
+	Blt_Free(intp);
+    } else {
+	int j;
+	double last;
+
+	j = 1;			/* Index of the right end of the interval. */
+	last = -DBL_MAX;
+	for (i = 0; i < length; i++) {
+	    double xi;
+
+	    xi = newX[i];
+	    if (xi <= x[0]) {
+		valueArr[i] = y[0];
+	    } else if (xi >= x[n - 1]) {
+		valueArr[i] = y[n - 1];
+	    } else {
+		if (xi < last) {
+		    int low, high;
+
+		    /* Coordinates went backwards, search for the interval. */
+		    low = 1, high = n - 1;
+		    while (low < high) {
+			int mid;
+
+			mid = (low + high) >> 1;
+			if (x[mid] < xi) {
+			    low = mid + 1;
+			} else {
+			    high = mid;
+			}
+		    }
+		    j = low;
+		} else {
+		    while (x[j] < xi) {
+			j++;
+		    }
+		}
+		valueArr[i] = y[j - 1] + (xi - x[j - 1]) * 
+		    (y[j] - y[j - 1]) / (x[j] - x[j - 1]);
+	    }
+	    last = xi;
+	}
+    }
+    return StoreFilterResult(switches.outputPtr, valueArr, length);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -835,6 +1362,61 @@ MinOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     return TCL_OK;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MovavgOp --
+ *
+ *	Computes the trailing moving average of the vector over a window of
+ *	n components.  The first n-1 components are averaged over the
+ *	partial window available.  A running sum makes this O(n) regardless
+ *	of the window size.
+ *
+ *	  $v movavg n ?-output vecName?
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ * Side Effects:
+ *	The output vector is reset.  Its clients are notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+MovavgOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    FilterSwitches switches;
+    double *src, *valueArr;
+    double sum;
+    int i, n, length;
+
+    if (Tcl_GetIntFromObj(interp, objv[2], &n) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (n < 1) {
+	Tcl_AppendResult(interp, "bad window size \"", Tcl_GetString(objv[2]),
+		"\": must be greater than zero", (char *)NULL);
+	return TCL_ERROR;
+    }
+    if (ParseFilterSwitches(vPtr, interp, filterSwitches, objc - 3, objv + 3,
+	&switches) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    src = vPtr->valueArr + vPtr->first;
+    length = MAX(vPtr->last - vPtr->first + 1, 0);
+    valueArr = Blt_AssertMalloc(MAX(length, 1) * sizeof(double));
+    sum = 0.0;
+    for (i = 0; i < length; i++) {
+	sum += src[i];
+	if (i >= n) {
+	    sum -= src[i - n];
+	}
+	valueArr[i] = sum / MIN(i + 1, n);
+    }
+    return StoreFilterResult(switches.outputPtr, valueArr, length);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -1271,7 +1853,8 @@ static int
 CopyValues(Vector *vPtr, char *byteArr, enum NativeFormats fmt, int size, 
 	int length, int swap, int *indexPtr)
 {
-    int i, n;
+    double *valueArr, *packed;
+    int i;
     int newSize;
 
     if ((swap) && (size > 1)) {
@@ -1290,14 +1873,38 @@ CopyValues(Vector *vPtr, char *byteArr, enum NativeFormats fmt, int size,
 	}
     }
     newSize = *indexPtr + length;
-    if (newSize > vPtr->length) {
-	if (Blt_Vec_ChangeLength(vPtr->interp, vPtr, newSize) != TCL_OK) {
+    packed = NULL;
+    if (vPtr->valueArr == NULL) {
+	/* 
+	 * The vector's values are packed.  Store the values directly in the
+	 * packed array.  If the format matches the storage type, no
+	 * conversion is needed at all.
+	 */
+	if ((newSize > vPtr->length) && 
+	    (Blt_Vec_SetPackedLength(vPtr->interp, vPtr, newSize) != TCL_OK)) {
 	    return TCL_ERROR;
 	}
+	if (((vPtr->type == VECTOR_TYPE_FLOAT) && (fmt == FMT_FLOAT)) ||
+	    ((vPtr->type == VECTOR_TYPE_INT32) && (fmt == FMT_INT)) ||
+	    ((vPtr->type == VECTOR_TYPE_INT16) && (fmt == FMT_SHORT))) {
+	    memcpy((char *)vPtr->packedArr + *indexPtr * size, byteArr, 
+		length * size);
+	    *indexPtr += length;
+	    return TCL_OK;
+	}
+	packed = Blt_AssertMalloc(MAX(length, 1) * sizeof(double));
+	valueArr = packed;
+    } else {
+	if (newSize > vPtr->length) {
+	    if (Blt_Vec_ChangeLength(vPtr->interp, vPtr, newSize) != TCL_OK) {
+		return TCL_ERROR;
+	    }
+	}
+	valueArr = vPtr->valueArr + *indexPtr;
     }
 #define CopyArrayToVector(vPtr, arr) \
-    for (i = 0, n = *indexPtr; i < length; i++, n++) { \
-	(vPtr)->valueArr[n] = (double)(arr)[i]; \
+    for (i = 0; i < length; i++) { \
+	valueArr[i] = (double)(arr)[i]; \
     }
 
     switch (fmt) {
@@ -1344,6 +1951,10 @@ CopyValues(Vector *vPtr, char *byteArr, enum NativeFormats fmt, int size,
     case FMT_UNKNOWN:
 	break;
     }
+    if (packed != NULL) {
+	Blt_Vec_StorePacked(vPtr, *indexPtr, length, packed);
+	Blt_Free(packed);
+    }
     *indexPtr += length;
     return TCL_OK;
 }
@@ -1503,7 +2114,8 @@ BinreadOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     if (vPtr->flush) {
 	Blt_Vec_FlushCache(vPtr);
     }
-    Blt_Vec_UpdateClients(vPtr);
+    /* Values before the ones read are unchanged. */
+    Blt_Vec_UpdateClientsFrom(vPtr, first - total);
 
     /* Set the result as the number of values read.  */
     Tcl_SetIntObj(Tcl_GetObjResult(interp), total);
@@ -2066,6 +2678,60 @@ SortOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
     return result;
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ViewOp --
+ *
+ *	Makes the named vector a view onto a window of the current vector.
+ *	The view shares the storage of the vector, so no values are copied.
+ *	Changes to either vector are seen by the other.
+ *
+ *	vecName view destName first last ?stride?
+ *
+ * Results:
+ *	A standard TCL result.  If the indices are invalid, TCL_ERROR is
+ *	returned.  Otherwise interp->result will contain the name of the
+ *	view.
+ *
+ * Side Effects:
+ *	The previous values of the destination vector are discarded.
+ *	Clients of the destination vector are notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ViewOp(Vector *vPtr, Tcl_Interp *interp, int objc, Tcl_Obj *const *objv)
+{
+    Vector *v2Ptr;
+    char *string;
+    int first, last, stride;
+    int isNew;
+
+    if ((Blt_Vec_GetIndex(interp, vPtr, Tcl_GetString(objv[3]), &first, 
+		INDEX_CHECK, (Blt_VectorIndexProc **) NULL) != TCL_OK) ||
+	(Blt_Vec_GetIndex(interp, vPtr, Tcl_GetString(objv[4]), &last, 
+		INDEX_CHECK, (Blt_VectorIndexProc **) NULL) != TCL_OK)) {
+	return TCL_ERROR;
+    }
+    stride = 1;
+    if ((objc > 5) && 
+	(Tcl_GetIntFromObj(interp, objv[5], &stride) != TCL_OK)) {
+	return TCL_ERROR;
+    }
+    string = Tcl_GetString(objv[2]);
+    v2Ptr = Blt_Vec_Create(vPtr->dataPtr, string, string, string, &isNew);
+    if (v2Ptr == NULL) {
+	return TCL_ERROR;
+    }
+    if (Blt_Vec_SetView(interp, v2Ptr, vPtr, first, last, stride) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    Tcl_SetStringObj(Tcl_GetObjResult(interp), v2Ptr->name, -1);
+    return TCL_OK;
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -2236,16 +2902,22 @@ static Blt_OpSpec vectorInstOps[] =
     {"append",    1, AppendOp,    3, 0, "item ?item...?",},
     {"binread",   1, BinreadOp,   3, 0, "channel ?numValues? ?flags?",},
     {"clear",     1, ClearOp,     2, 2, "",},
+    {"convolve",  2, ConvolveOp,  3, 0, "kernelName ?switches?",},
+    {"cumsum",    2, CumsumOp,    2, 0, "?switches?",},
+    {"decimate",  3, DecimateOp,  3, 0, "n ?switches?",},
     {"delete",    2, DeleteOp,    2, 0, "index ?index...?",},
+    {"diff",      2, DiffOp,      2, 0, "?switches?",},
     {"dup",       2, DupOp,       3, 0, "vecName",},
     {"expr",      1, InstExprOp,  3, 3, "expression",},
     {"fft",	  1, FFTOp,	  3, 0, "vecName ?switches?",},
     {"index",     3, IndexOp,     3, 4, "index ?value?",},
+    {"interpolate",3, InterpolateOp, 4, 0, "xVecName newXVecName ?switches?",},
     {"inversefft",3, InverseFFTOp,4, 4, "vecName vecName",},
     {"length",    1, LengthOp,    2, 3, "?newSize?",},
     {"max",       2, MaxOp,       2, 2, "",},
     {"merge",     2, MergeOp,     3, 0, "vecName ?vecName...?",},
     {"min",       2, MinOp,       2, 2, "",},
+    {"movavg",    2, MovavgOp,    3, 0, "n ?switches?",},
     {"normalize", 3, NormalizeOp, 2, 3, "?vecName?",},	/*Deprecated*/
     {"notify",    3, NotifyOp,    3, 3, "keyword",},
     {"offset",    1, OffsetOp,    2, 3, "?offset?",},
@@ -2260,6 +2932,7 @@ static Blt_OpSpec vectorInstOps[] =
     {"split",     2, SplitOp,     2, 0, "?vecName...?",},
     {"values",    3, ValuesOp,    2, 0, "?switches?",},
     {"variable",  3, MapOp,       2, 3, "?varName?",},
+    {"view",      2, ViewOp,      5, 6, "vecName first last ?stride?",},
 };
 
 static int nInstOps = sizeof(vectorInstOps) / sizeof(Blt_OpSpec);
@@ -2278,6 +2951,13 @@ Blt_Vec_InstCmd(ClientData clientData, Tcl_Interp *interp, int objc,
     if (proc == NULL) {
 	return TCL_ERROR;
     }
+    if (vPtr->valueArr == NULL) {
+	/* Only a few operations work directly on packed values. */
+	if (((proc != LengthOp) || (objc > 2)) && (proc != MinOp) && 
+	    (proc != MaxOp) && (proc != BinreadOp)) {
+	    Blt_Vec_Unpack(vPtr);
+	}
+    }
     return (*proc) (vPtr, interp, objc, objv);
 }
 
@@ -2315,6 +2995,9 @@ Blt_Vec_VarTrace(ClientData clientData, Tcl_Interp *interp, const char *part1,
 	}
 	return NULL;
     }
+    if (vPtr->valueArr == NULL) {
+	Blt_Vec_Unpack(vPtr);
+    }
     if (Blt_Vec_GetIndexRange(interp, vPtr, part2, INDEX_ALL_FLAGS, &indexProc)
 	 != TCL_OK) {
 	goto error;
@@ -2391,6 +3074,7 @@ Blt_Vec_VarTrace(ClientData clientData, Tcl_Interp *interp, const char *part1,
 	 * Also flush any array variable entries so that the shift is
 	 * reflected when the array variable is read.
 	 */
+	Blt_Vec_DetachView(vPtr, TRUE);
 	for (i = first, j = last + 1; j < vPtr->length; i++, j++) {
 	    vPtr->valueArr[i] = vPtr->valueArr[j];
 	}
@@ -2402,7 +3086,8 @@ Blt_Vec_VarTrace(ClientData clientData, Tcl_Interp *interp, const char *part1,
 	return (char *)"unknown variable trace flag";
     }
     if (flags & (TCL_TRACE_UNSETS | TCL_TRACE_WRITES)) {
-	Blt_Vec_UpdateClients(vPtr);
+	/* Values before the first index are unchanged. */
+	Blt_Vec_UpdateClientsFrom(vPtr, first);
     }
     Tcl_ResetResult(interp);
     return NULL;
@@ -49,6 +49,14 @@
 #define FFT_BARTLETT		(1<<1)
 #define FFT_SPECTRUM		(1<<2)
 
+#define CONVOLVE_FFT		(1<<0)
+
+/* Storage types of vector values. */
+#define VECTOR_TYPE_DOUBLE	0
+#define VECTOR_TYPE_FLOAT	1
+#define VECTOR_TYPE_INT32	2
+#define VECTOR_TYPE_INT16	3
+
 typedef struct {
     Blt_HashTable vectorTable;	/* Table of vectors */
     Blt_HashTable mathProcTable; /* Table of vector math functions */
@@ -65,6 +73,11 @@ typedef struct {
  *	the array points initially to a statically allocated buffer, but to
  *	malloc-ed memory if more is necessary.
  *
+ *	A vector may instead store its values as single precision floats or
+ *	32 or 16-bit integers.  Such vectors keep their values packed in the
+ *	storage type and materialize the array of doubles only when it's
+ *	needed.  The array is released again at the next idle point.
+ *
  *	Vectors can be shared by several clients (for example, two different
  *	graph widgets).  The data is shared. When a client wants to use a
  *	vector, it allocates a vector identifier, which identifies the client.
@@ -74,7 +87,7 @@ typedef struct {
  *	callback routine.
  */
 
-typedef struct {
+typedef struct _Vector {
 
     /*
      * If you change these fields, make sure you change the definition of
@@ -139,6 +152,35 @@ typedef struct {
 
     int first, last;		/* Selected region of vector. This is used
 				 * mostly for the math routines */
+
+    /*
+     * A vector can be a view onto a window of another (parent) vector.  A
+     * view with a stride of 1 aliases the parent's value array directly
+     * (its storage is TCL_STATIC).  Strided views keep a gathered copy
+     * that is refreshed whenever the parent changes and scattered back
+     * whenever the view is written.
+     */
+    struct _Vector *parentPtr;	/* If non-NULL, the vector whose storage
+				 * this vector is a view of. */
+
+    Blt_ChainLink viewLink;	/* Link of this view in the parent's chain
+				 * of views. */
+
+    Blt_Chain views;		/* Views onto this vector's storage. NULL
+				 * if there are none. */
+
+    int viewFirst, viewLast;	/* Indices in the parent of the first and
+				 * last components of the view. */
+
+    int viewStride;		/* Step between successive components of
+				 * the view in the parent. */
+
+    int type;			/* Storage type of the values. See
+				 * definitions above. */
+
+    void *packedArr;		/* If non-NULL, the values packed in the
+				 * storage type.  The value array is NULL
+				 * while the vector is packed. */
 } Vector;
 
 #define NOTIFY_UPDATED		((int)BLT_VECTOR_NOTIFY_UPDATE)
@@ -162,6 +204,9 @@ typedef struct {
 					 * Update the min and max limits when
 					 * they are needed */
 
+#define PACK_PENDING		(1<<10)	/* A do-when-idle packing of the
+					 * vector's values is pending. */
+
 #define FindRange(array, first, last, min, max) \
 { \
     min = max = 0.0; \
@@ -221,8 +266,15 @@ BLT_EXTERN void Blt_Vec_UpdateRange(Vector *vPtr);
 
 BLT_EXTERN void Blt_Vec_UpdateClients(Vector *vPtr);
 
+BLT_EXTERN void Blt_Vec_UpdateClientsFrom(Vector *vPtr, int first);
+
 BLT_EXTERN void Blt_Vec_FlushCache(Vector *vPtr);
 
+BLT_EXTERN int Blt_Vec_SetView(Tcl_Interp *interp, Vector *vPtr,
+	Vector *parentPtr, int first, int last, int stride);
+
+BLT_EXTERN void Blt_Vec_DetachView(Vector *vPtr, int keepValues);
+
 BLT_EXTERN int Blt_Vec_Reset(Vector *vPtr, double *dataArr,
 	int nValues, int arraySize, Tcl_FreeProc *freeProc);
 
@@ -243,6 +295,29 @@ BLT_EXTERN int Blt_Vec_FFT(Tcl_Interp *interp, Vector *realPtr,
 BLT_EXTERN int Blt_Vec_InverseFFT(Tcl_Interp *interp, Vector *iSrcPtr, 
 	Vector *rDestPtr, Vector *iDestPtr, Vector *srcPtr);
 
+BLT_EXTERN int Blt_Vec_GetTypeFromObj(Tcl_Interp *interp, Tcl_Obj *objPtr,
+	int *typePtr);
+
+BLT_EXTERN const char *Blt_Vec_NameOfType(int type);
+
+BLT_EXTERN void Blt_Vec_SetType(Vector *vPtr, int type);
+
+BLT_EXTERN double *Blt_Vec_Unpack(Vector *vPtr);
+
+BLT_EXTERN void Blt_Vec_Pack(Vector *vPtr);
+
+BLT_EXTERN int Blt_Vec_SetPackedLength(Tcl_Interp *interp, Vector *vPtr,
+	int length);
+
+BLT_EXTERN void Blt_Vec_StorePacked(Vector *vPtr, int first, int n,
+	const double *values);
+
+BLT_EXTERN void Blt_Vec_LoadPacked(Vector *vPtr, int first, int n,
+	double *values);
+
+BLT_EXTERN int Blt_Vec_Convolve(Tcl_Interp *interp, Vector *srcPtr,
+	Vector *kernelPtr, int flags, double *resultArr);
+
 BLT_EXTERN Tcl_ObjCmdProc Blt_Vec_InstCmd;
 
 BLT_EXTERN Tcl_VarTraceProc Blt_Vec_VarTrace;
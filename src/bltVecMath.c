@@ -236,6 +236,13 @@ Blt_VecMin(Blt_Vector *vectorPtr)
     return Blt_Vec_Min(vPtr);
 }
 
+double *
+Blt_VecUnpack(Blt_Vector *vectorPtr)
+{
+    Vector *vPtr = (Vector *)vectorPtr;
+
+    return Blt_Vec_Unpack(vPtr);
+}
 
 static double
 Product(Blt_Vector *vectorPtr)
@@ -95,6 +95,16 @@ typedef struct {
     ClientData clientData;	/* Data passed whenever the vector change
 				 * procedure is called. */
 
+    int pinned;			/* Indicates the client references the
+				 * vector's array directly. See
+				 * Blt_PinVector. */
+
+    int changed;		/* Index of the first value changed since
+				 * the client was last notified. */
+
+    int first;			/* Index of the first changed value, as
+				 * reported by the current notification. */
+
     Blt_ChainLink link;		/* Used to quickly remove this entry from its
 				 * server's client chain. */
 } VectorClient;
@@ -108,8 +118,14 @@ typedef struct {
     char *cmdName;		/* Requested command name. */
     int flush;			/* Flush */
     int watchUnset;		/* Watch when variable is unset. */
+    int type;			/* Storage type. -1 if not specified. */
 } CreateSwitches;
 
+static Blt_SwitchParseProc ObjToType;
+static Blt_SwitchCustom typeSwitch = {
+    ObjToType, NULL, (ClientData)0,
+};
+
 static Blt_SwitchSpec createSwitches[] = 
 {
     {BLT_SWITCH_STRING, "-variable", "varName",
@@ -120,6 +136,8 @@ static Blt_SwitchSpec createSwitches[] =
 	Blt_Offset(CreateSwitches, watchUnset), 0},
     {BLT_SWITCH_BOOLEAN, "-flush", "bool",
 	Blt_Offset(CreateSwitches, flush), 0},
+    {BLT_SWITCH_CUSTOM, "-type", "type",
+	Blt_Offset(CreateSwitches, type), 0, 0, &typeSwitch},
     {BLT_SWITCH_END}
 };
 
@@ -188,12 +206,441 @@ GetVectorObject(
     return vPtr;
 }
 
+/*
+ * Conversions from double precision values to the vector's storage type.
+ * Integer types are rounded to the nearest integer and clamped to the
+ * range of the type.  NaNs are stored as zero.
+ */
+#define ROUND_TO_INT(x, lo, hi) \
+    (((x) != (x)) ? 0 : ((x) <= (double)(lo)) ? (lo) : \
+     ((x) >= (double)(hi)) ? (hi) : \
+     ((x) < 0.0) ? (int)ceil((x) - 0.5) : (int)floor((x) + 0.5))
+
+typedef struct {
+    const char *name;		/* Name of the storage type. */
+    size_t size;		/* Size of each packed value in bytes. */
+} VectorTypeSpec;
+
+static VectorTypeSpec vectorTypes[] = {
+    { "double", sizeof(double) },
+    { "float",  sizeof(float)  },
+    { "int32",  sizeof(int)    },
+    { "int16",  sizeof(short)  },
+};
+
+static int nVectorTypes = sizeof(vectorTypes) / sizeof(VectorTypeSpec);
+
+static Tcl_IdleProc PackIdleProc;
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_GetTypeFromObj --
+ *
+ *	Converts the name of a storage type into its enumerated value.
+ *
+ * Results:
+ *	A standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_Vec_GetTypeFromObj(Tcl_Interp *interp, Tcl_Obj *objPtr, int *typePtr)
+{
+    const char *string;
+    int i;
+
+    string = Tcl_GetString(objPtr);
+    for (i = 0; i < nVectorTypes; i++) {
+	if (strcmp(string, vectorTypes[i].name) == 0) {
+	    *typePtr = i;
+	    return TCL_OK;
+	}
+    }
+    if (interp != NULL) {
+	Tcl_AppendResult(interp, "unknown vector type \"", string, 
+		"\": should be double, float, int32, or int16", (char *)NULL);
+    }
+    return TCL_ERROR;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ObjToType --
+ *
+ *	Converts the name of a storage type for the "-type" switch.
+ *
+ * Results:
+ *	The return value is a standard TCL result.
+ *
+ *---------------------------------------------------------------------------
+ */
+/*ARGSUSED*/
+static int
+ObjToType(
+    ClientData clientData,	/* Not used. */
+    Tcl_Interp *interp,		/* Interpreter to send results back to */
+    const char *switchName,	/* Not used. */
+    Tcl_Obj *objPtr,		/* Name of the storage type. */
+    char *record,		/* Structure record */
+    int offset,			/* Offset to field in structure */
+    int flags)			/* Not used. */
+{
+    int *typePtr = (int *)(record + offset);
+
+    return Blt_Vec_GetTypeFromObj(interp, objPtr, typePtr);
+}
+
+const char *
+Blt_Vec_NameOfType(int type)
+{
+    if ((type < 0) || (type >= nVectorTypes)) {
+	return "???";
+    }
+    return vectorTypes[type].name;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_StorePacked --
+ *
+ *	Converts the double precision values into the vector's storage type
+ *	and writes them into its packed array, starting at the given index.
+ *	The packed array must already hold at least first + n values.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_Vec_StorePacked(Vector *vPtr, int first, int n, const double *values)
+{
+    int i;
+
+    switch (vPtr->type) {
+    case VECTOR_TYPE_FLOAT:
+	{
+	    float *fp = (float *)vPtr->packedArr + first;
+
+	    for (i = 0; i < n; i++) {
+		fp[i] = (float)values[i];
+	    }
+	}
+	break;
+    case VECTOR_TYPE_INT32:
+	{
+	    int *ip = (int *)vPtr->packedArr + first;
+
+	    for (i = 0; i < n; i++) {
+		ip[i] = ROUND_TO_INT(values[i], INT_MIN, INT_MAX);
+	    }
+	}
+	break;
+    case VECTOR_TYPE_INT16:
+	{
+	    short *sp = (short *)vPtr->packedArr + first;
+
+	    for (i = 0; i < n; i++) {
+		sp[i] = (short)ROUND_TO_INT(values[i], SHRT_MIN, SHRT_MAX);
+	    }
+	}
+	break;
+    default:
+	memcpy((double *)vPtr->packedArr + first, values, n * sizeof(double));
+	break;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_LoadPacked --
+ *
+ *	Converts n values of the vector's packed array, starting at the
+ *	given index, into double precision values.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_Vec_LoadPacked(Vector *vPtr, int first, int n, double *values)
+{
+    int i;
+
+    switch (vPtr->type) {
+    case VECTOR_TYPE_FLOAT:
+	{
+	    float *fp = (float *)vPtr->packedArr + first;
+
+	    for (i = 0; i < n; i++) {
+		values[i] = (double)fp[i];
+	    }
+	}
+	break;
+    case VECTOR_TYPE_INT32:
+	{
+	    int *ip = (int *)vPtr->packedArr + first;
+
+	    for (i = 0; i < n; i++) {
+		values[i] = (double)ip[i];
+	    }
+	}
+	break;
+    case VECTOR_TYPE_INT16:
+	{
+	    short *sp = (short *)vPtr->packedArr + first;
+
+	    for (i = 0; i < n; i++) {
+		values[i] = (double)sp[i];
+	    }
+	}
+	break;
+    default:
+	memcpy(values, (double *)vPtr->packedArr + first, n * sizeof(double));
+	break;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * PackedRange --
+ *
+ *	Computes the minimum and maximum of the packed values without
+ *	converting them to double precision.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+PackedRange(Vector *vPtr, double *minPtr, double *maxPtr)
+{
+    double min, max;
+
+    min = max = 0.0;
+    if (vPtr->length > 0) {
+	switch (vPtr->type) {
+	case VECTOR_TYPE_FLOAT:
+	    FindRange(((float *)vPtr->packedArr), 0, vPtr->length - 1, 
+		      min, max);
+	    break;
+	case VECTOR_TYPE_INT32:
+	    {
+		int imin, imax;
+
+		FindRange(((int *)vPtr->packedArr), 0, vPtr->length - 1, 
+			  imin, imax);
+		min = imin, max = imax;
+	    }
+	    break;
+	case VECTOR_TYPE_INT16:
+	    {
+		short smin, smax;
+
+		FindRange(((short *)vPtr->packedArr), 0, vPtr->length - 1, 
+			  smin, smax);
+		min = smin, max = smax;
+	    }
+	    break;
+	default:
+	    FindRange(((double *)vPtr->packedArr), 0, vPtr->length - 1, 
+		      min, max);
+	    break;
+	}
+    }
+    *minPtr = min;
+    *maxPtr = max;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_Unpack --
+ *
+ *	Materializes the double precision array of a vector whose values
+ *	are packed in its storage type.  The packed array is released.  The
+ *	vector is packed again at the next idle point.
+ *
+ *	Every path that hands out the vector's value array (the instance
+ *	command, its array variable, vector expressions, and Blt_VecData)
+ *	calls this first.
+ *
+ * Results:
+ *	Returns the vector's value array.
+ *
+ *---------------------------------------------------------------------------
+ */
+double *
+Blt_Vec_Unpack(Vector *vPtr)
+{
+    if (vPtr->valueArr == NULL) {
+	double *valueArr;
+	int size;
+
+	size = MAX(vPtr->length, DEF_ARRAY_SIZE);
+	valueArr = Blt_AssertMalloc(size * sizeof(double));
+	Blt_Vec_LoadPacked(vPtr, 0, vPtr->length, valueArr);
+	if (vPtr->packedArr != NULL) {
+	    Blt_Free(vPtr->packedArr);
+	    vPtr->packedArr = NULL;
+	}
+	vPtr->valueArr = valueArr;
+	vPtr->size = size;
+	vPtr->freeProc = TCL_DYNAMIC;
+    }
+    if ((vPtr->type != VECTOR_TYPE_DOUBLE) && 
+	((vPtr->notifyFlags & PACK_PENDING) == 0)) {
+	vPtr->notifyFlags |= PACK_PENDING;
+	Tcl_DoWhenIdle(PackIdleProc, vPtr);
+    }
+    return vPtr->valueArr;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * IsPinned --
+ *
+ *	Indicates if any client references the vector's array directly.
+ *
+ *---------------------------------------------------------------------------
+ */
+static int
+IsPinned(Vector *vPtr)
+{
+    Blt_ChainLink link;
+
+    for (link = Blt_Chain_FirstLink(vPtr->chain); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	VectorClient *clientPtr;
+
+	clientPtr = Blt_Chain_GetValue(link);
+	if (clientPtr->pinned) {
+	    return TRUE;
+	}
+    }
+    return FALSE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_Pack --
+ *
+ *	Converts the vector's values into its storage type and releases the
+ *	double precision array.  Vectors that share storage (views, their
+ *	parents, and pinned vectors), or whose array is owned by someone
+ *	else, are left unpacked.
+ *
+ * Side Effects:
+ *	The vector's value array is NULL until it is next unpacked.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_Vec_Pack(Vector *vPtr)
+{
+    if ((vPtr->type == VECTOR_TYPE_DOUBLE) || (vPtr->valueArr == NULL) ||
+	(vPtr->parentPtr != NULL) || (vPtr->views != NULL) ||
+	(vPtr->freeProc != TCL_DYNAMIC) || (IsPinned(vPtr))) {
+	return;
+    }
+    vPtr->packedArr = Blt_AssertMalloc(MAX(vPtr->length, 1) * 
+	vectorTypes[vPtr->type].size);
+    Blt_Vec_StorePacked(vPtr, 0, vPtr->length, vPtr->valueArr);
+    Blt_Free(vPtr->valueArr);
+    vPtr->valueArr = NULL;
+    vPtr->size = 0;
+    /* Rounding may have changed the values. */
+    PackedRange(vPtr, &vPtr->min, &vPtr->max);
+    vPtr->notifyFlags &= ~UPDATE_RANGE;
+}
+
+static void
+PackIdleProc(ClientData clientData)
+{
+    Vector *vPtr = clientData;
+
+    vPtr->notifyFlags &= ~PACK_PENDING;
+    Blt_Vec_Pack(vPtr);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_SetPackedLength --
+ *
+ *	Resizes the packed array of a packed vector.  New values are set to
+ *	zero.
+ *
+ * Results:
+ *	A standard TCL result.  If the memory can't be allocated, TCL_ERROR
+ *	is returned and an error message is left in the interpreter.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_Vec_SetPackedLength(Tcl_Interp *interp, Vector *vPtr, int length)
+{
+    size_t size;
+    void *packedArr;
+
+    size = vectorTypes[vPtr->type].size;
+    packedArr = Blt_Realloc(vPtr->packedArr, MAX(length, 1) * size);
+    if (packedArr == NULL) {
+	if (interp != NULL) {
+	    Tcl_AppendResult(interp, "can't allocate ", Blt_Itoa(length), 
+		" elements for vector \"", vPtr->name, "\"", (char *)NULL);
+	}
+	return TCL_ERROR;
+    }
+    if (length > vPtr->length) {
+	memset((char *)packedArr + vPtr->length * size, 0, 
+	       (length - vPtr->length) * size);
+    }
+    vPtr->packedArr = packedArr;
+    vPtr->length = length;
+    vPtr->notifyFlags |= UPDATE_RANGE;
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_SetType --
+ *
+ *	Changes the storage type of the vector.  Existing values are
+ *	converted when the vector is next packed.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_Vec_SetType(Vector *vPtr, int type)
+{
+    if (vPtr->type == type) {
+	return;
+    }
+    Blt_Vec_Unpack(vPtr);
+    vPtr->type = type;
+    if (type == VECTOR_TYPE_DOUBLE) {
+	if (vPtr->notifyFlags & PACK_PENDING) {
+	    vPtr->notifyFlags &= ~PACK_PENDING;
+	    Tcl_CancelIdleCall(PackIdleProc, vPtr);
+	}
+    } else {
+	Blt_Vec_Unpack(vPtr);	/* Schedule the vector to be packed. */
+    }
+}
+
 void
 Blt_Vec_UpdateRange(Vector *vPtr)
 {
     double min, max;
     double *vp, *vend;
 
+    if (vPtr->valueArr == NULL) {
+	PackedRange(vPtr, &vPtr->min, &vPtr->max);
+	vPtr->notifyFlags &= ~UPDATE_RANGE;
+	return;
+    }
     vp = vPtr->valueArr + vPtr->first;
     vend = vPtr->valueArr + vPtr->last;
     min = max = *vp++;
@@ -403,6 +850,9 @@ Blt_Vec_ParseElement(
 	return NULL;
     }
     *p = saved;
+    if (vPtr->valueArr == NULL) {
+	Blt_Vec_Unpack(vPtr);
+    }
     vPtr->first = 0;
     vPtr->last = vPtr->length - 1;
     if (*p == '(') {
@@ -480,6 +930,8 @@ Blt_Vec_NotifyClients(ClientData clientData)
 
 	next = Blt_Chain_NextLink(link);
 	clientPtr = Blt_Chain_GetValue(link);
+	clientPtr->first = clientPtr->changed;
+	clientPtr->changed = INT_MAX;
 	if ((clientPtr->proc != NULL) && (clientPtr->serverPtr != NULL)) {
 	    (*clientPtr->proc) (vPtr->interp, clientPtr->clientData, notify);
 	}
@@ -503,22 +955,31 @@ Blt_Vec_NotifyClients(ClientData clientData)
 /*
  *---------------------------------------------------------------------------
  *
- * Blt_Vec_UpdateClients --
+ * UpdateClients --
  *
- *	Notifies each client of the vector that the vector has changed
- *	(updated or destroyed) by calling the provided function back.
+ *	Marks the vector as changed and schedules the notification of its
+ *	clients, according to the vector's notify mode.  Values before
+ *	*first* are unchanged.
  *
  * Results:
  *	None.
  *
- * Side effects:
- *	The individual client callbacks are eventually invoked.
- *
  *---------------------------------------------------------------------------
  */
-void
-Blt_Vec_UpdateClients(Vector *vPtr)
+static void
+UpdateClients(Vector *vPtr, int first)
 {
+    Blt_ChainLink link;
+
+    for (link = Blt_Chain_FirstLink(vPtr->chain); link != NULL;
+	 link = Blt_Chain_NextLink(link)) {
+	VectorClient *clientPtr;
+
+	clientPtr = Blt_Chain_GetValue(link);
+	if (first < clientPtr->changed) {
+	    clientPtr->changed = first;
+	}
+    }
     vPtr->dirty++;
     vPtr->max = vPtr->min = Blt_NaN();
     if (vPtr->notifyFlags & NOTIFY_NEVER) {
@@ -535,6 +996,260 @@ Blt_Vec_UpdateClients(Vector *vPtr)
     }
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * UnlinkView --
+ *
+ *	Removes the view from its parent's chain of views.  The storage of
+ *	the view is left as is.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+UnlinkView(Vector *vPtr)
+{
+    Vector *parentPtr = vPtr->parentPtr;
+
+    Blt_Chain_DeleteLink(parentPtr->views, vPtr->viewLink);
+    if (Blt_Chain_GetLength(parentPtr->views) == 0) {
+	Blt_Chain_Destroy(parentPtr->views);
+	parentPtr->views = NULL;
+    }
+    vPtr->viewLink = NULL;
+    vPtr->parentPtr = NULL;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * InvalidateView --
+ *
+ *	Detaches a view whose window no longer lies within its parent's
+ *	storage (the parent was shortened or destroyed).  The view becomes
+ *	an ordinary, empty vector and its clients are notified.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+InvalidateView(Vector *vPtr)
+{
+    Blt_Vec_DetachView(vPtr, FALSE);
+    if (vPtr->flush) {
+	Blt_Vec_FlushCache(vPtr);
+    }
+    Blt_Vec_UpdateClients(vPtr);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * RelocateClients --
+ *
+ *	Tells the clients pinning the vector that its array has moved.
+ *	Unlike other notifications, this is done immediately: the old array
+ *	may already be freed.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+RelocateClients(Vector *vPtr)
+{
+    Blt_ChainLink link, next;
+
+    for (link = Blt_Chain_FirstLink(vPtr->chain); link != NULL; link = next) {
+	VectorClient *clientPtr;
+
+	next = Blt_Chain_NextLink(link);
+	clientPtr = Blt_Chain_GetValue(link);
+	if ((clientPtr->pinned) && (clientPtr->proc != NULL)) {
+	    (*clientPtr->proc) (vPtr->interp, clientPtr->clientData, 
+		BLT_VECTOR_NOTIFY_MOVE);
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * RelocateViews --
+ *
+ *	Repoints the views sharing the vector's storage after the storage
+ *	has been moved (reallocated or replaced).  Views whose window lies
+ *	outside of the new storage are invalidated.  Clients pinning the
+ *	vector or its views are relocated too.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+RelocateViews(Vector *vPtr)
+{
+    Blt_ChainLink link, next;
+    int limit;
+
+    RelocateClients(vPtr);
+    limit = MIN(vPtr->length, vPtr->size);
+    for (link = Blt_Chain_FirstLink(vPtr->views); link != NULL; link = next) {
+	Vector *viewPtr;
+
+	next = Blt_Chain_NextLink(link);
+	viewPtr = Blt_Chain_GetValue(link);
+	if (viewPtr->viewLast >= limit) {
+	    InvalidateView(viewPtr);
+	    continue;
+	}
+	if (viewPtr->viewStride == 1) {
+	    viewPtr->valueArr = vPtr->valueArr + viewPtr->viewFirst;
+	    RelocateViews(viewPtr);
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * NotifyViews --
+ *
+ *	Propagates a change in the vector to each of its views (and their
+ *	views).  Strided views gather their components anew from the
+ *	vector.  Views whose window no longer fits are invalidated.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The clients of the views are eventually notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+static void
+NotifyViews(Vector *vPtr)
+{
+    Blt_ChainLink link, next;
+
+    for (link = Blt_Chain_FirstLink(vPtr->views); link != NULL; link = next) {
+	Vector *viewPtr;
+
+	next = Blt_Chain_NextLink(link);
+	viewPtr = Blt_Chain_GetValue(link);
+	if (viewPtr->viewLast >= vPtr->length) {
+	    InvalidateView(viewPtr);
+	    continue;
+	}
+	if (viewPtr->viewStride == 1) {
+	    viewPtr->valueArr = vPtr->valueArr + viewPtr->viewFirst;
+	} else {
+	    double *sp, *dp, *dend;
+
+	    sp = vPtr->valueArr + viewPtr->viewFirst;
+	    for (dp = viewPtr->valueArr, dend = dp + viewPtr->length; 
+		 dp < dend; dp++, sp += viewPtr->viewStride) {
+		*dp = *sp;
+	    }
+	}
+	if (viewPtr->flush) {
+	    Blt_Vec_FlushCache(viewPtr);
+	}
+	UpdateClients(viewPtr, 0);
+	NotifyViews(viewPtr);
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_UpdateClients --
+ *
+ *	Notifies each client of the vector that the vector has changed
+ *	(updated or destroyed) by calling the provided function back.
+ *
+ *	Changes made through a view are written back to its parent, so the
+ *	parent and all its other views are notified too.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The individual client callbacks are eventually invoked.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_Vec_UpdateClients(Vector *vPtr)
+{
+    Vector *parentPtr = vPtr->parentPtr;
+
+    if (parentPtr != NULL) {
+	int length;
+
+	length = (vPtr->viewLast - vPtr->viewFirst) / vPtr->viewStride + 1;
+	if (vPtr->length != length) {
+	    /* The shape of the view has changed. It's now a separate
+	     * vector. */
+	    Blt_Vec_DetachView(vPtr, TRUE);
+	} else {
+	    if (vPtr->viewStride > 1) {
+		double *sp, *dp, *send;
+
+		/* Scatter the values back into the parent. */
+		dp = parentPtr->valueArr + vPtr->viewFirst;
+		for (sp = vPtr->valueArr, send = sp + vPtr->length; sp < send;
+		     sp++, dp += vPtr->viewStride) {
+		    *dp = *sp;
+		}
+	    }
+	    if (parentPtr->flush) {
+		Blt_Vec_FlushCache(parentPtr);
+	    }
+	    Blt_Vec_UpdateClients(parentPtr);
+	    return;
+	}
+    }
+    UpdateClients(vPtr, 0);
+    NotifyViews(vPtr);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_UpdateClientsFrom --
+ *
+ *	Like Blt_Vec_UpdateClients, but records that the values before
+ *	*first* are unchanged.  Clients can then tell when values were
+ *	only appended to the vector (see Blt_VectorChangedFrom).
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The individual client callbacks are eventually invoked.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_Vec_UpdateClientsFrom(Vector *vPtr, int first)
+{
+    if (vPtr->parentPtr != NULL) {
+	/* Indices of a view aren't those of its parent. */
+	Blt_Vec_UpdateClients(vPtr);
+	return;
+    }
+    UpdateClients(vPtr, MAX(first, 0));
+    NotifyViews(vPtr);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -626,6 +1341,10 @@ Blt_Vec_Min(Vector *vecObjPtr)
     double *vp, *vend;
     double min;
 
+    if (vecObjPtr->valueArr == NULL) {
+	Blt_Vec_UpdateRange(vecObjPtr);
+	return vecObjPtr->min;
+    }
     vp = vecObjPtr->valueArr + vecObjPtr->first;
     vend = vecObjPtr->valueArr + vecObjPtr->last;
     min = *vp++;
@@ -644,6 +1363,10 @@ Blt_Vec_Max(Vector *vecObjPtr)
     double max;
     double *vp, *vend;
 
+    if (vecObjPtr->valueArr == NULL) {
+	Blt_Vec_UpdateRange(vecObjPtr);
+	return vecObjPtr->max;
+    }
     max = Blt_NaN();
     vp = vecObjPtr->valueArr + vecObjPtr->first;
     vend = vecObjPtr->valueArr + vecObjPtr->last;
@@ -842,6 +1565,11 @@ Blt_Vec_SetSize(
 	/* Same size, use the current array. */
 	return TCL_OK;
     } 
+    if (vPtr->parentPtr != NULL) {
+	/* A view can't grow or shrink within its parent. Its values are
+	 * copied into storage of its own below. */
+	UnlinkView(vPtr);
+    }
     if (vPtr->freeProc == TCL_DYNAMIC) {
 	double *newArr;
 
@@ -857,6 +1585,7 @@ Blt_Vec_SetSize(
 	}
 	vPtr->size = newSize;
 	vPtr->valueArr = newArr;
+	RelocateViews(vPtr);
 	return TCL_OK;
     }
 
@@ -909,6 +1638,7 @@ Blt_Vec_SetSize(
 	vPtr->freeProc = TCL_DYNAMIC; /* Set the type of the new storage */
 	vPtr->valueArr = newArr;
 	vPtr->size = newSize;
+	RelocateViews(vPtr);
     }
     return TCL_OK;
 }
@@ -937,6 +1667,9 @@ Blt_Vec_SetLength(
     Vector *vPtr, 
     int newLength)		/* Size of array in elements */
 {
+    if ((vPtr->parentPtr != NULL) && (newLength != vPtr->length)) {
+	Blt_Vec_DetachView(vPtr, TRUE);
+    }
     if (vPtr->size < newLength) {
 	if (Blt_Vec_SetSize(interp, vPtr, newLength) != TCL_OK) {
 	    return TCL_ERROR;
@@ -986,6 +1719,9 @@ Blt_Vec_ChangeLength(
     if (newLength < 0) {
 	newLength = 0;
     } 
+    if ((vPtr->parentPtr != NULL) && (newLength != vPtr->length)) {
+	Blt_Vec_DetachView(vPtr, TRUE);
+    }
     if (newLength > vPtr->size) {
 	int newSize;		/* Size of array in elements */
     
@@ -1043,7 +1779,13 @@ Blt_Vec_Reset(
 				 * for the array of values.  Can also be
 				 * TCL_STATIC, TCL_DYNAMIC, or TCL_VOLATILE. */
 {
-    if (vPtr->valueArr != valueArr) {	/* New array of values resides
+    if (vPtr->packedArr != NULL) {
+	/* The packed values are being replaced. */
+	Blt_Free(vPtr->packedArr);
+	vPtr->packedArr = NULL;
+    }
+    if ((vPtr->valueArr != valueArr) || (valueArr == NULL)) {
+					/* New array of values resides
 					 * in different memory than
 					 * the current vector.  */
 	if ((valueArr == NULL) || (size == 0)) {
@@ -1073,26 +1815,186 @@ Blt_Vec_Reset(
 	    valueArr = newArr;
 	    freeProc = TCL_DYNAMIC;
 	} 
+	if (vPtr->parentPtr != NULL) {
+	    UnlinkView(vPtr);	/* No longer a view onto the parent. */
+	}
+	if (vPtr->freeProc != TCL_STATIC) {
+	    /* Old data was dynamically allocated. Free it before attaching
+	     * new data.  */
+	    if (vPtr->freeProc == TCL_DYNAMIC) {
+		Blt_Free(vPtr->valueArr);
+	    } else {
+		(*freeProc) ((char *)vPtr->valueArr);
+	    }
+	}
+	vPtr->freeProc = freeProc;
+	vPtr->valueArr = valueArr;
+	vPtr->size = size;
+    }
+
+    vPtr->length = length;
+    RelocateViews(vPtr);
+    if (vPtr->flush) {
+	Blt_Vec_FlushCache(vPtr);
+    }
+    Blt_Vec_UpdateClients(vPtr);
+    return TCL_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_DetachView --
+ *
+ *	Detaches the view from its parent.  The view becomes an ordinary
+ *	vector with its own storage.  If *keepValues* is set, the current
+ *	components of the view are copied into the new storage, otherwise
+ *	the vector is left empty.
+ *
+ * Results:
+ *	None.
+ *
+ * Side Effects:
+ *	Any views of the view are relocated onto its new storage.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_Vec_DetachView(Vector *vPtr, int keepValues)
+{
+    int length;
+
+    if (vPtr->parentPtr == NULL) {
+	return;			/* Not a view. */
+    }
+    UnlinkView(vPtr);
+    length = (keepValues) ? vPtr->length : 0;
+    if (vPtr->freeProc == TCL_STATIC) {
+	double *valueArr;
+	int size;
+
+	/* The storage belongs to the parent. Copy the values out. */
+	size = MAX(length, DEF_ARRAY_SIZE);
+	valueArr = Blt_AssertMalloc(sizeof(double) * size);
+	if (length > 0) {
+	    memcpy(valueArr, vPtr->valueArr, sizeof(double) * length);
+	}
+	vPtr->valueArr = valueArr;
+	vPtr->size = size;
+	vPtr->freeProc = TCL_DYNAMIC;
+    }
+    vPtr->length = length;
+    vPtr->first = 0;
+    vPtr->last = length - 1;
+    RelocateViews(vPtr);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_SetView --
+ *
+ *	Makes the vector a view onto the components *first* through *last*
+ *	(every *stride* component) of the parent vector.  With a stride of
+ *	1, the view aliases the parent's storage so no values are copied.
+ *	Strided views hold a gathered copy that is kept in sync with the
+ *	parent.  In both cases, writing into the view updates the parent
+ *	and vice versa.
+ *
+ *	The view is invalidated (becomes empty) if the parent is shortened
+ *	so that the window is no longer inside of it, or the parent is
+ *	destroyed.  The view is detached from the parent (keeping its
+ *	values) if its own length is changed.
+ *
+ * Results:
+ *	A standard TCL result.  If the window is invalid or the view would
+ *	be cyclic, TCL_ERROR is returned.
+ *
+ * Side Effects:
+ *	The previous storage of the vector is freed.  The vector's clients
+ *	are notified.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_Vec_SetView(
+    Tcl_Interp *interp,
+    Vector *vPtr,		/* Vector to become the view. */
+    Vector *parentPtr,		/* Vector whose storage is viewed. */
+    int first, int last,	/* Window of the parent (inclusive). */
+    int stride)			/* Step between components. */
+{
+    Vector *ancestorPtr;
+    int length;
 
+    for (ancestorPtr = parentPtr; ancestorPtr != NULL; 
+	 ancestorPtr = ancestorPtr->parentPtr) {
+	if (ancestorPtr == vPtr) {
+	    Tcl_AppendResult(interp, "can't make \"", vPtr->name, 
+		"\" a view of \"", parentPtr->name, "\": cyclic view", 
+		(char *)NULL);
+	    return TCL_ERROR;
+	}
+    }
+    if (stride < 1) {
+	Tcl_AppendResult(interp, "bad stride \"", Blt_Itoa(stride), 
+		"\": must be greater than zero", (char *)NULL);
+	return TCL_ERROR;
+    }
+    if ((first < 0) || (first > last) || (last >= parentPtr->length)) {
+	Tcl_AppendResult(interp, "bad range \"", Blt_Itoa(first), ":", 
+		(char *)NULL);
+	Tcl_AppendResult(interp, Blt_Itoa(last), "\" for vector \"", 
+		parentPtr->name, "\"", (char *)NULL);
+	return TCL_ERROR;
+    }
+    length = (last - first) / stride + 1;
+    if (vPtr->parentPtr != NULL) {
+	UnlinkView(vPtr);
+    }
+    if (stride == 1) {
 	if (vPtr->freeProc != TCL_STATIC) {
-	    /* Old data was dynamically allocated. Free it before attaching
-	     * new data.  */
 	    if (vPtr->freeProc == TCL_DYNAMIC) {
 		Blt_Free(vPtr->valueArr);
 	    } else {
-		(*freeProc) ((char *)vPtr->valueArr);
+		(*vPtr->freeProc) ((char *)vPtr->valueArr);
 	    }
 	}
-	vPtr->freeProc = freeProc;
-	vPtr->valueArr = valueArr;
-	vPtr->size = size;
-    }
+	vPtr->valueArr = parentPtr->valueArr + first;
+	vPtr->freeProc = TCL_STATIC;
+	vPtr->size = length;
+    } else {
+	double *sp, *dp, *dend;
 
+	if ((vPtr->freeProc != TCL_DYNAMIC) || (vPtr->size < length)) {
+	    if (Blt_Vec_SetSize(interp, vPtr, length) != TCL_OK) {
+		return TCL_ERROR;
+	    }
+	}
+	sp = parentPtr->valueArr + first;
+	for (dp = vPtr->valueArr, dend = dp + length; dp < dend; 
+	     dp++, sp += stride) {
+	    *dp = *sp;
+	}
+    }
     vPtr->length = length;
+    vPtr->first = 0;
+    vPtr->last = length - 1;
+    vPtr->viewFirst = first;
+    vPtr->viewLast = first + (length - 1) * stride;
+    vPtr->viewStride = stride;
+    vPtr->parentPtr = parentPtr;
+    if (parentPtr->views == NULL) {
+	parentPtr->views = Blt_Chain_Create();
+    }
+    vPtr->viewLink = Blt_Chain_Append(parentPtr->views, vPtr);
+    RelocateViews(vPtr);
     if (vPtr->flush) {
 	Blt_Vec_FlushCache(vPtr);
     }
-    Blt_Vec_UpdateClients(vPtr);
+    /* Only the view has changed, not its parent. */
+    UpdateClients(vPtr, 0);
+    NotifyViews(vPtr);
     return TCL_OK;
 }
 
@@ -1154,6 +2056,13 @@ Blt_Vec_Free(Vector *vPtr)
     if (vPtr->arrayName != NULL) {
 	UnmapVariable(vPtr);
     }
+    if (vPtr->parentPtr != NULL) {
+	UnlinkView(vPtr);
+    }
+    while (vPtr->views != NULL) {
+	/* Views can't outlive the storage they share. */
+	InvalidateView(Blt_Chain_FirstValue(vPtr->views));
+    }
     vPtr->length = 0;
 
     /* Immediately notify clients that vector is going away */
@@ -1161,6 +2070,10 @@ Blt_Vec_Free(Vector *vPtr)
 	vPtr->notifyFlags &= ~NOTIFY_PENDING;
 	Tcl_CancelIdleCall(Blt_Vec_NotifyClients, vPtr);
     }
+    if (vPtr->notifyFlags & PACK_PENDING) {
+	vPtr->notifyFlags &= ~PACK_PENDING;
+	Tcl_CancelIdleCall(PackIdleProc, vPtr);
+    }
     vPtr->notifyFlags |= NOTIFY_DESTROYED;
     Blt_Vec_NotifyClients(vPtr);
 
@@ -1179,6 +2092,9 @@ Blt_Vec_Free(Vector *vPtr)
 	    (*vPtr->freeProc) ((char *)vPtr->valueArr);
 	}
     }
+    if (vPtr->packedArr != NULL) {
+	Blt_Free(vPtr->packedArr);
+    }
     if (vPtr->hashPtr != NULL) {
 	Blt_DeleteHashEntry(&vPtr->dataPtr->vectorTable, vPtr->hashPtr);
     }
@@ -1361,12 +2277,19 @@ Blt_Vec_Duplicate(Vector *destPtr, Vector *srcPtr)
     if (destPtr == srcPtr) {
 	/* Copying the same vector. */
     }
+    if (srcPtr->valueArr == NULL) {
+	Blt_Vec_Unpack(srcPtr);
+    }
+    if (destPtr->valueArr == NULL) {
+	Blt_Vec_Unpack(destPtr);
+    }
     length = srcPtr->last - srcPtr->first + 1;
     if (Blt_Vec_ChangeLength(destPtr->interp, destPtr, length) != TCL_OK) {
 	return TCL_ERROR;
     }
     nBytes = length * sizeof(double);
-    memcpy(destPtr->valueArr, srcPtr->valueArr + srcPtr->first, nBytes);
+    /* The source and destination may be views sharing the same storage. */
+    memmove(destPtr->valueArr, srcPtr->valueArr + srcPtr->first, nBytes);
     destPtr->offset = srcPtr->offset;
     return TCL_OK;
 }
@@ -1490,6 +2413,7 @@ VectorCreate2(
 	return TCL_ERROR;
     }
     memset(&switches, 0, sizeof(switches));
+    switches.type = -1;
     if (Blt_ParseSwitches(interp, createSwitches, objc - i, objv + i, 
 	&switches, BLT_SWITCH_DEFAULTS) < 0) {
 	return TCL_ERROR;
@@ -1578,6 +2502,9 @@ VectorCreate2(
 	vPtr->freeOnUnset = switches.watchUnset;
 	vPtr->flush = switches.flush;
 	vPtr->offset = first;
+	if (switches.type >= 0) {
+	    Blt_Vec_SetType(vPtr, switches.type);
+	}
 	if (size > 0) {
 	    if (Blt_Vec_ChangeLength(interp, vPtr, size) != TCL_OK) {
 		goto error;
@@ -2187,6 +3114,9 @@ Blt_ResizeVector(Blt_Vector *vecPtr, int length)
 {
     Vector *vPtr = (Vector *)vecPtr;
 
+    if (vPtr->valueArr == NULL) {
+	Blt_Vec_Unpack(vPtr);
+    }
     if (Blt_Vec_ChangeLength((Tcl_Interp *)NULL, vPtr, length) != TCL_OK) {
 	Tcl_AppendResult(vPtr->interp, "can't resize vector \"", vPtr->name,
 	    "\"", (char *)NULL);
@@ -2242,6 +3172,7 @@ Blt_AllocVectorId(Tcl_Interp *interp, const char *name)
     /* Allocate a new client structure */
     clientPtr = Blt_AssertCalloc(1, sizeof(VectorClient));
     clientPtr->magic = VECTOR_MAGIC;
+    clientPtr->changed = INT_MAX;
 
     /* Add the new client to the server's list of clients */
     clientPtr->link = Blt_Chain_Append(vPtr->chain, clientPtr);
@@ -2374,6 +3305,62 @@ Blt_VectorNotifyPending(Blt_VectorId clientId)
     return (clientPtr->serverPtr->notifyFlags & NOTIFY_PENDING);
 }
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_PinVector --
+ *
+ *	Indicates whether the client references the vector's array
+ *	directly, rather than copying its values.  While pinned, the vector
+ *	keeps its values as an array of doubles (it isn't packed) and the
+ *	client is called back with BLT_VECTOR_NOTIFY_MOVE as soon as the
+ *	array is moved or freed.  The callback should only pick up the new
+ *	array (it may be called in the middle of an operation on the
+ *	vector); the usual update notification follows.
+ *
+ * Results:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+void
+Blt_PinVector(Blt_VectorId clientId, int state)
+{
+    VectorClient *clientPtr = (VectorClient *)clientId;
+
+    if (clientPtr->magic != VECTOR_MAGIC) {
+	return;			/* Not a valid token */
+    }
+    clientPtr->pinned = state;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_VectorChangedFrom --
+ *
+ *	Returns the index of the first value changed, as reported by the
+ *	current notification.  The values before it are unchanged, so if
+ *	the index is the length the client last saw, the vector was only
+ *	appended to.  It's meant to be called from the client's callback.
+ *
+ * Results:
+ *	The index of the first changed value.  If no values were changed,
+ *	the length of the vector is returned.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_VectorChangedFrom(Blt_VectorId clientId)
+{
+    VectorClient *clientPtr = (VectorClient *)clientId;
+
+    if ((clientPtr->magic != VECTOR_MAGIC) || (clientPtr->serverPtr == NULL)) {
+	return 0;
+    }
+    return MIN(clientPtr->first, clientPtr->serverPtr->length);
+}
+
 /*
  *---------------------------------------------------------------------------
  *
@@ -2731,6 +3718,111 @@ for(i=0;i<pow2len;i++){
 
 /* spinellia@acm.org STOP */
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_Vec_Convolve --
+ *
+ *	Convolves the source vector with the kernel.  The result has the
+ *	same length as the source, with the kernel centered on each
+ *	component.  Values beyond the ends of the source are treated as
+ *	zero.
+ *
+ *	The direct method is O(n*k).  If the CONVOLVE_FFT flag is set, the
+ *	convolution is computed by multiplying the transforms of the
+ *	zero-padded source and kernel, which is O(n log n) and much faster
+ *	for long kernels.
+ *
+ * Results:
+ *	A standard TCL result.  The convolved values are written into
+ *	*resultArr*, which must hold as many values as the source.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_Vec_Convolve(
+    Tcl_Interp *interp,		/* Interpreter to report errors to */
+    Vector *srcPtr,		/* Vector to be convolved. */
+    Vector *kernelPtr,		/* Convolution kernel. */
+    int flags,			/* If CONVOLVE_FFT, use the FFT. */
+    double *resultArr)		/* (out) Convolved values. */
+{
+    double *src, *kernel;
+    int length, kLength, half;
+
+    length = srcPtr->last - srcPtr->first + 1;
+    kLength = kernelPtr->last - kernelPtr->first + 1;
+    if (kLength < 1) {
+	Tcl_AppendResult(interp, "kernel vector \"", kernelPtr->name, 
+		"\" is empty", (char *)NULL);
+	return TCL_ERROR;
+    }
+    src = srcPtr->valueArr + srcPtr->first;
+    kernel = kernelPtr->valueArr + kernelPtr->first;
+    half = (kLength - 1) / 2;
+    if (flags & CONVOLVE_FFT) {
+	double *a, *b;
+	double oneOverN;
+	int i, pow2len;
+
+	pow2len = smallest_power_of_2_not_less_than(length + kLength - 1);
+	a = Blt_Calloc(pow2len * 2, sizeof(double));
+	b = Blt_Calloc(pow2len * 2, sizeof(double));
+	if ((a == NULL) || (b == NULL)) {
+	    if (a != NULL) {
+		Blt_Free(a);
+	    }
+	    if (b != NULL) {
+		Blt_Free(b);
+	    }
+	    Tcl_AppendResult(interp, "can't allocate memory for padded data",
+		(char *)NULL);
+	    return TCL_ERROR;
+	}
+	for (i = 0; i < length; i++) {
+	    a[2*i] = src[i];
+	}
+	for (i = 0; i < kLength; i++) {
+	    b[2*i] = kernel[i];
+	}
+	four1(a - 1, pow2len, 1);
+	four1(b - 1, pow2len, 1);
+	/* Multiply the transforms and invert the product. */
+	for (i = 0; i < pow2len; i++) {
+	    double re, im;
+
+	    re = a[2*i] * b[2*i] - a[2*i+1] * b[2*i+1];
+	    im = a[2*i] * b[2*i+1] + a[2*i+1] * b[2*i];
+	    a[2*i] = re;
+	    a[2*i+1] = im;
+	}
+	four1(a - 1, pow2len, -1);
+	oneOverN = 1.0 / pow2len;
+	for (i = 0; i < length; i++) {
+	    resultArr[i] = a[2 * (i + half)] * oneOverN;
+	}
+	Blt_Free(a);
+	Blt_Free(b);
+    } else {
+	int i;
+
+	for (i = 0; i < length; i++) {
+	    double sum;
+	    int j, jFirst, jLast;
+
+	    /* Only the kernel values overlapping the source contribute. */
+	    jFirst = MAX(0, i + half - (length - 1));
+	    jLast = MIN(kLength - 1, i + half);
+	    sum = 0.0;
+	    for (j = jFirst; j <= jLast; j++) {
+		sum += kernel[j] * src[i + half - j];
+	    }
+	    resultArr[i] = sum;
+	}
+    }
+    return TCL_OK;
+}
+
 
 
 static double
@@ -2774,7 +3866,20 @@ FindSplit(Point2d *points, int i, int j, int *split)
 }
 
 
-/* Douglas-Peucker line simplification algorithm */
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_SimplifyLine --
+ *
+ *	Simplifies the polyline using the Douglas-Peucker algorithm.  The
+ *	recursion is replaced by an explicit stack of pending end points.
+ *
+ * Results:
+ *	Returns the number of points kept.  Their indices, in increasing
+ *	order, are written into the indices array.
+ *
+ *---------------------------------------------------------------------------
+ */
 int
 Blt_SimplifyLine(Point2d *inputPts, int low, int high, double tolerance,
 		 int *indices)
@@ -2792,7 +3897,7 @@ Blt_SimplifyLine(Point2d *inputPts, int low, int high, double tolerance,
     stack = Blt_AssertMalloc(sizeof(int) * (high - low + 1));
     StackPush(high);
     count = 0;
-    indices[count++] = 0;
+    indices[count++] = low;
     tolerance2 = tolerance * tolerance;
     while (!StackEmpty()) {
 	dist2 = FindSplit(inputPts, low, StackTop(), &split);
@@ -2806,3 +3911,308 @@ Blt_SimplifyLine(Point2d *inputPts, int low, int high, double tolerance,
     Blt_Free(stack);
     return count;
 }
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_SimplifyMonotonicLine --
+ *
+ *	Simplifies a polyline whose x-coordinates are non-decreasing (such
+ *	as a time series) in a single pass.  A segment is extended from the
+ *	last point kept for as long as the line through it passes within
+ *	the tolerance of every point skipped over.  Each skipped point
+ *	narrows the range of angles the line can take (the "swinging
+ *	door").  This is the same distance test as Blt_SimplifyLine, but
+ *	the split points are found greedily, so slightly more points may be
+ *	kept.
+ *
+ * Results:
+ *	Returns the number of points kept.  Their indices, in increasing
+ *	order, are written into the indices array.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_SimplifyMonotonicLine(Point2d *points, int nPoints, double tolerance,
+			  int *indices)
+{
+    double lower, upper;		/* Range of angles from the last
+					 * point kept of lines that pass
+					 * within the tolerance of the points
+					 * skipped over. */
+    double tolerance2;
+    int count, last, i;
+
+    if (nPoints < 3) {
+	for (i = 0; i < nPoints; i++) {
+	    indices[i] = i;
+	}
+	return nPoints;
+    }
+    tolerance2 = tolerance * tolerance;
+    count = 0;
+    indices[count++] = last = 0;
+    lower = -M_PI, upper = M_PI;
+    for (i = 1; i < nPoints; i++) {
+	double dx, dy, d2, angle;
+
+	dx = points[i].x - points[last].x;
+	dy = points[i].y - points[last].y;
+	angle = atan2(dy, dx);
+	if ((angle < lower) || (angle > upper)) {
+	    /* The segment can't end at this point.  End it at the previous
+	     * point and start a new one from there. */
+	    indices[count++] = last = i - 1;
+	    dx = points[i].x - points[last].x;
+	    dy = points[i].y - points[last].y;
+	    angle = atan2(dy, dx);
+	    lower = -M_PI, upper = M_PI;
+	}
+	d2 = (dx * dx) + (dy * dy);
+	if (d2 > tolerance2) {
+	    double delta;
+
+	    /* Narrow the door to the lines passing near this point. */
+	    delta = asin(tolerance / sqrt(d2));
+	    if ((angle - delta) > lower) {
+		lower = angle - delta;
+	    }
+	    if ((angle + delta) < upper) {
+		upper = angle + delta;
+	    }
+	}
+    }
+    indices[count++] = nPoints - 1;
+    return count;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_SimplifyLineRadial --
+ *
+ *	Simplifies the polyline by dropping points that are within the
+ *	tolerance of the last point kept.  This is a single pass and is
+ *	often used to thin out dense data before another method is applied.
+ *
+ * Results:
+ *	Returns the number of points kept.  Their indices, in increasing
+ *	order, are written into the indices array.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_SimplifyLineRadial(Point2d *points, int nPoints, double tolerance,
+		       int *indices)
+{
+    double tolerance2;
+    int count, last, i;
+
+    if (nPoints < 1) {
+	return 0;
+    }
+    tolerance2 = tolerance * tolerance;
+    count = 0;
+    indices[count++] = last = 0;
+    for (i = 1; i < (nPoints - 1); i++) {
+	double dx, dy;
+
+	dx = points[i].x - points[last].x;
+	dy = points[i].y - points[last].y;
+	if (((dx * dx) + (dy * dy)) > tolerance2) {
+	    indices[count++] = last = i;
+	}
+    }
+    if (nPoints > 1) {
+	indices[count++] = nPoints - 1;	/* Always keep the last point. */
+    }
+    return count;
+}
+
+/*
+ * Binary heap of the points of a polyline, ordered by the area of the
+ * triangle each forms with its neighbors.  The areas are kept in the heap
+ * itself so that sifting doesn't chase indices.  Used by
+ * Blt_SimplifyLineVW.
+ */
+typedef struct {
+    double area;			/* Area of the point's triangle. */
+    int index;				/* Index of the point. */
+} AreaHeapEntry;
+
+typedef struct {
+    AreaHeapEntry *entries;		/* Points in heap order. */
+    int *slots;				/* Heap slot of each point. */
+    int length;				/* # of points in the heap. */
+} AreaHeap;
+
+static void
+AreaHeapSwap(AreaHeap *hPtr, int i, int j)
+{
+    AreaHeapEntry t;
+
+    t = hPtr->entries[i];
+    hPtr->entries[i] = hPtr->entries[j];
+    hPtr->entries[j] = t;
+    hPtr->slots[hPtr->entries[i].index] = i;
+    hPtr->slots[hPtr->entries[j].index] = j;
+}
+
+static void
+AreaHeapUp(AreaHeap *hPtr, int i)
+{
+    while (i > 0) {
+	int parent;
+
+	parent = (i - 1) / 2;
+	if (hPtr->entries[parent].area <= hPtr->entries[i].area) {
+	    break;
+	}
+	AreaHeapSwap(hPtr, i, parent);
+	i = parent;
+    }
+}
+
+static void
+AreaHeapDown(AreaHeap *hPtr, int i)
+{
+    for (;;) {
+	int child, smallest;
+
+	smallest = i;
+	child = 2 * i + 1;
+	if ((child < hPtr->length) && 
+	    (hPtr->entries[child].area < hPtr->entries[smallest].area)) {
+	    smallest = child;
+	}
+	child++;
+	if ((child < hPtr->length) && 
+	    (hPtr->entries[child].area < hPtr->entries[smallest].area)) {
+	    smallest = child;
+	}
+	if (smallest == i) {
+	    break;
+	}
+	AreaHeapSwap(hPtr, i, smallest);
+	i = smallest;
+    }
+}
+
+static void
+AreaHeapUpdate(AreaHeap *hPtr, int index, double area)
+{
+    int i;
+
+    i = hPtr->slots[index];
+    hPtr->entries[i].area = area;
+    AreaHeapUp(hPtr, i);
+    AreaHeapDown(hPtr, hPtr->slots[index]);
+}
+
+static double
+TriangleArea(Point2d *p, Point2d *q, Point2d *r)
+{
+    double area;
+
+    area = ((q->x - p->x) * (r->y - p->y) - (r->x - p->x) * (q->y - p->y));
+    return FABS(area) * 0.5;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Blt_SimplifyLineVW --
+ *
+ *	Simplifies the polyline using the Visvalingam-Whyatt algorithm.
+ *	The point forming the smallest triangle with its neighbors is
+ *	repeatedly removed, until every remaining triangle has an area
+ *	larger than the square of the tolerance.  A point's area is never
+ *	less than that of a point removed before it, so that removal is
+ *	in order of significance.
+ *
+ * Results:
+ *	Returns the number of points kept.  Their indices, in increasing
+ *	order, are written into the indices array.
+ *
+ *---------------------------------------------------------------------------
+ */
+int
+Blt_SimplifyLineVW(Point2d *points, int nPoints, double tolerance,
+		   int *indices)
+{
+    AreaHeap heap;
+    double minArea;
+    int *prev, *next;
+    int count, i;
+
+    if (nPoints < 3) {
+	for (i = 0; i < nPoints; i++) {
+	    indices[i] = i;
+	}
+	return nPoints;
+    }
+    heap.entries = Blt_AssertMalloc(nPoints * sizeof(AreaHeapEntry));
+    heap.slots = Blt_AssertMalloc(nPoints * sizeof(int));
+    prev = Blt_AssertMalloc(nPoints * sizeof(int));
+    next = Blt_AssertMalloc(nPoints * sizeof(int));
+    heap.length = 0;
+    for (i = 1; i < (nPoints - 1); i++) {
+	prev[i] = i - 1;
+	next[i] = i + 1;
+	heap.entries[heap.length].area = 
+	    TriangleArea(points + i - 1, points + i, points + i + 1);
+	heap.entries[heap.length].index = i;
+	heap.slots[i] = heap.length;
+	heap.length++;
+    }
+    for (i = (heap.length / 2) - 1; i >= 0; i--) {
+	AreaHeapDown(&heap, i);
+    }
+    minArea = tolerance * tolerance;
+    while (heap.length > 0) {
+	int k, p, n;
+	double area;
+
+	k = heap.entries[0].index;
+	area = heap.entries[0].area;
+	if (area > minArea) {
+	    break;
+	}
+	/* Remove the point with the smallest area. */
+	heap.length--;
+	if (heap.length > 0) {
+	    AreaHeapSwap(&heap, 0, heap.length);
+	    AreaHeapDown(&heap, 0);
+	}
+	heap.slots[k] = -1;
+	p = prev[k], n = next[k];
+	next[p] = n;
+	prev[n] = p;
+	/* Recompute the areas of its neighbors. */
+	if (p > 0) {
+	    double a;
+
+	    a = TriangleArea(points + prev[p], points + p, points + n);
+	    AreaHeapUpdate(&heap, p, MAX(a, area));
+	}
+	if (n < (nPoints - 1)) {
+	    double a;
+
+	    a = TriangleArea(points + p, points + n, points + next[n]);
+	    AreaHeapUpdate(&heap, n, MAX(a, area));
+	}
+    }
+    count = 0;
+    indices[count++] = 0;
+    for (i = 1; i < (nPoints - 1); i++) {
+	if (heap.slots[i] >= 0) {
+	    indices[count++] = i;
+	}
+    }
+    indices[count++] = nPoints - 1;
+    Blt_Free(heap.entries);
+    Blt_Free(heap.slots);
+    Blt_Free(prev);
+    Blt_Free(next);
+    return count;
+}
@@ -32,9 +32,11 @@
 
 typedef enum {
     BLT_VECTOR_NOTIFY_UPDATE = 1, /* The vector's values has been updated */
-    BLT_VECTOR_NOTIFY_DESTROY	/* The vector has been destroyed and the client
+    BLT_VECTOR_NOTIFY_DESTROY,	/* The vector has been destroyed and the client
 				 * should no longer use its data (calling
 				 * Blt_FreeVectorId) */
+    BLT_VECTOR_NOTIFY_MOVE	/* The vector's array has moved.  Only sent
+				 * to clients pinning the vector. */
 } Blt_VectorNotify;
 
 typedef struct _Blt_VectorId *Blt_VectorId;
@@ -77,7 +79,12 @@ typedef enum {
  * macros are a reminder it isn't really safe to reset the data
  * fields, except by the API routines.  
  */
-#define Blt_VecData(v)		((v)->valueArr)
+/* 
+ * Vectors with a storage type other than double keep their values packed
+ * and have no value array until one is requested.
+ */
+#define Blt_VecData(v)		\
+	(((v)->valueArr != NULL) ? (v)->valueArr : Blt_VecUnpack(v))
 #define Blt_VecLength(v)	((v)->numValues)
 #define Blt_VecSize(v)		((v)->arraySize)
 #define Blt_VecDirty(v)		((v)->dirty)
@@ -85,6 +92,8 @@ typedef enum {
 BLT_EXTERN double Blt_VecMin(Blt_Vector *vPtr);
 BLT_EXTERN double Blt_VecMax(Blt_Vector *vPtr);
 
+BLT_EXTERN double *Blt_VecUnpack(Blt_Vector *vPtr);
+
 BLT_EXTERN Blt_VectorId Blt_AllocVectorId(Tcl_Interp *interp, 
 	const char *vecName);
 
@@ -102,6 +111,10 @@ BLT_EXTERN const char *Blt_NameOfVector(Blt_Vector *vecPtr);
 
 BLT_EXTERN int Blt_VectorNotifyPending(Blt_VectorId clientId);
 
+BLT_EXTERN void Blt_PinVector(Blt_VectorId clientId, int state);
+
+BLT_EXTERN int Blt_VectorChangedFrom(Blt_VectorId clientId);
+
 BLT_EXTERN int Blt_CreateVector(Tcl_Interp *interp, const char *vecName, 
 	int size, Blt_Vector ** vecPtrPtr);
 
@@ -0,0 +1,51 @@
+if {[info procs test] != "test"} {
+    source defs
+}
+
+if [file exists ../library] {
+    set blt_library ../library
+}
+
+#set VERBOSE 1
+
+# These tests need Tk: run them with bltwish.
+
+test graph.1 {graph create} {
+    list [catch {blt::graph .g -width 200 -height 150} msg] $msg
+} {0 .g}
+
+test graph.2 {decimate minmax with log x-axis and non-positive x} {
+    list [catch {
+	blt::vector create x y
+	# Increasing data, but -1000..0 map back onto the screen on a log
+	# scale.  There are many more points than pixel columns.
+	x seq -1000 1000 20001
+	y expr { sin(x) }
+	pack .g
+	.g axis configure x -logscale yes
+	.g element create e1 -x x -y y -decimate minmax -symbol none
+	update
+	.g element type e1
+    } msg] $msg
+} {0 line}
+
+test graph.3 {decimate minmax with log x-axis, zoomed in} {
+    list [catch {
+	.g axis configure x -min 1 -max 100
+	update
+	.g axis configure x -min {} -max {}
+	update
+	.g element cget e1 -decimate
+    } msg] $msg
+} {0 minmax}
+
+test graph.4 {graph destroy} {
+    list [catch {
+	destroy .g
+	blt::vector destroy x y
+    } msg] $msg
+} {0 {}}
+
+puts stderr "done testing graph.tcl"
+
+exit 0
@@ -0,0 +1,283 @@
+
+if {[info procs test] != "test"} {
+    source defs
+}
+
+if [file exists ../library] {
+    set blt_library ../library
+}
+
+#set VERBOSE 1
+
+test vector.1 {vector create} {
+    list [catch {blt::vector create v1} msg] $msg
+} {0 ::v1}
+
+test vector.2 {seq} {
+    list [catch {
+	v1 seq 0 9 10
+	v1 range 0 end
+    } msg] $msg
+} {0 {0.0 1.0 2.0 3.0 4.0 5.0 6.0 7.0 8.0 9.0}}
+
+test vector.3 {view (no args)} {
+    list [catch {v1 view} msg] $msg
+} {1 {wrong # args: should be "v1 view vecName first last ?stride?"}}
+
+test vector.4 {view v2 2 5} {
+    list [catch {
+	v1 view v2 2 5
+	v2 range 0 end
+    } msg] $msg
+} {0 {2.0 3.0 4.0 5.0}}
+
+test vector.5 {view writes through to parent} {
+    list [catch {
+	set v2(0) 100
+	v1 range 0 end
+    } msg] $msg
+} {0 {0.0 1.0 100.0 3.0 4.0 5.0 6.0 7.0 8.0 9.0}}
+
+test vector.6 {parent writes through to view} {
+    list [catch {
+	set v1(3) -3
+	v2 range 0 end
+    } msg] $msg
+} {0 {100.0 -3.0 4.0 5.0}}
+
+test vector.7 {view v3 1 9 3 (strided)} {
+    list [catch {
+	v1 view v3 1 9 3
+	set v3(1) 44
+	list [v3 range 0 end] [v1 range 0 end] [v2 range 0 end]
+    } msg] $msg
+} {0 {{1.0 44.0 7.0} {0.0 1.0 100.0 -3.0 44.0 5.0 6.0 7.0 8.0 9.0} {100.0 -3.0 44.0 5.0}}}
+
+test vector.8 {view survives parent growing} {
+    list [catch {
+	v1 length 1000
+	set v2(1) 7
+	list [v1 index 3] [v2 length]
+    } msg] $msg
+} {0 {7.0 4}}
+
+test vector.9 {view invalidated by parent shrinking} {
+    list [catch {
+	v1 length 3
+	list [v2 length] [v3 length]
+    } msg] $msg
+} {0 {0 0}}
+
+test vector.10 {resizing a view detaches it} {
+    list [catch {
+	v1 seq 0 9 10
+	v1 view v2 0 4
+	v2 append 99
+	list [v2 range 0 end] [v1 length]
+    } msg] $msg
+} {0 {{0.0 1.0 2.0 3.0 4.0 99.0} 10}}
+
+test vector.11 {view of a view} {
+    list [catch {
+	v1 view v2 0 4
+	v2 view v4 1 2
+	set v4(0) 55
+	v1 range 0 3
+    } msg] $msg
+} {0 {0.0 55.0 2.0 3.0}}
+
+test vector.12 {cyclic view} {
+    list [catch {v4 view v1 0 1} msg] $msg
+} {1 {can't make "::v1" a view of "::v4": cyclic view}}
+
+test vector.13 {bad stride} {
+    list [catch {v1 view v2 0 4 0} msg] $msg
+} {1 {bad stride "0": must be greater than zero}}
+
+test vector.14 {bad range} {
+    list [catch {v1 view v2 4 2} msg] $msg
+} {1 {bad range "4:2" for vector "::v1"}}
+
+test vector.15 {destroying parent empties views} {
+    list [catch {
+	blt::vector destroy v1
+	list [v2 length] [v4 length]
+    } msg] $msg
+} {0 {0 0}}
+
+test vector.16 {vector destroy} {
+    list [catch {blt::vector destroy v2 v3 v4} msg] $msg
+} {0 {}}
+
+test vector.17 {cumsum} {
+    list [catch {
+	blt::vector create v1
+	v1 set {1 2 3 4 5}
+	v1 cumsum
+	v1 range 0 end
+    } msg] $msg
+} {0 {1.0 3.0 6.0 10.0 15.0}}
+
+test vector.18 {diff -output} {
+    list [catch {
+	v1 diff -output v2
+	list [v2 range 0 end] [v1 length]
+    } msg] $msg
+} {0 {{2.0 3.0 4.0 5.0} 5}}
+
+test vector.19 {movavg 2} {
+    list [catch {
+	v1 set {2 4 6 8}
+	v1 movavg 2
+	v1 range 0 end
+    } msg] $msg
+} {0 {2.0 3.0 5.0 7.0}}
+
+test vector.20 {movavg 0} {
+    list [catch {v1 movavg 0} msg] $msg
+} {1 {bad window size "0": must be greater than zero}}
+
+test vector.21 {decimate 2} {
+    list [catch {
+	v1 set {0 5 1 -4 2 3 7}
+	v1 decimate 2 -output v2
+	v2 range 0 end
+    } msg] $msg
+} {0 {0.0 1.0 2.0 7.0}}
+
+test vector.22 {decimate 3 -minmax} {
+    list [catch {
+	v1 decimate 3 -minmax -output v2
+	v2 range 0 end
+    } msg] $msg
+} {0 {0.0 5.0 -4.0 3.0 7.0}}
+
+test vector.23 {convolve} {
+    list [catch {
+	blt::vector create k
+	k set {1 1 1}
+	v1 set {1 2 3 4}
+	v1 convolve k -output v2
+	v2 range 0 end
+    } msg] $msg
+} {0 {3.0 6.0 9.0 7.0}}
+
+test vector.24 {convolve -fft} {
+    list [catch {
+	v1 convolve k -fft -output v3
+	set result {}
+	foreach x [v3 range 0 end] {
+	    lappend result [expr round($x)]
+	}
+	set result
+    } msg] $msg
+} {0 {3 6 9 7}}
+
+test vector.25 {interpolate -linear} {
+    list [catch {
+	blt::vector create x xnew
+	x set {0 1 2 3}
+	v1 set {0 10 20 40}
+	xnew set {-1 0.5 2.5 1.5 5}
+	v1 interpolate x xnew -linear -output v2
+	v2 range 0 end
+    } msg] $msg
+} {0 {0.0 5.0 30.0 15.0 40.0}}
+
+test vector.26 {interpolate -spline} {
+    list [catch {
+	v1 set {0 1 4 9}
+	xnew set {0 1 2 3}
+	v1 interpolate x xnew -spline -output v2
+	v2 range 0 end
+    } msg] $msg
+} {0 {0.0 1.0 4.0 9.0}}
+
+test vector.27 {interpolate (not increasing)} {
+    list [catch {
+	x set {0 1 1 3}
+	v1 interpolate x xnew
+    } msg] $msg
+} {1 {x-coordinates in "::x" must be increasing}}
+
+test vector.28 {filter ops use the selected range of vector arguments} {
+    list [catch {
+	x set {0 1 2 3 4 5}
+	k set {0 2 0 9}
+	v1 set {0 10 20 30}
+	v1 convolve k(0:2) -output v2
+	v1 interpolate x(2:5) x(0:3) -output v3
+	list [v2 range 0 end] [v3 range 0 end]
+    } msg] $msg
+} {0 {{0.0 20.0 40.0 60.0} {0.0 0.0 0.0 10.0}}}
+
+test vector.29 {filter ops destroy} {
+    list [catch {blt::vector destroy v1 v2 v3 k x xnew} msg] $msg
+} {0 {}}
+
+test vector.30 {vector create -type badType} {
+    list [catch {blt::vector create v1 -type badType} msg] $msg
+} {1 {unknown vector type "badType": should be double, float, int32, or int16}}
+
+test vector.31 {int16 values are rounded and clamped when packed} {
+    list [catch {
+	blt::vector create v1 -type int16
+	v1 set {1.4 2.6 -2.5 -40000 40000}
+	update idletasks
+	v1 range 0 end
+    } msg] $msg
+} {0 {1.0 3.0 -3.0 -32768.0 32767.0}}
+
+test vector.32 {length, min, and max of packed vector} {
+    list [catch {
+	list [v1 length] [v1 min] [v1 max]
+    } msg] $msg
+} {0 {5 -32768.0 32767.0}}
+
+test vector.33 {array variable reads packed vector} {
+    list [catch {
+	update idletasks
+	set v1(1)
+    } msg] $msg
+} {0 3.0}
+
+test vector.34 {float storage} {
+    list [catch {
+	blt::vector create v2 -type float
+	v2 set {0.5 0.1}
+	update idletasks
+	list [v2 index 0] [expr {[v2 index 1] != 0.1}]
+    } msg] $msg
+} {0 {0.5 1}}
+
+test vector.35 {binread into packed vector} {
+    list [catch {
+	set f [open vector.bin w]
+	fconfigure $f -translation binary
+	puts -nonewline $f [binary format s* {1 -2 300}]
+	close $f
+	update idletasks
+	set f [open vector.bin r]
+	v1 binread $f -format i2
+	close $f
+	file delete vector.bin
+	v1 range 0 end
+    } msg] $msg
+} {0 {1.0 3.0 -3.0 -32768.0 32767.0 1.0 -2.0 300.0}}
+
+test vector.36 {vector create -type double unpacks} {
+    list [catch {
+	blt::vector create v1 -type double
+	v1 set {1.5}
+	update idletasks
+	v1 range 0 end
+    } msg] $msg
+} {0 1.5}
+
+test vector.37 {typed vectors destroy} {
+    list [catch {blt::vector destroy v1 v2} msg] $msg
+} {0 {}}
+
+puts stderr "done testing vector.tcl"
+
+exit 0